@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "../src/mini_jit/generator/Brgemm.h"
+#include "../src/mini_jit/generator/TuningTable.h"
 #include "../src/mini_jit/generator/Unary.h"
 #include "../src/mini_jit/generator/Util.h"
 #include "../src/mini_jit/include/gemm_ref.h"
@@ -46,7 +47,8 @@ void benchmark_brgemm() {
                 mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
                 l_kernel(l_a, l_b, l_c_jit,
                          m, k, m,
-                         m * k, k * n);
+                         m * k, k * n,
+                         nullptr);
 
                 double l_error = 0.0;
                 for (size_t i = 0; i < m * n; i++) {
@@ -62,7 +64,8 @@ void benchmark_brgemm() {
                 for (int i = 0; i < 10; i++) {
                     l_kernel(l_a, l_b, l_c_jit,
                              m, k, m,
-                             m * k, k * n);
+                             m * k, k * n,
+                             nullptr);
                 }
                 auto l_end = std::chrono::high_resolution_clock::now();
                 std::chrono::duration<double> l_duration = l_end - l_start;
@@ -72,7 +75,8 @@ void benchmark_brgemm() {
                 for (int i = 0; i < iteration; i++) {
                     l_kernel(l_a, l_b, l_c_jit,
                              m, k, m,
-                             m * k, k * n);
+                             m * k, k * n,
+                             nullptr);
                 }
                 l_end = std::chrono::high_resolution_clock::now();
                 l_duration = l_end - l_start;
@@ -101,6 +105,77 @@ void benchmark_brgemm() {
     std::cout << "************************************" << std::endl;
 }
 
+double gflops_brgemm(Brgemm::kernel_t l_kernel,
+                     int64_t m,
+                     int64_t n,
+                     int64_t k,
+                     int64_t br) {
+    float *l_a = (float *)malloc((br * m * k + 16) * sizeof(float));
+    float *l_b = (float *)malloc((br * k * n + 16) * sizeof(float));
+    float *l_c = (float *)malloc(m * n * sizeof(float));
+
+    for (int i = 0; i < br * m * k + 16; i++) {
+        l_a[i] = (float)drand48() * 0.01f;
+    }
+    for (int i = 0; i < br * k * n + 16; i++) {
+        l_b[i] = (float)drand48() * 0.01f;
+    }
+    for (int i = 0; i < m * n; i++) {
+        l_c[i] = 0.0f;
+    }
+
+    int64_t iteration = 100000000 / (2 * m * n * k * br) + 1;
+    auto l_start = std::chrono::high_resolution_clock::now();
+    for (int64_t i = 0; i < iteration; i++) {
+        l_kernel(l_a, l_b, l_c,
+                 m, k, m,
+                 m * k, k * n,
+                 nullptr);
+    }
+    auto l_end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> l_duration = l_end - l_start;
+
+    free(l_a);
+    free(l_b);
+    free(l_c);
+
+    return (2.0 * m * n * k * br) * iteration / l_duration.count() / 1e9;
+}
+
+void benchmark_tuning() {
+    // GEMMs of the iris model with a batch of 64 and square shapes for comparison
+    int64_t l_shapes[6][4] = {{64, 64, 4, 1},
+                              {64, 16, 64, 1},
+                              {64, 3, 16, 1},
+                              {64, 64, 64, 1},
+                              {32, 32, 32, 16},
+                              {17, 5, 128, 4}};
+
+    std::cout << "Autotuned register blocking ..." << std::endl;
+    for (auto const &l_shape : l_shapes) {
+        int64_t m = l_shape[0];
+        int64_t n = l_shape[1];
+        int64_t k = l_shape[2];
+        int64_t br = l_shape[3];
+
+        TuningTable::clear();
+        Brgemm l_heuristic;
+        l_heuristic.generate(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+
+        Brgemm::blocking_t l_blocking = TuningTable::tune(m, n, k, br);
+        Brgemm l_tuned;
+        l_tuned.generate(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+
+        std::cout << "  M=" << m << ", N=" << n << ", K=" << k << ", BR=" << br
+                  << " | heuristic: " << gflops_brgemm(l_heuristic.get_kernel(), m, n, k, br) << " GFLOPS"
+                  << " | tuned " << l_blocking.m_vectors << "x" << l_blocking.n << ": "
+                  << gflops_brgemm(l_tuned.get_kernel(), m, n, k, br) << " GFLOPS" << std::endl;
+    }
+    TuningTable::clear();
+    std::cout << "************************************" << std::endl;
+}
+
 int main() {
+    benchmark_tuning();
     benchmark_brgemm();
 }
\ No newline at end of file
@@ -43,7 +43,7 @@ void benchmark_gemm() {
                          m, n, k,
                          m, k, m);
                 mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
-                l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0);
+                l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0, nullptr);
 
                 double l_error = 0.0;
                 for (size_t i = 0; i < m * n; i++) {
@@ -57,7 +57,7 @@ void benchmark_gemm() {
                 // get iteration by testing a few iterations
                 auto l_start = std::chrono::high_resolution_clock::now();
                 for (int i = 0; i < 10; i++) {
-                    l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0);
+                    l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0, nullptr);
                 }
                 auto l_end = std::chrono::high_resolution_clock::now();
                 std::chrono::duration<double> l_duration = l_end - l_start;
@@ -65,7 +65,7 @@ void benchmark_gemm() {
 
                 l_start = std::chrono::high_resolution_clock::now();
                 for (int i = 0; i < iteration; i++) {
-                    l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0);
+                    l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0, nullptr);
                 }
                 l_end = std::chrono::high_resolution_clock::now();
                 l_duration = l_end - l_start;
@@ -1,8 +1,12 @@
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "../src/einsum/trees/einsum_trees.h"
+#include "../src/mini_jit/generator/Brgemm.h"
 #include "../src/mini_jit/include/gemm_ref.h"
 #include "../src/tensor/tensor.h"
 
@@ -96,6 +100,156 @@ void test_model(uint32_t batch_size) {
     std::cout << "  Execution time: " << duration.count() << " ms" << std::endl;
     std::cout << "  Execution time (seconds): " << duration.count() / 1000.0 << " s" << std::endl;
     std::cout << "*******************************************" << std::endl;
+
+    // whole model generated into one function
+    if (!model_tree.compile()) {
+        std::cout << "Model could not be compiled into one function." << std::endl;
+        return;
+    }
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < reps; i++) {
+        model_tree.execute(model_inputs, model_bias, model_output);
+    }
+    end = std::chrono::high_resolution_clock::now();
+
+    duration = end - start;
+    std::cout << "Compiled model execution completed." << std::endl;
+    std::cout << "  Batch size: " << batch_size << std::endl;
+    std::cout << "  Execution time: " << duration.count() << " ms" << std::endl;
+    std::cout << "  Execution time per run: " << duration.count() * 1e6 / reps << " ns" << std::endl;
+    std::cout << "*******************************************" << std::endl;
+}
+
+/** Running the model with int8 weights and activations:
+ * the weights are quantized once per output feature, the input of every layer per tensor
+ * right before the layer. Each layer is one int8 BRGEMM (M = BATCH_SIZE, N = out, K = in)
+ * whose epilogue dequantizes to single precision, adds the bias and applies ReLU.
+ * The output is compared with the single precision einsum tree.
+ */
+void test_model_int8(uint32_t batch_size) {
+    std::cout << "Running int8 model ..." << std::endl;
+    std::cout << "*******************************************" << std::endl;
+    if (!mini_jit::backend::Cpu::has_int8()) {
+        std::cout << "int8 kernels are not supported on this host." << std::endl;
+        std::cout << "*******************************************" << std::endl;
+        return;
+    }
+
+    std::string str_repr = "[[[1,0],[2,1]->[2,0]r],[3,2]->[3,0]r],[4,3]->[4,0]";
+    EinsumTree model_tree = EinsumTree(str_repr, {batch_size, 4, 64, 16, 3}, true);
+    model_tree.optimize();
+    model_tree.lower();
+
+    // features of the layers: 4 -> 64 -> 16 -> 3
+    int const features[4] = {4, 64, 16, 3};
+
+    srand48(time(NULL));
+    Tensor input = Tensor(4, (int)batch_size);
+    for (size_t i = 0; i < input.size; i++) {
+        input.data[i] = (float)drand48() * 10 - 5;
+    }
+
+    std::vector<Tensor> weights;
+    std::vector<Tensor> biases;
+    std::vector<Tensor> outputs;
+    for (int l = 0; l < 3; l++) {
+        weights.push_back(Tensor(features[l + 1], features[l]));
+        biases.push_back(Tensor(features[l + 1]));
+        outputs.push_back(Tensor(features[l + 1], (int)batch_size));
+        for (size_t i = 0; i < weights[l].size; i++) {
+            weights[l].data[i] = (float)drand48() * 10 - 5;
+        }
+        for (size_t i = 0; i < biases[l].size; i++) {
+            biases[l].data[i] = (float)drand48() * 10 - 5;
+        }
+        weights[l].quantize(true);
+    }
+
+    // single precision reference
+    std::vector<void*> model_inputs = {static_cast<void*>(input.data),
+                                       static_cast<void*>(weights[0].data),
+                                       static_cast<void*>(weights[1].data),
+                                       static_cast<void*>(weights[2].data)};
+    std::vector<void*> model_bias = {static_cast<void*>(biases[2].data),
+                                     static_cast<void*>(biases[1].data),
+                                     static_cast<void*>(biases[0].data)};
+    std::vector<float> model_output(3 * batch_size, 0.0f);
+
+    int64_t reps = 10;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < reps; i++) {
+        model_tree.execute(model_inputs, model_bias, model_output.data());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration_fp32 = end - start;
+
+    // kernels of the layers, the scales of the columns are followed by the bias
+    std::vector<mini_jit::generator::Brgemm> brgemms(3);
+    std::vector<std::vector<float>> params(3);
+    for (int l = 0; l < 3; l++) {
+        mini_jit::generator::Brgemm::error_t err = brgemms[l].generate(batch_size, features[l + 1], features[l], 1, 0, 0, 0,
+                                                                       mini_jit::generator::Brgemm::dtype_t::int8,
+                                                                       l < 2,
+                                                                       mini_jit::generator::Brgemm::bias_t::n);
+        if (err != mini_jit::generator::Brgemm::error_t::success) {
+            std::cout << "int8 kernel of layer " << l << " could not be generated." << std::endl;
+            return;
+        }
+        params[l].resize(2 * features[l + 1]);
+        std::copy(biases[l].data, biases[l].data + features[l + 1], params[l].begin() + features[l + 1]);
+    }
+
+    auto run_int8 = [&]() {
+        Tensor* layer_in = &input;
+        for (int l = 0; l < 3; l++) {
+            layer_in->quantize(false);
+            for (int n = 0; n < features[l + 1]; n++) {
+                params[l][n] = layer_in->scales[0] * weights[l].scales[n];
+            }
+            brgemms[l].get_kernel()(layer_in->data_int8, weights[l].data_int8, outputs[l].data,
+                                    batch_size, features[l], batch_size, 0, 0, params[l].data());
+            layer_in = &outputs[l];
+        }
+    };
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < reps; i++) {
+        run_int8();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration_int8 = end - start;
+
+    // kernels only, on the activations quantized by the last run
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < reps; i++) {
+        Tensor* layer_in = &input;
+        for (int l = 0; l < 3; l++) {
+            brgemms[l].get_kernel()(layer_in->data_int8, weights[l].data_int8, outputs[l].data,
+                                    batch_size, features[l], batch_size, 0, 0, params[l].data());
+            layer_in = &outputs[l];
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration_kernels = end - start;
+
+    // accuracy of the int8 model
+    float max_ref = 0.0f;
+    float max_err = 0.0f;
+    for (size_t i = 0; i < model_output.size(); i++) {
+        max_ref = std::max(max_ref, std::abs(model_output[i]));
+        max_err = std::max(max_err, std::abs(model_output[i] - outputs[2].data[i]));
+    }
+
+    std::cout << "  Batch size: " << batch_size << std::endl;
+    std::cout << "  fp32 execution time per run: " << duration_fp32.count() * 1e6 / reps << " ns" << std::endl;
+    std::cout << "  int8 execution time per run: " << duration_int8.count() * 1e6 / reps << " ns" << std::endl;
+    std::cout << "  int8 kernel time per run (without quantization of the activations): " << duration_kernels.count() * 1e6 / reps << " ns" << std::endl;
+    std::cout << "  Speedup: " << duration_fp32.count() / duration_int8.count() << std::endl;
+    std::cout << "  Speedup of the kernels: " << duration_fp32.count() / duration_kernels.count() << std::endl;
+    std::cout << "  Max. absolute error: " << max_err << std::endl;
+    std::cout << "  Max. relative error (to max. |output|): " << max_err / max_ref << std::endl;
+    std::cout << "*******************************************" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -108,6 +262,7 @@ int main(int argc, char* argv[]) {
     }
 
     test_model(batch_size);
+    test_model_int8(batch_size);
 
     return 0;
 }
\ No newline at end of file
@@ -42,10 +42,12 @@ void example1_2_ref(float* in0,
     }
 }
 
-void first_example() {
-    std::cout << "Running first example..." << std::endl;
+void first_example(mini_jit::generator::Brgemm::prefetch_t const& i_prefetch) {
+    std::cout << "Running first example (prefetch distance " << i_prefetch.k_distance
+              << ", next br block " << i_prefetch.next_br << ")..." << std::endl;
 
     TensorOperation tensor_op;
+    tensor_op._prefetch = i_prefetch;
 
     std::vector<TensorOperation::dim_t> i_dim_types = {TensorOperation::dim_t::m,
                                                        TensorOperation::dim_t::n,
@@ -151,10 +153,12 @@ void first_example() {
     strides_in1	        ( 0, 8192, 1024, 0, 32, 1 )
     strides_out	        ( 32768, 1024, 0, 1, 32, 0 )
  */
-void second_example() {
-    std::cout << "Running second example..." << std::endl;
+void second_example(mini_jit::generator::Brgemm::prefetch_t const& i_prefetch) {
+    std::cout << "Running second example (prefetch distance " << i_prefetch.k_distance
+              << ", next br block " << i_prefetch.next_br << ")..." << std::endl;
 
     TensorOperation tensor_op;
+    tensor_op._prefetch = i_prefetch;
 
     std::vector<TensorOperation::dim_t> i_dim_types = {TensorOperation::dim_t::m,
                                                        TensorOperation::dim_t::n,
@@ -260,12 +264,14 @@ void second_example() {
     strides_in1	        ( 0, 8192, 1024, 0, 32, 1 )
     strides_out	        ( 32768, 1024, 0, 1, 32, 0 )
  */
-void third_example() {
+void third_example(mini_jit::generator::Brgemm::prefetch_t const& i_prefetch) {
     // Testing first example
 
-    std::cout << "Running third example with ReLU activation..." << std::endl;
+    std::cout << "Running third example with ReLU activation (prefetch distance " << i_prefetch.k_distance
+              << ", next br block " << i_prefetch.next_br << ")..." << std::endl;
 
     TensorOperation tensor_op;
+    tensor_op._prefetch = i_prefetch;
 
     std::vector<TensorOperation::dim_t> i_dim_types = {TensorOperation::dim_t::m,
                                                        TensorOperation::dim_t::n,
@@ -370,11 +376,17 @@ void third_example() {
 int main() {
     std::cout << "Benchmarking Tensor contraction settings ..." << std::endl;
 
-    first_example();
-    std::cout << "----------------------------------------" << std::endl;
-    second_example();
-    std::cout << "----------------------------------------" << std::endl;
-    third_example();
+    mini_jit::generator::Brgemm::prefetch_t l_prefetch_configs[2] = {{0, false},
+                                                                     {8, true}};
+
+    for (auto const& l_prefetch : l_prefetch_configs) {
+        first_example(l_prefetch);
+        std::cout << "----------------------------------------" << std::endl;
+        second_example(l_prefetch);
+        std::cout << "----------------------------------------" << std::endl;
+        third_example(l_prefetch);
+        std::cout << "========================================" << std::endl;
+    }
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -1,9 +1,8 @@
 #include "TensorOperation.h"
 
-#include <omp.h>
-
 #include <algorithm>
 #include <iostream>
+#include <type_traits>
 
 #include "../../tensor/tensor.h"
 #include "../include/einsum_ref.h"
@@ -21,18 +20,37 @@ namespace einsum::backend {
                                                     std::span<const int64_t> dim_sizes,
                                                     std::span<const int64_t> strides_in0,
                                                     std::span<const int64_t> strides_in1,
-                                                    std::span<const int64_t> strides_out) {
+                                                    std::span<const int64_t> strides_out,
+                                                    std::span<const int64_t> strides_bias) {
         // set primitive types and dtype
         _prim_first_touch = prim_first_touch;
         _prim_main = prim_main;
         _prim_last_touch = prim_last_touch;
         _dtype = dtype;
+        _element_size = (_dtype == dtype_t::fp64) ? 8 : 4;
+        _element_size_in = (_dtype == dtype_t::bf16) ? 2 : _element_size;
 
-        if (_prim_last_touch == prim_t::relu) {
-            _is_last_touch_relu = true;
-        } else {
-            _is_last_touch_relu = false;
+        // activations are applied by the BRGEMM before the last store
+        switch (_prim_last_touch) {
+            case prim_t::relu:
+                _last_touch_act = mini_jit::generator::Brgemm::act_t::relu;
+                break;
+            case prim_t::gelu:
+                _last_touch_act = mini_jit::generator::Brgemm::act_t::gelu;
+                break;
+            case prim_t::sigmoid:
+                _last_touch_act = mini_jit::generator::Brgemm::act_t::sigmoid;
+                break;
+            case prim_t::tanh:
+                _last_touch_act = mini_jit::generator::Brgemm::act_t::tanh;
+                break;
+            case prim_t::silu:
+                _last_touch_act = mini_jit::generator::Brgemm::act_t::silu;
+                break;
+            default:
+                _last_touch_act = mini_jit::generator::Brgemm::act_t::none;
         }
+        _is_last_touch_fused = (_last_touch_act != mini_jit::generator::Brgemm::act_t::none);
 
         // set vectors
         _dim_types.assign(dim_types.begin(), dim_types.end());
@@ -42,108 +60,104 @@ namespace einsum::backend {
         _strides_in1.assign(strides_in1.begin(), strides_in1.end());
         _strides_out.assign(strides_out.begin(), strides_out.end());
 
+        // without bias strides a bias is a single value broadcast over the output
+        if (strides_bias.empty()) {
+            _strides_bias.assign(_dim_sizes.size(), 0);
+        } else {
+            _strides_bias.assign(strides_bias.begin(), strides_bias.end());
+        }
+
         return TensorOperation::error_t::success;
     }
     void TensorOperation::execute(void const* tensor_in0,
                                   void const* tensor_in1,
-                                  void* tensor_out) {
+                                  void* tensor_out,
+                                  void const* tensor_bias) {
         // get pointers to input and output data
         char const* l_ptr_in0 = static_cast<char const*>(tensor_in0);
         char const* l_ptr_in1 = static_cast<char const*>(tensor_in1);
         char* l_ptr_out = static_cast<char*>(tensor_out);
+        char const* l_ptr_bias = static_cast<char const*>(tensor_bias);
+
+        // split K accumulates partial outputs of the K chunks in parallel
+        if (_split_k && _num_split_k > 1) {
+            execute_split_k(l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias);
+            return;
+        }
+
+        // Check if the leading loops should be executed in parallel
+        bool use_parallel = _num_parallel_loops > 0 && !_split_k;
+
+        // generated loop nest of the sequential loops
+        mini_jit::generator::LoopNest* l_loop_nest = (l_ptr_bias != nullptr) ? _loop_nest_bias.get() : _loop_nest.get();
+        if (l_loop_nest != nullptr) {
+            mini_jit::generator::LoopNest::kernel_t l_kernel = l_loop_nest->get_kernel();
+            if (!use_parallel) {
+                void const* l_args[4] = {l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias};
+                l_kernel(l_args);
+                return;
+            }
 
-        // Check if the first loop should be executed in parallel
-        bool use_parallel = false;
-        if (_loop_ids.size() > 0 && _exec_types[_loop_ids[0]] == exec_t::shared) {
-            use_parallel = true;
+            thread_pool().parallel_for(parallel_size(0), [&](int64_t l_it) {
+                int64_t l_offsets[4];
+                parallel_offsets(0, l_it, l_offsets);
+                void const* l_args[4] = {l_ptr_in0 + l_offsets[0],
+                                         l_ptr_in1 + l_offsets[1],
+                                         l_ptr_out + l_offsets[2],
+                                         (l_ptr_bias != nullptr) ? l_ptr_bias + l_offsets[3] : nullptr};
+                l_kernel(l_args);
+            });
+            return;
         }
 
+        // every output block is touched for the first and last time unless a K loop says otherwise
         if (use_parallel) {
-            execute_iter_parallel(0, l_ptr_in0, l_ptr_in1, l_ptr_out, false, false);
+            execute_iter_parallel(0, l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias, true, true);
         } else {
-            execute_iter(0, l_ptr_in0, l_ptr_in1, l_ptr_out, false, false);
+            execute_iter(0, l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias, true, true);
         }
     }
     void TensorOperation::execute_iter(int64_t id_loop,
                                        char const* ptr_in0,
                                        char const* ptr_in1,
                                        char* ptr_out,
+                                       char const* ptr_bias,
                                        bool first_access,
                                        bool last_access) {
-        int64_t l_size = 1;
-        if (_loop_ids.size() > 0) {
-            l_size = _dim_sizes[_loop_ids[id_loop]];
+        if (_loop_ids.size() == 0) {
+            execute_block(ptr_in0, ptr_in1, ptr_out, ptr_bias, first_access, last_access);
+            return;
         }
 
+        int64_t l_id = _loop_ids[id_loop];
+        int64_t l_size = _dim_sizes[l_id];
+
         for (int64_t l_it = 0; l_it < l_size; l_it++) {
-            // derive if this is first or last access to the output block
-            if (_loop_ids.size() > 0 && id_loop == 0 && _dim_types[_loop_ids[id_loop]] != dim_t::k) {
-                first_access = true;
-            } else if (_loop_ids.size() > 0 && id_loop == 0 && _dim_types[_loop_ids[id_loop]] == dim_t::k && l_it == 0) {
-                first_access = true;
-            } else if (_loop_ids.size() == 0) {
-                first_access = true;
-            } else {
-                first_access = false;
-            }
-            if ((id_loop == _loop_ids.size() - 1) && (_dim_types[_loop_ids[id_loop]] != dim_t::k)) {
-                last_access = true;
-            } else if ((id_loop == _loop_ids.size() - 1) && (_dim_types[_loop_ids[id_loop]] == dim_t::k) && (l_it == l_size - 1)) {
-                last_access = true;
-            } else if (_loop_ids.size() == 0) {
-                last_access = true;
-            } else {
-                last_access = false;
+            // derive if this is first or last access to the output block, only K loops revisit a block
+            bool l_first_access = first_access;
+            bool l_last_access = last_access;
+            if (_dim_types[l_id] == dim_t::k) {
+                l_first_access = l_first_access && (l_it == 0);
+                l_last_access = l_last_access && (l_it == l_size - 1);
             }
 
             // update pointer with strides
-            char* l_ptr_in0 = const_cast<char*>(ptr_in0);
-            char* l_ptr_in1 = const_cast<char*>(ptr_in1);
-            char* l_ptr_out = ptr_out;
+            char const* l_ptr_in0 = ptr_in0 + l_it * _strides_in0[l_id] * _element_size_in;
+            char const* l_ptr_in1 = ptr_in1 + l_it * _strides_in1[l_id] * _element_size_in;
+            char* l_ptr_out = ptr_out + l_it * _strides_out[l_id] * _element_size;
+            char const* l_ptr_bias = (ptr_bias != nullptr) ? ptr_bias + l_it * _strides_bias[l_id] * _element_size : nullptr;
 
-            if (_loop_ids.size() > 0) {
-                l_ptr_in0 += l_it * _strides_in0[_loop_ids[id_loop]] * 4;
-                l_ptr_in1 += l_it * _strides_in1[_loop_ids[id_loop]] * 4;
-                l_ptr_out += l_it * _strides_out[_loop_ids[id_loop]] * 4;
-            }
-            if ((_loop_ids.size() > 0) && (id_loop < _loop_ids.size() - 1)) {
+            if (id_loop < static_cast<int64_t>(_loop_ids.size()) - 1) {
                 // recursive function call
                 execute_iter(id_loop + 1,
                              l_ptr_in0,
                              l_ptr_in1,
                              l_ptr_out,
-                             false,
-                             false);
+                             l_ptr_bias,
+                             l_first_access,
+                             l_last_access);
             } else {
-                // call first touch kernel if necessary
-                if (first_access && _prim_first_touch != prim_t::none) {
-                    _unary_first_touch_kernel(l_ptr_out, l_ptr_out, _ldc, _ldc);
-                }
-                if (_is_last_touch_relu && last_access) {
-                    _brgemm_last_touch_kernel(l_ptr_in0,
-                                              l_ptr_in1,
-                                              l_ptr_out,
-                                              _lda,
-                                              _ldb,
-                                              _ldc,
-                                              _br_stride_a,
-                                              _br_stride_b);
-                } else {
-                    // call main kernel
-                    _brgemm_kernel(l_ptr_in0,
-                                   l_ptr_in1,
-                                   l_ptr_out,
-                                   _lda,
-                                   _ldb,
-                                   _ldc,
-                                   _br_stride_a,
-                                   _br_stride_b);
-
-                    // call last touch kernel if necessary
-                    if (last_access && _prim_last_touch != prim_t::none) {
-                        _unary_last_touch_kernel(l_ptr_out, l_ptr_out, _ldc, _ldc);
-                    }
-                }
+                execute_block(l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias, l_first_access, l_last_access);
             }
         }
     }
@@ -152,81 +166,302 @@ namespace einsum::backend {
                                                 const char* ptr_in0,
                                                 const char* ptr_in1,
                                                 char* ptr_out,
+                                                char const* ptr_bias,
                                                 bool first_access,
                                                 bool last_access) {
-        int64_t l_size = 1;
-        if (_loop_ids.size() > 0) {
-            l_size = _dim_sizes[_loop_ids[id_loop]];
+        if (_loop_ids.size() == 0) {
+            execute_block(ptr_in0, ptr_in1, ptr_out, ptr_bias, first_access, last_access);
+            return;
         }
 
-#pragma omp parallel for
-        for (int64_t l_it = 0; l_it < l_size; l_it++) {
-            // derive if this is first or last access to the output block
-            bool local_first_access = first_access;
-            bool local_last_access = false;
+        // the parallel loops are M, N or C loops, every iteration visits other output blocks
+        int64_t l_id_next = id_loop + _num_parallel_loops;
 
-            if (id_loop == 0) {
-                local_first_access = true;
-            }
-            if ((id_loop == _loop_ids.size() - 1) && (_dim_types[_loop_ids[id_loop]] != dim_t::k)) {
-                local_last_access = true;
-            } else if ((id_loop == _loop_ids.size() - 1) && (_dim_types[_loop_ids[id_loop]] == dim_t::k) && (l_it == l_size - 1)) {
-                local_last_access = true;
-            }
+        thread_pool().parallel_for(parallel_size(id_loop), [&](int64_t l_it) {
+            int64_t l_offsets[4];
+            parallel_offsets(id_loop, l_it, l_offsets);
 
-            // update pointer with strides
-            char* l_ptr_in0 = const_cast<char*>(ptr_in0);
-            char* l_ptr_in1 = const_cast<char*>(ptr_in1);
-            char* l_ptr_out = ptr_out;
-
-            if (_loop_ids.size() > 0) {
-                l_ptr_in0 += l_it * _strides_in0[_loop_ids[id_loop]] * 4;
-                l_ptr_in1 += l_it * _strides_in1[_loop_ids[id_loop]] * 4;
-                l_ptr_out += l_it * _strides_out[_loop_ids[id_loop]] * 4;
-            }
+            char const* l_ptr_in0 = ptr_in0 + l_offsets[0];
+            char const* l_ptr_in1 = ptr_in1 + l_offsets[1];
+            char* l_ptr_out = ptr_out + l_offsets[2];
+            char const* l_ptr_bias = (ptr_bias != nullptr) ? ptr_bias + l_offsets[3] : nullptr;
 
-            if ((_loop_ids.size() > 0) && (id_loop < _loop_ids.size() - 1)) {
+            if (l_id_next < static_cast<int64_t>(_loop_ids.size())) {
                 // recursive function call (sequential from here)
-                execute_iter(id_loop + 1,
+                execute_iter(l_id_next,
                              l_ptr_in0,
                              l_ptr_in1,
                              l_ptr_out,
-                             false,
-                             false);
+                             l_ptr_bias,
+                             first_access,
+                             last_access);
             } else {
-                // call first touch kernel if necessary
-                if (local_first_access && _prim_first_touch != prim_t::none) {
-                    _unary_first_touch_kernel(l_ptr_out, l_ptr_out, _ldc, _ldc);
-                }
-                if (_is_last_touch_relu && local_last_access) {
-                    _brgemm_last_touch_kernel(l_ptr_in0,
-                                              l_ptr_in1,
-                                              l_ptr_out,
-                                              _lda,
-                                              _ldb,
-                                              _ldc,
-                                              _br_stride_a,
-                                              _br_stride_b);
+                execute_block(l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias, first_access, last_access);
+            }
+        });
+    }
+
+    int64_t TensorOperation::parallel_size(int64_t id_loop) const {
+        int64_t l_size = 1;
+        for (int64_t l_lo = id_loop; l_lo < id_loop + _num_parallel_loops; l_lo++) {
+            l_size *= _dim_sizes[_loop_ids[l_lo]];
+        }
+        return l_size;
+    }
+
+    void TensorOperation::parallel_offsets(int64_t id_loop,
+                                           int64_t it,
+                                           int64_t (&o_offsets)[4]) const {
+        o_offsets[0] = o_offsets[1] = o_offsets[2] = o_offsets[3] = 0;
+
+        // the innermost parallel loop runs fastest
+        for (int64_t l_lo = id_loop + _num_parallel_loops - 1; l_lo >= id_loop; l_lo--) {
+            int64_t l_id = _loop_ids[l_lo];
+            int64_t l_it = it % _dim_sizes[l_id];
+            it /= _dim_sizes[l_id];
+
+            o_offsets[0] += l_it * _strides_in0[l_id] * _element_size_in;
+            o_offsets[1] += l_it * _strides_in1[l_id] * _element_size_in;
+            o_offsets[2] += l_it * _strides_out[l_id] * _element_size;
+            o_offsets[3] += l_it * _strides_bias[l_id] * _element_size;
+        }
+    }
+
+    void TensorOperation::execute_split_k(char const* ptr_in0,
+                                          char const* ptr_in1,
+                                          char* ptr_out,
+                                          char const* ptr_bias) {
+        int64_t l_id = _loop_ids[0];
+        int64_t l_size = _dim_sizes[l_id];
+
+        thread_pool().parallel_for(_num_split_k, [&](int64_t l_chunk) {
+            // the first chunk initializes the output, the others accumulate into zeroed partial outputs
+            char* l_ptr_out = ptr_out;
+            char const* l_ptr_bias = ptr_bias;
+            if (l_chunk > 0) {
+                char* l_partial = _split_k_buffer.data() + (l_chunk - 1) * _size_split_k * _element_size;
+                std::fill(l_partial, l_partial + _size_split_k * _element_size, 0);
+                l_ptr_out = l_partial;
+                l_ptr_bias = nullptr;
+            }
+
+            // the last touch follows the reduction
+            for (int64_t l_it = l_chunk * l_size / _num_split_k; l_it < (l_chunk + 1) * l_size / _num_split_k; l_it++) {
+                bool l_first_access = (l_chunk == 0 && l_it == 0);
+                char const* l_ptr_in0 = ptr_in0 + l_it * _strides_in0[l_id] * _element_size_in;
+                char const* l_ptr_in1 = ptr_in1 + l_it * _strides_in1[l_id] * _element_size_in;
+
+                if (_loop_ids.size() > 1) {
+                    execute_iter(1, l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias, l_first_access, false);
                 } else {
-                    // call main kernel
-                    _brgemm_kernel(l_ptr_in0,
-                                   l_ptr_in1,
-                                   l_ptr_out,
-                                   _lda,
-                                   _ldb,
-                                   _ldc,
-                                   _br_stride_a,
-                                   _br_stride_b);
-
-                    // call last touch kernel if necessary
-                    if (local_last_access && _prim_last_touch != prim_t::none) {
-                        _unary_last_touch_kernel(l_ptr_out, l_ptr_out, _ldc, _ldc);
+                    execute_block(l_ptr_in0, l_ptr_in1, l_ptr_out, l_ptr_bias, l_first_access, false);
+                }
+            }
+        });
+
+        // output blocks are enumerated by the M, N and C loops, the innermost loop runs fastest
+        int64_t l_num_blocks = 1;
+        for (int64_t l_id_loop : _loop_ids) {
+            if (_dim_types[l_id_loop] != dim_t::k) {
+                l_num_blocks *= _dim_sizes[l_id_loop];
+            }
+        }
+        auto l_block_offset = [this](int64_t block) {
+            int64_t l_offset = 0;
+            for (std::size_t l_lo = _loop_ids.size(); l_lo-- > 0;) {
+                int64_t l_id_loop = _loop_ids[l_lo];
+                if (_dim_types[l_id_loop] != dim_t::k) {
+                    l_offset += (block % _dim_sizes[l_id_loop]) * _strides_out[l_id_loop];
+                    block /= _dim_sizes[l_id_loop];
+                }
+            }
+            return l_offset;
+        };
+
+        // reduction of the partial outputs, parallel over the columns of all blocks
+        int64_t l_size_m = _dim_sizes[_id_prim_m];
+        int64_t l_size_n = _dim_sizes[_id_prim_n];
+        auto l_reduce = [&](auto* io_out) {
+            using T = std::remove_pointer_t<decltype(io_out)>;
+            T const* l_partials = reinterpret_cast<T const*>(_split_k_buffer.data());
+            thread_pool().parallel_for(l_num_blocks * l_size_n, [&](int64_t l_col) {
+                int64_t l_offset = l_block_offset(l_col / l_size_n) + (l_col % l_size_n) * _ldc;
+                for (int64_t l_chunk = 1; l_chunk < _num_split_k; l_chunk++) {
+                    T const* l_partial = l_partials + (l_chunk - 1) * _size_split_k + l_offset;
+                    for (int64_t l_m = 0; l_m < l_size_m; l_m++) {
+                        io_out[l_offset + l_m] += l_partial[l_m];
                     }
                 }
+            });
+        };
+        if (_dtype == dtype_t::fp64) {
+            l_reduce(reinterpret_cast<double*>(ptr_out));
+        } else {
+            l_reduce(reinterpret_cast<float*>(ptr_out));
+        }
+
+        if (_prim_last_touch != prim_t::none) {
+            thread_pool().parallel_for(l_num_blocks, [&](int64_t l_block) {
+                char* l_ptr_block = ptr_out + l_block_offset(l_block) * _element_size;
+                _unary_last_touch_kernel(l_ptr_block, l_ptr_block, _ldc, _ldc);
+            });
+        }
+    }
+
+    void TensorOperation::execute_block(char const* ptr_in0,
+                                        char const* ptr_in1,
+                                        char* ptr_out,
+                                        char const* ptr_bias,
+                                        bool first_access,
+                                        bool last_access) {
+        // the first touch kernels initialize the accumulators with the bias or with zeros instead of loading C
+        // the zero kernels only replace the first touch without a bias, other bias layouts are initialized explicitly
+        bool l_fused_first_touch = (ptr_bias != nullptr) ? (_bias == mini_jit::generator::Brgemm::bias_t::m || _bias == mini_jit::generator::Brgemm::bias_t::n)
+                                                         : (_bias == mini_jit::generator::Brgemm::bias_t::zero);
+        if (first_access && l_fused_first_touch) {
+            if (_is_last_touch_fused && last_access) {
+                _brgemm_first_last_touch_kernel(ptr_in0, ptr_in1, ptr_out, _lda, _ldb, _ldc, _br_stride_a, _br_stride_b, ptr_bias);
+                return;
             }
+            _brgemm_first_touch_kernel(ptr_in0, ptr_in1, ptr_out, _lda, _ldb, _ldc, _br_stride_a, _br_stride_b, ptr_bias);
+        } else {
+            if (first_access && ptr_bias != nullptr) {
+                // bias layout without kernel support, initialize the block explicitly
+                auto l_init = [&](auto* o_out) {
+                    using T = std::remove_pointer_t<decltype(o_out)>;
+                    T const* l_bias = reinterpret_cast<T const*>(ptr_bias);
+                    int64_t l_stride_m = _strides_bias[_id_prim_m];
+                    int64_t l_stride_n = _strides_bias[_id_prim_n];
+                    for (int64_t l_n = 0; l_n < _dim_sizes[_id_prim_n]; l_n++) {
+                        for (int64_t l_m = 0; l_m < _dim_sizes[_id_prim_m]; l_m++) {
+                            o_out[l_n * _ldc + l_m] = l_bias[l_n * l_stride_n + l_m * l_stride_m];
+                        }
+                    }
+                };
+                if (_dtype == dtype_t::fp64) {
+                    l_init(reinterpret_cast<double*>(ptr_out));
+                } else {
+                    l_init(reinterpret_cast<float*>(ptr_out));
+                }
+            } else if (first_access && _prim_first_touch != prim_t::none) {
+                // call first touch kernel if necessary
+                _unary_first_touch_kernel(ptr_out, ptr_out, _ldc, _ldc);
+            }
+
+            if (_is_last_touch_fused && last_access) {
+                _brgemm_last_touch_kernel(ptr_in0, ptr_in1, ptr_out, _lda, _ldb, _ldc, _br_stride_a, _br_stride_b, nullptr);
+                return;
+            }
+
+            // call main kernel
+            _brgemm_kernel(ptr_in0, ptr_in1, ptr_out, _lda, _ldb, _ldc, _br_stride_a, _br_stride_b, nullptr);
+        }
+
+        // call last touch kernel if necessary
+        if (last_access && _prim_last_touch != prim_t::none && !_is_last_touch_fused) {
+            _unary_last_touch_kernel(ptr_out, ptr_out, _ldc, _ldc);
         }
     }
 
+    bool TensorOperation::get_block_calls(bool first_access,
+                                          bool last_access,
+                                          bool bias,
+                                          std::vector<mini_jit::generator::LoopNest::call_t>& o_calls) const {
+        using call_t = mini_jit::generator::LoopNest::call_t;
+        o_calls.clear();
+
+        // same decisions as execute_block
+        bool l_fused_first_touch = bias ? (_bias == mini_jit::generator::Brgemm::bias_t::m || _bias == mini_jit::generator::Brgemm::bias_t::n)
+                                        : (_bias == mini_jit::generator::Brgemm::bias_t::zero);
+        if (first_access && l_fused_first_touch) {
+            if (_is_last_touch_fused && last_access) {
+                o_calls.push_back(call_t{call_t::kind_t::brgemm, reinterpret_cast<void const*>(_brgemm_first_last_touch_kernel), bias});
+                return true;
+            }
+            o_calls.push_back(call_t{call_t::kind_t::brgemm, reinterpret_cast<void const*>(_brgemm_first_touch_kernel), bias});
+        } else {
+            if (first_access && bias) {
+                // explicit initialization with the bias
+                return false;
+            } else if (first_access && _prim_first_touch != prim_t::none) {
+                o_calls.push_back(call_t{call_t::kind_t::unary, reinterpret_cast<void const*>(_unary_first_touch_kernel), false});
+            }
+
+            if (_is_last_touch_fused && last_access) {
+                o_calls.push_back(call_t{call_t::kind_t::brgemm, reinterpret_cast<void const*>(_brgemm_last_touch_kernel), false});
+                return true;
+            }
+            o_calls.push_back(call_t{call_t::kind_t::brgemm, reinterpret_cast<void const*>(_brgemm_kernel), false});
+        }
+
+        if (last_access && _prim_last_touch != prim_t::none && !_is_last_touch_fused) {
+            o_calls.push_back(call_t{call_t::kind_t::unary, reinterpret_cast<void const*>(_unary_last_touch_kernel), false});
+        }
+
+        return true;
+    }
+
+    bool TensorOperation::get_loop_nest(bool bias,
+                                        bool sequential,
+                                        mini_jit::generator::LoopNest::nest_t& o_nest) const {
+        // the parallel loops stay in C++, split K reduces the partial outputs there
+        if (!sequential && _split_k) {
+            return false;
+        }
+        std::size_t l_first_loop = sequential ? 0 : _num_parallel_loops;
+
+        for (uint32_t l_ac = 0; l_ac < 4; l_ac++) {
+            if (!get_block_calls(l_ac & 1, l_ac & 2, bias, o_nest.calls[l_ac])) {
+                return false;
+            }
+        }
+
+        o_nest.loops.clear();
+        for (std::size_t l_lo = l_first_loop; l_lo < _loop_ids.size(); l_lo++) {
+            int64_t l_id = _loop_ids[l_lo];
+            mini_jit::generator::LoopNest::loop_t l_loop;
+            l_loop.size = _dim_sizes[l_id];
+            l_loop.stride_in0 = _strides_in0[l_id] * _element_size_in;
+            l_loop.stride_in1 = _strides_in1[l_id] * _element_size_in;
+            l_loop.stride_out = _strides_out[l_id] * _element_size;
+            l_loop.stride_bias = bias ? _strides_bias[l_id] * _element_size : 0;
+            l_loop.k = (_dim_types[l_id] == dim_t::k);
+            o_nest.loops.push_back(l_loop);
+        }
+
+        o_nest.params.lda = _lda;
+        o_nest.params.ldb = _ldb;
+        o_nest.params.ldc = _ldc;
+        o_nest.params.br_stride_a = _br_stride_a;
+        o_nest.params.br_stride_b = _br_stride_b;
+
+        return true;
+    }
+
+    std::shared_ptr<mini_jit::generator::LoopNest> TensorOperation::generate_loop_nest(bool bias) const {
+        using ptr_t = mini_jit::generator::LoopNest::ptr_t;
+
+        mini_jit::generator::LoopNest::nest_t l_nest;
+        if (!get_loop_nest(bias, false, l_nest)) {
+            return nullptr;
+        }
+
+        // the pointers are passed in the argument array: in0, in1, out, bias
+        for (uint32_t l_pt = 0; l_pt < 4; l_pt++) {
+            l_nest.ptrs[l_pt] = ptr_t{ptr_t::kind_t::arg, l_pt};
+        }
+        if (!bias) {
+            l_nest.ptrs[3] = ptr_t{};
+        }
+
+        auto l_loop_nest = std::make_shared<mini_jit::generator::LoopNest>();
+        if (l_loop_nest->generate({l_nest}) != mini_jit::generator::LoopNest::error_t::success) {
+            return nullptr;
+        }
+
+        return l_loop_nest;
+    }
+
     /** The folowing is set here:
      * - First touch primitive
      * - Main primitive
@@ -245,6 +480,15 @@ namespace einsum::backend {
             }
         }
 
+        // leading shared loops are executed in parallel: a K loop is split, M, N and C loops are collapsed
+        _split_k = _loop_ids.size() > 0 && _exec_types[_loop_ids[0]] == exec_t::shared && _dim_types[_loop_ids[0]] == dim_t::k;
+        _num_parallel_loops = _split_k ? 1 : 0;
+        while (!_split_k && _num_parallel_loops < static_cast<int64_t>(_loop_ids.size()) &&
+               _exec_types[_loop_ids[_num_parallel_loops]] == exec_t::shared &&
+               _dim_types[_loop_ids[_num_parallel_loops]] != dim_t::k) {
+            _num_parallel_loops++;
+        }
+
         // initialize id_prims
         _id_prim_m = -1;
         _id_prim_n = -1;
@@ -261,14 +505,20 @@ namespace einsum::backend {
             }
         }
 
-        // if k is stride 1 in in1 then K, else BR
+        // K has stride 1 in in1, or in in0 for a row-major A, else the smaller stride in in1 for a row-major B;
+        // the remaining K primitive is BR
         for (size_t i = 0; i < _exec_types.size(); i++) {
             if (_exec_types[i] == exec_t::prim && _dim_types[i] == dim_t::k) {
-                if (_strides_in1[i] == 1) {
+                if (_id_prim_k == -1) {
                     _id_prim_k = i;
-                } else {
-                    _id_prim_br = i;
+                    continue;
                 }
+                int64_t l_id_other = _id_prim_k;
+                bool l_is_k = (_strides_in1[i] == 1) ||
+                              (_strides_in1[l_id_other] != 1 && _strides_in0[i] == 1) ||
+                              (_strides_in1[l_id_other] != 1 && _strides_in0[l_id_other] != 1 && _strides_in1[i] < _strides_in1[l_id_other]);
+                _id_prim_k = l_is_k ? i : l_id_other;
+                _id_prim_br = l_is_k ? l_id_other : i;
             }
         }
         // check if all ids are set
@@ -277,50 +527,115 @@ namespace einsum::backend {
             return TensorOperation::error_t::compile_failed;
         }
 
-        // generate main primitive
-        _brgemm.generate(_dim_sizes[_id_prim_m],
-                         _dim_sizes[_id_prim_n],
-                         _dim_sizes[_id_prim_k],
-                         (_id_prim_br != -1) ? _dim_sizes[_id_prim_br] : 1,
-                         0,
-                         0,
-                         0,
-                         static_cast<mini_jit::generator::Brgemm::dtype_t>(_dtype),
-                         false);
-        _brgemm_kernel = _brgemm.get_kernel();
-
-        if (_is_last_touch_relu) {
-            _brgemm_last_touch.generate(_dim_sizes[_id_prim_m],
-                                        _dim_sizes[_id_prim_n],
-                                        _dim_sizes[_id_prim_k],
-                                        (_id_prim_br != -1) ? _dim_sizes[_id_prim_br] : 1,
-                                        0,
-                                        0,
-                                        0,
-                                        static_cast<mini_jit::generator::Brgemm::dtype_t>(_dtype),
-                                        true);
-        }
-        _brgemm_last_touch_kernel = _brgemm_last_touch.get_kernel();
-
-        // generate first/last touch primitive
-        if (!(_prim_first_touch == prim_t::none)) {
-            _unary_first_touch.generate(_dim_sizes[_id_prim_m],
-                                        _dim_sizes[_id_prim_n],
-                                        static_cast<mini_jit::generator::Unary::dtype_t>(_dtype),
-                                        static_cast<mini_jit::generator::Unary::ptype_t>(_prim_first_touch));
-            _unary_first_touch_kernel = _unary_first_touch.get_kernel();
-        }
-        if (!(_prim_last_touch == prim_t::none) && !_is_last_touch_relu) {
-            _unary_last_touch.generate(_dim_sizes[_id_prim_m],
-                                       _dim_sizes[_id_prim_n],
-                                       static_cast<mini_jit::generator::Unary::dtype_t>(_dtype),
-                                       static_cast<mini_jit::generator::Unary::ptype_t>(_prim_last_touch));
-            _unary_last_touch_kernel = _unary_last_touch.get_kernel();
+        // operands without unit stride in M (A) or K (B) are read row-major
+        _trans_a = (_strides_in0[_id_prim_m] != 1);
+        _trans_b = (_strides_in1[_id_prim_k] != 1);
+        if ((_trans_a && _strides_in0[_id_prim_k] != 1) || (_trans_b && _strides_in1[_id_prim_n] != 1)) {
+            std::cerr << "Error: The primitive dimensions of the inputs require unit stride." << std::endl;
+            return TensorOperation::error_t::compile_failed;
+        }
+        if ((_trans_a || _trans_b) && _dtype != dtype_t::fp32) {
+            std::cerr << "Error: Transposed inputs require single precision." << std::endl;
+            return TensorOperation::error_t::compile_failed;
+        }
+
+        // kernels of the operation share pages and are made executable together
+        mini_jit::generator::KernelCache::Batch l_batch;
+
+        // get main primitive
+        _brgemm_kernel = mini_jit::generator::KernelCache::get_brgemm(_dim_sizes[_id_prim_m],
+                                                                      _dim_sizes[_id_prim_n],
+                                                                      _dim_sizes[_id_prim_k],
+                                                                      (_id_prim_br != -1) ? _dim_sizes[_id_prim_br] : 1,
+                                                                      _trans_a,
+                                                                      _trans_b,
+                                                                      0,
+                                                                      static_cast<mini_jit::generator::Brgemm::dtype_t>(_dtype),
+                                                                      false,
+                                                                      _prefetch);
+        if (_brgemm_kernel == nullptr) {
+            std::cerr << "Error: Failed to generate the main primitive." << std::endl;
+            return TensorOperation::error_t::compile_failed;
+        }
+
+        if (_is_last_touch_fused) {
+            _brgemm_last_touch_kernel = mini_jit::generator::KernelCache::get_brgemm(_dim_sizes[_id_prim_m],
+                                                                                     _dim_sizes[_id_prim_n],
+                                                                                     _dim_sizes[_id_prim_k],
+                                                                                     (_id_prim_br != -1) ? _dim_sizes[_id_prim_br] : 1,
+                                                                                     _trans_a,
+                                                                                     _trans_b,
+                                                                                     0,
+                                                                                     static_cast<mini_jit::generator::Brgemm::dtype_t>(_dtype),
+                                                                                     false,
+                                                                                     _prefetch,
+                                                                                     mini_jit::generator::Brgemm::bias_t::none,
+                                                                                     _last_touch_act);
+        }
+
+        // the first touch kernels support a bias which is contiguous in either the M or the N primitive dimension,
+        // without a bias they replace the zero first touch
+        _bias = mini_jit::generator::Brgemm::bias_t::none;
+        if (_strides_bias[_id_prim_m] == 1 && _strides_bias[_id_prim_n] == 0) {
+            _bias = mini_jit::generator::Brgemm::bias_t::m;
+        } else if (_strides_bias[_id_prim_m] == 0 && _strides_bias[_id_prim_n] == 1) {
+            _bias = mini_jit::generator::Brgemm::bias_t::n;
+        } else if (_prim_first_touch == prim_t::zero) {
+            _bias = mini_jit::generator::Brgemm::bias_t::zero;
+        }
+
+        if (_bias != mini_jit::generator::Brgemm::bias_t::none) {
+            _brgemm_first_touch_kernel = mini_jit::generator::KernelCache::get_brgemm(_dim_sizes[_id_prim_m],
+                                                                                      _dim_sizes[_id_prim_n],
+                                                                                      _dim_sizes[_id_prim_k],
+                                                                                      (_id_prim_br != -1) ? _dim_sizes[_id_prim_br] : 1,
+                                                                                      _trans_a,
+                                                                                      _trans_b,
+                                                                                      0,
+                                                                                      static_cast<mini_jit::generator::Brgemm::dtype_t>(_dtype),
+                                                                                      false,
+                                                                                      _prefetch,
+                                                                                      _bias);
+            if (_is_last_touch_fused) {
+                _brgemm_first_last_touch_kernel = mini_jit::generator::KernelCache::get_brgemm(_dim_sizes[_id_prim_m],
+                                                                                               _dim_sizes[_id_prim_n],
+                                                                                               _dim_sizes[_id_prim_k],
+                                                                                               (_id_prim_br != -1) ? _dim_sizes[_id_prim_br] : 1,
+                                                                                               _trans_a,
+                                                                                               _trans_b,
+                                                                                               0,
+                                                                                               static_cast<mini_jit::generator::Brgemm::dtype_t>(_dtype),
+                                                                                               false,
+                                                                                               _prefetch,
+                                                                                               _bias,
+                                                                                               _last_touch_act);
+            }
+            if (_brgemm_first_touch_kernel == nullptr || (_is_last_touch_fused && _brgemm_first_last_touch_kernel == nullptr)) {
+                std::cerr << "Error: Failed to generate the first touch primitive." << std::endl;
+                return TensorOperation::error_t::compile_failed;
+            }
+        }
+
+        // get first/last touch primitive, they operate on the single precision output of bf16 contractions
+        mini_jit::generator::Unary::dtype_t l_dtype_unary = (_dtype == dtype_t::bf16) ? mini_jit::generator::Unary::dtype_t::fp32
+                                                                                        : static_cast<mini_jit::generator::Unary::dtype_t>(_dtype);
+        if (!(_prim_first_touch == prim_t::none) && _bias != mini_jit::generator::Brgemm::bias_t::zero) {
+            _unary_first_touch_kernel = mini_jit::generator::KernelCache::get_unary(_dim_sizes[_id_prim_m],
+                                                                                    _dim_sizes[_id_prim_n],
+                                                                                    l_dtype_unary,
+                                                                                    static_cast<mini_jit::generator::Unary::ptype_t>(_prim_first_touch));
+        }
+        // split K applies the last touch after the reduction
+        if (!(_prim_last_touch == prim_t::none) && (!_is_last_touch_fused || _split_k)) {
+            _unary_last_touch_kernel = mini_jit::generator::KernelCache::get_unary(_dim_sizes[_id_prim_m],
+                                                                                   _dim_sizes[_id_prim_n],
+                                                                                   l_dtype_unary,
+                                                                                   static_cast<mini_jit::generator::Unary::ptype_t>(_prim_last_touch));
         }
 
         // set runtime parameter
-        _lda = _strides_in0[_id_prim_k];
-        _ldb = _strides_in1[_id_prim_n];
+        _lda = _trans_a ? _strides_in0[_id_prim_m] : _strides_in0[_id_prim_k];
+        _ldb = _trans_b ? _strides_in1[_id_prim_k] : _strides_in1[_id_prim_n];
         _ldc = _strides_out[_id_prim_n];
         if (_id_prim_br != -1) {
             _br_stride_a = _strides_in0[_id_prim_br];
@@ -337,6 +652,29 @@ namespace einsum::backend {
             return TensorOperation::error_t::compile_failed;
         }
 
+        // partial outputs of the K chunks, each spans the output blocks
+        _num_split_k = 1;
+        _size_split_k = 0;
+        _split_k_buffer.clear();
+        if (_split_k) {
+            _num_split_k = std::min<int64_t>(thread_pool().num_threads(), _dim_sizes[_loop_ids[0]]);
+            _size_split_k = (_dim_sizes[_id_prim_n] - 1) * _ldc + _dim_sizes[_id_prim_m];
+            for (int64_t l_id : _loop_ids) {
+                if (_dim_types[l_id] != dim_t::k) {
+                    _size_split_k += (_dim_sizes[l_id] - 1) * _strides_out[l_id];
+                }
+            }
+            _split_k_buffer.resize((_num_split_k - 1) * _size_split_k * _element_size);
+        }
+
+        // generated loop nests, execute_iter remains the fallback
+        _loop_nest = nullptr;
+        _loop_nest_bias = nullptr;
+        if (_jit_loops) {
+            _loop_nest = generate_loop_nest(false);
+            _loop_nest_bias = generate_loop_nest(true);
+        }
+
         return TensorOperation::error_t::success;
     }
 
@@ -372,6 +710,7 @@ namespace einsum::backend {
                 _strides_in0.insert(_strides_in0.begin() + i + 1, _strides_in0[i] * split_size_0);
                 _strides_in1.insert(_strides_in1.begin() + i + 1, _strides_in1[i] * split_size_0);
                 _strides_out.insert(_strides_out.begin() + i + 1, _strides_out[i] * split_size_0);
+                _strides_bias.insert(_strides_bias.begin() + i + 1, _strides_bias[i] * split_size_0);
             }
         }
 
@@ -394,6 +733,7 @@ namespace einsum::backend {
                 _strides_in0.insert(_strides_in0.begin() + i + 1, _strides_in0[i] * split_size_0);
                 _strides_in1.insert(_strides_in1.begin() + i + 1, _strides_in1[i] * split_size_0);
                 _strides_out.insert(_strides_out.begin() + i + 1, _strides_out[i] * split_size_0);
+                _strides_bias.insert(_strides_bias.begin() + i + 1, _strides_bias[i] * split_size_0);
             }
         }
 
@@ -416,6 +756,7 @@ namespace einsum::backend {
                 _strides_in0.insert(_strides_in0.begin() + i + 1, _strides_in0[i] * split_size_0);
                 _strides_in1.insert(_strides_in1.begin() + i + 1, _strides_in1[i] * split_size_0);
                 _strides_out.insert(_strides_out.begin() + i + 1, _strides_out[i] * split_size_0);
+                _strides_bias.insert(_strides_bias.begin() + i + 1, _strides_bias[i] * split_size_0);
             }
         }
 
@@ -428,10 +769,12 @@ namespace einsum::backend {
             if (_dim_types[i] == dim_t::m && _dim_sizes[i] < 64) {
                 int64_t tmp_stride_in0 = _strides_in0[i];
                 int64_t tmp_stride_out = _strides_out[i];
+                int64_t tmp_stride_bias = _strides_bias[i];
                 int64_t tmp_dim_size = _dim_sizes[i];
                 for (size_t j = 0; j < _dim_sizes.size(); j++) {
                     // fuse with smaller stride
-                    if ((tmp_stride_in0 == _strides_in0[j] * tmp_dim_size) && (tmp_stride_out == _strides_out[j] * tmp_dim_size)) {
+                    if ((tmp_stride_in0 == _strides_in0[j] * tmp_dim_size) && (tmp_stride_out == _strides_out[j] * tmp_dim_size) &&
+                        (tmp_stride_bias == _strides_bias[j] * tmp_dim_size)) {
                         // fuse dimensions
                         _dim_sizes[j] *= tmp_dim_size;
                         // remove dimension i
@@ -441,12 +784,15 @@ namespace einsum::backend {
                         _strides_in0.erase(_strides_in0.begin() + i);
                         _strides_in1.erase(_strides_in1.begin() + i);
                         _strides_out.erase(_strides_out.begin() + i);
+                        _strides_bias.erase(_strides_bias.begin() + i);
                     }  // fuse with bigger stride
-                    else if (tmp_stride_in0 * _dim_sizes[i] == _strides_in0[j] && tmp_stride_out * _dim_sizes[i] == _strides_out[j]) {
+                    else if (tmp_stride_in0 * _dim_sizes[i] == _strides_in0[j] && tmp_stride_out * _dim_sizes[i] == _strides_out[j] &&
+                             tmp_stride_bias * _dim_sizes[i] == _strides_bias[j]) {
                         // fuse dimensions
                         _dim_sizes[j] *= tmp_dim_size;
                         _strides_in0[j] = _strides_in0[i];
                         _strides_out[j] = _strides_out[i];
+                        _strides_bias[j] = _strides_bias[i];
                         // remove dimension i
                         _dim_types.erase(_dim_types.begin() + i);
                         _exec_types.erase(_exec_types.begin() + i);
@@ -454,6 +800,7 @@ namespace einsum::backend {
                         _strides_in0.erase(_strides_in0.begin() + i);
                         _strides_in1.erase(_strides_in1.begin() + i);
                         _strides_out.erase(_strides_out.begin() + i);
+                        _strides_bias.erase(_strides_bias.begin() + i);
                     }
                 }
             }
@@ -464,10 +811,12 @@ namespace einsum::backend {
             if (_dim_types[i] == dim_t::n && _dim_sizes[i] < 64) {
                 int64_t tmp_stride_in1 = _strides_in1[i];
                 int64_t tmp_stride_out = _strides_out[i];
+                int64_t tmp_stride_bias = _strides_bias[i];
                 int64_t tmp_dim_size = _dim_sizes[i];
                 for (size_t j = 0; j < _dim_sizes.size(); j++) {
                     // fuse with smaller stride
-                    if ((tmp_stride_in1 == _strides_in1[j] * tmp_dim_size) && (tmp_stride_out == _strides_out[j] * tmp_dim_size)) {
+                    if ((tmp_stride_in1 == _strides_in1[j] * tmp_dim_size) && (tmp_stride_out == _strides_out[j] * tmp_dim_size) &&
+                        (tmp_stride_bias == _strides_bias[j] * tmp_dim_size)) {
                         // fuse dimensions
                         _dim_sizes[j] *= tmp_dim_size;
                         // remove dimension i
@@ -477,12 +826,15 @@ namespace einsum::backend {
                         _strides_in0.erase(_strides_in0.begin() + i);
                         _strides_in1.erase(_strides_in1.begin() + i);
                         _strides_out.erase(_strides_out.begin() + i);
+                        _strides_bias.erase(_strides_bias.begin() + i);
                     }  // fuse with bigger stride
-                    else if (tmp_stride_in1 * _dim_sizes[i] == _strides_in1[j] && tmp_stride_out * _dim_sizes[i] == _strides_out[j]) {
+                    else if (tmp_stride_in1 * _dim_sizes[i] == _strides_in1[j] && tmp_stride_out * _dim_sizes[i] == _strides_out[j] &&
+                             tmp_stride_bias * _dim_sizes[i] == _strides_bias[j]) {
                         // fuse dimensions
                         _dim_sizes[j] *= tmp_dim_size;
                         _strides_in1[j] = _strides_in1[i];
                         _strides_out[j] = _strides_out[i];
+                        _strides_bias[j] = _strides_bias[i];
                         // remove dimension i
                         _dim_types.erase(_dim_types.begin() + i);
                         _exec_types.erase(_exec_types.begin() + i);
@@ -490,6 +842,7 @@ namespace einsum::backend {
                         _strides_in0.erase(_strides_in0.begin() + i);
                         _strides_in1.erase(_strides_in1.begin() + i);
                         _strides_out.erase(_strides_out.begin() + i);
+                        _strides_bias.erase(_strides_bias.begin() + i);
                     }
                 }
             }
@@ -513,6 +866,7 @@ namespace einsum::backend {
                         _strides_in0.erase(_strides_in0.begin() + i);
                         _strides_in1.erase(_strides_in1.begin() + i);
                         _strides_out.erase(_strides_out.begin() + i);
+                        _strides_bias.erase(_strides_bias.begin() + i);
                     }  // fuse with bigger stride
                     else if (tmp_stride_in0 * tmp_dim_size == _strides_in0[j] && tmp_stride_in1 * tmp_dim_size == _strides_in1[j]) {
                         // fuse dimensions
@@ -526,6 +880,7 @@ namespace einsum::backend {
                         _strides_in0.erase(_strides_in0.begin() + i);
                         _strides_in1.erase(_strides_in1.begin() + i);
                         _strides_out.erase(_strides_out.begin() + i);
+                        _strides_bias.erase(_strides_bias.begin() + i);
                     }
                 }
             }
@@ -564,15 +919,52 @@ namespace einsum::backend {
                 _loop_ids.push_back(k_loops[i]);
             }
         }
-        if (_loop_ids.size() > 0 && _dim_types[_loop_ids[0]] != dim_t::k) {
-            _id_parallel_loop = _loop_ids[0];
+        // collapse the leading M and N loops until there is an iteration for every thread
+        int64_t num_threads = thread_pool().num_threads();
+        int64_t parallel_its = 1;
+        std::size_t num_parallel = 0;
+        while (num_parallel < _loop_ids.size() && _dim_types[_loop_ids[num_parallel]] != dim_t::k &&
+               (num_parallel == 0 || parallel_its < num_threads)) {
+            parallel_its *= _dim_sizes[_loop_ids[num_parallel]];
+            num_parallel++;
+        }
+
+        // K-dominated contractions split the largest K loop instead, if it has more iterations
+        int64_t id_split_k = -1;
+        if (parallel_its < num_threads) {
+            for (size_t i = 0; i < _loop_ids.size(); i++) {
+                int64_t id = _loop_ids[i];
+                if (_dim_types[id] == dim_t::k && _dim_sizes[id] > parallel_its &&
+                    (id_split_k < 0 || _dim_sizes[id] > _dim_sizes[_loop_ids[id_split_k]])) {
+                    id_split_k = i;
+                }
+            }
+        }
+
+        if (id_split_k >= 0) {
+            // the split K loop becomes the outermost loop
+            _id_parallel_loop = _loop_ids[id_split_k];
+            _loop_ids.erase(_loop_ids.begin() + id_split_k);
+            _loop_ids.insert(_loop_ids.begin(), _id_parallel_loop);
             _exec_types[_id_parallel_loop] = exec_t::shared;
+        } else if (num_parallel > 0) {
+            _id_parallel_loop = _loop_ids[0];
+            for (size_t i = 0; i < num_parallel; i++) {
+                _exec_types[_loop_ids[i]] = exec_t::shared;
+            }
         }
 
         return TensorOperation::error_t::success;
     }
 
     TensorOperation::error_t TensorOperation::identify_primitives() {
+        // single precision kernels read row-major operands, i.e., A with unit stride in K or B with unit stride in N
+        bool l_transposable = (_dtype == dtype_t::fp32);
+        _id_prim_m = -1;
+        _id_prim_n = -1;
+        _id_prim_k = -1;
+        _id_prim_br = -1;
+
         // identify prim M
         for (size_t i = 0; i < _dim_types.size(); i++) {
             if (_dim_types[i] == dim_t::m && _strides_in0[i] == 1 && _strides_out[i] == 1) {
@@ -581,6 +973,12 @@ namespace einsum::backend {
                 break;
             }
         }
+        for (size_t i = 0; _id_prim_m == -1 && l_transposable && i < _dim_types.size(); i++) {
+            if (_dim_types[i] == dim_t::m && _strides_out[i] == 1) {
+                _id_prim_m = i;
+                _exec_types[i] = exec_t::prim;
+            }
+        }
 
         // identify prim N
         int64_t smallest_stride = 1e18;
@@ -598,7 +996,7 @@ namespace einsum::backend {
             }
         }
 
-        // identify prim K
+        // identify prim K, a row-major A requires unit stride in in0, a row-major B the smallest stride in in1
         for (size_t i = 0; i < _dim_types.size(); i++) {
             if (_dim_types[i] == dim_t::k && _strides_in1[i] == 1) {
                 _id_prim_k = i;
@@ -606,17 +1004,35 @@ namespace einsum::backend {
                 break;
             }
         }
+        for (size_t i = 0; _id_prim_k == -1 && l_transposable && i < _dim_types.size(); i++) {
+            if (_dim_types[i] == dim_t::k && _strides_in0[i] == 1) {
+                _id_prim_k = i;
+                _exec_types[i] = exec_t::prim;
+            }
+        }
+        if (_id_prim_k == -1 && l_transposable && _id_prim_n != -1 && _strides_in1[_id_prim_n] == 1) {
+            smallest_stride = 1e18;
+            for (size_t i = 0; i < _dim_types.size(); i++) {
+                if (_dim_types[i] == dim_t::k && _strides_in1[i] > 1 && _strides_in1[i] < smallest_stride) {
+                    smallest_stride = _strides_in1[i];
+                    _id_prim_k = i;
+                }
+            }
+            if (_id_prim_k != -1) {
+                _exec_types[_id_prim_k] = exec_t::prim;
+            }
+        }
 
         // identify prim BR
         smallest_stride = 1e18;
         for (size_t i = 0; i < _dim_types.size(); i++) {
             // find smalles stride in BR dimension
-            if (_dim_types[i] == dim_t::k && _strides_in1[i] > 1) {
+            if (_dim_types[i] == dim_t::k && static_cast<int64_t>(i) != _id_prim_k && _strides_in1[i] > 1) {
                 smallest_stride = std::min(smallest_stride, _strides_in1[i]);
             }
         }
         for (size_t i = 0; i < _dim_types.size(); i++) {
-            if (smallest_stride == _strides_in1[i] && _dim_types[i] == dim_t::k) {
+            if (smallest_stride == _strides_in1[i] && _dim_types[i] == dim_t::k && static_cast<int64_t>(i) != _id_prim_k) {
                 if (_dim_sizes[i] > 16) {
                     continue;  // skip if size is 1
                 }
@@ -635,6 +1051,10 @@ namespace einsum::backend {
         return TensorOperation::error_t::success;
     }
 
+    ThreadPool& TensorOperation::thread_pool() const {
+        return (_thread_pool != nullptr) ? *_thread_pool : *ThreadPool::global();
+    }
+
     int64_t TensorOperation::get_flops_count() {
         int64_t flops = 2;
         for (size_t i = 0; i < _dim_sizes.size(); i++) {
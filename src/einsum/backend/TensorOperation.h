@@ -2,12 +2,16 @@
 #define EINSUM_BACKEND_TENSOR_OPERATION_H
 
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <vector>
 
 #include "../../mini_jit/generator/Brgemm.h"
+#include "../../mini_jit/generator/KernelCache.h"
+#include "../../mini_jit/generator/LoopNest.h"
 #include "../../mini_jit/generator/Unary.h"
 #include "../../tensor/tensor.h"
+#include "ThreadPool.h"
 
 namespace einsum {
     namespace backend {
@@ -31,6 +35,10 @@ class einsum::backend::TensorOperation {
         relu = 2,
         gemm = 3,
         brgemm = 4,
+        gelu = 5,
+        sigmoid = 6,
+        tanh = 7,
+        silu = 8,
         none = 99
     };
 
@@ -46,7 +54,8 @@ class einsum::backend::TensorOperation {
     /// data type
     enum class dtype_t : uint32_t {
         fp32 = 0,
-        fp64 = 1
+        fp64 = 1,
+        bf16 = 2  // inputs in bfloat16, output and bias in single precision
     };
 
     /// error codes
@@ -59,6 +68,8 @@ class einsum::backend::TensorOperation {
     };
     /* Setup values */
     dtype_t _dtype;
+    int64_t _element_size;     // bytes per element of the output and the bias
+    int64_t _element_size_in;  // bytes per element of the input tensors
     prim_t _prim_first_touch;  // first touch primitive
     prim_t _prim_main;         // main primitive
     prim_t _prim_last_touch;   // last touch primitive
@@ -69,6 +80,7 @@ class einsum::backend::TensorOperation {
     std::vector<int64_t> _strides_in0;
     std::vector<int64_t> _strides_in1;
     std::vector<int64_t> _strides_out;
+    std::vector<int64_t> _strides_bias;
 
     /* Compile Values */
     std::vector<int64_t> _loop_ids;  // ids of the loops dimensions
@@ -77,6 +89,10 @@ class einsum::backend::TensorOperation {
     int64_t _id_prim_k;
     int64_t _id_prim_br;
     int64_t _id_parallel_loop = -1;
+    int64_t _num_parallel_loops = 0;  // leading loops executed in parallel, collapsed into one iteration space
+    bool _split_k = false;            // the parallel loop is a K loop, each thread accumulates a partial output
+    bool _trans_a = false;            // in0 is read row-major, i.e., with unit stride in K
+    bool _trans_b = false;            // in1 is read row-major, i.e., with unit stride in N
 
     /* Runtime Values */
     int64_t _lda;
@@ -85,21 +101,37 @@ class einsum::backend::TensorOperation {
     int64_t _br_stride_a = 0;
     int64_t _br_stride_b = 0;
 
-    /* last touch relu */
-    bool _is_last_touch_relu;
+    /* last touch activation, fused into the BRGEMM */
+    bool _is_last_touch_fused;
+    mini_jit::generator::Brgemm::act_t _last_touch_act = mini_jit::generator::Brgemm::act_t::none;
+
+    /* initialization of the accumulators by the first touch kernels: broadcast of the bias, zero without a bias,
+       none if the first touch is applied explicitly */
+    mini_jit::generator::Brgemm::bias_t _bias = mini_jit::generator::Brgemm::bias_t::none;
+
+    /* software prefetching of the BRGEMM kernels, has to be set before compile() */
+    mini_jit::generator::Brgemm::prefetch_t _prefetch;
+
+    /* generate the sequential loops with their first and last touch calls into one function, has to be set before compile() */
+    bool _jit_loops = false;
+
+    /* threads executing the shared loops, the global pool if nullptr, has to be set before optimize() */
+    std::shared_ptr<ThreadPool> _thread_pool;
 
     using kernel_t = mini_jit::generator::Brgemm::kernel_t;
 
     /**
      * Setup for a binary tensor contraction or a unary tensor operation.
      *
-     * @param dtype             Datatype of all tensor elements.
+     * @param dtype             Datatype of the tensor elements, bf16 for bfloat16 inputs and a single precision output.
      * @param prim_first_touch  Type of the first touch primitive.
      * @param prim_main         Type of the main primitive.
      * @param prim_last_touch   Type of the last touch primitive.
      * @param in0               First input tensor.
      * @param in1               Second input tensor (use nullptr if unary).
      * @param out               Output tensor.
+     * @param strides_bias      Strides of the bias which initializes the output on first touch,
+     *                          0 in the dimensions the bias is broadcast over (empty if no bias).
      *
      * @return error_t::success on success, another error_t value otherwise.
      **/
@@ -112,7 +144,8 @@ class einsum::backend::TensorOperation {
                   std::span<const int64_t> dim_sizes,
                   std::span<const int64_t> strides_in0,
                   std::span<const int64_t> strides_in1,
-                  std::span<const int64_t> strides_out);
+                  std::span<const int64_t> strides_out,
+                  std::span<const int64_t> strides_bias = {});
 
     /**
      * @brief Optimizes tensor contraction for efficient computation.
@@ -164,12 +197,26 @@ class einsum::backend::TensorOperation {
      *
      * @param tensor_in0 First input tensor.
      * @param tensor_in1 Second input tensor (use nullptr if unary).
-     * @param tensor_bias Bias tensor (use nullptr if no bias).
      * @param tensor_out Output tensor.
+     * @param tensor_bias Bias tensor (use nullptr if no bias), replaces the previous values of the output.
      **/
     void execute(void const* tensor_in0,
                  void const* tensor_in1,
-                 void* tensor_out);
+                 void* tensor_out,
+                 void const* tensor_bias = nullptr);
+
+    /**
+     * Describes the compiled loops as a loop nest, e.g., to generate several operations into one function.
+     * The base pointers of the nest are left to the caller.
+     *
+     * @param bias       True if a bias is given.
+     * @param sequential True to include the shared loops, false to leave them to the caller.
+     * @param o_nest     Loops, calls and parameters of the nest.
+     * @return false if the operation cannot be executed by a loop nest.
+     **/
+    bool get_loop_nest(bool bias,
+                       bool sequential,
+                       mini_jit::generator::LoopNest::nest_t& o_nest) const;
 
     /**
      * General-purpose loop implementation featuring first and last touch operations.
@@ -179,6 +226,7 @@ class einsum::backend::TensorOperation {
      * @param ptr_in0      Pointer to the first input tensor's data.
      * @param ptr_in1      Pointer to the second input tensor's data (use nullptr if unary).
      * @param ptr_out      Pointer to the output tensor's data.
+     * @param ptr_bias     Pointer to the bias data (use nullptr if no bias).
      * @param first_access True if first time accessing data of output tensor.
      * @param last_access  True if last time accessing data of output tensor.
      **/
@@ -186,6 +234,7 @@ class einsum::backend::TensorOperation {
                       char const* ptr_in0,
                       char const* ptr_in1,
                       char* ptr_out,
+                      char const* ptr_bias,
                       bool first_access,
                       bool last_access);
 
@@ -196,11 +245,12 @@ class einsum::backend::TensorOperation {
                             char* ptr_out);
 
     /**
-     * @brief Executes the the first loop if it is M or N dimension in parallel
+     * @brief Executes the leading shared M, N or C loops in parallel, collapsed into one iteration space.
      *
      * @param ptr_in0      Pointer to the first input tensor's data.
      * @param ptr_in1      Pointer to the second input tensor's data (use nullptr if unary).
      * @param ptr_out      Pointer to the output tensor's data.
+     * @param ptr_bias     Pointer to the bias data (use nullptr if no bias).
      * @param first_access True if first time accessing data of output tensor.
      * @param last_access  True if last time accessing data of output tensor.
      **/
@@ -208,29 +258,110 @@ class einsum::backend::TensorOperation {
                                char const* ptr_in0,
                                char const* ptr_in1,
                                char* ptr_out,
+                               char const* ptr_bias,
                                bool first_access,
                                bool last_access);
+
+    /**
+     * @brief Executes the shared K loop in parallel chunks.
+     * The first chunk accumulates into the output, the other chunks into zeroed partial outputs.
+     * The partial outputs are reduced into the output in parallel before the last touch is applied.
+     *
+     * @param ptr_in0      Pointer to the first input tensor's data.
+     * @param ptr_in1      Pointer to the second input tensor's data.
+     * @param ptr_out      Pointer to the output tensor's data.
+     * @param ptr_bias     Pointer to the bias data (use nullptr if no bias).
+     **/
+    void execute_split_k(char const* ptr_in0,
+                         char const* ptr_in1,
+                         char* ptr_out,
+                         char const* ptr_bias);
+
     /**
      * @brief Returns the number of floating-point operations (FLOPs) for the tensor operation.
      */
     int64_t get_flops_count();
 
    private:
-    // BRGEMM
-    mini_jit::generator::Brgemm _brgemm;
+    /**
+     * Pool executing the shared loops.
+     **/
+    ThreadPool& thread_pool() const;
+
+    // BRGEMM, kernels are owned by mini_jit::generator::KernelCache
     kernel_t _brgemm_kernel{nullptr};
 
     // Unary first touch
-    mini_jit::generator::Unary _unary_first_touch;
     mini_jit::generator::Unary::kernel_t _unary_first_touch_kernel{nullptr};
 
     // Unary last touch
-    mini_jit::generator::Unary _unary_last_touch;
     mini_jit::generator::Unary::kernel_t _unary_last_touch_kernel{nullptr};
 
     // BRGEMM last touch
-    mini_jit::generator::Brgemm _brgemm_last_touch;
     kernel_t _brgemm_last_touch_kernel{nullptr};
+
+    // BRGEMM first touch with bias or zero initialization, and its variant for blocks which are touched only once with a fused last touch
+    kernel_t _brgemm_first_touch_kernel{nullptr};
+    kernel_t _brgemm_first_last_touch_kernel{nullptr};
+
+    /**
+     * Number of iterations of the parallel loops starting at id_loop, collapsed into one iteration space.
+     **/
+    int64_t parallel_size(int64_t id_loop) const;
+
+    /**
+     * Offsets in bytes of iteration it of the collapsed parallel loops for in0, in1, out and bias.
+     **/
+    void parallel_offsets(int64_t id_loop,
+                          int64_t it,
+                          int64_t (&o_offsets)[4]) const;
+
+    // split K: number of chunks, elements spanned by the output and partial outputs of all chunks but the first
+    int64_t _num_split_k = 1;
+    int64_t _size_split_k = 0;
+    std::vector<char> _split_k_buffer;
+
+    // generated loop nests without and with a bias, nullptr if the loops are executed by execute_iter
+    std::shared_ptr<mini_jit::generator::LoopNest> _loop_nest;
+    std::shared_ptr<mini_jit::generator::LoopNest> _loop_nest_bias;
+
+    /**
+     * Calls of execute_block for one block in the order they are executed.
+     *
+     * @param first_access True if first time accessing the output block.
+     * @param last_access  True if last time accessing the output block.
+     * @param bias         True if a bias is given.
+     * @param o_calls      Calls of the block.
+     * @return false if the block cannot be executed by kernel calls alone.
+     **/
+    bool get_block_calls(bool first_access,
+                         bool last_access,
+                         bool bias,
+                         std::vector<mini_jit::generator::LoopNest::call_t>& o_calls) const;
+
+    /**
+     * Generates the loop nest after the parallel loop, nullptr if the loops cannot be generated.
+     *
+     * @param bias True if a bias is given.
+     **/
+    std::shared_ptr<mini_jit::generator::LoopNest> generate_loop_nest(bool bias) const;
+
+    /**
+     * Executes the primitives on one block of the output tensor.
+     *
+     * @param ptr_in0      Pointer to the first input block.
+     * @param ptr_in1      Pointer to the second input block.
+     * @param ptr_out      Pointer to the output block.
+     * @param ptr_bias     Pointer to the bias of the block (use nullptr if no bias).
+     * @param first_access True if first time accessing the output block.
+     * @param last_access  True if last time accessing the output block.
+     **/
+    void execute_block(char const* ptr_in0,
+                       char const* ptr_in1,
+                       char* ptr_out,
+                       char const* ptr_bias,
+                       bool first_access,
+                       bool last_access);
 };
 
 #endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "TensorOperationUnary.h"
 
+#include <algorithm>
+
 namespace einsum::backend {
     TensorOperationUnary::error_t TensorOperationUnary::setup(dtype_t dtype,
                                                               prim_t prim_main,
@@ -10,6 +12,7 @@ namespace einsum::backend {
         // set primitive types and dtype
         _prim_main = prim_main;
         _dtype = dtype;
+        _element_size = (_dtype == dtype_t::fp64) ? 8 : 4;
 
         // set vectors
         _exec_types.assign(exec_types.begin(), exec_types.end());
@@ -21,10 +24,111 @@ namespace einsum::backend {
     }
 
     TensorOperationUnary::error_t TensorOperationUnary::compile() {
+        TensorOperationUnary::error_t l_err = compile_primitive();
+        if (l_err != TensorOperationUnary::error_t::success) {
+            return l_err;
+        }
+
+        // small operations stay sequential
+        int64_t l_num_elements = 1;
+        for (int64_t l_size : _dim_sizes) {
+            l_num_elements *= l_size;
+        }
+        if (l_num_elements < PARALLEL_THRESHOLD) {
+            return TensorOperationUnary::error_t::success;
+        }
+
+        // parallelize the largest loop, outer loops of a unary operation write disjoint blocks in any order
+        if (_loop_ids.size() > 0) {
+            auto l_largest = std::max_element(_loop_ids.begin(), _loop_ids.end(), [&](int64_t a, int64_t b) {
+                return _dim_sizes[a] < _dim_sizes[b];
+            });
+            if (_dim_sizes[*l_largest] > 1) {
+                std::rotate(_loop_ids.begin(), l_largest, l_largest + 1);
+                _id_parallel_loop = _loop_ids[0];
+                _exec_types[_id_parallel_loop] = exec_t::shared;
+                return TensorOperationUnary::error_t::success;
+            }
+        }
+
+        // otherwise the tiles of a transposition
+        if (_prim_main == prim_t::trans && _id_prim_n >= 0) {
+            _parallel_tiles = true;
+        }
+
+        return TensorOperationUnary::error_t::success;
+    }
+
+    TensorOperationUnary::error_t TensorOperationUnary::compile_primitive() {
         if (_prim_main == prim_t::trans) {
+            // M is the largest dimension with unit stride in the input, N the one in the output
+            _id_prim_m = -1;
+            _id_prim_n = -1;
             for (size_t i = 0; i < _exec_types.size(); i++) {
-                _loop_ids.push_back(i);
+                if (_strides_in0[i] == 1 && (_id_prim_m < 0 || _dim_sizes[i] > _dim_sizes[_id_prim_m])) {
+                    _id_prim_m = i;
+                }
+                if (_strides_out[i] == 1 && (_id_prim_n < 0 || _dim_sizes[i] > _dim_sizes[_id_prim_n])) {
+                    _id_prim_n = i;
+                }
+            }
+
+            // no contiguous dimension: element-wise copy in the loops
+            if (_id_prim_m < 0 || _id_prim_n < 0) {
+                for (size_t i = 0; i < _exec_types.size(); i++) {
+                    _loop_ids.push_back(i);
+                }
+                return TensorOperationUnary::error_t::success;
+            }
+
+            for (size_t i = 0; i < _exec_types.size(); i++) {
+                if (static_cast<int64_t>(i) != _id_prim_m && static_cast<int64_t>(i) != _id_prim_n) {
+                    _loop_ids.push_back(i);
+                } else {
+                    _exec_types[i] = exec_t::prim;
+                }
+            }
+
+            // contiguous in input and output: copy of a single column
+            if (_id_prim_m == _id_prim_n) {
+                _id_prim_n = -1;
+                _ldi = _dim_sizes[_id_prim_m];
+                _ldo = _dim_sizes[_id_prim_m];
+                _unary_kernel = mini_jit::generator::KernelCache::get_unary(_dim_sizes[_id_prim_m],
+                                                                            1,
+                                                                            static_cast<mini_jit::generator::Unary::dtype_t>(_dtype),
+                                                                            mini_jit::generator::Unary::ptype_t::identity);
+                if (_unary_kernel == nullptr) {
+                    std::cerr << "Error: Failed to generate the copy primitive." << std::endl;
+                    return TensorOperationUnary::error_t::compile_failed;
+                }
+                return TensorOperationUnary::error_t::success;
+            }
+
+            // kernels of the full tiles and of the remainders
+            int64_t l_size_m[2] = {(_dim_sizes[_id_prim_m] >= TRANS_BLOCK) ? TRANS_BLOCK : 0, _dim_sizes[_id_prim_m] % TRANS_BLOCK};
+            int64_t l_size_n[2] = {(_dim_sizes[_id_prim_n] >= TRANS_BLOCK) ? TRANS_BLOCK : 0, _dim_sizes[_id_prim_n] % TRANS_BLOCK};
+            for (int64_t l_rm = 0; l_rm < 2; l_rm++) {
+                for (int64_t l_rn = 0; l_rn < 2; l_rn++) {
+                    if (l_size_m[l_rm] == 0 || l_size_n[l_rn] == 0) {
+                        continue;
+                    }
+                    _trans_kernels[l_rm][l_rn] = mini_jit::generator::KernelCache::get_unary(l_size_m[l_rm],
+                                                                                             l_size_n[l_rn],
+                                                                                             static_cast<mini_jit::generator::Unary::dtype_t>(_dtype),
+                                                                                             mini_jit::generator::Unary::ptype_t::trans);
+                    if (_trans_kernels[l_rm][l_rn] == nullptr) {
+                        std::cerr << "Error: Failed to generate the transpose primitive." << std::endl;
+                        return TensorOperationUnary::error_t::compile_failed;
+                    }
+                }
             }
+            _unary_kernel = _trans_kernels[l_size_m[0] == 0][l_size_n[0] == 0];
+
+            // leading dimensions
+            _ldi = _strides_in0[_id_prim_n];
+            _ldo = _strides_out[_id_prim_m];
+
             return TensorOperationUnary::error_t::success;
         }
 
@@ -58,12 +162,14 @@ namespace einsum::backend {
         }
         std::cout << std::endl;
 
-        _unary.generate(_dim_sizes[_id_prim_m],
-                        _dim_sizes[_id_prim_n],
-                        static_cast<mini_jit::generator::Unary::dtype_t>(_dtype),
-                        static_cast<mini_jit::generator::Unary::ptype_t>(_prim_main));
-
-        _unary_kernel = _unary.get_kernel();
+        _unary_kernel = mini_jit::generator::KernelCache::get_unary(_dim_sizes[_id_prim_m],
+                                                                    _dim_sizes[_id_prim_n],
+                                                                    static_cast<mini_jit::generator::Unary::dtype_t>(_dtype),
+                                                                    static_cast<mini_jit::generator::Unary::ptype_t>(_prim_main));
+        if (_unary_kernel == nullptr) {
+            std::cerr << "Error: Failed to generate the unary primitive." << std::endl;
+            return TensorOperationUnary::error_t::compile_failed;
+        }
 
         // leading dimensions
         _ldi = _strides_in0[_id_prim_n];
@@ -83,7 +189,11 @@ namespace einsum::backend {
         char* l_ptr_out = static_cast<char*>(tensor_out);
 
         // execute the unary operation
-        execute_iter(0, l_ptr_in, l_ptr_out);
+        if (_id_parallel_loop >= 0) {
+            execute_iter_parallel(0, l_ptr_in, l_ptr_out);
+        } else {
+            execute_iter(0, l_ptr_in, l_ptr_out);
+        }
     }
 
     void TensorOperationUnary::execute_iter(int64_t id_loop,
@@ -100,33 +210,82 @@ namespace einsum::backend {
             char* l_ptr_out = ptr_out;
 
             if (_loop_ids.size() > 0) {
-                l_ptr_in0 += l_it * _strides_in0[_loop_ids[id_loop]] * 4;
-                l_ptr_out += l_it * _strides_out[_loop_ids[id_loop]] * 4;
+                l_ptr_in0 += l_it * _strides_in0[_loop_ids[id_loop]] * _element_size;
+                l_ptr_out += l_it * _strides_out[_loop_ids[id_loop]] * _element_size;
+            }
+
+            if ((_loop_ids.size() > 0) && (id_loop < static_cast<int64_t>(_loop_ids.size()) - 1)) {
+                // recursive function call
+                execute_iter(id_loop + 1,
+                             l_ptr_in0,
+                             l_ptr_out);
+            } else if (_unary_kernel == nullptr) {
+                // permutation without contiguous dimensions
+                std::copy_n(l_ptr_in0, _element_size, l_ptr_out);
+            } else if (_prim_main == prim_t::trans && _id_prim_n >= 0) {
+                execute_trans_tiles(l_ptr_in0, l_ptr_out);
+            } else {
+                // call main kernel
+                _unary_kernel(l_ptr_in0, l_ptr_out, _ldi, _ldo);
             }
+        }
+    }
 
-            if (_prim_main == prim_t::trans) {
-                if ((_loop_ids.size() > 0) && (id_loop < _loop_ids.size() - 1)) {
-                    // recursive function call
-                    execute_iter(id_loop + 1,
-                                 l_ptr_in0,
-                                 l_ptr_out);
+    void TensorOperationUnary::execute_iter_parallel(int64_t id_loop,
+                                                     const char* ptr_in,
+                                                     char* ptr_out) {
+        int64_t l_size = _dim_sizes[_loop_ids[id_loop]];
 
-                } else {
-                    float* input_pointer = reinterpret_cast<float*>(const_cast<char*>(l_ptr_in0));
-                    float* output_pointer = reinterpret_cast<float*>(l_ptr_out);
-                    output_pointer[0] = input_pointer[0];
-                }
+        thread_pool().parallel_for(l_size, [&](int64_t l_it) {
+            // update pointer with strides
+            char const* l_ptr_in0 = ptr_in + l_it * _strides_in0[_loop_ids[id_loop]] * _element_size;
+            char* l_ptr_out = ptr_out + l_it * _strides_out[_loop_ids[id_loop]] * _element_size;
+
+            if (id_loop < static_cast<int64_t>(_loop_ids.size()) - 1) {
+                // recursive function call (sequential from here)
+                execute_iter(id_loop + 1,
+                             l_ptr_in0,
+                             l_ptr_out);
+            } else if (_unary_kernel == nullptr) {
+                // permutation without contiguous dimensions
+                std::copy_n(l_ptr_in0, _element_size, l_ptr_out);
+            } else if (_prim_main == prim_t::trans && _id_prim_n >= 0) {
+                execute_trans_tiles(l_ptr_in0, l_ptr_out);
             } else {
-                if ((_loop_ids.size() > 0) && (id_loop < _loop_ids.size() - 1)) {
-                    // recursive function call
-                    execute_iter(id_loop + 1,
-                                 l_ptr_in0,
-                                 l_ptr_out);
-                } else {
-                    // call main kernel
-                    _unary_kernel(l_ptr_in0, l_ptr_out, _ldi, _ldo);
-                }
+                // call main kernel
+                _unary_kernel(l_ptr_in0, l_ptr_out, _ldi, _ldo);
+            }
+        });
+    }
+
+    void TensorOperationUnary::execute_trans_tiles(char const* ptr_in0,
+                                                   char* ptr_out) {
+        int64_t l_size_m = _dim_sizes[_id_prim_m];
+        int64_t l_size_n = _dim_sizes[_id_prim_n];
+
+        // tiles are enumerated column-major, the tiles of one column of the input are adjacent
+        int64_t l_tiles_m = (l_size_m + TRANS_BLOCK - 1) / TRANS_BLOCK;
+        int64_t l_tiles_n = (l_size_n + TRANS_BLOCK - 1) / TRANS_BLOCK;
+        auto l_tile = [&](int64_t l_ti) {
+            int64_t l_m = (l_ti % l_tiles_m) * TRANS_BLOCK;
+            int64_t l_n = (l_ti / l_tiles_m) * TRANS_BLOCK;
+            kernel_t l_kernel = _trans_kernels[l_size_m - l_m < TRANS_BLOCK][l_size_n - l_n < TRANS_BLOCK];
+            l_kernel(ptr_in0 + (l_m + l_n * _ldi) * _element_size,
+                     ptr_out + (l_m * _ldo + l_n) * _element_size,
+                     _ldi,
+                     _ldo);
+        };
+
+        if (_parallel_tiles) {
+            thread_pool().parallel_for(l_tiles_m * l_tiles_n, l_tile);
+        } else {
+            for (int64_t l_ti = 0; l_ti < l_tiles_m * l_tiles_n; l_ti++) {
+                l_tile(l_ti);
             }
         }
     }
+
+    ThreadPool& TensorOperationUnary::thread_pool() const {
+        return (_thread_pool != nullptr) ? *_thread_pool : *ThreadPool::global();
+    }
 }  // namespace einsum::backend
@@ -1,15 +1,16 @@
 #ifndef EINSUM_BACKEND_TENSOR_OPERATION_UNARY_H
 #define EINSUM_BACKEND_TENSOR_OPERATION_UNARY_H
 
-#include <omp.h>
-
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <span>
 #include <vector>
 
+#include "../../mini_jit/generator/KernelCache.h"
 #include "../../mini_jit/generator/Unary.h"
 #include "../../tensor/tensor.h"
+#include "ThreadPool.h"
 
 namespace einsum {
     namespace backend {
@@ -51,7 +52,8 @@ class einsum::backend::TensorOperationUnary {
     };
     /* Setup values */
     dtype_t _dtype;
-    prim_t _prim_main;  // main primitive
+    int64_t _element_size;  // bytes per tensor element
+    prim_t _prim_main;      // main primitive
 
     std::vector<exec_t> _exec_types;
     std::vector<int64_t> _dim_sizes;
@@ -64,10 +66,19 @@ class einsum::backend::TensorOperationUnary {
     int64_t _id_prim_n;
     int64_t _id_parallel_loop = -1;
 
+    //! size of the transpose tiles in both primitive dimensions
+    static constexpr int64_t TRANS_BLOCK = 64;
+
+    //! number of elements from which on an operation is executed in parallel
+    static constexpr int64_t PARALLEL_THRESHOLD = 1 << 16;
+
     /* Runtime Values */
     int64_t _ldi;
     int64_t _ldo;
 
+    /* threads executing the shared loops, the global pool if nullptr */
+    std::shared_ptr<ThreadPool> _thread_pool;
+
     using kernel_t = mini_jit::generator::Unary::kernel_t;
 
     error_t setup(dtype_t dtype,
@@ -143,25 +154,44 @@ class einsum::backend::TensorOperationUnary {
                       char* ptr_out);
 
     /**
-     * @brief Executes the the first loop if it is M or N dimension in parallel
+     * @brief Executes the first loop in parallel, the inner loops sequentially.
      *
+     * @param id_loop      Dimension id of the loop which is executed.
      * @param ptr_in0      Pointer to the first input tensor's data.
-     * @param ptr_in1      Pointer to the second input tensor's data (use nullptr if unary).
      * @param ptr_out      Pointer to the output tensor's data.
-     * @param first_access True if first time accessing data of output tensor.
-     * @param last_access  True if last time accessing data of output tensor.
      **/
     void execute_iter_parallel(int64_t id_loop,
                                char const* ptr_in0,
-                               char const* ptr_in1,
-                               char* ptr_out,
-                               bool first_access,
-                               bool last_access);
+                               char* ptr_out);
 
    private:
-    // BRGEMM
-    mini_jit::generator::Unary _unary;
+    /**
+     * Pool executing the shared loops.
+     **/
+    ThreadPool& thread_pool() const;
+
+    /**
+     * Identifies the primitive dimensions and loops and gets the kernels.
+     **/
+    error_t compile_primitive();
+
+    /**
+     * Calls the transpose kernels on all tiles of the two primitive dimensions.
+     *
+     * @param ptr_in0 Pointer to the first element of the input block.
+     * @param ptr_out Pointer to the first element of the output block.
+     **/
+    void execute_trans_tiles(char const* ptr_in0,
+                             char* ptr_out);
+
+    // Unary, kernel is owned by mini_jit::generator::KernelCache
     kernel_t _unary_kernel{nullptr};
+
+    // transpose kernels of the tiles, indexed by [remainder in M][remainder in N]
+    kernel_t _trans_kernels[2][2] = {{nullptr, nullptr}, {nullptr, nullptr}};
+
+    // true if the tiles of a transposition without outer loops are executed in parallel
+    bool _parallel_tiles = false;
 };
 
 #endif
\ No newline at end of file
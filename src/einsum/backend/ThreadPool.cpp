@@ -0,0 +1,210 @@
+#include "ThreadPool.h"
+
+#include <omp.h>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace einsum::backend {
+    ThreadPool::ThreadPool(int64_t num_threads,
+                           std::vector<int32_t> const& cpus) {
+        _num_threads = (num_threads > 0) ? num_threads : omp_get_max_threads();
+        _cpus = cpus;
+
+        // ranges of the outermost loop, nested loops add theirs on first use
+        _jobs.reserve(8);
+        _free_ranges.reserve(8);
+        _free_ranges.push_back(std::make_unique<range_t[]>(_num_threads));
+
+        // the calling thread is the first thread of every parallel loop
+        for (int64_t l_id = 0; l_id < _num_threads - 1; l_id++) {
+            _workers.emplace_back(&ThreadPool::work, this, l_id);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> l_lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+        for (std::thread& l_worker : _workers) {
+            l_worker.join();
+        }
+    }
+
+    std::shared_ptr<ThreadPool> ThreadPool::global() {
+        static std::shared_ptr<ThreadPool> l_pool = std::make_shared<ThreadPool>();
+        return l_pool;
+    }
+
+    void ThreadPool::work(int64_t id) {
+#if defined(__linux__)
+        if (!_cpus.empty()) {
+            cpu_set_t l_set;
+            CPU_ZERO(&l_set);
+            CPU_SET(_cpus[id % _cpus.size()], &l_set);
+            pthread_setaffinity_np(pthread_self(), sizeof(l_set), &l_set);
+        }
+#endif
+
+        std::unique_lock<std::mutex> l_lock(_mutex);
+        while (true) {
+            // join the newest job with work left, nested loops are finished first
+            job_t* l_job = nullptr;
+            _cv.wait(l_lock, [&] {
+                for (auto l_it = _jobs.rbegin(); l_it != _jobs.rend(); l_it++) {
+                    if (!(*l_it)->exhausted.load(std::memory_order_acquire)) {
+                        l_job = *l_it;
+                        return true;
+                    }
+                }
+                return _stop;
+            });
+            if (l_job == nullptr) {
+                return;
+            }
+
+            // the job stays alive until all threads left it
+            l_job->active.fetch_add(1, std::memory_order_acq_rel);
+            l_lock.unlock();
+
+            int64_t l_range = l_job->next_range.fetch_add(1, std::memory_order_relaxed);
+            participate(*l_job, (l_range < l_job->num_ranges) ? l_range : -1);
+
+            l_job->active.fetch_sub(1, std::memory_order_acq_rel);
+            l_lock.lock();
+        }
+    }
+
+    void ThreadPool::participate(job_t& job,
+                                 int64_t range) {
+        int64_t l_begin = 0;
+        int64_t l_end = 0;
+        while (pop(job, range, l_begin, l_end) || steal(job, range, l_begin, l_end)) {
+            job.func(job.ctx, l_begin, l_end);
+            job.remaining.fetch_sub(l_end - l_begin, std::memory_order_acq_rel);
+        }
+        job.exhausted.store(true, std::memory_order_release);
+    }
+
+    bool ThreadPool::pop(job_t& job,
+                         int64_t range,
+                         int64_t& o_begin,
+                         int64_t& o_end) {
+        if (range < 0) {
+            return false;
+        }
+
+        range_t& l_range = job.ranges[range];
+        std::lock_guard<std::mutex> l_lock(l_range.lock);
+        if (l_range.begin == l_range.end) {
+            return false;
+        }
+        o_begin = l_range.begin;
+        o_end = std::min(l_range.begin + job.grain, l_range.end);
+        l_range.begin = o_end;
+
+        return true;
+    }
+
+    bool ThreadPool::steal(job_t& job,
+                           int64_t range,
+                           int64_t& o_begin,
+                           int64_t& o_end) {
+        for (int64_t l_offset = (range < 0) ? 0 : 1; l_offset < job.num_ranges; l_offset++) {
+            range_t& l_victim = job.ranges[(std::max<int64_t>(range, 0) + l_offset) % job.num_ranges];
+            std::unique_lock<std::mutex> l_lock(l_victim.lock);
+            int64_t l_left = l_victim.end - l_victim.begin;
+            if (l_left == 0) {
+                continue;
+            }
+
+            if (range < 0 || l_left <= job.grain) {
+                // threads without a range take single chunks
+                o_end = l_victim.end;
+                o_begin = std::max(l_victim.begin, l_victim.end - job.grain);
+                l_victim.end = o_begin;
+                return true;
+            }
+
+            // the second half of the victim's iterations becomes the own range
+            int64_t l_begin = l_victim.begin + l_left / 2;
+            int64_t l_end = l_victim.end;
+            l_victim.end = l_begin;
+            l_lock.unlock();
+            {
+                std::lock_guard<std::mutex> l_own_lock(job.ranges[range].lock);
+                job.ranges[range].begin = l_begin;
+                job.ranges[range].end = l_end;
+            }
+            if (pop(job, range, o_begin, o_end)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::run(int64_t size,
+                         void (*func)(void* ctx, int64_t begin, int64_t end),
+                         void* ctx) {
+        if (size <= 0) {
+            return;
+        }
+        if (_workers.empty() || size == 1) {
+            func(ctx, 0, size);
+            return;
+        }
+
+        // one range per thread, taken in chunks which keep the stealing cheap
+        job_t l_job;
+        l_job.func = func;
+        l_job.ctx = ctx;
+        l_job.num_ranges = std::min(_num_threads, size);
+        l_job.grain = std::max<int64_t>(1, size / (8 * l_job.num_ranges));
+        l_job.remaining.store(size, std::memory_order_relaxed);
+        l_job.next_range.store(1, std::memory_order_relaxed);
+
+        // the ranges are reused across loops, new ones are only allocated for deeper nesting
+        std::unique_ptr<range_t[]> l_ranges;
+        {
+            std::lock_guard<std::mutex> l_lock(_mutex);
+            if (_free_ranges.empty()) {
+                l_ranges = std::make_unique<range_t[]>(_num_threads);
+            } else {
+                l_ranges = std::move(_free_ranges.back());
+                _free_ranges.pop_back();
+            }
+
+            l_job.ranges = l_ranges.get();
+            for (int64_t l_ra = 0; l_ra < l_job.num_ranges; l_ra++) {
+                l_job.ranges[l_ra].begin = l_ra * size / l_job.num_ranges;
+                l_job.ranges[l_ra].end = (l_ra + 1) * size / l_job.num_ranges;
+            }
+            _jobs.push_back(&l_job);
+        }
+        _cv.notify_all();
+
+        // the calling thread owns the first range
+        participate(l_job, 0);
+
+        // no thread joins after the job is unpublished, the others finish their iterations
+        {
+            std::lock_guard<std::mutex> l_lock(_mutex);
+            _jobs.erase(std::find(_jobs.begin(), _jobs.end(), &l_job));
+        }
+        while (l_job.remaining.load(std::memory_order_acquire) > 0 || l_job.active.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+
+        {
+            std::lock_guard<std::mutex> l_lock(_mutex);
+            _free_ranges.push_back(std::move(l_ranges));
+        }
+    }
+}  // namespace einsum::backend
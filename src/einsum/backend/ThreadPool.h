@@ -0,0 +1,159 @@
+#ifndef EINSUM_BACKEND_THREAD_POOL_H
+#define EINSUM_BACKEND_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace einsum {
+    namespace backend {
+        class ThreadPool;
+    }
+}  // namespace einsum
+
+/**
+ * Persistent pool of worker threads executing the parallel loops of the tensor operations.
+ *
+ * The calling thread takes part in every parallel loop, the workers join the newest loop with remaining work.
+ * The iterations of a loop are split into one range per thread, threads which run out of work steal half of
+ * the remaining iterations of another range. Parallel loops started inside of a parallel loop share the workers,
+ * the thread which started a loop always finishes it, even if all workers are busy.
+ **/
+class einsum::backend::ThreadPool {
+   private:
+    /// iterations of one thread, protected by its lock
+    struct alignas(64) range_t {
+        std::mutex lock;
+        int64_t begin = 0;
+        int64_t end = 0;
+    };
+
+    /// parallel loop
+    struct job_t {
+        void (*func)(void* ctx, int64_t begin, int64_t end) = nullptr;
+        void* ctx = nullptr;
+        int64_t grain = 1;
+        int64_t num_ranges = 0;
+        range_t* ranges = nullptr;
+        //! next unclaimed range
+        std::atomic<int64_t> next_range = 0;
+        //! iterations which are not finished
+        std::atomic<int64_t> remaining = 0;
+        //! threads working on the job
+        std::atomic<int64_t> active = 0;
+        //! set once a thread found no iterations left
+        std::atomic<bool> exhausted = false;
+    };
+
+    int64_t _num_threads = 1;
+    std::vector<int32_t> _cpus;
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    //! published jobs, the newest one is last
+    std::vector<job_t*> _jobs;
+    //! unused ranges of _num_threads threads, one per running loop is taken
+    std::vector<std::unique_ptr<range_t[]>> _free_ranges;
+    bool _stop = false;
+
+    /**
+     * Main loop of the worker with the given id.
+     **/
+    void work(int64_t id);
+
+    /**
+     * Executes iterations of the job until none are left.
+     *
+     * @param job   Parallel loop.
+     * @param range Range owned by the thread, -1 if it only steals.
+     **/
+    static void participate(job_t& job,
+                            int64_t range);
+
+    /**
+     * Takes the next iterations of a range.
+     **/
+    static bool pop(job_t& job,
+                    int64_t range,
+                    int64_t& o_begin,
+                    int64_t& o_end);
+
+    /**
+     * Takes iterations from the end of another range.
+     **/
+    static bool steal(job_t& job,
+                      int64_t range,
+                      int64_t& o_begin,
+                      int64_t& o_end);
+
+    /**
+     * Executes func(ctx, begin, end) on subranges of [0, size) in parallel.
+     **/
+    void run(int64_t size,
+             void (*func)(void* ctx, int64_t begin, int64_t end),
+             void* ctx);
+
+   public:
+    /**
+     * Starts the workers of the pool.
+     *
+     * @param num_threads Number of threads executing a parallel loop including the calling thread,
+     *                    omp_get_max_threads() if 0.
+     * @param cpus        CPUs the workers are pinned to round-robin, not pinned if empty.
+     **/
+    explicit ThreadPool(int64_t num_threads = 0,
+                        std::vector<int32_t> const& cpus = {});
+
+    /**
+     * Stops and joins the workers.
+     **/
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    /**
+     * Pool used by the operations which are not given one, sized by omp_get_max_threads() on first use.
+     **/
+    static std::shared_ptr<ThreadPool> global();
+
+    /**
+     * Number of threads executing a parallel loop including the calling thread.
+     **/
+    int64_t num_threads() const {
+        return _num_threads;
+    }
+
+    /**
+     * CPUs the workers are pinned to, empty if they are not pinned.
+     **/
+    std::vector<int32_t> const& cpus() const {
+        return _cpus;
+    }
+
+    /**
+     * Executes func(it) for all it in [0, size) and returns once all iterations are finished.
+     *
+     * @param size Number of iterations.
+     * @param func Body of the loop, called concurrently for different iterations.
+     **/
+    template <typename F>
+    void parallel_for(int64_t size,
+                      F&& func) {
+        auto l_body = [](void* ctx, int64_t begin, int64_t end) {
+            auto& l_func = *static_cast<std::remove_reference_t<F>*>(ctx);
+            for (int64_t l_it = begin; l_it < end; l_it++) {
+                l_func(l_it);
+            }
+        };
+        run(size, l_body, const_cast<void*>(static_cast<void const*>(&func)));
+    }
+};
+
+#endif
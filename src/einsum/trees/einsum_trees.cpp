@@ -1,19 +1,208 @@
 #include "./einsum_trees.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <unordered_set>
 #include <vector>
 
+#include "../../mini_jit/generator/KernelCache.h"
 #include "../../tensor/tensor.h"
 
 using namespace einsum::trees;
 using namespace einsum::backend;
 
-EinsumTree::EinsumTree(std::string str_repr, std::vector<uint32_t> id_dims, bool use_bias) {
+namespace {
+    // path of a contraction network: pairs of slots, operands are the first slots, each step appends its result
+    struct path_plan_t {
+        std::vector<std::pair<int32_t, int32_t>> steps;
+        double flops = 0;
+        double size = 0;  // floats of all intermediates
+        bool valid = false;
+    };
+
+    // bit mask of the dimension ids of a notation
+    uint64_t dim_mask(std::vector<uint32_t> const& notation) {
+        uint64_t mask = 0;
+        for (uint32_t dim : notation) {
+            mask |= uint64_t(1) << dim;
+        }
+        return mask;
+    }
+
+    // number of elements of a tensor with the dimensions of a mask
+    double mask_size(uint64_t mask, std::vector<uint32_t> const& id_dims) {
+        double size = 1;
+        for (uint32_t dim = 0; dim < id_dims.size(); dim++) {
+            if (mask & (uint64_t(1) << dim)) {
+                size *= id_dims[dim];
+            }
+        }
+        return size;
+    }
+
+    // true if the backend supports the contraction: M, N and K dimensions, no batch dimensions,
+    // every dimension which is not kept is a contraction dimension
+    bool valid_contraction(uint64_t left, uint64_t right, uint64_t out) {
+        uint64_t shared = left & right;
+        uint64_t removed = (left | right) & ~out;
+        return (left & out) != 0 && (right & out) != 0 && (shared & out) == 0 &&
+               removed != 0 && (removed & ~shared) == 0;
+    }
+
+    // cheaper in FLOPs, memory of the intermediates breaks ties
+    bool cheaper(double flops, double size, double other_flops, double other_size) {
+        return flops < other_flops || (flops == other_flops && size < other_size);
+    }
+
+    path_plan_t greedy_path(std::vector<uint64_t> const& operands, uint64_t out, std::vector<uint32_t> const& id_dims) {
+        path_plan_t plan;
+        std::vector<uint64_t> slots = operands;
+        std::vector<bool> active(slots.size(), true);
+
+        for (size_t remaining = operands.size(); remaining > 1; remaining--) {
+            int32_t best_i = -1;
+            int32_t best_j = -1;
+            uint64_t best_result = 0;
+            double best_removed = 0;
+            double best_flops = 0;
+
+            for (size_t i = 0; i < slots.size(); i++) {
+                for (size_t j = i + 1; j < slots.size() && active[i]; j++) {
+                    if (!active[j]) {
+                        continue;
+                    }
+                    // dimensions needed by the output or another operand are kept
+                    uint64_t keep = out;
+                    for (size_t l = 0; l < slots.size(); l++) {
+                        if (active[l] && l != i && l != j) {
+                            keep |= slots[l];
+                        }
+                    }
+                    uint64_t result = (slots[i] | slots[j]) & keep;
+                    if (!valid_contraction(slots[i], slots[j], result)) {
+                        continue;
+                    }
+
+                    // memory freed by the contraction as in opt_einsum, FLOPs break ties
+                    double removed = mask_size(result, id_dims) - mask_size(slots[i], id_dims) - mask_size(slots[j], id_dims);
+                    double flops = 2 * mask_size(slots[i] | slots[j], id_dims);
+                    if (best_i < 0 || cheaper(removed, flops, best_removed, best_flops)) {
+                        best_i = i;
+                        best_j = j;
+                        best_result = result;
+                        best_removed = removed;
+                        best_flops = flops;
+                    }
+                }
+            }
+            if (best_i < 0) {
+                return plan;
+            }
+
+            plan.steps.push_back({best_i, best_j});
+            plan.flops += best_flops;
+            if (remaining > 2) {
+                plan.size += mask_size(best_result, id_dims);
+            }
+            active[best_i] = false;
+            active[best_j] = false;
+            slots.push_back(best_result);
+            active.push_back(true);
+        }
+
+        plan.valid = true;
+        return plan;
+    }
+
+    path_plan_t dp_path(std::vector<uint64_t> const& operands, uint64_t out, std::vector<uint32_t> const& id_dims) {
+        size_t num_operands = operands.size();
+        uint32_t full = (uint32_t(1) << num_operands) - 1;
+        double inf = std::numeric_limits<double>::infinity();
+
+        // dimensions of the contracted result of each subset of the operands
+        std::vector<uint64_t> all_dims(full + 1, 0);
+        for (uint32_t set = 1; set <= full; set++) {
+            all_dims[set] = all_dims[set & (set - 1)] | operands[__builtin_ctz(set)];
+        }
+        auto result = [&](uint32_t set) {
+            return all_dims[set] & (out | all_dims[full & ~set]);
+        };
+
+        std::vector<double> flops(full + 1, inf);
+        std::vector<double> size(full + 1, inf);
+        std::vector<uint32_t> split(full + 1, 0);
+        for (size_t i = 0; i < num_operands; i++) {
+            flops[uint32_t(1) << i] = 0;
+            size[uint32_t(1) << i] = 0;
+        }
+
+        for (uint32_t set = 1; set <= full; set++) {
+            if ((set & (set - 1)) == 0) {
+                continue;
+            }
+            uint64_t set_result = result(set);
+            double set_size = (set == full) ? 0 : mask_size(set_result, id_dims);
+            uint32_t lowest = set & (~set + 1);
+
+            // every split once: the left part holds the lowest operand
+            for (uint32_t left = (set - 1) & set; left > 0; left = (left - 1) & set) {
+                uint32_t right = set ^ left;
+                if (!(left & lowest) || flops[left] == inf || flops[right] == inf) {
+                    continue;
+                }
+                uint64_t left_result = result(left);
+                uint64_t right_result = result(right);
+                if (!valid_contraction(left_result, right_result, set_result)) {
+                    continue;
+                }
+
+                double split_flops = flops[left] + flops[right] + 2 * mask_size(left_result | right_result, id_dims);
+                double split_size = size[left] + size[right] + set_size;
+                if (cheaper(split_flops, split_size, flops[set], size[set])) {
+                    flops[set] = split_flops;
+                    size[set] = split_size;
+                    split[set] = left;
+                }
+            }
+        }
+
+        path_plan_t plan;
+        if (flops[full] == inf) {
+            return plan;
+        }
+
+        // steps in post-order of the splits
+        std::function<int32_t(uint32_t)> build = [&](uint32_t set) -> int32_t {
+            if ((set & (set - 1)) == 0) {
+                return __builtin_ctz(set);
+            }
+            int32_t left = build(split[set]);
+            int32_t right = build(set ^ split[set]);
+            plan.steps.push_back({left, right});
+            return num_operands + plan.steps.size() - 1;
+        };
+        build(full);
+
+        plan.flops = flops[full];
+        plan.size = size[full];
+        plan.valid = true;
+        return plan;
+    }
+}  // namespace
+
+EinsumTree::EinsumTree(std::string str_repr,
+                       std::vector<uint32_t> id_dims,
+                       bool use_bias,
+                       TensorOperation::dtype_t dtype) {
     // set class attribures
     this->id_dims = id_dims;
     this->use_bias = use_bias;  // flag for using biases
+    this->dtype = dtype;
+    this->element_size = (dtype == TensorOperation::dtype_t::fp64) ? 8 : 4;
 
     /*
         Stack shows the state of parsing.
@@ -153,17 +342,27 @@ EinsumTree::EinsumTree(std::string str_repr, std::vector<uint32_t> id_dims, bool
                 }
             }
         } else if (character >= 'a' && character <= 'z') {
+            // r: relu, z: zero, g: gelu, s: sigmoid, t: tanh, l: silu
+            TensorOperation::prim_t prim = TensorOperation::prim_t::none;
             if (character == 'r') {
-                if (stack.back() == 'w') {
-                    current->first_touch = TensorOperation::prim_t::relu;
-                } else {
-                    current->last_touch = TensorOperation::prim_t::relu;
-                }
+                prim = TensorOperation::prim_t::relu;
             } else if (character == 'z') {
+                prim = TensorOperation::prim_t::zero;
+            } else if (character == 'g') {
+                prim = TensorOperation::prim_t::gelu;
+            } else if (character == 's') {
+                prim = TensorOperation::prim_t::sigmoid;
+            } else if (character == 't') {
+                prim = TensorOperation::prim_t::tanh;
+            } else if (character == 'l') {
+                prim = TensorOperation::prim_t::silu;
+            }
+
+            if (prim != TensorOperation::prim_t::none) {
                 if (stack.back() == 'w') {
-                    current->first_touch = TensorOperation::prim_t::zero;
+                    current->first_touch = prim;
                 } else {
-                    current->last_touch = TensorOperation::prim_t::zero;
+                    current->last_touch = prim;
                 }
             }
         }
@@ -269,6 +468,127 @@ void EinsumTree::optimize() {
     identify();
 }
 
+void EinsumTree::optimize_path(path_t path) {
+    if (this->root == nullptr) {
+        std::cerr << "Einsum tree is empty, cannot optimize." << std::endl;
+        return;
+    }
+
+    optimizePathNode(this->root, path);
+    identify();
+}
+
+void EinsumTree::collectOperands(TreeNode* node, std::vector<TreeNode*>& operands, std::vector<TreeNode*>& internal) {
+    if (node->node_type == node_t::contraction && !this->use_bias &&
+        node->first_touch == TensorOperation::prim_t::none && node->last_touch == TensorOperation::prim_t::none) {
+        internal.push_back(node);
+        collectOperands(node->left_child, operands, internal);
+        collectOperands(node->right_child, operands, internal);
+    } else {
+        operands.push_back(node);
+    }
+}
+
+void EinsumTree::optimizePathNode(TreeNode* node, path_t path) {
+    if (node == nullptr || node->node_type == node_t::leaf) {
+        return;
+    }
+    if (node->node_type == node_t::permutation) {
+        optimizePathNode(node->left_child, path);
+        return;
+    }
+
+    // operands of the network with the node as root
+    std::vector<TreeNode*> operands;
+    std::vector<TreeNode*> internal;
+    collectOperands(node->left_child, operands, internal);
+    collectOperands(node->right_child, operands, internal);
+    for (TreeNode* operand : operands) {
+        optimizePathNode(operand, path);
+    }
+    if (operands.size() < 3 || operands.size() > 64) {
+        return;
+    }
+
+    // cost of the given path
+    double flops = 2 * mask_size(dim_mask(node->left_child->notation) | dim_mask(node->right_child->notation), this->id_dims);
+    double size = 0;
+    for (TreeNode* contraction : internal) {
+        flops += 2 * mask_size(dim_mask(contraction->left_child->notation) | dim_mask(contraction->right_child->notation), this->id_dims);
+        size += mask_size(dim_mask(contraction->notation), this->id_dims);
+    }
+
+    std::vector<uint64_t> masks;
+    for (TreeNode* operand : operands) {
+        masks.push_back(dim_mask(operand->notation));
+    }
+    uint64_t out = dim_mask(node->notation);
+
+    path_plan_t plan;
+    if (path == path_t::dp && operands.size() <= 16) {
+        plan = dp_path(masks, out, this->id_dims);
+    } else {
+        plan = greedy_path(masks, out, this->id_dims);
+    }
+    if (!plan.valid || !cheaper(plan.flops, plan.size, flops, size)) {
+        return;
+    }
+
+    // rebuild the network, the node stays the root
+    std::vector<TreeNode*> slots = operands;
+    for (size_t step = 0; step < plan.steps.size(); step++) {
+        TreeNode* left = slots[plan.steps[step].first];
+        TreeNode* right = slots[plan.steps[step].second];
+        TreeNode* parent = node;
+
+        if (step + 1 < plan.steps.size()) {
+            // without batch dimensions the shared dimensions are contracted, N dimensions are outside of M
+            uint64_t kept = dim_mask(left->notation) ^ dim_mask(right->notation);
+            std::vector<uint32_t> notation;
+            for (uint32_t dim : right->notation) {
+                if (kept & (uint64_t(1) << dim)) {
+                    notation.push_back(dim);
+                }
+            }
+            for (uint32_t dim : left->notation) {
+                if (kept & (uint64_t(1) << dim)) {
+                    notation.push_back(dim);
+                }
+            }
+
+            parent = new TreeNode{
+                static_cast<int32_t>(this->size),  // id
+                EinsumTree::node_t::contraction,   // node_type
+                nullptr,                           // parent
+                nullptr,                           // left_child
+                nullptr,                           // right_child
+                notation,                          // notation
+                nullptr,                           // left_tensor
+                nullptr,                           // right_tensor
+                nullptr,                           // out_tensor
+                TensorOperation::prim_t::none,     // first touch
+                TensorOperation::prim_t::gemm,     // operation primitive
+                TensorOperation::prim_t::none,     // last touch
+                TensorOperation(),                 // op
+            };
+            this->size++;
+        } else if (!(dim_mask(left->notation) & (uint64_t(1) << node->notation.back()))) {
+            // the innermost output dimension is an M dimension
+            std::swap(left, right);
+        }
+
+        parent->left_child = left;
+        parent->right_child = right;
+        left->parent = parent;
+        right->parent = parent;
+        slots.push_back(parent);
+    }
+
+    for (TreeNode* contraction : internal) {
+        delete contraction;
+    }
+}
+
 double EinsumTree::getScore(TreeNode* node, TensorOperation::dim_t dim_type, bool swap) {
     TensorOperation::dim_t left_dim_type, right_dim_type;
     if (swap) {
@@ -334,11 +654,35 @@ void EinsumTree::optimizeNode(TreeNode* node) {
             return;
         }
 
-        // Check if the left and right children have to be swapped
-        double current_score = getScore(node, TensorOperation::dim_t::m, false);
-        double swap_score = getScore(node, TensorOperation::dim_t::n, true);
-        if (swap_score < current_score) {
+        // Check if the left and right children have to be swapped, the innermost output dimension has to be an M dimension
+        int out_inner = node->out_tensor->id.back().dim_t;
+        if (out_inner == static_cast<int>(TensorOperation::dim_t::n)) {
             swap(node);
+        } else if (out_inner != static_cast<int>(TensorOperation::dim_t::m)) {
+            double current_score = getScore(node, TensorOperation::dim_t::m, false);
+            double swap_score = getScore(node, TensorOperation::dim_t::n, true);
+            if (swap_score < current_score) {
+                swap(node);
+            }
+        }
+
+        // single precision contractions read inputs with all M dimensions outside of K (left) or all K dimensions outside
+        // of N (right) through transposed BRGEMMs if their layout cannot be folded, the innermost K dimension of the left
+        // input is the primitive K dimension and has to be the innermost K dimension of the right input as well
+        bool trans_left = false;
+        bool trans_right = false;
+        if (this->dtype == TensorOperation::dtype_t::fp32) {
+            trans_left = isRowMajor(node->left_tensor, TensorOperation::dim_t::m, TensorOperation::dim_t::k);
+            trans_right = isRowMajor(node->right_tensor, TensorOperation::dim_t::k, TensorOperation::dim_t::n);
+            if (trans_left) {
+                uint32_t inner_k_right = node->left_child->notation.back() + 1;
+                for (size_t i = 0; i < node->right_tensor->id.size(); i++) {
+                    if (node->right_tensor->id[i].dim_t == static_cast<int>(TensorOperation::dim_t::k)) {
+                        inner_k_right = node->right_child->notation[i];
+                    }
+                }
+                trans_left = (inner_k_right == node->left_child->notation.back());
+            }
         }
 
         // Insert left permutation node if necessary
@@ -362,7 +706,7 @@ void EinsumTree::optimizeNode(TreeNode* node) {
         size_t k_dim_size = k_dim.size();
         k_dim.insert(k_dim.end(), m_dim.begin(), m_dim.end());
         std::vector<uint32_t> new_notation = k_dim;
-        if (add_left_permutation) {
+        if (add_left_permutation && !foldLayout(node->left_child, new_notation) && !trans_left) {
             std::vector<uint32_t> out_dims;
             for (uint32_t dim_id : new_notation) {
                 out_dims.push_back(this->id_dims[dim_id]);
@@ -418,7 +762,7 @@ void EinsumTree::optimizeNode(TreeNode* node) {
         size_t n_dim_size = n_dim.size();
         n_dim.insert(n_dim.end(), k_dim.begin(), k_dim.end());
         new_notation = n_dim;
-        if (add_right_permutation) {
+        if (add_right_permutation && !foldLayout(node->right_child, new_notation) && !trans_right) {
             std::vector<uint32_t> out_dims;
             for (uint32_t dim_id : new_notation) {
                 out_dims.push_back(this->id_dims[dim_id]);
@@ -459,6 +803,51 @@ void EinsumTree::optimizeNode(TreeNode* node) {
     }
 }
 
+bool EinsumTree::isRowMajor(Tensor const* tensor, TensorOperation::dim_t outer, TensorOperation::dim_t inner) {
+    bool has_outer = false;
+    bool has_inner = false;
+    for (size_t i = 0; i < tensor->id.size(); i++) {
+        if (tensor->id[i].dim_t == static_cast<int>(outer)) {
+            if (has_inner) {
+                return false;
+            }
+            has_outer = true;
+        } else if (tensor->id[i].dim_t == static_cast<int>(inner)) {
+            has_inner = true;
+        }
+    }
+    return has_outer && has_inner && tensor->id.back().dim_t == static_cast<int>(inner);
+}
+
+bool EinsumTree::foldLayout(TreeNode* node, std::vector<uint32_t> const& notation) {
+    if (node->node_type == node_t::contraction && !this->use_bias) {
+        // the contraction writes its output in the layout of the consumer
+        node->notation = notation;
+        identifyNode(node);
+        return true;
+    } else if (node->node_type == node_t::permutation) {
+        node->notation = notation;
+        if (node->notation != node->left_child->notation) {
+            identifyNode(node);
+            return true;
+        }
+
+        // the permutation became the identity
+        TreeNode* parent = node->parent;
+        TreeNode* child = node->left_child;
+        if (parent->left_child == node) {
+            parent->left_child = child;
+        } else {
+            parent->right_child = child;
+        }
+        child->parent = parent;
+        delete node;
+        return true;
+    }
+
+    return false;
+}
+
 void EinsumTree::identify() {
     identifyNode(this->root);
 }
@@ -516,8 +905,236 @@ std::vector<uint32_t> EinsumTree::identifyNode(TreeNode* node) {
     return out_dims;
 }
 
+void EinsumTree::set_threads(int64_t num_threads, std::vector<int32_t> const& cpus) {
+    this->thread_pool = std::make_shared<ThreadPool>(num_threads, cpus);
+}
+
+ThreadPool& EinsumTree::pool() {
+    return (this->thread_pool != nullptr) ? *this->thread_pool : *ThreadPool::global();
+}
+
 void EinsumTree::lower() {
+    // pack the kernels of the whole tree and make them executable together
+    mini_jit::generator::KernelCache::Batch l_batch;
+
     lowerNode(this->root);
+
+    planMemory();
+
+    // the generated tree bakes in the lowered operations and the workspace
+    this->tree_kernel = nullptr;
+}
+
+bool EinsumTree::compile() {
+    this->tree_kernel = nullptr;
+    if (this->root == nullptr || this->root->node_type != EinsumTree::node_t::contraction) {
+        return false;
+    }
+
+    std::vector<mini_jit::generator::LoopNest::nest_t> nests;
+    mini_jit::generator::LoopNest::ptr_t out;
+    if (!compileNode(this->root, nests, out)) {
+        return false;
+    }
+
+    auto kernel = std::make_shared<mini_jit::generator::LoopNest>();
+    if (kernel->generate(nests) != mini_jit::generator::LoopNest::error_t::success) {
+        return false;
+    }
+
+    this->tree_kernel = kernel;
+    this->tree_args.assign(this->leaf_ids.size() + (this->use_bias ? this->bias_ids.size() : 0) + 1, nullptr);
+    return true;
+}
+
+bool EinsumTree::compileNode(TreeNode* node,
+                             std::vector<mini_jit::generator::LoopNest::nest_t>& nests,
+                             mini_jit::generator::LoopNest::ptr_t& out) {
+    using ptr_t = mini_jit::generator::LoopNest::ptr_t;
+
+    if (node->node_type == EinsumTree::node_t::leaf) {
+        // inputs are the first arguments, in the order of the leaf ids
+        auto it = std::find(this->leaf_ids.begin(), this->leaf_ids.end(), node->id);
+        if (it == this->leaf_ids.end()) {
+            return false;
+        }
+        out = ptr_t{ptr_t::kind_t::arg, it - this->leaf_ids.begin()};
+        return true;
+    }
+
+    // permutations, the zero fill of an explicit first touch and the conversions to bfloat16 are executed in C++
+    if (node->node_type != EinsumTree::node_t::contraction ||
+        (!this->use_bias && node->op._prim_first_touch != TensorOperation::prim_t::zero) ||
+        (this->dtype == TensorOperation::dtype_t::bf16 && node != this->root)) {
+        return false;
+    }
+
+    ptr_t left;
+    ptr_t right;
+    if (!compileNode(node->left_child, nests, left) || !compileNode(node->right_child, nests, right)) {
+        return false;
+    }
+
+    mini_jit::generator::LoopNest::nest_t nest;
+    if (!node->op.get_loop_nest(this->use_bias, true, nest)) {
+        return false;
+    }
+
+    // biases follow the inputs, the output is the last argument
+    int64_t num_args = this->leaf_ids.size() + (this->use_bias ? this->bias_ids.size() : 0);
+    if (node == this->root) {
+        out = ptr_t{ptr_t::kind_t::arg, num_args};
+    } else {
+        out = ptr_t{ptr_t::kind_t::address, reinterpret_cast<int64_t>(this->workspace + node->workspace_offset * this->element_size)};
+    }
+
+    nest.ptrs[0] = left;
+    nest.ptrs[1] = right;
+    nest.ptrs[2] = out;
+    if (this->use_bias) {
+        auto it = std::find(this->bias_ids.begin(), this->bias_ids.end(), node->id);
+        nest.ptrs[3] = ptr_t{ptr_t::kind_t::arg, static_cast<int64_t>(this->leaf_ids.size() + (it - this->bias_ids.begin()))};
+    }
+    nests.push_back(nest);
+
+    return true;
+}
+
+int64_t EinsumTree::outputSize(TreeNode* node) {
+    int64_t out_size = 1;
+    for (auto id : node->out_tensor->id) {
+        // permutation nodes write all dimensions, contractions all but K
+        if (node->node_type == EinsumTree::node_t::permutation ||
+            id.dim_t == static_cast<int>(TensorOperation::dim_t::m) ||
+            id.dim_t == static_cast<int>(TensorOperation::dim_t::n) ||
+            id.dim_t == static_cast<int>(TensorOperation::dim_t::c)) {
+            out_size *= id.dim_sizes;
+        }
+    }
+    return out_size;
+}
+
+int64_t EinsumTree::planNode(TreeNode* node,
+                             uint32_t& step,
+                             std::vector<std::pair<TreeNode*, bool>>& branches,
+                             std::vector<buffer_t>& buffers) {
+    if (node == nullptr || node->node_type == EinsumTree::node_t::leaf) {
+        return -1;
+    }
+
+    // independent subtrees on both sides are executed concurrently
+    node->parallel_children = node->node_type == EinsumTree::node_t::contraction &&
+                              node->left_child->node_type != EinsumTree::node_t::leaf &&
+                              node->right_child->node_type != EinsumTree::node_t::leaf &&
+                              pool().num_threads() > 1;
+
+    // children are executed first, their outputs live until this node is executed
+    if (node->parallel_children) {
+        branches.push_back({node, false});
+    }
+    int64_t left = planNode(node->left_child, step, branches, buffers);
+    if (node->parallel_children) {
+        branches.back().second = true;
+    }
+    int64_t right = planNode(node->right_child, step, branches, buffers);
+    if (node->parallel_children) {
+        branches.pop_back();
+    }
+
+    // round up to 64 bytes to keep every buffer aligned
+    int64_t out_size = outputSize(node);
+    int64_t size = (out_size + 15) / 16 * 16;
+
+    // intermediate outputs of bf16 trees are followed by their bfloat16 copy
+    node->to_bf16_kernels[0] = node->to_bf16_kernels[1] = nullptr;
+    if (this->dtype == TensorOperation::dtype_t::bf16 && node != this->root && node->node_type == EinsumTree::node_t::contraction) {
+        size += ((out_size + 1) / 2 + 15) / 16 * 16;
+        int64_t blocks[2] = {(out_size >= BF16_BLOCK) ? BF16_BLOCK : 0, out_size % BF16_BLOCK};
+        for (int64_t i = 0; i < 2; i++) {
+            if (blocks[i] > 0) {
+                node->to_bf16_kernels[i] = mini_jit::generator::KernelCache::get_unary(blocks[i],
+                                                                                       1,
+                                                                                       mini_jit::generator::Unary::dtype_t::bf16,
+                                                                                       mini_jit::generator::Unary::ptype_t::to_bf16);
+            }
+        }
+    }
+    buffers.push_back({node, size, step, step, branches});
+    if (left >= 0) {
+        buffers[left].last_step = step;
+    }
+    if (right >= 0) {
+        buffers[right].last_step = step;
+    }
+    step++;
+
+    return buffers.size() - 1;
+}
+
+void EinsumTree::planMemory() {
+    std::vector<buffer_t> buffers;
+    std::vector<std::pair<TreeNode*, bool>> branches;
+    uint32_t step = 0;
+    planNode(this->root, step, branches, buffers);
+
+    // buffers on different sides of concurrently executed subtrees are alive at the same time
+    auto concurrent = [](buffer_t const* a, buffer_t const* b) {
+        for (auto const& branch_a : a->branches) {
+            for (auto const& branch_b : b->branches) {
+                if (branch_a.first == branch_b.first && branch_a.second != branch_b.second) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    // place large buffers first, each at the lowest offset not used by a buffer alive at the same time
+    std::vector<buffer_t*> order;
+    for (auto& buffer : buffers) {
+        order.push_back(&buffer);
+    }
+    std::stable_sort(order.begin(), order.end(), [](buffer_t* a, buffer_t* b) {
+        return a->size > b->size;
+    });
+
+    std::vector<buffer_t*> placed;
+    int64_t length = 0;
+    for (buffer_t* buffer : order) {
+        std::vector<buffer_t*> alive;
+        for (buffer_t* other : placed) {
+            if ((other->first_step <= buffer->last_step && buffer->first_step <= other->last_step) ||
+                concurrent(buffer, other)) {
+                alive.push_back(other);
+            }
+        }
+        std::sort(alive.begin(), alive.end(), [](buffer_t* a, buffer_t* b) {
+            return a->node->workspace_offset < b->node->workspace_offset;
+        });
+
+        int64_t offset = 0;
+        for (buffer_t* other : alive) {
+            if (offset + buffer->size <= other->node->workspace_offset) {
+                break;
+            }
+            offset = std::max(offset, other->node->workspace_offset + other->size);
+        }
+
+        buffer->node->workspace_offset = offset;
+        placed.push_back(buffer);
+        length = std::max(length, offset + buffer->size);
+    }
+
+    std::free(this->workspace);
+    this->workspace = nullptr;
+    this->workspace_length = length;
+    if (length > 0) {
+        this->workspace = static_cast<char*>(std::aligned_alloc(64, length * this->element_size));
+    }
+}
+
+int64_t EinsumTree::workspace_size() {
+    return this->workspace_length * this->element_size;
 }
 
 TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
@@ -530,10 +1147,15 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
             return TensorOperation::prim_t::none;
         }
 
+        if (this->dtype == TensorOperation::dtype_t::bf16) {
+            std::cerr << "Permutations are not supported in bf16 trees." << std::endl;
+            return TensorOperation::prim_t::none;
+        }
+
         lowerNode(node->left_child);
         node_op = TensorOperation::prim_t::copy;
 
-        TensorOperationUnary::dtype_t dtype = TensorOperationUnary::dtype_t::fp32;
+        TensorOperationUnary::dtype_t dtype = static_cast<TensorOperationUnary::dtype_t>(this->dtype);
         TensorOperationUnary::prim_t prim_type = TensorOperationUnary::prim_t::trans;
 
         std::vector<TensorOperationUnary::exec_t> exec_types;
@@ -546,7 +1168,7 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
             dim_sizes.push_back(id.dim_sizes);
         }
 
-        for (int i = 0; i < node->notation.size(); i++) {
+        for (size_t i = 0; i < node->notation.size(); i++) {
             strides_out.push_back(0);
         }
         int counter = 0;
@@ -571,14 +1193,18 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
             std::cerr << "Setup failed for permutation operation" << std::endl;
             return TensorOperation::prim_t::none;
         }
+        node->op_unary._thread_pool = this->thread_pool;
         node->op_unary.compile();
     } else if (node->node_type == node_t::contraction) {
         this->bias_ids.push_back(node->id);
         lowerNode(node->left_child);
         lowerNode(node->right_child);
 
-        TensorOperation::dtype_t dtype = TensorOperation::dtype_t::fp32;
         TensorOperation::prim_t prim_first_touch = node->first_touch;
+        if (prim_first_touch == TensorOperation::prim_t::none && !this->use_bias) {
+            // the first touch kernels zero the accumulators instead of loading the output
+            prim_first_touch = TensorOperation::prim_t::zero;
+        }
         TensorOperation::prim_t prim_main = node->operation_primitive;
         TensorOperation::prim_t prim_last_touch = node->last_touch;
 
@@ -588,8 +1214,19 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
         std::vector<int64_t> strides_in0;
         std::vector<int64_t> strides_in1;
         std::vector<int64_t> strides_out;
+        std::vector<int64_t> strides_bias;
         std::unordered_set<uint32_t> added_dims;
 
+        // the bias holds one value per column, the N dimensions of the output are flattened in their order
+        std::vector<int64_t> out_strides_bias(node->notation.size(), 0);
+        int64_t bias_stride = 1;
+        for (size_t i = node->notation.size(); i-- > 0;) {
+            if (node->out_tensor->id[i].dim_t == static_cast<int>(TensorOperation::dim_t::n)) {
+                out_strides_bias[i] = bias_stride;
+                bias_stride *= node->out_tensor->id[i].dim_sizes;
+            }
+        }
+
         uint32_t dim_id = 0;
 
         for (uint32_t dim_size : this->id_dims) {
@@ -618,9 +1255,11 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
                 node->right_tensor->id[i].loop_id = node->right_child->notation[i];
             }
 
+            int64_t stride_bias = 0;
             for (size_t i = 0; i < node->notation.size(); i++) {
                 if (dim_id == node->notation[i]) {
                     stride_out = node->out_tensor->id[i].stride;
+                    stride_bias = out_strides_bias[i];
                     // break;
                 }
                 node->out_tensor->id[i].loop_id = node->notation[i];
@@ -640,6 +1279,7 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
                     node->right_tensor->id.push_back(dim_info);  // Set default stride if not set
                 }
                 strides_out.push_back(stride_out);
+                strides_bias.push_back(stride_bias);
                 if (stride_out == 0) {
                     node->out_tensor->id.push_back(dim_info);  // Set default stride if not set
                 }
@@ -647,31 +1287,19 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
             dim_id++;
         }
 
-        Tensor* bias_tensor = nullptr;
-        if (this->use_bias) {
-            std::vector<u_int32_t> bias_dims;
-            for (size_t i = 0; i < node->out_tensor->id.size(); i++) {
-                if (node->out_tensor->id[i].dim_t == static_cast<int>(TensorOperation::dim_t::n)) {
-                    bias_dims.push_back(node->out_tensor->id[i].dim_sizes);
-                } else if (node->out_tensor->id[i].dim_t == static_cast<int>(TensorOperation::dim_t::m)) {
-                    bias_dims.push_back(1);
-                } else {
-                    bias_dims.push_back(0);
-                }
-            }
-
-            bias_tensor = new Tensor(bias_dims);
-        }
-
         std::span<TensorOperation::dim_t> dim_types_span(dim_types);
         std::span<TensorOperation::exec_t> exec_types_span(exec_types);
         std::span<int64_t> dim_sizes_span(dim_sizes);
         std::span<int64_t> strides_in0_span(strides_in0);
         std::span<int64_t> strides_in1_span(strides_in1);
         std::span<int64_t> strides_out_span(strides_out);
+        std::span<int64_t> strides_bias_span;
+        if (this->use_bias) {
+            strides_bias_span = std::span<int64_t>(strides_bias);
+        }
 
         TensorOperation::error_t result = node->op.setup(
-            dtype,
+            this->dtype,
             prim_first_touch,
             prim_main,
             prim_last_touch,
@@ -680,23 +1308,44 @@ TensorOperation::prim_t EinsumTree::lowerNode(TreeNode* node) {
             dim_sizes_span,
             strides_in0_span,
             strides_in1_span,
-            strides_out_span);
+            strides_out_span,
+            strides_bias_span);
 
         if (result != TensorOperation::error_t::success) {
             std::cerr << "Setup failed for contraction operation" << std::endl;
         }
+        node->op._thread_pool = this->thread_pool;
         node->op.optimize();
         node->op.compile();
     }
     return node_op;
 }
 
-void EinsumTree::execute(std::vector<void*> inputs, std::vector<void*> biases, void* output) {
+void EinsumTree::execute(std::vector<void*> const& inputs, std::vector<void*> const& biases, void* output) {
     if (this->root == nullptr) {
         std::cerr << "Einsum tree is empty, cannot execute." << std::endl;
         return;
     }
 
+    // generated tree: the arguments are the inputs, the biases and the output
+    bool all_biases = !this->use_bias || biases.size() >= this->bias_ids.size();
+    for (size_t i = 0; all_biases && this->use_bias && i < this->bias_ids.size(); i++) {
+        all_biases = biases[i] != nullptr;
+    }
+    if (this->tree_kernel != nullptr && inputs.size() >= this->leaf_ids.size() && all_biases) {
+        size_t arg = 0;
+        for (size_t i = 0; i < this->leaf_ids.size(); i++) {
+            this->tree_args[arg++] = inputs[i];
+        }
+        for (size_t i = 0; this->use_bias && i < this->bias_ids.size(); i++) {
+            this->tree_args[arg++] = biases[i];
+        }
+        this->tree_args[arg] = output;
+
+        this->tree_kernel->get_kernel()(this->tree_args.data());
+        return;
+    }
+
     // Execute the root node and get the result
     void* result = executeNode(this->root, inputs, biases);
 
@@ -717,10 +1366,25 @@ void EinsumTree::execute(std::vector<void*> inputs, std::vector<void*> biases, v
     // TODO: check if all permutation node allocation is correct.
 
     // Copy the data
-    memcpy(output, result, size * sizeof(float));
+    memcpy(output, result, size * this->element_size);
+}
+
+void* EinsumTree::convertToBf16(TreeNode* node) {
+    int64_t out_size = outputSize(node);
+    float* output = reinterpret_cast<float*>(this->workspace + node->workspace_offset * this->element_size);
+    uint16_t* output_bf16 = reinterpret_cast<uint16_t*>(output + (out_size + 15) / 16 * 16);
+
+    // full blocks and the remainder are converted in parallel
+    int64_t num_blocks = (out_size + BF16_BLOCK - 1) / BF16_BLOCK;
+    pool().parallel_for(num_blocks, [&](int64_t block) {
+        bool remainder = (block + 1) * BF16_BLOCK > out_size;
+        node->to_bf16_kernels[remainder](output + block * BF16_BLOCK, output_bf16 + block * BF16_BLOCK, BF16_BLOCK, BF16_BLOCK);
+    });
+
+    return output_bf16;
 }
 
-void* EinsumTree::executeNode(TreeNode* node, std::vector<void*> inputs, std::vector<void*> biases) {
+void* EinsumTree::executeNode(TreeNode* node, std::vector<void*> const& inputs, std::vector<void*> const& biases) {
     if (node == nullptr) {
         std::cerr << "Node is null, cannot execute." << std::endl;
         return nullptr;
@@ -739,95 +1403,68 @@ void* EinsumTree::executeNode(TreeNode* node, std::vector<void*> inputs, std::ve
         return nullptr;
     }
 
-    // For non-leaf nodes, we need to allocate output memory
-    uint32_t out_size = 1;
-    uint32_t n_size = 1;
-    uint32_t m_size = 1;
-    for (auto id : node->out_tensor->id) {
-        if (id.dim_t == static_cast<int>(TensorOperation::dim_t::n)) {
-            n_size *= id.dim_sizes;
-            out_size *= id.dim_sizes;
-        } else if (id.dim_t == static_cast<int>(TensorOperation::dim_t::m)) {
-            m_size *= id.dim_sizes;
-            out_size *= id.dim_sizes;
-        } else if (id.dim_t == static_cast<int>(TensorOperation::dim_t::c)) {
-            out_size *= id.dim_sizes;
-        }
-    }
+    // For non-leaf nodes, the output is in the workspace
+    int64_t out_size = outputSize(node);
 
-    if (node->node_type == EinsumTree::node_t::permutation) {
-        out_size = 1;  // For permutation nodes, we only need to consider the output size
-        for (size_t i = 0; i < node->out_tensor->id.size(); i++) {
-            out_size *= node->out_tensor->id[i].dim_sizes;
-        }
-    }
-
-    float* output_f = nullptr;
-    void* output = nullptr;
+    char* output_c = this->workspace + node->workspace_offset * this->element_size;
+    void* output = static_cast<void*>(output_c);
 
     if (node->node_type == EinsumTree::node_t::contraction) {
         // Execute left and right children
-        void* left_output = executeNode(node->left_child, inputs, biases);
-        void* right_output = executeNode(node->right_child, inputs, biases);
-
-        output_f = new float[out_size]();  // Initialize to zero
+        void* left_output = nullptr;
+        void* right_output = nullptr;
+        if (node->parallel_children) {
+            // the parallel loops of both subtrees share the threads of the pool
+            pool().parallel_for(2, [&](int64_t side) {
+                if (side == 0) {
+                    left_output = executeNode(node->left_child, inputs, biases);
+                } else {
+                    right_output = executeNode(node->right_child, inputs, biases);
+                }
+            });
+        } else {
+            left_output = executeNode(node->left_child, inputs, biases);
+            right_output = executeNode(node->right_child, inputs, biases);
+        }
 
+        // get correct bias for this node, it initializes the output on first touch
+        void const* bias = nullptr;
         if (this->use_bias) {
-            // get correct bias for this node
-            float* bias = nullptr;
             for (size_t i = 0; i < biases.size(); i++) {
-                if (node->id == this->bias_ids[i]) {
-                    bias = (float*)biases[i];
+                if (static_cast<uint32_t>(node->id) == this->bias_ids[i]) {
+                    bias = biases[i];
                     break;
                 }
             }
-
-            // fill each column with the corresponding bias value
-            for (size_t j = 0; j < n_size; j++) {
-                std::fill(&output_f[j * m_size], &output_f[j * m_size + m_size], bias[j]);
-            }
+        } else if (node->op._prim_first_touch != TensorOperation::prim_t::zero) {
+            // the kernels accumulate into the output
+            std::fill(output_c, output_c + out_size * this->element_size, 0);
         }
 
-        output = static_cast<void*>(output_f);
-
         if (left_output == nullptr || right_output == nullptr) {
             std::cerr << "Failed to execute child nodes." << std::endl;
-            delete[] output_f;  // Clean up allocated memory
             return nullptr;
         }
 
         // Execute the tensor operation
-        node->op.execute(left_output, right_output, output);
-        if (node->left_child->node_type != EinsumTree::node_t::leaf) {
-            // If the left child is not a leaf, we need to clean up the left output
-            delete[] static_cast<float*>(left_output);
-        }
-        if (node->right_child->node_type != EinsumTree::node_t::leaf) {
-            // If the right child is not a leaf, we need to clean up the right output
-            delete[] static_cast<float*>(right_output);
+        node->op.execute(left_output, right_output, output, bias);
+
+        if (node->to_bf16_kernels[0] != nullptr || node->to_bf16_kernels[1] != nullptr) {
+            return convertToBf16(node);
         }
     } else if (node->node_type == EinsumTree::node_t::permutation) {
         // Execute child node
         void* child_output = executeNode(node->left_child, inputs, biases);
-        output_f = new float[out_size]();  // Initialize to zero
-        output = static_cast<void*>(output_f);
 
         if (child_output == nullptr) {
             std::cerr << "Failed to execute child node for permutation." << std::endl;
-            delete[] output_f;  // Clean up allocated memory
             return nullptr;
         }
 
-        // Execute the permutation operation
+        // Execute the permutation operation, it writes every element of the output
         node->op_unary.execute(child_output, output);
-
-        if (node->left_child->node_type != EinsumTree::node_t::leaf) {
-            // If the left child is not a leaf, we need to clean up the child output
-            delete[] static_cast<float*>(child_output);
-        }
     } else {
         std::cerr << "Unsupported node type for execution: " << static_cast<int>(node->node_type) << std::endl;
-        delete[] output_f;  // Clean up allocated memory
         return nullptr;
     }
     return output;
@@ -905,6 +1542,11 @@ void EinsumTree::delete_tree() {
     this->leaf_ids.clear();
     this->bias_ids.clear();
     this->id_dims.clear();
+
+    std::free(this->workspace);
+    this->workspace = nullptr;
+    this->workspace_length = 0;
+    this->tree_kernel = nullptr;
 }
 
 uint32_t EinsumTree::operations() {
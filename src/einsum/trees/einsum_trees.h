@@ -2,7 +2,9 @@
 #define EINSUM_TREES_EINSUM_TREE_H
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../../tensor/tensor.h"
@@ -18,6 +20,13 @@ namespace einsum {
 using namespace einsum::backend;
 
 class einsum::trees::EinsumTree {
+   public:
+    /// contraction path optimization mode
+    enum class path_t : uint32_t {
+        greedy = 0,
+        dp = 1
+    };
+
    private:
     enum class node_t : uint32_t {
         leaf = 0,
@@ -42,17 +51,46 @@ class einsum::trees::EinsumTree {
         TensorOperation::prim_t last_touch;
 
         TensorOperation op;
-        TensorOperationUnary op_unary;
+        TensorOperationUnary op_unary{};
+
+        int64_t workspace_offset = -1;  // offset of the output in the workspace in elements
+        bool parallel_children = false;  // children are executed concurrently
+
+        // conversion of an intermediate output to the bfloat16 input of the parent in bf16 trees,
+        // indexed by [remainder block], owned by mini_jit::generator::KernelCache
+        mini_jit::generator::Unary::kernel_t to_bf16_kernels[2] = {nullptr, nullptr};
+    };
+
+    //! number of elements converted to bfloat16 per call of a conversion kernel
+    static constexpr int64_t BF16_BLOCK = 1 << 14;
+
+    // buffer of an intermediate tensor with its lifetime in execution steps
+    struct buffer_t {
+        TreeNode* node;
+        int64_t size;
+        uint32_t first_step;
+        uint32_t last_step;
+        std::vector<std::pair<TreeNode*, bool>> branches;  // concurrent subtrees containing the buffer: node, right side
     };
 
     TreeNode* root = nullptr;
     uint32_t size = 0;
     bool use_bias = false;
+    TensorOperation::dtype_t dtype = TensorOperation::dtype_t::fp32;
+    int64_t element_size = 4;  // bytes per element of the outputs and biases, bf16 trees accumulate in fp32
 
     std::vector<uint32_t> id_dims = {};
     std::vector<int32_t> leaf_ids = {};
     std::vector<uint32_t> bias_ids = {};
 
+    char* workspace = nullptr;     // 64-byte aligned memory of all intermediate tensors
+    int64_t workspace_length = 0;  // number of elements in the workspace
+
+    std::shared_ptr<ThreadPool> thread_pool;  // threads executing the tree, the global pool if nullptr
+
+    std::shared_ptr<mini_jit::generator::LoopNest> tree_kernel;  // whole tree in one function, nullptr if not compiled
+    std::vector<void const*> tree_args;                          // arguments of the tree kernel: inputs, biases, output
+
     /**
      * @brief Prints the structure of a Einsum tree node.
      *
@@ -80,14 +118,67 @@ class einsum::trees::EinsumTree {
      */
 
     TensorOperation::prim_t lowerNode(TreeNode* node);
+    /**
+     * @brief Plans the workspace offsets of all intermediate tensors.
+     * Buffers of tensors with disjoint lifetimes share the same memory.
+     */
+    void planMemory();
+    /**
+     * @brief Collects the buffers of a node and its children in execution order.
+     * Decides which children are executed concurrently.
+     *
+     * @param node current node in the tree.
+     * @param step next execution step, incremented for each non-leaf node.
+     * @param branches concurrent subtrees containing the node.
+     * @param buffers buffers collected so far.
+     * @return int64_t Index of the node's buffer, -1 for leaves.
+     */
+    int64_t planNode(TreeNode* node,
+                     uint32_t& step,
+                     std::vector<std::pair<TreeNode*, bool>>& branches,
+                     std::vector<buffer_t>& buffers);
+    /**
+     * @brief Number of elements of the output tensor of a node.
+     *
+     * @param node non-leaf node in the tree.
+     * @return int64_t Number of elements.
+     */
+    int64_t outputSize(TreeNode* node);
+    /**
+     * @brief Converts the single precision output of an intermediate contraction in a bf16 tree to bfloat16.
+     * The copy is stored behind the output in the node's workspace buffer.
+     *
+     * @param node intermediate contraction in the tree.
+     * @return void* Pointer to the bfloat16 copy.
+     */
+    void* convertToBf16(TreeNode* node);
+    /**
+     * @brief Appends the loop nests of a node and its children in execution order.
+     *
+     * @param node current node in the tree.
+     * @param nests loop nests collected so far.
+     * @param out pointer to the output tensor of the node in the generated function.
+     * @return bool True on success, false if the node cannot be generated.
+     */
+    bool compileNode(TreeNode* node,
+                     std::vector<mini_jit::generator::LoopNest::nest_t>& nests,
+                     mini_jit::generator::LoopNest::ptr_t& out);
     /**
      * @brief Executes the Einsum tree nodes recursively.
+     * Concurrent children are executed as a parallel loop of the thread pool, the threads which finish one subtree
+     * steal the iterations of the operations of the other one.
      *
      * @param node current node in the tree to be executed.
      * @param inputs Vector of input tensors for the execution.
      * @return void* Pointer to the output tensor after execution.
      */
-    void* executeNode(TreeNode* node, std::vector<void*> inputs, std::vector<void*> biases);
+    void* executeNode(TreeNode* node, std::vector<void*> const& inputs, std::vector<void*> const& biases);
+    /**
+     * @brief Thread pool of the tree.
+     *
+     * @return ThreadPool& The pool set by set_threads() or the global pool.
+     */
+    ThreadPool& pool();
     /**
      * @brief Swaps the left and right children of a node if the the parent is contraction.
      *
@@ -118,6 +209,41 @@ class einsum::trees::EinsumTree {
      * @param node Pointer to the current node in the tree to be optimized.
      */
     void optimizeNode(TreeNode* node);
+    /**
+     * @brief Checks if all outer dimensions of an input are outside of its inner dimensions, i.e., if a
+     * transposed BRGEMM reads the input without a permutation.
+     *
+     * @param tensor The input tensor of a contraction.
+     * @param outer The dimension type which has to be outside.
+     * @param inner The dimension type which has to be inside, including the innermost dimension.
+     * @return bool True if the input is row-major with respect to the two dimension types.
+     */
+    bool isRowMajor(Tensor const* tensor, TensorOperation::dim_t outer, TensorOperation::dim_t inner);
+    /**
+     * @brief Changes the output layout of a node instead of inserting a permutation behind it.
+     * Intermediate contractions write the new layout directly, permutations are rewritten or removed.
+     *
+     * @param node Pointer to the node which produces the operand.
+     * @param notation The layout required by the consumer.
+     * @return bool True if the layout was folded, false if a permutation has to be inserted.
+     */
+    bool foldLayout(TreeNode* node, std::vector<uint32_t> const& notation);
+    /**
+     * @brief Reorders the contractions of the network below a node and of all nested networks.
+     *
+     * @param node Pointer to the current node in the tree to be optimized.
+     * @param path The path optimization mode.
+     */
+    void optimizePathNode(TreeNode* node, path_t path);
+    /**
+     * @brief Collects the operands and internal nodes of a contraction network.
+     * Contractions without unary primitives and bias are internal nodes, all other nodes are operands.
+     *
+     * @param node Pointer to the current node in the network.
+     * @param operands Operands collected so far.
+     * @param internal Internal nodes collected so far.
+     */
+    void collectOperands(TreeNode* node, std::vector<TreeNode*>& operands, std::vector<TreeNode*>& internal);
     /**
      * @brief Deletes a node and its children recursively.
      *
@@ -140,10 +266,25 @@ class einsum::trees::EinsumTree {
      * @param str_repr String representation of the einsum operation.
      * @param id_dims Vector of dimensions for each tensor ID in the einsum operation.
      * @param use_bias Boolean indicating whether to use a bias tensor in the operation.
+     * @param dtype Datatype of all tensors, inputs, biases and output.
+     *              bf16 trees take bfloat16 inputs and accumulate in single precision, the biases and the output are
+     *              fp32 and intermediate outputs are rounded to bfloat16 for their parent. Permutations are not supported.
+     */
+    EinsumTree(std::string str_repr,
+               std::vector<uint32_t> id_dims,
+               bool use_bias = false,
+               TensorOperation::dtype_t dtype = TensorOperation::dtype_t::fp32);
+    /**
+     * @brief Sets the threads executing the tree, e.g., to run several trees side by side on disjoint cores.
+     * The tree gets its own thread pool, otherwise the operations share the global pool. Call before lower().
+     *
+     * @param num_threads Number of threads including the calling thread, omp_get_max_threads() if 0.
+     * @param cpus CPUs the workers are pinned to round-robin, not pinned if empty.
      */
-    EinsumTree(std::string str_repr, std::vector<uint32_t> id_dims, bool use_bias = false);
+    void set_threads(int64_t num_threads, std::vector<int32_t> const& cpus = {});
     /**
-     * @brief Lowers the Einsum tree nodes for each to hold a tensor operations.
+     * @brief Lowers the Einsum tree nodes for each to hold a tensor operations
+     * and allocates the workspace of the intermediate tensors.
      */
     void lower();
     /**
@@ -151,6 +292,27 @@ class einsum::trees::EinsumTree {
      * This includes adding permutation nodes and swapping children if necessary.
      */
     void optimize();
+    /**
+     * @brief Chooses the order of the contractions to minimize the estimated FLOPs and the size of the intermediates.
+     * Networks of contractions without unary primitives and bias are rebuilt if the new path is cheaper.
+     * The greedy mode contracts the pair which removes the most memory first,
+     * the dp mode finds the path with the fewest FLOPs by dynamic programming over subsets of up to 16 operands.
+     * Call before optimize(). The inputs keep the order of the string representation
+     * until optimize() orders them by the leaves of the optimized tree.
+     *
+     * @param path The path optimization mode.
+     */
+    void optimize_path(path_t path = path_t::greedy);
+    /**
+     * @brief Generates the whole lowered tree into one function for low-latency execution.
+     * The contractions are executed sequentially one after another, the intermediate tensors stay in the workspace
+     * and the root writes directly to the output. execute() calls the function if all biases are given.
+     * Call after lower(), trees with permutations or an explicit first touch
+     * and bf16 trees with intermediate contractions are not supported.
+     *
+     * @return bool True if the tree was generated, false if it is executed node by node.
+     */
+    bool compile();
     /**
      * @brief Executes the Einsum tree with the provided input tensors.
      *
@@ -158,7 +320,7 @@ class einsum::trees::EinsumTree {
      * @param biases Vector of bias tensors to be used in the execution.
      * @param output Tensor, which is returned from root contraction.
      */
-    void execute(std::vector<void*> inputs, std::vector<void*> biases, void* output);
+    void execute(std::vector<void*> const& inputs, std::vector<void*> const& biases, void* output);
     /**
      * @brief Prints the structure of the Einsum tree.
      */
@@ -173,6 +335,12 @@ class einsum::trees::EinsumTree {
      * @return uint32_t The number of operations in the tree.
      */
     uint32_t operations();
+    /**
+     * @brief Returns the size of the workspace for the intermediate tensors.
+     *
+     * @return int64_t The size of the workspace in bytes.
+     */
+    int64_t workspace_size();
 
     /**
      * @brief Destructor for the EinsumTree class.
@@ -0,0 +1,186 @@
+#include "CodeArena.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+mini_jit::backend::CodeArena::CodeArena(std::size_t chunk_size) {
+    m_page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    m_chunk_size = (chunk_size + m_page_size - 1) / m_page_size * m_page_size;
+}
+
+mini_jit::backend::CodeArena::~CodeArena() noexcept {
+    for (Chunk const& l_chunk : m_chunks) {
+        munmap(l_chunk.mem,
+               l_chunk.size);
+        munmap(l_chunk.exec,
+               l_chunk.size);
+    }
+}
+
+void* mini_jit::backend::CodeArena::add(void const* code,
+                                        std::size_t num_bytes) {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    std::size_t l_offset = (m_offset + KERNEL_ALIGNMENT - 1) / KERNEL_ALIGNMENT * KERNEL_ALIGNMENT;
+
+    // map a new chunk if the code does not fit into the last one
+    if (m_chunks.empty() || l_offset + num_bytes > m_chunks.back().size) {
+        seal_locked();
+
+        std::size_t l_size = (num_bytes + m_page_size - 1) / m_page_size * m_page_size;
+        l_size = (l_size > m_chunk_size) ? l_size : m_chunk_size;
+
+        // map the same memory twice, once writable and once executable
+        int l_fd = memfd_create("mini_jit_code",
+                                MFD_CLOEXEC);
+        if (l_fd == -1) {
+            throw std::runtime_error("Failed to create memory for code arena: " + std::string(std::strerror(errno)));
+        }
+        if (ftruncate(l_fd, l_size) == -1) {
+            int l_errno = errno;
+            close(l_fd);
+            throw std::runtime_error("Failed to allocate memory for code arena: " + std::string(std::strerror(l_errno)));
+        }
+
+        void* l_mem = mmap(0,
+                           l_size,
+                           PROT_READ | PROT_WRITE,
+                           MAP_SHARED,
+                           l_fd,
+                           0);
+        void* l_exec = mmap(0,
+                            l_size,
+                            PROT_READ | PROT_EXEC,
+                            MAP_SHARED,
+                            l_fd,
+                            0);
+        int l_errno = errno;
+        close(l_fd);
+        if (l_mem == MAP_FAILED || l_exec == MAP_FAILED) {
+            if (l_mem != MAP_FAILED) {
+                munmap(l_mem,
+                       l_size);
+            }
+            if (l_exec != MAP_FAILED) {
+                munmap(l_exec,
+                       l_size);
+            }
+            throw std::runtime_error("Failed to allocate memory for code arena: " + std::string(std::strerror(l_errno)));
+        }
+
+        m_chunks.push_back({reinterpret_cast<char*>(l_mem), reinterpret_cast<char*>(l_exec), l_size});
+        m_offset_sealed = 0;
+        l_offset = 0;
+    }
+
+    std::memcpy(m_chunks.back().mem + l_offset,
+                code,
+                num_bytes);
+    m_offset = l_offset + num_bytes;
+
+    if (m_batch_depths.count(std::this_thread::get_id()) == 0) {
+        seal_locked();
+    }
+
+    return m_chunks.back().exec + l_offset;
+}
+
+void mini_jit::backend::CodeArena::seal_locked() {
+    if (m_chunks.empty() || m_offset == m_offset_sealed) {
+        return;
+    }
+
+    // clear cache, the executable view is always mapped executable
+    Chunk const& l_chunk = m_chunks.back();
+    __builtin___clear_cache(l_chunk.exec + m_offset_sealed,
+                            l_chunk.exec + m_offset);
+
+    m_offset_sealed = m_offset;
+}
+
+void mini_jit::backend::CodeArena::seal() {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    seal_locked();
+}
+
+void mini_jit::backend::CodeArena::seal(void const* code) {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    if (m_chunks.empty()) {
+        return;
+    }
+
+    // only code in the last chunk behind the sealed offset is pending
+    char const* l_code = static_cast<char const*>(code);
+    Chunk const& l_chunk = m_chunks.back();
+    if (l_code >= l_chunk.exec + m_offset_sealed &&
+        l_code < l_chunk.exec + l_chunk.size) {
+        seal_locked();
+    }
+}
+
+void mini_jit::backend::CodeArena::begin_batch() {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    m_batch_depths[std::this_thread::get_id()]++;
+}
+
+void mini_jit::backend::CodeArena::end_batch() {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    auto l_it = m_batch_depths.find(std::this_thread::get_id());
+    if (l_it == m_batch_depths.end()) {
+        return;
+    }
+
+    l_it->second--;
+    if (l_it->second == 0) {
+        m_batch_depths.erase(l_it);
+        seal_locked();
+    }
+}
+
+void mini_jit::backend::CodeArena::release() {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    for (Chunk const& l_chunk : m_chunks) {
+        int l_res = munmap(l_chunk.mem,
+                           l_chunk.size);
+        if (l_res != -1) {
+            l_res = munmap(l_chunk.exec,
+                           l_chunk.size);
+        }
+        if (l_res == -1) {
+            throw std::runtime_error("Failed to release memory");
+        }
+    }
+    m_chunks.clear();
+    m_offset = 0;
+    m_offset_sealed = 0;
+}
+
+std::size_t mini_jit::backend::CodeArena::get_size_used() {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    std::size_t l_size = 0;
+    for (std::size_t l_ch = 0; l_ch + 1 < m_chunks.size(); l_ch++) {
+        l_size += m_chunks[l_ch].size;
+    }
+    return l_size + m_offset;
+}
+
+std::size_t mini_jit::backend::CodeArena::get_size_mapped() {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    std::size_t l_size = 0;
+    for (Chunk const& l_chunk : m_chunks) {
+        l_size += l_chunk.size;
+    }
+    return l_size;
+}
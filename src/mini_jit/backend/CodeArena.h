@@ -0,0 +1,142 @@
+#ifndef MINI_JIT_BACKEND_CODE_ARENA_H
+#define MINI_JIT_BACKEND_CODE_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mini_jit::backend {
+    class CodeArena;
+}
+
+/**
+ * Bump allocator for executable code.
+ *
+ * Kernels added to the arena are packed next to each other into large chunks
+ * of pages. Every chunk is mapped twice: code is written through a writable
+ * view and executed through a read-only executable view of the same memory.
+ * Thus, no page is ever writable and executable at once and the protection of
+ * executable code never changes, which allows kernels added later to share the
+ * pages of running kernels. Sealing makes all pending kernels executable with
+ * a single cache clear. All memory is released together.
+ **/
+class mini_jit::backend::CodeArena {
+   private:
+    //! chunk of pages
+    struct Chunk {
+        //! start of the writable view of the chunk
+        char* mem = nullptr;
+
+        //! start of the executable view of the chunk
+        char* exec = nullptr;
+
+        //! size of the chunk in bytes
+        std::size_t size = 0;
+    };
+
+    //! guards the arena
+    std::mutex m_mutex;
+
+    //! size of a memory page in bytes
+    std::size_t m_page_size = 0;
+
+    //! minimum size of a chunk in bytes
+    std::size_t m_chunk_size = 0;
+
+    //! allocated chunks, code is added to the last one
+    std::vector<Chunk> m_chunks;
+
+    //! offset of the next kernel in the last chunk
+    std::size_t m_offset = 0;
+
+    //! offset in the last chunk up to which the code is executable
+    std::size_t m_offset_sealed = 0;
+
+    //! number of open batches per thread
+    std::unordered_map<std::thread::id, uint32_t> m_batch_depths;
+
+    /**
+     * Makes the pending code executable, the lock has to be held.
+     **/
+    void seal_locked();
+
+   public:
+    //! alignment of the kernels in bytes
+    static constexpr std::size_t KERNEL_ALIGNMENT = 64;
+
+    /**
+     * Constructor
+     *
+     * @param chunk_size minimum number of bytes which are mapped at once.
+     **/
+    CodeArena(std::size_t chunk_size = 1 << 20);
+
+    /**
+     * Destructor
+     **/
+    ~CodeArena() noexcept;
+
+    CodeArena(CodeArena const&) = delete;
+    CodeArena& operator=(CodeArena const&) = delete;
+    CodeArena(CodeArena&&) noexcept = delete;
+    CodeArena& operator=(CodeArena&&) noexcept = delete;
+
+    /**
+     * Copies the given code to the arena.
+     *
+     * Outside a batch the code is executable right away, inside a batch it is
+     * executable once the outermost batch of the calling thread ends.
+     *
+     * @param code instructions.
+     * @param num_bytes number of bytes.
+     * @return pointer to the code in the arena.
+     **/
+    void* add(void const* code,
+              std::size_t num_bytes);
+
+    /**
+     * Makes all code added so far executable.
+     **/
+    void seal();
+
+    /**
+     * Makes the given code executable if it is still pending.
+     *
+     * Used by lookups which hand out code added by another thread, whose
+     * batch may not have ended yet.
+     *
+     * @param code pointer returned by add.
+     **/
+    void seal(void const* code);
+
+    /**
+     * Starts a batch of the calling thread, batches can be nested.
+     **/
+    void begin_batch();
+
+    /**
+     * Ends a batch of the calling thread, the outermost batch seals the arena.
+     **/
+    void end_batch();
+
+    /**
+     * Releases all memory of the arena.
+     * Kernels added before are invalid afterwards.
+     **/
+    void release();
+
+    /**
+     * Gets the number of bytes occupied by code and padding.
+     **/
+    std::size_t get_size_used();
+
+    /**
+     * Gets the number of bytes mapped by the arena.
+     **/
+    std::size_t get_size_mapped();
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "Cpu.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+mini_jit::backend::Cpu::isa_t mini_jit::backend::Cpu::get_isa() {
+#if defined(__aarch64__)
+    static isa_t const l_isa = []() {
+#if defined(__linux__) && defined(HWCAP_SVE)
+        char const* l_max_isa = std::getenv("MINI_JIT_MAX_ISA");
+        bool l_allow_sve = (l_max_isa == nullptr) || (std::strcmp(l_max_isa, "neon") != 0);
+
+        if (l_allow_sve && (getauxval(AT_HWCAP) & HWCAP_SVE)) {
+            return isa_t::sve;
+        }
+#endif
+        return isa_t::neon;
+    }();
+    return l_isa;
+#elif defined(__x86_64__)
+    static isa_t const l_isa = []() {
+        char const* l_max_isa = std::getenv("MINI_JIT_MAX_ISA");
+        bool l_allow_avx512 = (l_max_isa == nullptr) || (std::strcmp(l_max_isa, "avx2") != 0);
+
+        if (l_allow_avx512 && __builtin_cpu_supports("avx512f")) {
+            return isa_t::avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return isa_t::avx2;
+        }
+        return isa_t::unsupported;
+    }();
+    return l_isa;
+#else
+    return isa_t::unsupported;
+#endif
+}
+
+bool mini_jit::backend::Cpu::has_bf16() {
+#if defined(__aarch64__)
+#if defined(__linux__) && defined(HWCAP2_BF16)
+    static bool const l_bf16 = (getauxval(AT_HWCAP2) & HWCAP2_BF16) != 0;
+    return l_bf16;
+#else
+    return false;
+#endif
+#elif defined(__x86_64__)
+    static bool const l_bf16 = (get_isa() == isa_t::avx512) && __builtin_cpu_supports("avx512bf16");
+    return l_bf16;
+#else
+    return false;
+#endif
+}
+
+bool mini_jit::backend::Cpu::has_int8() {
+#if defined(__aarch64__)
+#if defined(__linux__) && defined(HWCAP2_I8MM)
+    static bool const l_int8 = (getauxval(AT_HWCAP2) & HWCAP2_I8MM) != 0;
+    return l_int8;
+#else
+    return false;
+#endif
+#elif defined(__x86_64__)
+    static bool const l_int8 = (get_isa() == isa_t::avx512) && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni");
+    return l_int8;
+#else
+    return false;
+#endif
+}
+
+bool mini_jit::backend::Cpu::has_fp16() {
+#if defined(__aarch64__)
+#if defined(__linux__) && defined(HWCAP_ASIMDHP)
+    static bool const l_fp16 = (getauxval(AT_HWCAP) & HWCAP_ASIMDHP) != 0;
+    return l_fp16;
+#else
+    return false;
+#endif
+#elif defined(__x86_64__)
+    // older compilers do not know avx512fp16 in __builtin_cpu_supports, CPUID.(EAX=7,ECX=0):EDX[23]
+    static bool const l_fp16 = []() {
+        uint32_t l_eax = 0;
+        uint32_t l_ebx = 0;
+        uint32_t l_ecx = 0;
+        uint32_t l_edx = 0;
+        if (get_isa() != isa_t::avx512 || !__builtin_cpu_supports("avx512bw") || !__get_cpuid_count(7, 0, &l_eax, &l_ebx, &l_ecx, &l_edx)) {
+            return false;
+        }
+        return (l_edx & (1u << 23)) != 0;
+    }();
+    return l_fp16;
+#else
+    return false;
+#endif
+}
+
+bool mini_jit::backend::Cpu::has_fp16_fp32() {
+#if defined(__aarch64__)
+#if defined(__linux__) && defined(HWCAP_ASIMDFHM)
+    static bool const l_fp16_fp32 = (getauxval(AT_HWCAP) & HWCAP_ASIMDFHM) != 0;
+    return l_fp16_fp32;
+#else
+    return false;
+#endif
+#elif defined(__x86_64__)
+    static bool const l_fp16_fp32 = (get_isa() == isa_t::avx512) && __builtin_cpu_supports("avx512bw");
+    return l_fp16_fp32;
+#else
+    return false;
+#endif
+}
+
+std::string mini_jit::backend::Cpu::fingerprint() {
+#if defined(__aarch64__)
+    std::string l_arch = "aarch64";
+#elif defined(__x86_64__)
+    std::string l_arch = "x86_64";
+#else
+    std::string l_arch = "unknown";
+#endif
+
+    uint64_t l_hwcap = 0;
+    uint64_t l_hwcap2 = 0;
+#if defined(__linux__) && defined(AT_HWCAP)
+    l_hwcap = getauxval(AT_HWCAP);
+#endif
+#if defined(__linux__) && defined(AT_HWCAP2)
+    l_hwcap2 = getauxval(AT_HWCAP2);
+#endif
+
+    char l_features[48];
+    std::snprintf(l_features,
+                  sizeof(l_features),
+                  "%u_%016llx%016llx",
+                  static_cast<uint32_t>(get_isa()),
+                  static_cast<unsigned long long>(l_hwcap),
+                  static_cast<unsigned long long>(l_hwcap2));
+
+    return l_arch + "_" + l_features;
+}
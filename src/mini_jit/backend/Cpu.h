@@ -0,0 +1,77 @@
+#ifndef MINI_JIT_BACKEND_CPU_H
+#define MINI_JIT_BACKEND_CPU_H
+
+#include <cstdint>
+#include <string>
+
+namespace mini_jit::backend {
+    class Cpu;
+}
+
+/**
+ * Information about the host CPU.
+ **/
+class mini_jit::backend::Cpu {
+   public:
+    /// instruction set targeted by the generators
+    enum class isa_t : uint32_t {
+        unsupported = 0,
+        neon = 1,
+        avx2 = 2,
+        avx512 = 3,
+        sve = 4
+    };
+
+    /**
+     * @brief Gets the best instruction set of the host supported by the generators.
+     *
+     * The environment variable MINI_JIT_MAX_ISA restricts the generators, e.g., to
+     * test the AVX2 kernels on an AVX-512 host (avx2) or the NEON kernels on an SVE host (neon).
+     *
+     * @return instruction set.
+     **/
+    static isa_t get_isa();
+
+    /**
+     * @brief Checks if the host supports the BF16 dot products used by the bf16 kernels:
+     *        BFMMLA (ARMv8.6 BF16) on AArch64 or VDPBF16PS (AVX512_BF16) on an AVX-512 host.
+     *
+     * @return true if the bf16 kernels can be generated.
+     **/
+    static bool has_bf16();
+
+    /**
+     * @brief Checks if the host supports the INT8 dot products used by the int8 kernels:
+     *        SMMLA (ARMv8.6 I8MM) on AArch64 or VPDPBUSD (AVX512_VNNI) on an AVX-512 host.
+     *
+     * @return true if the int8 kernels can be generated.
+     **/
+    static bool has_int8();
+
+    /**
+     * @brief Checks if the host supports the half-precision arithmetic used by the fp16 kernels:
+     *        FMLA on .8h arrangements (ARMv8.2 FP16) on AArch64 or VFMADD231PH (AVX512_FP16) on an AVX-512 host.
+     *
+     * @return true if the fp16 kernels can be generated.
+     **/
+    static bool has_fp16();
+
+    /**
+     * @brief Checks if the host supports the widening half-precision multiply-adds used by the fp16_fp32 kernels:
+     *        FMLAL/FMLAL2 (ARMv8.2 FHM) on AArch64 or VCVTPH2PS and VPBROADCASTW (AVX512BW) on an AVX-512 host.
+     *
+     * @return true if the fp16_fp32 kernels can be generated.
+     **/
+    static bool has_fp16_fp32();
+
+    /**
+     * @brief Builds a fingerprint of the architecture and the CPU features of the host.
+     *
+     * Kernels generated on a host are only valid on hosts with the same fingerprint.
+     *
+     * @return fingerprint which may be used in file names.
+     **/
+    static std::string fingerprint();
+};
+
+#endif
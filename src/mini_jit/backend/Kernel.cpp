@@ -16,11 +16,20 @@ mini_jit::backend::Kernel::~Kernel() noexcept {
 }
 
 void mini_jit::backend::Kernel::add_instr(uint32_t ins) {
-    m_buffer.push_back(ins);
+    // little-endian instruction word
+    for (std::size_t l_by = 0; l_by < 4; l_by++) {
+        m_buffer.push_back((ins >> (8 * l_by)) & 0xFF);
+    }
+}
+
+void mini_jit::backend::Kernel::add_instr(std::vector<uint8_t> const& ins) {
+    m_buffer.insert(m_buffer.end(),
+                    ins.begin(),
+                    ins.end());
 }
 
 std::size_t mini_jit::backend::Kernel::get_size() const {
-    return m_buffer.size() * 4;
+    return m_buffer.size();
 }
 
 void* mini_jit::backend::Kernel::alloc_mmap(std::size_t num_bytes) const {
@@ -59,6 +68,10 @@ void mini_jit::backend::Kernel::set_exec(std::size_t num_bytes,
     }
 }
 
+void mini_jit::backend::Kernel::set_arena(CodeArena* arena) {
+    m_arena = arena;
+}
+
 void mini_jit::backend::Kernel::set_kernel() {
     release_memory();
 
@@ -66,23 +79,30 @@ void mini_jit::backend::Kernel::set_kernel() {
         return;
     }
 
+    // pack kernel into the arena
+    if (m_arena != nullptr) {
+        m_kernel = m_arena->add(m_buffer.data(),
+                                m_buffer.size());
+        return;
+    }
+
     // alloc kernel memory
-    m_size_alloc = m_buffer.size() * 4;
+    m_size_alloc = m_buffer.size();
     try {
         m_kernel = (void*)alloc_mmap(m_size_alloc);
     } catch (std::runtime_error& e) {
         throw std::runtime_error("Failed to allocate memory for kernel: " + std::string(e.what()));
     }
 
-    // copy instruction words from buffer to kernel memory
-    for (std::size_t l_in = 0; l_in < m_buffer.size(); l_in++) {
-        reinterpret_cast<uint32_t*>(m_kernel)[l_in] = m_buffer[l_in];
-    }
+    // copy instructions from buffer to kernel memory
+    std::memcpy(m_kernel,
+                m_buffer.data(),
+                m_buffer.size());
 
     // clear cache
     char* l_kernel_ptr = reinterpret_cast<char*>(m_kernel);
     __builtin___clear_cache(l_kernel_ptr,
-                            l_kernel_ptr + m_buffer.size() * 4);
+                            l_kernel_ptr + m_buffer.size());
 
     // set executable
     set_exec(m_size_alloc,
@@ -94,7 +114,8 @@ void const* mini_jit::backend::Kernel::get_kernel() const {
 }
 
 void mini_jit::backend::Kernel::release_memory() {
-    if (m_kernel != nullptr) {
+    // memory of arena kernels is released by the arena
+    if (m_kernel != nullptr && m_size_alloc != 0) {
         release_mmap(m_size_alloc,
                      m_kernel);
     }
@@ -111,7 +132,69 @@ void mini_jit::backend::Kernel::write(char const* path) const {
     }
 
     l_out.write(reinterpret_cast<char const*>(m_buffer.data()),
-                m_buffer.size() * 4);
+                m_buffer.size());
+}
+
+void mini_jit::backend::Kernel::store(char const* path,
+                                      uint32_t version,
+                                      uint64_t signature) const {
+    std::ofstream l_out(path,
+                        std::ios::out | std::ios::binary);
+    if (!l_out) {
+        throw std::runtime_error("Failed to open file: " + std::string(path));
+    }
+
+    file_header_t l_header;
+    l_header.magic = FILE_MAGIC;
+    l_header.version = version;
+    l_header.size = m_buffer.size();
+    l_header.signature = signature;
+
+    l_out.write(reinterpret_cast<char const*>(&l_header),
+                sizeof(l_header));
+    l_out.write(reinterpret_cast<char const*>(m_buffer.data()),
+                m_buffer.size());
+    if (!l_out) {
+        throw std::runtime_error("Failed to write file: " + std::string(path));
+    }
+}
+
+bool mini_jit::backend::Kernel::load(char const* path,
+                                     uint32_t version,
+                                     uint64_t signature) {
+    std::ifstream l_in(path,
+                       std::ios::in | std::ios::binary | std::ios::ate);
+    if (!l_in) {
+        return false;
+    }
+
+    // the file has to hold exactly the code announced by a matching header
+    std::streamoff l_size = l_in.tellg();
+    if (l_size <= static_cast<std::streamoff>(sizeof(file_header_t))) {
+        return false;
+    }
+
+    file_header_t l_header;
+    l_in.seekg(0);
+    if (!l_in.read(reinterpret_cast<char*>(&l_header),
+                   sizeof(l_header))) {
+        return false;
+    }
+    if (l_header.magic != FILE_MAGIC ||
+        l_header.version != version ||
+        l_header.signature != signature ||
+        l_header.size != static_cast<uint64_t>(l_size) - sizeof(file_header_t)) {
+        return false;
+    }
+
+    std::vector<uint8_t> l_buffer(l_header.size);
+    if (!l_in.read(reinterpret_cast<char*>(l_buffer.data()),
+                   l_header.size)) {
+        return false;
+    }
+
+    m_buffer.swap(l_buffer);
+    return true;
 }
 
 void mini_jit::backend::Kernel::force_clear() {
@@ -5,6 +5,8 @@
 #ifndef MINI_JIT_KERNEL_H
 #define MINI_JIT_KERNEL_H
 
+#include "CodeArena.h"
+
 namespace mini_jit {
     namespace backend {
         class Kernel;
@@ -12,16 +14,35 @@ namespace mini_jit {
 }  // namespace mini_jit
 
 class mini_jit::backend::Kernel {
+   public:
+    /// header of a stored kernel, checked before the code is loaded
+    struct file_header_t {
+        //! FILE_MAGIC
+        uint32_t magic = 0;
+        //! version of the code generator which produced the code
+        uint32_t version = 0;
+        //! size of the code in bytes
+        uint64_t size = 0;
+        //! hash of the signature of the kernel
+        uint64_t signature = 0;
+    };
+
+    //! magic number of stored kernels, "MJIT" in little-endian order
+    static constexpr uint32_t FILE_MAGIC = 0x54494a4d;
+
    private:
     //! high-level code buffer
-    std::vector<uint32_t> m_buffer;
+    std::vector<uint8_t> m_buffer;
 
-    //! size of the kernel
+    //! size of the kernel, 0 if the kernel lives in an arena
     std::size_t m_size_alloc = 0;
 
     //! executable kernel
     void* m_kernel = nullptr;
 
+    //! arena receiving the kernel, nullptr if the kernel is mapped separately
+    CodeArena* m_arena = nullptr;
+
     /**
      * Allocates memory through POSIX mmap.
      *
@@ -75,6 +96,13 @@ class mini_jit::backend::Kernel {
      **/
     void add_instr(uint32_t ins);
 
+    /**
+     * Adds a variable-length instruction to the code buffer.
+     *
+     * @param ins bytes of the instruction which is added.
+     **/
+    void add_instr(std::vector<uint8_t> const& ins);
+
     /**
      * Gets the size of the code buffer.
      *
@@ -82,6 +110,14 @@ class mini_jit::backend::Kernel {
      **/
     std::size_t get_size() const;
 
+    /**
+     * Places future kernels in the given arena instead of mapping them separately.
+     * The arena owns the memory of these kernels and has to outlive their use.
+     *
+     * @param arena code arena, nullptr maps kernels separately.
+     **/
+    void set_arena(CodeArena* arena);
+
     /**
      * Sets the kernel based on the code buffer.
      **/
@@ -97,9 +133,34 @@ class mini_jit::backend::Kernel {
      *
      * @param path path to the file.
      * disassemble with: objdump -D -b binary -m aarch64 file.bin
+     *               or: objdump -D -b binary -m i386:x86-64 -M intel file.bin
      **/
     void write(char const* path) const;
 
+    /**
+     * Stores the code buffer with a header in the given file.
+     *
+     * @param path path to the file.
+     * @param version version of the code generator.
+     * @param signature hash of the signature of the kernel.
+     **/
+    void store(char const* path,
+               uint32_t version,
+               uint64_t signature) const;
+
+    /**
+     * Replaces the code buffer with the instructions of the given file.
+     * The file is expected to be written by store() with the same version and signature.
+     *
+     * @param path path to the file.
+     * @param version version of the code generator.
+     * @param signature hash of the signature of the kernel.
+     * @return true if the code buffer was read, false if the file is missing, malformed or belongs to another kernel.
+     **/
+    bool load(char const* path,
+              uint32_t version,
+              uint64_t signature);
+
     /**
      * DEBUG: Clears the code buffer.
      **/
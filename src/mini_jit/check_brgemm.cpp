@@ -63,7 +63,8 @@ int main(int argc, char *argv[]) {
 
     l_kernel(l_a, l_b, l_c_2,
              lda, ldb, ldc,
-             br_stride_a, br_stride_b);
+             br_stride_a, br_stride_b,
+             nullptr);
 
     // compare results
     double l_diff = 0.0;
@@ -78,7 +79,8 @@ int main(int argc, char *argv[]) {
     for (uint32_t i = 0; i < 200000; i++) {
         l_kernel(l_a, l_b, l_c_2,
                  lda, ldb, ldc,
-                 br_stride_a, br_stride_b);
+                 br_stride_a, br_stride_b,
+                 nullptr);
     }
     auto tp1 = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(tp1 - tp0).count();
@@ -0,0 +1,329 @@
+#include "Activation.h"
+
+#include <cmath>
+#include <cstring>
+
+using Inst = mini_jit::instructions::InstGen;
+using X86 = mini_jit::instructions::InstGenX86;
+
+namespace {
+    //! indices of the constants
+    constexpr uint32_t CLAMP_HI = 0;
+    constexpr uint32_t CLAMP_LO = 1;
+    constexpr uint32_t ALPHA_13 = 2;
+    constexpr uint32_t BETA_6 = 9;
+    constexpr uint32_t HALF = 13;
+    constexpr uint32_t GELU_C1 = 14;
+    constexpr uint32_t GELU_C2 = 15;
+
+    //! virtual registers of the programs
+    constexpr uint32_t REG_X = 0;
+    constexpr uint32_t REG_T0 = 1;
+    constexpr uint32_t REG_T1 = 2;
+    constexpr uint32_t REG_T2 = 3;
+    constexpr uint32_t REG_T3 = 4;
+
+    //! arrangement 4S of FMLA (vector): Q = 1, sz = 0
+    constexpr Inst::arr_spec_t ARR_4S = static_cast<Inst::arr_spec_t>(0x40000000);
+
+    //! bit pattern of a constant
+    uint32_t bits(float i_value) {
+        uint32_t l_bits;
+        std::memcpy(&l_bits, &i_value, sizeof(l_bits));
+        return l_bits;
+    }
+}  // namespace
+
+namespace mini_jit::generator {
+
+    float const Activation::CONSTANTS[NUM_CONSTANTS] = {
+        // clamp of the input of tanh
+        7.90531110763549805f,
+        -7.90531110763549805f,
+        // numerator, alpha_13 to alpha_1
+        -2.76076847742355e-16f,
+        2.00018790482477e-13f,
+        -8.60467152213735e-11f,
+        5.12229709037114e-08f,
+        1.48572235717979e-05f,
+        6.37261928875436e-04f,
+        4.89352455891786e-03f,
+        // denominator, beta_6 to beta_0
+        1.19825839466702e-06f,
+        1.18534705686654e-04f,
+        2.26843463243900e-03f,
+        4.89352518554385e-03f,
+        // 0.5, sqrt(2 / pi) and 0.044715 * sqrt(2 / pi)
+        0.5f,
+        0.7978845608028654f,
+        0.0356774081363001f};
+
+    bool Activation::is_rational(act_t act) {
+        return act == act_t::gelu || act == act_t::sigmoid || act == act_t::tanh || act == act_t::silu;
+    }
+
+    float Activation::reference(act_t act,
+                                float x) {
+        double l_x = x;
+
+        switch (act) {
+            case act_t::relu:
+                return static_cast<float>(l_x > 0.0 ? l_x : 0.0);
+            case act_t::gelu:
+                return static_cast<float>(0.5 * l_x * (1.0 + std::tanh(0.7978845608028654 * (l_x + 0.044715 * l_x * l_x * l_x))));
+            case act_t::sigmoid:
+                return static_cast<float>(1.0 / (1.0 + std::exp(-l_x)));
+            case act_t::tanh:
+                return static_cast<float>(std::tanh(l_x));
+            case act_t::silu:
+                return static_cast<float>(l_x / (1.0 + std::exp(-l_x)));
+            default:
+                return x;
+        }
+    }
+
+    std::vector<Activation::op_t> Activation::program(act_t act) {
+        using code_t = op_t::code_t;
+        std::vector<op_t> l_ops;
+
+        // tanh and sigmoid overwrite the input with the argument of tanh, gelu and silu need it at the end
+        bool l_in_place = (act == act_t::tanh || act == act_t::sigmoid);
+        uint32_t l_reg_u = l_in_place ? REG_X : REG_T0;
+
+        // argument u of tanh, clamped to the range of the approximation
+        auto l_gen_u = [&]() {
+            uint32_t l_src = REG_X;
+            if (act == act_t::sigmoid || act == act_t::silu) {
+                l_ops.push_back({code_t::load, REG_T3, HALF, 0});
+                l_ops.push_back({code_t::mul, l_reg_u, REG_X, REG_T3});
+                l_src = l_reg_u;
+            } else if (act == act_t::gelu) {
+                l_ops.push_back({code_t::mul, l_reg_u, REG_X, REG_X});
+                l_ops.push_back({code_t::load, REG_T3, GELU_C2, 0});
+                l_ops.push_back({code_t::mul, l_reg_u, l_reg_u, REG_T3});
+                l_ops.push_back({code_t::load, REG_T3, GELU_C1, 0});
+                l_ops.push_back({code_t::add, l_reg_u, l_reg_u, REG_T3});
+                l_ops.push_back({code_t::mul, l_reg_u, l_reg_u, REG_X});
+                l_src = l_reg_u;
+            }
+            l_ops.push_back({code_t::load, REG_T3, CLAMP_HI, 0});
+            l_ops.push_back({code_t::min, l_reg_u, l_src, REG_T3});
+            l_ops.push_back({code_t::load, REG_T3, CLAMP_LO, 0});
+            l_ops.push_back({code_t::max, l_reg_u, l_reg_u, REG_T3});
+        };
+
+        l_gen_u();
+        l_ops.push_back({code_t::mul, REG_T0, l_reg_u, l_reg_u});
+
+        // Horner schemes in u^2, the registers of coefficient and partial result alternate
+        auto l_gen_horner = [&](uint32_t i_first, uint32_t i_count, uint32_t i_reg_a, uint32_t i_reg_b) {
+            l_ops.push_back({code_t::load, i_reg_a, i_first, 0});
+            for (uint32_t l_co = 1; l_co < i_count; l_co++) {
+                l_ops.push_back({code_t::load, i_reg_b, i_first + l_co, 0});
+                l_ops.push_back({code_t::fma, i_reg_b, i_reg_a, REG_T0});
+                std::swap(i_reg_a, i_reg_b);
+            }
+            return i_reg_a;
+        };
+
+        // denominator in T2, numerator in T1
+        uint32_t l_reg_q = l_gen_horner(BETA_6, 4, REG_T1, REG_T2);
+        uint32_t l_reg_p = l_gen_horner(ALPHA_13, 7, REG_T1, REG_T3);
+
+        if (!l_in_place) {
+            l_gen_u();
+        }
+        l_ops.push_back({code_t::mul, l_reg_p, l_reg_p, l_reg_u});
+
+        if (act == act_t::tanh) {
+            l_ops.push_back({code_t::div, REG_X, l_reg_p, l_reg_q});
+        } else {
+            l_ops.push_back({code_t::div, l_reg_p, l_reg_p, l_reg_q});
+
+            // 0.5 + 0.5 * tanh(u)
+            uint32_t l_reg_s = (act == act_t::sigmoid) ? REG_X : REG_T0;
+            l_ops.push_back({code_t::load, l_reg_s, HALF, 0});
+            l_ops.push_back({code_t::fma, l_reg_s, l_reg_p, l_reg_s});
+            if (act != act_t::sigmoid) {
+                l_ops.push_back({code_t::mul, REG_X, REG_X, l_reg_s});
+            }
+        }
+
+        return l_ops;
+    }
+
+    void Activation::gen_table_neon(backend::Kernel& i_kernel,
+                                    Inst::gpr_t i_table) {
+        i_kernel.add_instr(Inst::base_adr(i_table, 8));
+        i_kernel.add_instr(Inst::base_b(1 + 4 * NUM_CONSTANTS));
+        for (uint32_t l_co = 0; l_co < NUM_CONSTANTS; l_co++) {
+            for (uint32_t l_la = 0; l_la < 4; l_la++) {
+                i_kernel.add_instr(bits(CONSTANTS[l_co]));
+            }
+        }
+    }
+
+    void Activation::gen_neon(backend::Kernel& i_kernel,
+                              act_t i_act,
+                              uint32_t i_first,
+                              uint32_t i_count,
+                              Inst::gpr_t i_table) {
+        std::vector<op_t> l_ops = program(i_act);
+
+        for (uint32_t l_re = i_first; l_re < i_first + i_count; l_re++) {
+            auto l_reg = [&](uint32_t i_virtual) {
+                return static_cast<Inst::simd_fp_t>(i_virtual == REG_X ? l_re : Inst::v28 + i_virtual - 1);
+            };
+
+            for (op_t const& l_op : l_ops) {
+                Inst::simd_fp_t l_dst = l_reg(l_op.dst);
+                Inst::simd_fp_t l_src1 = l_reg(l_op.src1);
+                Inst::simd_fp_t l_src2 = l_reg(l_op.src2);
+
+                switch (l_op.code) {
+                    case op_t::code_t::load:
+                        i_kernel.add_instr(Inst::neon_ldr_q_imm(l_dst, i_table, 16 * l_op.src1));
+                        break;
+                    case op_t::code_t::add:
+                        i_kernel.add_instr(Inst::neon_fadd_vector(l_dst, l_src1, l_src2, false));
+                        break;
+                    case op_t::code_t::mul:
+                        i_kernel.add_instr(Inst::neon_fmul_vector(l_dst, l_src1, l_src2, false));
+                        break;
+                    case op_t::code_t::div:
+                        i_kernel.add_instr(Inst::neon_fdiv_vector(l_dst, l_src1, l_src2, false));
+                        break;
+                    case op_t::code_t::min:
+                        i_kernel.add_instr(Inst::neon_fmin_vector(l_dst, l_src1, l_src2, false));
+                        break;
+                    case op_t::code_t::max:
+                        i_kernel.add_instr(Inst::neon_fmax_vector(l_dst, l_src1, l_src2, false));
+                        break;
+                    case op_t::code_t::fma:
+                        i_kernel.add_instr(Inst::neon_fmla_vector(l_dst, l_src1, l_src2, ARR_4S));
+                        break;
+                }
+            }
+        }
+    }
+
+    void Activation::gen_table_sve(backend::Kernel& i_kernel,
+                                   Inst::gpr_t i_table) {
+        i_kernel.add_instr(Inst::base_adr(i_table, 8));
+        i_kernel.add_instr(Inst::base_b(1 + NUM_CONSTANTS));
+        for (uint32_t l_co = 0; l_co < NUM_CONSTANTS; l_co++) {
+            i_kernel.add_instr(bits(CONSTANTS[l_co]));
+        }
+    }
+
+    void Activation::gen_sve(backend::Kernel& i_kernel,
+                             act_t i_act,
+                             uint32_t i_count,
+                             Inst::pred_t i_pred,
+                             Inst::gpr_t i_table) {
+        std::vector<op_t> l_ops = program(i_act);
+
+        for (uint32_t l_re = 0; l_re < i_count; l_re++) {
+            auto l_reg = [&](uint32_t i_virtual) {
+                return static_cast<Inst::simd_fp_t>(i_virtual == REG_X ? l_re : Inst::v24 + i_virtual - 1);
+            };
+
+            for (op_t const& l_op : l_ops) {
+                Inst::simd_fp_t l_dst = l_reg(l_op.dst);
+                Inst::simd_fp_t l_src1 = l_reg(l_op.src1);
+                Inst::simd_fp_t l_src2 = l_reg(l_op.src2);
+
+                // the predicated instructions are destructive, min and max commute
+                bool l_commutes = (l_op.code == op_t::code_t::min || l_op.code == op_t::code_t::max);
+                if (l_commutes && l_dst == l_src2) {
+                    std::swap(l_src1, l_src2);
+                }
+
+                switch (l_op.code) {
+                    case op_t::code_t::load:
+                        i_kernel.add_instr(Inst::sve_ld1rw(l_dst, i_pred, i_table, 4 * l_op.src1));
+                        break;
+                    case op_t::code_t::add:
+                        i_kernel.add_instr(Inst::sve_fadd(l_dst, l_src1, l_src2));
+                        break;
+                    case op_t::code_t::mul:
+                        i_kernel.add_instr(Inst::sve_fmul(l_dst, l_src1, l_src2));
+                        break;
+                    case op_t::code_t::fma:
+                        i_kernel.add_instr(Inst::sve_fmla(l_dst, i_pred, l_src1, l_src2));
+                        break;
+                    default:
+                        if (l_dst != l_src1) {
+                            i_kernel.add_instr(Inst::sve_mov(l_dst, l_src1));
+                        }
+                        if (l_op.code == op_t::code_t::div) {
+                            i_kernel.add_instr(Inst::sve_fdiv(l_dst, i_pred, l_src2));
+                        } else if (l_op.code == op_t::code_t::min) {
+                            i_kernel.add_instr(Inst::sve_fmin(l_dst, i_pred, l_src2));
+                        } else {
+                            i_kernel.add_instr(Inst::sve_fmax(l_dst, i_pred, l_src2));
+                        }
+                        break;
+                }
+            }
+        }
+    }
+
+    void Activation::gen_table_x86(backend::Kernel& i_kernel,
+                                   X86::mem_t i_table) {
+        for (uint32_t l_co = 0; l_co < NUM_CONSTANTS; l_co++) {
+            X86::mem_t l_mem = i_table;
+            l_mem.disp += 4 * l_co;
+            i_kernel.add_instr(X86::base_mov_store_imm32(l_mem, static_cast<int32_t>(bits(CONSTANTS[l_co]))));
+        }
+    }
+
+    void Activation::gen_x86(backend::Kernel& i_kernel,
+                             bool i_avx512,
+                             act_t i_act,
+                             uint32_t i_count,
+                             uint32_t i_temp,
+                             X86::mem_t i_table) {
+        std::vector<op_t> l_ops = program(i_act);
+
+        for (uint32_t l_re = 0; l_re < i_count; l_re++) {
+            auto l_reg = [&](uint32_t i_virtual) {
+                return static_cast<X86::simd_t>(i_virtual == REG_X ? l_re : i_temp + i_virtual - 1);
+            };
+
+            for (op_t const& l_op : l_ops) {
+                X86::simd_t l_dst = l_reg(l_op.dst);
+                X86::simd_t l_src1 = l_reg(l_op.src1);
+                X86::simd_t l_src2 = l_reg(l_op.src2);
+
+                switch (l_op.code) {
+                    case op_t::code_t::load: {
+                        X86::mem_t l_mem = i_table;
+                        l_mem.disp += 4 * l_op.src1;
+                        i_kernel.add_instr(i_avx512 ? X86::avx512_vbroadcastss(l_dst, l_mem) : X86::avx_vbroadcastss(l_dst, l_mem));
+                        break;
+                    }
+                    case op_t::code_t::add:
+                        i_kernel.add_instr(i_avx512 ? X86::avx512_vaddps(l_dst, l_src1, l_src2) : X86::avx_vaddps(l_dst, l_src1, l_src2));
+                        break;
+                    case op_t::code_t::mul:
+                        i_kernel.add_instr(i_avx512 ? X86::avx512_vmulps(l_dst, l_src1, l_src2) : X86::avx_vmulps(l_dst, l_src1, l_src2));
+                        break;
+                    case op_t::code_t::div:
+                        i_kernel.add_instr(i_avx512 ? X86::avx512_vdivps(l_dst, l_src1, l_src2) : X86::avx_vdivps(l_dst, l_src1, l_src2));
+                        break;
+                    case op_t::code_t::min:
+                        i_kernel.add_instr(i_avx512 ? X86::avx512_vminps(l_dst, l_src1, l_src2) : X86::avx_vminps(l_dst, l_src1, l_src2));
+                        break;
+                    case op_t::code_t::max:
+                        i_kernel.add_instr(i_avx512 ? X86::avx512_vmaxps(l_dst, l_src1, l_src2) : X86::avx_vmaxps(l_dst, l_src1, l_src2));
+                        break;
+                    case op_t::code_t::fma:
+                        i_kernel.add_instr(i_avx512 ? X86::avx512_vfmadd231ps(l_dst, l_src1, l_src2) : X86::avx_vfmadd231ps(l_dst, l_src1, l_src2));
+                        break;
+                }
+            }
+        }
+    }
+
+}  // namespace mini_jit::generator
@@ -0,0 +1,142 @@
+#ifndef MINI_JIT_GENERATOR_ACTIVATION_H
+#define MINI_JIT_GENERATOR_ACTIVATION_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../backend/Kernel.h"
+#include "../instructions/instructions.h"
+#include "../instructions/instructions_x86.h"
+
+namespace mini_jit::generator {
+    class Activation;
+}
+
+/**
+ * Vectorized activation functions applied to registers before they are stored.
+ *
+ * tanh is evaluated through a rational approximation, tanh(x) ~ x * P(x^2) / Q(x^2)
+ * with a numerator of degree 13 and a denominator of degree 6 on the clamped input
+ * |x| <= 7.9053, its absolute error is below 3e-7. The other functions are derived
+ * from it:
+ *   sigmoid(x) = 0.5 + 0.5 * tanh(x / 2)
+ *   silu(x)    = x * sigmoid(x)
+ *   gelu(x)    = x * (0.5 + 0.5 * tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+ *
+ * The generated code reads its constants from a table, four temporary vector
+ * registers hold the intermediate values.
+ **/
+class mini_jit::generator::Activation {
+   public:
+    /// activation function
+    enum class act_t : uint32_t {
+        none = 0,
+        relu = 1,
+        gelu = 2,
+        sigmoid = 3,
+        tanh = 4,
+        silu = 5
+    };
+
+    //! number of constants in the table
+    static constexpr uint32_t NUM_CONSTANTS = 16;
+
+    //! constants used by the generated code
+    static float const CONSTANTS[NUM_CONSTANTS];
+
+    /**
+     * @brief Returns true if the activation is evaluated through the rational approximation of tanh.
+     **/
+    static bool is_rational(act_t act);
+
+    /**
+     * @brief Scalar reference of the activation function, evaluated in double precision.
+     **/
+    static float reference(act_t act,
+                           float x);
+
+    /**
+     * @brief Generates the NEON constant table: the address of the table is written to i_table
+     *        and the table itself is branched over. Every constant is replicated to four lanes.
+     **/
+    static void gen_table_neon(backend::Kernel& i_kernel,
+                               instructions::InstGen::gpr_t i_table);
+
+    /**
+     * @brief Generates a rational activation of the 128-bit registers v<i_first>, ..., v<i_first + i_count - 1>.
+     *
+     * v28-v31 are used as temporary registers.
+     **/
+    static void gen_neon(backend::Kernel& i_kernel,
+                         act_t i_act,
+                         uint32_t i_first,
+                         uint32_t i_count,
+                         instructions::InstGen::gpr_t i_table);
+
+    /**
+     * @brief Generates the SVE constant table, see gen_table_neon. Every constant is stored once.
+     **/
+    static void gen_table_sve(backend::Kernel& i_kernel,
+                              instructions::InstGen::gpr_t i_table);
+
+    /**
+     * @brief Generates a rational activation of the SVE registers z0, ..., z<i_count - 1>.
+     *
+     * z24-z27 are used as temporary registers.
+     *
+     * @param i_pred predicate with all lanes active.
+     **/
+    static void gen_sve(backend::Kernel& i_kernel,
+                        act_t i_act,
+                        uint32_t i_count,
+                        instructions::InstGen::pred_t i_pred,
+                        instructions::InstGen::gpr_t i_table);
+
+    /**
+     * @brief Generates the stores of the constant table to memory, NUM_CONSTANTS 32-bit values starting at i_table.
+     **/
+    static void gen_table_x86(backend::Kernel& i_kernel,
+                              instructions::InstGenX86::mem_t i_table);
+
+    /**
+     * @brief Generates a rational activation of the registers ymm0/zmm0, ..., ymm/zmm<i_count - 1>.
+     *
+     * @param i_avx512 true for zmm registers, false for ymm registers.
+     * @param i_temp first of four consecutive temporary registers.
+     * @param i_table constant table written by gen_table_x86.
+     **/
+    static void gen_x86(backend::Kernel& i_kernel,
+                        bool i_avx512,
+                        act_t i_act,
+                        uint32_t i_count,
+                        uint32_t i_temp,
+                        instructions::InstGenX86::mem_t i_table);
+
+   private:
+    /// operation on virtual registers: 0 is the activated register, 1-4 are the temporaries
+    struct op_t {
+        enum class code_t : uint32_t {
+            //! dst = constant src1 in all lanes
+            load,
+            add,
+            mul,
+            div,
+            min,
+            max,
+            //! dst += src1 * src2
+            fma
+        };
+
+        code_t code;
+        uint32_t dst;
+        uint32_t src1;
+        uint32_t src2;
+    };
+
+    /**
+     * @brief ISA independent sequence of operations computing the activation of one register.
+     **/
+    static std::vector<op_t> program(act_t act);
+};
+
+#endif
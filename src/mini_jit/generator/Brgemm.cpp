@@ -1,12 +1,20 @@
 #include "Brgemm.h"
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 #include "../instructions/instructions.h"
+#include "TuningTable.h"
 #include "Util.h"
 
 namespace inst = mini_jit::instructions;
 
+namespace {
+    //! offset of the bias argument on the stack once the callee-saved registers are stored
+    constexpr uint32_t BIAS_ARG_OFFSET = 9 * 16;
+}  // namespace
+
 void mini_jit::generator::Brgemm::gen_microkernel(backend::Kernel& i_kernel,
                                                   Util::KernelSize& i_kernelsize,
                                                   int32_t i_used_reg_count) {
@@ -18,6 +26,13 @@ void mini_jit::generator::Brgemm::gen_microkernel(backend::Kernel& i_kernel,
     l_m_block[0] = i_kernelsize.M / 4;
     l_m_block[1] = i_kernelsize.M % 4;
 
+    // prefetch A of a later K iteration
+    if (m_prefetch.k_distance > 0) {
+        i_kernel.add_instr(inst::InstGen::base_prfm_register(inst::InstGen::pldl1keep,
+                                                             Util::WORKING_ADDRESS_A_REG,
+                                                             Util::PREFETCH_OFFSET_A_REG));
+    }
+
     // load values for A
     if (l_m_block[0] > 0) {
         inst::InstGen::vector_count_t v_count;
@@ -105,7 +120,137 @@ void mini_jit::generator::Brgemm::gen_microkernel(backend::Kernel& i_kernel,
                                                             inst::InstGen::element_spec_t::S4_0));
     }
 }
-// TODO: remove transpose parameter
+void mini_jit::generator::Brgemm::gen_prefetch_br_a(Util::KernelSize const& i_kernelsize) {
+    if (!m_prefetch.next_br) {
+        return;
+    }
+
+    // column of A of the next batch-reduce iteration, one step per K iteration
+    uint32_t l_lines_a = (i_kernelsize.M * 4 + 63) / 64;
+    if (l_lines_a == 1) {
+        m_kernel.add_instr(inst::InstGen::base_prfm_register(inst::InstGen::pldl2keep,
+                                                             Util::WORKING_ADDRESS_A_REG,
+                                                             Util::BR_STRIDE_A));
+        return;
+    }
+
+    m_kernel.add_instr(inst::InstGen::base_add_shifted_register(Util::HELP_REG_3,
+                                                                Util::WORKING_ADDRESS_A_REG,
+                                                                Util::BR_STRIDE_A,
+                                                                0,
+                                                                0));
+    for (uint32_t l_li = 0; l_li < l_lines_a; l_li++) {
+        m_kernel.add_instr(inst::InstGen::base_prfm_imm(inst::InstGen::pldl2keep, Util::HELP_REG_3, l_li * 64));
+    }
+}
+
+void mini_jit::generator::Brgemm::gen_prefetch_br_b(Util::KernelSize const& i_kernelsize,
+                                                    uint32_t k,
+                                                    int32_t i_m_count_first) {
+    if (!m_prefetch.next_br) {
+        return;
+    }
+
+    // the block of B is shared by all M blocks, only the first one prefetches it
+    m_kernel.add_instr(inst::InstGen::base_mov_imm(Util::K_LOOP_COUNT_REG, i_m_count_first, 0));
+    m_kernel.add_instr(inst::InstGen::base_sub_shifted_register(Util::K_LOOP_COUNT_REG,
+                                                                Util::M_LOOP_COUNT_REG,
+                                                                Util::K_LOOP_COUNT_REG,
+                                                                0,
+                                                                0));
+    // skips the add, the counter setup and the loop of N prefetches, an add and the cbnz
+    m_kernel.add_instr(inst::InstGen::base_br_cbnz(Util::K_LOOP_COUNT_REG, i_kernelsize.N + 6));
+
+    // block of B of the next batch-reduce iteration, one cache line of all columns per iteration
+    m_kernel.add_instr(inst::InstGen::base_add_shifted_register(Util::HELP_REG_3,
+                                                                Util::WORKING_ADDRESS_B_REG,
+                                                                Util::BR_STRIDE_B,
+                                                                0,
+                                                                0));
+    m_kernel.add_instr(inst::InstGen::base_mov_imm(Util::K_LOOP_COUNT_REG, (k * 4 + 63) / 64, 0));
+    m_kernel.add_instr(inst::InstGen::base_sub_imm(Util::K_LOOP_COUNT_REG,
+                                                   Util::K_LOOP_COUNT_REG,
+                                                   1,
+                                                   0));
+    std::size_t l_loop_pos = m_kernel.get_size();
+
+    // the column offsets are held in x20 onwards
+    m_kernel.add_instr(inst::InstGen::base_prfm_imm(inst::InstGen::pldl2keep, Util::HELP_REG_3, 0));
+    for (int32_t l_n = 1; l_n < i_kernelsize.N; l_n++) {
+        m_kernel.add_instr(inst::InstGen::base_prfm_register(inst::InstGen::pldl2keep,
+                                                             Util::HELP_REG_3,
+                                                             static_cast<inst::InstGen::gpr_t>(inst::InstGen::x19 + l_n)));
+    }
+    m_kernel.add_instr(inst::InstGen::base_add_imm(Util::HELP_REG_3,
+                                                   Util::HELP_REG_3,
+                                                   64,
+                                                   0));
+    m_kernel.add_instr(inst::InstGen::base_br_cbnz(Util::K_LOOP_COUNT_REG,
+                                                   (l_loop_pos - m_kernel.get_size()) / 4 - 1));
+}
+
+void mini_jit::generator::Brgemm::gen_load_block(Util::KernelSize& i_kernelsize) {
+    if (m_bias == bias_t::none) {
+        Util::generator_load_reg_block(m_kernel, i_kernelsize, Util::WORKING_ADDRESS_C_REG);
+        return;
+    }
+
+    // accumulators of column j: j * l_m_vectors to (j + 1) * l_m_vectors - 1, four rows each
+    int32_t l_m_vectors = (i_kernelsize.M + 3) / 4;
+    if (m_bias == bias_t::zero) {
+        for (int32_t l_reg = 0; l_reg < i_kernelsize.N * l_m_vectors; l_reg++) {
+            m_kernel.add_instr(inst::InstGen::neon_movi_zero(static_cast<inst::InstGen::simd_fp_t>(l_reg), true, false));
+        }
+        return;
+    }
+
+    m_kernel.add_instr(inst::InstGen::base_mov_register(Util::HELP_REG_3, Util::BIAS_REG));
+
+    for (int32_t l_n = 0; l_n < i_kernelsize.N; l_n++) {
+        for (int32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+            auto l_reg = static_cast<inst::InstGen::simd_fp_t>(l_n * l_m_vectors + l_mv);
+
+            if (m_bias == bias_t::n) {
+                m_kernel.add_instr(inst::InstGen::neon_ld1r(l_reg, Util::HELP_REG_3));
+                continue;
+            }
+
+            int32_t l_rows = std::min(4, i_kernelsize.M - 4 * l_mv);
+            if (l_rows == 4) {
+                m_kernel.add_instr(inst::InstGen::neon_ldr(l_reg, Util::HELP_REG_3, 16, inst::InstGen::arr_spec_t::q));
+            } else if (l_rows == 1) {
+                m_kernel.add_instr(inst::InstGen::neon_ldr(l_reg, Util::HELP_REG_3, 4, inst::InstGen::arr_spec_t::s));
+            } else {
+                m_kernel.add_instr(inst::InstGen::neon_ldr(l_reg, Util::HELP_REG_3, 8, inst::InstGen::arr_spec_t::d));
+                if (l_rows == 3) {
+                    m_kernel.add_instr(inst::InstGen::neon_ld1_scalar_index(l_reg, Util::HELP_REG_3, 2));
+                    m_kernel.add_instr(inst::InstGen::base_add_imm(Util::HELP_REG_3, Util::HELP_REG_3, 4, 0));
+                }
+            }
+        }
+
+        if (m_bias == bias_t::n) {
+            // value of the next column
+            m_kernel.add_instr(inst::InstGen::base_add_imm(Util::HELP_REG_3, Util::HELP_REG_3, 4, 0));
+        } else {
+            // the same rows for the next column
+            m_kernel.add_instr(inst::InstGen::base_sub_imm(Util::HELP_REG_3, Util::HELP_REG_3, i_kernelsize.M * 4, 0));
+        }
+    }
+}
+
+void mini_jit::generator::Brgemm::gen_bias_step(int32_t i_m_bytes,
+                                                int32_t i_n_columns) {
+    // the bias has the data type of C
+    int32_t l_size = (m_dtype == dtype_t::fp64) ? 8 : (m_dtype == dtype_t::fp16) ? 2 : 4;
+
+    if (m_bias == bias_t::m && i_m_bytes > 0) {
+        m_kernel.add_instr(inst::InstGen::base_add_imm(Util::BIAS_REG, Util::BIAS_REG, i_m_bytes, 0));
+    } else if (m_bias == bias_t::n && i_n_columns > 0) {
+        m_kernel.add_instr(inst::InstGen::base_add_imm(Util::BIAS_REG, Util::BIAS_REG, i_n_columns * l_size, 0));
+    }
+}
+
 mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint32_t m,
                                                                            uint32_t n,
                                                                            uint32_t k,
@@ -114,9 +259,104 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                            uint32_t trans_b,
                                                                            uint32_t trans_c,
                                                                            dtype_t dtype,
-                                                                           bool is_relu) {
-    BRGEMM_EXPECT((trans_a | trans_b | trans_c) == 0);
-    BRGEMM_EXPECT(dtype == dtype_t::fp32);
+                                                                           bool is_relu,
+                                                                           bias_t bias,
+                                                                           act_t act) {
+    BRGEMM_EXPECT(dtype == dtype_t::fp32 || dtype == dtype_t::fp64 || dtype == dtype_t::bf16 || dtype == dtype_t::int8 || dtype == dtype_t::fp16 || dtype == dtype_t::fp16_fp32);
+    BRGEMM_EXPECT(dtype == dtype_t::fp32 || (trans_a | trans_b | trans_c) == 0);
+    m_dtype = dtype;
+    m_bias = bias;
+
+    // a row-major C is the column-major C^T = B^T * A^T, the operands swap their roles and layouts
+    m_swap_ab = (trans_c != 0);
+    m_trans_a = m_swap_ab ? (trans_b == 0) : (trans_a != 0);
+    m_trans_b = m_swap_ab ? (trans_a == 0) : (trans_b != 0);
+    if (m_swap_ab) {
+        std::swap(m, n);
+        if (m_bias == bias_t::m || m_bias == bias_t::n) {
+            m_bias = (m_bias == bias_t::m) ? bias_t::n : bias_t::m;
+        }
+    }
+    bool l_transposed = m_trans_a || m_trans_b || m_swap_ab;
+    m_act = is_relu ? act_t::relu : act;
+    is_relu = (m_act == act_t::relu);
+
+    // the rational activations are evaluated in single precision only
+    BRGEMM_EXPECT((m_dtype != dtype_t::fp64 && m_dtype != dtype_t::fp16) || !Activation::is_rational(m_act));
+
+    // the int8 scales are per column of C, the bias argument holds them
+    BRGEMM_EXPECT(m_dtype != dtype_t::int8 || m_bias != bias_t::m);
+
+    // register blocking found by the autotuner, the table holds single precision blockings of column-major operands
+    if (m_blocking.m_vectors == 0 && m_blocking.n == 0 && m_dtype == dtype_t::fp32 && !l_transposed) {
+        TuningTable::lookup(m, n, k, br_size, m_blocking);
+    }
+
+#if defined(__x86_64__)
+    return generate_x86(m, n, k, br_size, is_relu);
+#else
+    if (m_dtype == dtype_t::fp64) {
+        return generate_fp64(m, n, k, br_size, is_relu);
+    }
+    if (m_dtype == dtype_t::bf16) {
+        return generate_bf16(m, n, k, br_size);
+    }
+    if (m_dtype == dtype_t::int8) {
+        return generate_int8(m, n, k, br_size);
+    }
+    if (m_dtype == dtype_t::fp16 || m_dtype == dtype_t::fp16_fp32) {
+        return generate_fp16(m, n, k, br_size, is_relu);
+    }
+    if (l_transposed) {
+        return generate_trans(m, n, k, br_size, is_relu);
+    }
+    if (backend::Cpu::get_isa() == backend::Cpu::isa_t::sve) {
+        return generate_sve(m, n, k, br_size, is_relu);
+    }
+
+    Util::KernelSize kernelsize_big;
+    Util::KernelSize kernelsize_reminder_big;
+    Util::KernelSize kernelsize_small;
+    Util::KernelSize kernelsize_reminder_small;
+    int reg_count_big = 0;
+    int reg_count_small = 0;
+    int reg_count_reminder_big = 0;
+    int reg_count_reminder_small = 0;
+    std::size_t br_loop_pos = 0;
+    Util::get_kernel_sizes_brgemm(m, n, kernelsize_big, kernelsize_small, reg_count_big, reg_count_small);
+
+    // explicit register blocking, four rows per vector register
+    if (m_blocking.m_vectors > 0 || m_blocking.n > 0) {
+        if (m_blocking.m_vectors > 0) {
+            BRGEMM_EXPECT(m_blocking.m_vectors <= 4);
+            kernelsize_big.M = std::min<int32_t>(m_blocking.m_vectors * 4, m);
+            kernelsize_small.M = kernelsize_big.M;
+        }
+        if (m_blocking.n > 0) {
+            kernelsize_big.N = std::min<int32_t>(m_blocking.n, n);
+        }
+        kernelsize_small.N = n % kernelsize_big.N;
+
+        // accumulators, A and at least one B register, B offsets in x20-x27
+        int32_t l_m_blocks = (kernelsize_big.M + 3) / 4;
+        BRGEMM_EXPECT(kernelsize_big.N <= 9);
+        BRGEMM_EXPECT(l_m_blocks * kernelsize_big.N + l_m_blocks + 1 <= 32);
+
+        reg_count_big = l_m_blocks * kernelsize_big.N;
+        reg_count_small = l_m_blocks * kernelsize_small.N;
+    }
+
+    int full_m_loop = m / kernelsize_big.M;
+    int rem_m_loop = m % kernelsize_big.M;
+
+    int full_n_loop = n / kernelsize_big.N;
+    int rem_n_loop = n % kernelsize_big.N;
+
+    kernelsize_reminder_big.M = rem_m_loop;
+    kernelsize_reminder_big.N = kernelsize_big.N;
+
+    kernelsize_reminder_small.M = rem_m_loop;
+    kernelsize_reminder_small.N = kernelsize_small.N;
 
     // procedure call standard (store to stack)
     // GR
@@ -154,34 +394,24 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
     m_kernel.add_instr(0xd37ef631);
     m_kernel.add_instr(0xd37ef673);
 
-    Util::KernelSize kernelsize_big;
-    Util::KernelSize kernelsize_reminder_big;
-    Util::KernelSize kernelsize_small;
-    Util::KernelSize kernelsize_reminder_small;
-    int reg_count_big = 0;
-    int reg_count_small = 0;
-    int reg_count_reminder_big = 0;
-    int reg_count_reminder_small = 0;
-    std::size_t br_loop_pos = 0;
-    Util::get_kernel_sizes_brgemm(m, n, kernelsize_big, kernelsize_small, reg_count_big, reg_count_small);
-
-    int full_m_loop = m / kernelsize_big.M;
-    int rem_m_loop = m % kernelsize_big.M;
-
-    int full_n_loop = n / kernelsize_big.N;
-    int rem_n_loop = n % kernelsize_big.N;
-
-    kernelsize_reminder_big.M = rem_m_loop;
-    kernelsize_reminder_big.N = kernelsize_big.N;
+    /* pointer to the bias, the ninth argument is passed on the stack */
+    if (m_bias == bias_t::m || m_bias == bias_t::n) {
+        m_kernel.add_instr(inst::InstGen::base_ldr_imm(Util::BIAS_REG, inst::InstGen::sp, BIAS_ARG_OFFSET));
+    }
 
-    kernelsize_reminder_small.M = rem_m_loop;
-    kernelsize_reminder_small.N = kernelsize_small.N;
+    /* offset of the prefetched A values */
+    if (m_prefetch.k_distance > 0) {
+        m_kernel.add_instr(inst::InstGen::base_mov_imm(Util::PREFETCH_OFFSET_A_REG, m_prefetch.k_distance, 0));
+        m_kernel.add_instr(inst::InstGen::base_mul_reg(Util::PREFETCH_OFFSET_A_REG,
+                                                       Util::PREFETCH_OFFSET_A_REG,
+                                                       Util::LEADING_DIM_A_REG));
+    }
 
     // write offsets for faster loads in B
-    for (size_t i = 1; i < kernelsize_big.N; i++) {
+    for (int32_t i = 1; i < kernelsize_big.N; i++) {
         m_kernel.add_instr(inst::InstGen::base_mov_imm(static_cast<inst::InstGen::gpr_t>(inst::InstGen::gpr_t::x19 + i), i, 0));
     }
-    for (size_t i = 1; i < kernelsize_big.N; i++) {
+    for (int32_t i = 1; i < kernelsize_big.N; i++) {
         m_kernel.add_instr(inst::InstGen::base_mul_reg(static_cast<inst::InstGen::gpr_t>(inst::InstGen::gpr_t::x19 + i),
                                                        static_cast<inst::InstGen::gpr_t>(inst::InstGen::gpr_t::x19 + i),
                                                        static_cast<inst::InstGen::gpr_t>(Util::LEADING_DIM_B_REG)));
@@ -209,7 +439,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
         // get M loop position
         std::size_t m_loop_pos = m_kernel.get_size();
 
-        Util::generator_load_reg_block(m_kernel, kernelsize_big, Util::WORKING_ADDRESS_C_REG);
+        gen_load_block(kernelsize_big);
 
         if (br_size > 1) {
             // set BR loop counter
@@ -221,6 +451,8 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                            0));
             // get BR loop position
             br_loop_pos = m_kernel.get_size();
+
+            gen_prefetch_br_b(kernelsize_big, k, full_m_loop - 1);
         }
         // set K loop  counter
         m_kernel.add_instr(inst::InstGen::base_mov_imm(Util::K_LOOP_COUNT_REG, k, 0));
@@ -243,6 +475,9 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
         // get k loop position
         std::size_t k_loop_pos = m_kernel.get_size();
 
+        if (br_size > 1) {
+            gen_prefetch_br_a(kernelsize_big);
+        }
         mini_jit::generator::Brgemm::gen_microkernel(m_kernel, kernelsize_big, reg_count_big);
 
         // adjust Working A and B
@@ -310,7 +545,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                         0));
         }
 
-        Util::generator_store_reg_block(m_kernel, kernelsize_big, Util::WORKING_ADDRESS_C_REG, is_relu);
+        Util::generator_store_reg_block(m_kernel, kernelsize_big, Util::WORKING_ADDRESS_C_REG, is_relu, m_act);
 
         // restore Working A
         if (br_size < 2) {
@@ -341,6 +576,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                        Util::WORKING_ADDRESS_C_REG,
                                                        kernelsize_big.M * 4,
                                                        0));
+        gen_bias_step(kernelsize_big.M * 4, 0);
 
         /* cbnz M loop */
         m_kernel.add_instr(inst::InstGen::base_br_cbnz(Util::M_LOOP_COUNT_REG,
@@ -350,7 +586,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
         // compute M reminder block
         /****************************/
         if (rem_m_loop > 0) {
-            Util::generator_load_reg_block(m_kernel, kernelsize_reminder_big, Util::WORKING_ADDRESS_C_REG);
+            gen_load_block(kernelsize_reminder_big);
 
             if (br_size > 1) {
                 // set BR loop counter
@@ -360,7 +596,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                Util::BR_LOOP_COUNT_REG,
                                                                1,
                                                                0));
-                // get BR loop position
+                // get BR loop position, B was prefetched by the first M block
                 br_loop_pos = m_kernel.get_size();
             }
 
@@ -386,6 +622,9 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
 
             reg_count_reminder_big = ((kernelsize_reminder_big.M + 3) / 4) * kernelsize_reminder_big.N;
 
+            if (br_size > 1) {
+                gen_prefetch_br_a(kernelsize_reminder_big);
+            }
             mini_jit::generator::Brgemm::gen_microkernel(m_kernel, kernelsize_reminder_big, reg_count_reminder_big);
 
             // adjust Working A and B
@@ -454,7 +693,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                             0));
             }
 
-            Util::generator_store_reg_block(m_kernel, kernelsize_reminder_big, Util::WORKING_ADDRESS_C_REG, is_relu);
+            Util::generator_store_reg_block(m_kernel, kernelsize_reminder_big, Util::WORKING_ADDRESS_C_REG, is_relu, m_act);
         }
 
         // restore Working A
@@ -497,6 +736,12 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                     0,
                                                                     0));
 
+        // bias of the next column block, back at the first row
+        if (m_bias == bias_t::m) {
+            m_kernel.add_instr(inst::InstGen::base_ldr_imm(Util::BIAS_REG, inst::InstGen::sp, BIAS_ARG_OFFSET));
+        }
+        gen_bias_step(0, kernelsize_big.N);
+
         // cbnz N loop
         m_kernel.add_instr(inst::InstGen::base_br_cbnz(Util::N_LOOP_COUNT_REG,
                                                        (n_loop_pos - m_kernel.get_size()) / 4 - 1));
@@ -516,7 +761,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
         // get M loop position
         std::size_t m_loop_pos = m_kernel.get_size();
 
-        Util::generator_load_reg_block(m_kernel, kernelsize_small, Util::WORKING_ADDRESS_C_REG);
+        gen_load_block(kernelsize_small);
         if (br_size > 1) {
             // set BR loop counter
             m_kernel.add_instr(inst::InstGen::base_mov_imm(Util::BR_LOOP_COUNT_REG, br_size, 0));
@@ -527,6 +772,8 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                            0));
             // get BR loop position
             br_loop_pos = m_kernel.get_size();
+
+            gen_prefetch_br_b(kernelsize_small, k, full_m_loop - 1);
         }
         // set K loop  counter
         m_kernel.add_instr(inst::InstGen::base_mov_imm(Util::K_LOOP_COUNT_REG, k, 0));
@@ -547,6 +794,9 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
         // get k loop position
         std::size_t k_loop_pos = m_kernel.get_size();
 
+        if (br_size > 1) {
+            gen_prefetch_br_a(kernelsize_small);
+        }
         mini_jit::generator::Brgemm::gen_microkernel(m_kernel, kernelsize_small, reg_count_small);
 
         // adjust Working A and B
@@ -615,7 +865,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                         0));
         }
 
-        Util::generator_store_reg_block(m_kernel, kernelsize_small, Util::WORKING_ADDRESS_C_REG, is_relu);
+        Util::generator_store_reg_block(m_kernel, kernelsize_small, Util::WORKING_ADDRESS_C_REG, is_relu, m_act);
 
         // restore Working A
         if (br_size < 2) {
@@ -647,12 +897,13 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                        Util::WORKING_ADDRESS_C_REG,
                                                        kernelsize_small.M * 4,
                                                        0));
+        gen_bias_step(kernelsize_small.M * 4, 0);
         /* cbnz M loop */
         m_kernel.add_instr(inst::InstGen::base_br_cbnz(Util::M_LOOP_COUNT_REG,
                                                        (m_loop_pos - m_kernel.get_size()) / 4 - 1));
 
         if (rem_m_loop > 0) {
-            Util::generator_load_reg_block(m_kernel, kernelsize_reminder_small, Util::WORKING_ADDRESS_C_REG);
+            gen_load_block(kernelsize_reminder_small);
 
             if (br_size > 1) {
                 // set BR loop counter
@@ -662,7 +913,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                Util::BR_LOOP_COUNT_REG,
                                                                1,
                                                                0));
-                // get BR loop position
+                // get BR loop position, B was prefetched by the first M block
                 br_loop_pos = m_kernel.get_size();
             }
 
@@ -689,6 +940,9 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
 
             reg_count_reminder_small = ((kernelsize_reminder_small.M + 3) / 4) * kernelsize_reminder_small.N;
 
+            if (br_size > 1) {
+                gen_prefetch_br_a(kernelsize_reminder_small);
+            }
             mini_jit::generator::Brgemm::gen_microkernel(m_kernel, kernelsize_reminder_small, reg_count_reminder_small);
 
             // adjust Working A
@@ -730,7 +984,7 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
                                                                (br_loop_pos - m_kernel.get_size()) / 4 - 1));
             }
 
-            Util::generator_store_reg_block(m_kernel, kernelsize_reminder_small, Util::WORKING_ADDRESS_C_REG, is_relu);
+            Util::generator_store_reg_block(m_kernel, kernelsize_reminder_small, Util::WORKING_ADDRESS_C_REG, is_relu, m_act);
         }
     }
 
@@ -751,11 +1005,39 @@ mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate(uint3
 
     m_kernel.set_kernel();
 
-    m_kernel.write("output_test.bin");
-
     return mini_jit::generator::Brgemm::error_t::success;
+#endif
 }
 
 mini_jit::generator::Brgemm::kernel_t mini_jit::generator::Brgemm::get_kernel() const {
     return reinterpret_cast<kernel_t>(const_cast<void*>(m_kernel.get_kernel()));
-}
\ No newline at end of file
+}
+
+void mini_jit::generator::Brgemm::set_prefetch(prefetch_t const& prefetch) {
+    m_prefetch = prefetch;
+}
+
+void mini_jit::generator::Brgemm::set_blocking(blocking_t const& blocking) {
+    m_blocking = blocking;
+}
+
+void mini_jit::generator::Brgemm::set_arena(backend::CodeArena* arena) {
+    m_kernel.set_arena(arena);
+}
+
+mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::load(char const* path,
+                                                                       uint32_t version,
+                                                                       uint64_t signature) {
+    if (!m_kernel.load(path, version, signature)) {
+        return mini_jit::generator::Brgemm::error_t::io_error;
+    }
+    m_kernel.set_kernel();
+
+    return mini_jit::generator::Brgemm::error_t::success;
+}
+
+void mini_jit::generator::Brgemm::store(char const* path,
+                                        uint32_t version,
+                                        uint64_t signature) const {
+    m_kernel.store(path, version, signature);
+}
@@ -3,7 +3,9 @@
 
 #include <cstdint>
 
+#include "../backend/Cpu.h"
 #include "../backend/Kernel.h"
+#include "Activation.h"
 #include "Util.h"
 
 #define BRGEMM_EXPECT(cond)                     \
@@ -23,16 +25,56 @@ class mini_jit::generator::Brgemm {
     backend::Kernel m_kernel;
 
    public:
+    /// software prefetching of the generated kernel
+    struct prefetch_t {
+        //! number of K iterations the A values are prefetched ahead (L1), 0 disables
+        uint32_t k_distance = 0;
+        //! prefetch the A and B blocks of the next batch-reduce iteration (L2)
+        bool next_br = false;
+    };
+
+    /// register blocking of the generated kernel
+    struct blocking_t {
+        //! vector registers per column of a register block, 0 selects the heuristic
+        uint32_t m_vectors = 0;
+        //! columns of a register block, 0 selects the heuristic
+        uint32_t n = 0;
+    };
+
+    /// bias which initializes the accumulators instead of C
+    enum class bias_t : uint32_t {
+        //! no bias, the kernel accumulates into C
+        none = 0,
+        //! one value per row of C, broadcast over the columns
+        m = 1,
+        //! one value per column of C, broadcast over the rows
+        n = 2,
+        //! no bias, the accumulators start at zero and C is only stored (beta = 0)
+        zero = 3
+    };
+
+    /// activation applied to C before it is stored
+    using act_t = Activation::act_t;
+
     /// data type
     enum class dtype_t : uint32_t {
         fp32 = 0,
-        fp64 = 1
+        fp64 = 1,
+        //! A and B in bfloat16, C and the bias in single precision
+        bf16 = 2,
+        //! A and B in signed 8-bit integers, accumulated in 32-bit integers and dequantized to C in single precision
+        int8 = 3,
+        //! A, B, C and the bias in half precision, accumulated in half precision
+        fp16 = 4,
+        //! A and B in half precision, C and the bias in single precision, accumulated in single precision
+        fp16_fp32 = 5
     };
 
     /// error codes
     enum class error_t : int32_t {
         success = 0,
-        bad_param = -1
+        bad_param = -1,
+        io_error = -2
     };
 
     /**
@@ -44,7 +86,18 @@ class mini_jit::generator::Brgemm {
      * @param trans_a 0 if A is stored in column-major order, 1 if A is stored in row-major order.
      * @param trans_b 0 if B is stored in column-major order, 1 if B is stored in row-major order.
      * @param trans_c 0 if C is stored in column-major order, 1 if C is stored in row-major order.
-     * @param dtype data type of the matrices.
+     *                The leading dimensions are the distances of the rows of row-major matrices,
+     *                transposed operands require dtype_t::fp32. A row-major C is only used by direct
+     *                callers, einsum::backend::TensorOperation always passes a column-major C.
+     * @param dtype data type of the matrices, fp64 supports ReLU as the only activation,
+     *              bf16 requires backend::Cpu::has_bf16() and accumulates in single precision,
+     *              int8 requires backend::Cpu::has_int8() and supports bias_t::none, bias_t::zero and bias_t::n,
+     *              fp16 requires backend::Cpu::has_fp16() and supports ReLU as the only activation,
+     *              fp16_fp32 requires backend::Cpu::has_fp16_fp32().
+     * @param is_relu applies ReLU to C before it is stored.
+     * @param bias broadcast mode of the bias vector passed to the kernel, the kernel computes C = bias + sum_i(A_i * B_i)
+     *             without loading C if it is not bias_t::none, C = sum_i(A_i * B_i) for bias_t::zero.
+     * @param act activation applied to C before it is stored, act_t::relu is equivalent to is_relu.
      * @return error_t::success on success, another error_t value otherwise.
      **/
     error_t generate(uint32_t m,
@@ -55,7 +108,9 @@ class mini_jit::generator::Brgemm {
                      uint32_t trans_b,
                      uint32_t trans_c,
                      dtype_t dtype,
-                     bool is_relu);
+                     bool is_relu,
+                     bias_t bias = bias_t::none,
+                     act_t act = act_t::none);
 
     /*
      * Kernel type.
@@ -68,6 +123,10 @@ class mini_jit::generator::Brgemm {
      * - ldc: leading dimension of C.
      * - br_stride_a: stride between two A matrices (in elements, not bytes).
      * - br_stride_b: stride between two B matrices (in elements, not bytes).
+     * - bias: pointer to the contiguous bias vector, ignored by kernels without bias.
+     *
+     * The int8 kernels accumulate sum_i(A_i * B_i) in 32-bit integers and compute C = scale(n) * sum_i(A_i * B_i) + C,
+     * + bias(n) or + 0, where bias points to the n scales of the columns followed by the n values of the bias for bias_t::n.
      */
     using kernel_t = void (*)(void const* a,
                               void const* b,
@@ -76,14 +135,64 @@ class mini_jit::generator::Brgemm {
                               int64_t ldb,
                               int64_t ldc,
                               int64_t br_stride_a,
-                              int64_t br_stride_b);
+                              int64_t br_stride_b,
+                              void const* bias);
 
     /**
-     * @brief Get the generated kernel: C += sum_i(A_i * B_i).
+     * @brief Get the generated kernel: C += sum_i(A_i * B_i), or C = bias + sum_i(A_i * B_i) with a bias.
      * @return pointer to the generated kernel.
      **/
     kernel_t get_kernel() const;
 
+    /**
+     * @brief Enable software prefetching in the generated kernel, disabled by default.
+     *
+     * The x86-64 generator supports k_distance only and rounds it down to 1, 2, 4 or 8,
+     * the NEON bf16 kernels support k_distance only. The NEON kernels with transposed operands
+     * and the x86-64 kernels with a row-major A ignore it.
+     *
+     * @param prefetch prefetch configuration, has to be set before generate().
+     **/
+    void set_prefetch(prefetch_t const& prefetch);
+
+    /**
+     * @brief Set the register blocking of the generated kernel.
+     *
+     * Without an explicit blocking generate() uses the entry of the TuningTable
+     * for the shape, or the built-in heuristic if the shape was not tuned.
+     * generate() fails with error_t::bad_param if the block does not fit into the registers.
+     *
+     * @param blocking register blocking, has to be set before generate().
+     **/
+    void set_blocking(blocking_t const& blocking);
+
+    /**
+     * @brief Place the kernel in the given code arena instead of mapping it separately.
+     * @param arena code arena which owns the kernel memory, has to be set before generate() or load().
+     **/
+    void set_arena(backend::CodeArena* arena);
+
+    /**
+     * @brief Load a previously stored kernel instead of generating it.
+     * @param path path to a file written by store().
+     * @param version version of the code generator, has to match the stored one.
+     * @param signature hash of the kernel signature, has to match the stored one.
+     * @return error_t::success on success, error_t::io_error if the file could not be read or does not match.
+     **/
+    error_t load(char const* path,
+                 uint32_t version,
+                 uint64_t signature);
+
+    /**
+     * @brief Store the generated kernel, e.g., to warm-start a later run through load().
+     * @param path path to the file.
+     * @param version version of the code generator.
+     * @param signature hash of the kernel signature.
+     **/
+    void store(char const* path,
+               uint32_t version,
+               uint64_t signature) const;
+
     /**
      * @brief Generate the inner microkernel of the matrix multplication
      *
@@ -91,6 +200,228 @@ class mini_jit::generator::Brgemm {
     void gen_microkernel(backend::Kernel& i_kernel,
                          Util::KernelSize& i_kernelsize,
                          int32_t used_reg_count);
+
+   private:
+    //! prefetching of the generated kernel
+    prefetch_t m_prefetch;
+
+    //! bias of the generated kernel
+    bias_t m_bias = bias_t::none;
+
+    //! activation of the generated kernel
+    act_t m_act = act_t::none;
+
+    //! register blocking of the generated kernel
+    blocking_t m_blocking;
+
+    //! data type of the generated kernel
+    dtype_t m_dtype = dtype_t::fp32;
+
+    //! A (B) of the generated kernel is stored in row-major order
+    bool m_trans_a = false;
+    bool m_trans_b = false;
+
+    //! the kernel computes the row-major C through C^T = B^T * A^T, A and B are swapped at entry
+    bool m_swap_ab = false;
+
+    /**
+     * @brief Generate the prefetch of the A column of the next batch-reduce iteration, emitted in the K loop.
+     * @param i_kernelsize size of the register block.
+     **/
+    void gen_prefetch_br_a(Util::KernelSize const& i_kernelsize);
+
+    /**
+     * @brief Generate the prefetch of the B block of the next batch-reduce iteration, emitted at the start of a BR iteration.
+     *
+     * The prefetch is a counted loop over the cache lines of the columns and runs in the first M block only.
+     *
+     * @param i_kernelsize size of the register block.
+     * @param k number of columns in A and rows in B.
+     * @param i_m_count_first value of the M loop counter in the first M block.
+     **/
+    void gen_prefetch_br_b(Util::KernelSize const& i_kernelsize,
+                           uint32_t k,
+                           int32_t i_m_count_first);
+
+    /**
+     * @brief Generate the load of a register block, from C or from the bias, or its zeroing (NEON).
+     * @param i_kernelsize size of the register block.
+     **/
+    void gen_load_block(Util::KernelSize& i_kernelsize);
+
+    /**
+     * @brief Generate the step of the bias pointer which follows the one of C (NEON).
+     * @param i_m_bytes step of C in M direction in bytes, used for bias_t::m.
+     * @param i_n_columns step of C in N direction in columns, used for bias_t::n.
+     **/
+    void gen_bias_step(int32_t i_m_bytes,
+                       int32_t i_n_columns);
+
+    /**
+     * @brief Generate the single or double precision kernel for x86-64 using AVX2 or AVX-512 FMA instructions,
+     *        the bf16 (int8) kernel using AVX512_BF16 (AVX512_VNNI) dot products,
+     *        or the fp16 (fp16_fp32) kernel using AVX512_FP16 FMAs (conversions to single precision).
+     **/
+    error_t generate_x86(uint32_t m,
+                         uint32_t n,
+                         uint32_t k,
+                         uint32_t br_size,
+                         bool is_relu);
+
+    /**
+     * @brief Generate the x86-64 code computing one register block of C.
+     * @param i_isa targeted instruction set, avx2 or avx512.
+     * @param i_m_vectors number of vectors in M direction.
+     * @param i_m_mask number of active lanes of the last vector, 0 if it is full.
+     * @param i_n number of columns.
+     * @param n number of columns of the kernel, offset of the bias behind the scales of the int8 kernels.
+     **/
+    void gen_block_x86(backend::Cpu::isa_t i_isa,
+                       uint32_t i_m_vectors,
+                       uint32_t i_m_mask,
+                       uint32_t i_n,
+                       uint32_t n,
+                       uint32_t k,
+                       uint32_t br_size,
+                       bool is_relu);
+
+    /**
+     * @brief Generate a double precision kernel for AArch64 using NEON instructions on .2d arrangements.
+     **/
+    error_t generate_fp64(uint32_t m,
+                          uint32_t n,
+                          uint32_t k,
+                          uint32_t br_size,
+                          bool is_relu);
+
+    /**
+     * @brief Generate the NEON code computing one double precision register block of C.
+     * @param i_m_vectors number of vectors in M direction, each holds two rows.
+     * @param i_m_odd true if the last vector holds a single row.
+     * @param i_n number of columns.
+     **/
+    void gen_block_fp64(uint32_t i_m_vectors,
+                        bool i_m_odd,
+                        uint32_t i_n,
+                        uint32_t k,
+                        uint32_t br_size,
+                        bool is_relu);
+
+    /**
+     * @brief Generate a kernel for AArch64 which multiplies bfloat16 matrices using BFMMLA instructions.
+     **/
+    error_t generate_bf16(uint32_t m,
+                          uint32_t n,
+                          uint32_t k,
+                          uint32_t br_size);
+
+    /**
+     * @brief Generate the NEON code computing one register block of C in the bf16 kernels.
+     *
+     * An accumulator holds a 2x2 block of C, the rows are packed in pairs.
+     *
+     * @param i_m number of rows.
+     * @param i_n number of columns.
+     **/
+    void gen_block_bf16(uint32_t i_m,
+                        uint32_t i_n,
+                        uint32_t k,
+                        uint32_t br_size);
+
+    /**
+     * @brief Generate a kernel for AArch64 which multiplies int8 matrices using SMMLA instructions.
+     **/
+    error_t generate_int8(uint32_t m,
+                          uint32_t n,
+                          uint32_t k,
+                          uint32_t br_size);
+
+    /**
+     * @brief Generate the NEON code computing one register block of C in the int8 kernels.
+     *
+     * An accumulator holds a 2x2 block of C as in the bf16 kernels.
+     *
+     * @param i_m number of rows.
+     * @param i_n number of columns.
+     * @param n number of columns of the kernel, offset of the bias behind the scales.
+     **/
+    void gen_block_int8(uint32_t i_m,
+                        uint32_t i_n,
+                        uint32_t n,
+                        uint32_t k,
+                        uint32_t br_size);
+
+    /**
+     * @brief Generate a half-precision kernel for AArch64 using FMLA on .8h arrangements (fp16)
+     *        or FMLAL/FMLAL2 with single precision accumulators (fp16_fp32).
+     **/
+    error_t generate_fp16(uint32_t m,
+                          uint32_t n,
+                          uint32_t k,
+                          uint32_t br_size,
+                          bool is_relu);
+
+    /**
+     * @brief Generate the NEON code computing one register block of C in the fp16 and fp16_fp32 kernels.
+     *
+     * A vector of A holds eight rows, an accumulator holds eight (fp16) or four (fp16_fp32) rows of C.
+     *
+     * @param i_m number of rows.
+     * @param i_n number of columns.
+     **/
+    void gen_block_fp16(uint32_t i_m,
+                        uint32_t i_n,
+                        uint32_t k,
+                        uint32_t br_size,
+                        bool is_relu);
+
+    /**
+     * @brief Generate a single precision kernel for AArch64 with row-major A, B or C,
+     *        a row-major C is computed through the swapped operands.
+     **/
+    error_t generate_trans(uint32_t m,
+                           uint32_t n,
+                           uint32_t k,
+                           uint32_t br_size,
+                           bool is_relu);
+
+    /**
+     * @brief Generate the NEON code computing one register block of C in the kernels with transposed operands.
+     *
+     * A vector holds four rows of a column of A, four rows of a row-major A are loaded per step of four columns
+     * and transposed in the registers. The values of a row-major B are loaded in groups of four columns.
+     *
+     * @param i_m number of rows.
+     * @param i_n number of columns.
+     **/
+    void gen_block_trans(uint32_t i_m,
+                         uint32_t i_n,
+                         uint32_t k,
+                         uint32_t br_size,
+                         bool is_relu);
+
+    /**
+     * @brief Generate a vector-length agnostic kernel for AArch64 using SVE instructions.
+     **/
+    error_t generate_sve(uint32_t m,
+                         uint32_t n,
+                         uint32_t k,
+                         uint32_t br_size,
+                         bool is_relu);
+
+    /**
+     * @brief Generate the SVE code computing one register block of C.
+     *
+     * The rows of the block are given by the predicates p0 (and p1 for the second vector).
+     *
+     * @param i_m_vectors number of vectors in M direction.
+     * @param i_n number of columns.
+     **/
+    void gen_block_sve(uint32_t i_m_vectors,
+                       uint32_t i_n,
+                       uint32_t k,
+                       uint32_t br_size,
+                       bool is_relu);
 };
 
 #endif
\ No newline at end of file
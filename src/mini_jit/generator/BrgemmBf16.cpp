@@ -0,0 +1,475 @@
+#include "../instructions/instructions.h"
+#include "Brgemm.h"
+
+using Inst = mini_jit::instructions::InstGen;
+
+/*
+ * Register usage of the bfloat16 NEON BRGEMM kernels (AAPCS64).
+ *
+ * Arguments: x0 = A, x1 = B, x2 = C, x3 = lda, x4 = ldb, x5 = ldc,
+ *            x6 = br_stride_a, x7 = br_stride_b, stack = bias.
+ *
+ * BFMMLA multiplies a 2x4 block of A with a 4x2 block of B and accumulates a 2x2 block of C.
+ * An accumulator holds the rows m, m + 1 of the columns n, n + 1 of C in the order
+ * c(m,n), c(m,n+1), c(m+1,n), c(m+1,n+1). The kernels pack four columns of A per K step in registers:
+ * two ZIP stages turn the columns into the pairs of rows BFMMLA expects, while the four values of a
+ * column of B are already contiguous.
+ */
+namespace {
+    //! A, constant
+    constexpr Inst::gpr_t A_REG = Inst::x0;
+    //! B of the current column block
+    constexpr Inst::gpr_t B_COL_REG = Inst::x1;
+    //! C of the current column block
+    constexpr Inst::gpr_t C_COL_REG = Inst::x2;
+
+    //! leading dimensions in bytes
+    constexpr Inst::gpr_t LDA_REG = Inst::x3;
+    constexpr Inst::gpr_t LDB_REG = Inst::x4;
+    constexpr Inst::gpr_t LDC_REG = Inst::x5;
+
+    //! steps from the end of the K loop to the next matrices of the batch in bytes
+    constexpr Inst::gpr_t BR_STEP_A_REG = Inst::x6;
+    constexpr Inst::gpr_t BR_STEP_B_REG = Inst::x7;
+
+    //! offset of the current register block in a column of C in bytes, half of it in a column of A
+    constexpr Inst::gpr_t M_OFFSET_REG = Inst::x8;
+
+    //! working pointer of A
+    constexpr Inst::gpr_t WORKING_A_REG = Inst::x10;
+    //! offset of the A values prefetched in the K loop
+    constexpr Inst::gpr_t PREFETCH_OFFSET_A_REG = Inst::x11;
+    //! second column of a pair of columns of C
+    constexpr Inst::gpr_t C_PAIR_REG = Inst::x16;
+    //! address of the lanes of partial loads and stores
+    constexpr Inst::gpr_t LANE_REG = Inst::x17;
+    //! working pointers of B, one per column, advanced by the loads
+    constexpr Inst::gpr_t WORKING_B_REGS[10] = {Inst::x19, Inst::x20, Inst::x21, Inst::x22, Inst::x23,
+                                                Inst::x24, Inst::x25, Inst::x26, Inst::x27, Inst::x28};
+
+    //! loop counters
+    constexpr Inst::gpr_t M_LOOP_COUNT_REG = Inst::x9;
+    constexpr Inst::gpr_t K_LOOP_COUNT_REG = Inst::x12;
+    constexpr Inst::gpr_t BR_LOOP_COUNT_REG = Inst::x13;
+    constexpr Inst::gpr_t N_LOOP_COUNT_REG = Inst::x14;
+
+    constexpr Inst::gpr_t HELP_REG = Inst::x15;
+
+    //! columns of A, overwritten by the packed pairs of rows, the accumulators start at v0
+    constexpr Inst::simd_fp_t A_VREGS[4] = {Inst::v24, Inst::v25, Inst::v26, Inst::v27};
+    //! interleaved columns of A
+    constexpr Inst::simd_fp_t ZIP_VREGS[4] = {Inst::v28, Inst::v29, Inst::v30, Inst::v31};
+    //! columns of B
+    constexpr Inst::simd_fp_t B_VREGS[3] = {Inst::v20, Inst::v21, Inst::v22};
+
+    //! maximum number of pairs of rows and of columns of a register block
+    constexpr uint32_t MAX_M_PAIRS = 4;
+    constexpr uint32_t MAX_N_BLOCK = 10;
+
+    //! depth of a BFMMLA
+    constexpr uint32_t K_STEP = 4;
+
+    //! offset of the bias argument on the stack once the callee-saved registers are stored
+    constexpr uint32_t BIAS_ARG_OFFSET = 9 * 16;
+
+    /**
+     * Moves an unsigned 32-bit value to the given X register.
+     **/
+    void mov_imm32(mini_jit::backend::Kernel& i_kernel,
+                   Inst::gpr_t i_reg,
+                   uint32_t i_value) {
+        i_kernel.add_instr(Inst::base_movz(i_reg, i_value & 0xffff, 0));
+        if (i_value > 0xffff) {
+            i_kernel.add_instr(Inst::base_movk(i_reg, i_value >> 16, 16));
+        }
+    }
+
+    /**
+     * Scalar or 128-bit register of the given size in bytes.
+     **/
+    Inst::arr_spec_t reg_spec(uint32_t i_bytes) {
+        return (i_bytes == 16) ? Inst::q : (i_bytes == 8) ? Inst::d
+                                       : (i_bytes == 4)   ? Inst::s
+                                                          : Inst::h;
+    }
+
+    /**
+     * Loads i_bytes (even, at most 16) bytes into the lower part of a vector register without touching the memory behind them.
+     * The largest power of two is loaded first, which zeroes the register, the rest is inserted lane by lane.
+     **/
+    void load_bytes(mini_jit::backend::Kernel& i_kernel,
+                    Inst::simd_fp_t i_reg,
+                    Inst::gpr_t i_base,
+                    uint32_t i_offset,
+                    uint32_t i_bytes) {
+        uint32_t l_first = 16;
+        while (l_first > i_bytes) {
+            l_first /= 2;
+        }
+        i_kernel.add_instr(Inst::neon_ldr_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+
+        uint32_t l_done = l_first;
+        for (uint32_t l_piece = l_first / 2; l_done < i_bytes; l_piece /= 2) {
+            if (i_bytes - l_done >= l_piece) {
+                i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_done, 0));
+                if (l_piece == 4) {
+                    i_kernel.add_instr(Inst::neon_ld1_scalar_index(i_reg, LANE_REG, l_done / 4));
+                } else {
+                    i_kernel.add_instr(Inst::neon_ld1_h_index(i_reg, LANE_REG, l_done / 2));
+                }
+                l_done += l_piece;
+            }
+        }
+    }
+
+    /**
+     * Stores the lower i_bytes (multiple of 4, at most 16) bytes of a vector register, see load_bytes.
+     **/
+    void store_bytes(mini_jit::backend::Kernel& i_kernel,
+                     Inst::simd_fp_t i_reg,
+                     Inst::gpr_t i_base,
+                     uint32_t i_offset,
+                     uint32_t i_bytes) {
+        uint32_t l_first = 16;
+        while (l_first > i_bytes) {
+            l_first /= 2;
+        }
+        i_kernel.add_instr(Inst::neon_str_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+
+        if (l_first < i_bytes) {
+            // a single 32-bit value is left
+            i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_first, 0));
+            i_kernel.add_instr(Inst::neon_st1_scalar_index(i_reg, LANE_REG, l_first / 4));
+        }
+    }
+}  // namespace
+
+void mini_jit::generator::Brgemm::gen_block_bf16(uint32_t i_m,
+                                                 uint32_t i_n,
+                                                 uint32_t k,
+                                                 uint32_t br_size) {
+    // pairs of rows and columns, the accumulator of row pair p and column pair q is q * l_pairs_m + p
+    uint32_t l_pairs_m = (i_m + 1) / 2;
+    uint32_t l_pairs_n = (i_n + 1) / 2;
+    auto l_acc = [&](uint32_t i_pm, uint32_t i_pn) {
+        return static_cast<Inst::simd_fp_t>(i_pn * l_pairs_m + i_pm);
+    };
+    // bytes of the rows of C held by the first (rows 0-3) or second (rows 4-7) vector of a column
+    auto l_c_bytes = [&](uint32_t i_half) {
+        uint32_t l_rows = (i_half == 0) ? i_m : i_m - 4;
+        return 4 * ((l_rows < 4) ? l_rows : 4);
+    };
+    uint32_t l_c_vectors = (i_m + 3) / 4;
+
+    /*
+     * Accumulators of C: ZIP of the columns n and n + 1, the first vector of a column holds
+     * the row pairs 0 and 1, the second one the row pairs 2 and 3.
+     */
+    auto l_zip_columns = [&](uint32_t i_pn, Inst::simd_fp_t const* i_col_0, Inst::simd_fp_t const* i_col_1) {
+        for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+            m_kernel.add_instr(Inst::neon_zip(l_acc(l_pm, i_pn), i_col_0[l_pm / 2], i_col_1[l_pm / 2], 1 + l_pm % 2, Inst::s));
+        }
+    };
+
+    if (m_bias == bias_t::none) {
+        // load block of C
+        m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+        for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+            bool l_pair = (2 * l_pn + 1 < i_n);
+            for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                load_bytes(m_kernel, A_VREGS[l_cv], HELP_REG, l_cv * 16, l_c_bytes(l_cv));
+            }
+            if (l_pair) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(C_PAIR_REG, HELP_REG, LDC_REG, 0, 0));
+                for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                    load_bytes(m_kernel, A_VREGS[2 + l_cv], C_PAIR_REG, l_cv * 16, l_c_bytes(l_cv));
+                }
+            }
+            l_zip_columns(l_pn, A_VREGS, l_pair ? A_VREGS + 2 : A_VREGS);
+            if (l_pn + 1 < l_pairs_n) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 1));
+            }
+        }
+    } else if (m_bias == bias_t::zero) {
+        for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+            for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+                m_kernel.add_instr(Inst::neon_movi_zero(l_acc(l_pm, l_pn), true, false));
+            }
+        }
+    } else if (m_bias == bias_t::m) {
+        // bias of the rows, duplicated for both columns of an accumulator
+        m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, M_OFFSET_REG, 0, 0));
+        for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+            load_bytes(m_kernel, A_VREGS[l_cv], HELP_REG, l_cv * 16, l_c_bytes(l_cv));
+        }
+        for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+            l_zip_columns(l_pn, A_VREGS, A_VREGS);
+        }
+    } else {
+        // bias of the columns of the current column block, the values of a column pair are broadcast as one 64-bit value
+        m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+            for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+                if (2 * l_pn + 1 < i_n) {
+                    m_kernel.add_instr(Inst::neon_ld1r(l_acc(l_pm, l_pn), HELP_REG, true));
+                } else {
+                    m_kernel.add_instr(Inst::neon_ldr_imm(l_acc(l_pm, l_pn), HELP_REG, 0, Inst::s));
+                    m_kernel.add_instr(Inst::neon_zip(l_acc(l_pm, l_pn), l_acc(l_pm, l_pn), l_acc(l_pm, l_pn), 1));
+                }
+            }
+            if (l_pn + 1 < l_pairs_n) {
+                m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, 8, 0));
+            }
+        }
+    }
+
+    // working pointers of A and B
+    m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, A_REG, M_OFFSET_REG, 1, 1));
+    m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REGS[0], B_COL_REG));
+    for (uint32_t l_n = 1; l_n < i_n; l_n++) {
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n - 1], LDB_REG, 0, 0));
+    }
+
+    // one step of i_k (at most four) rows of B, the missing rows are zero in both A and B
+    auto l_gen_k_step = [&](uint32_t i_k) {
+        if (m_prefetch.k_distance > 0) {
+            m_kernel.add_instr(Inst::base_prfm_register(Inst::pldl1keep, WORKING_A_REG, PREFETCH_OFFSET_A_REG));
+        }
+
+        // columns of A
+        for (uint32_t l_k = 0; l_k < K_STEP; l_k++) {
+            if (l_k < i_k) {
+                load_bytes(m_kernel, A_VREGS[l_k], WORKING_A_REG, 0, 2 * i_m);
+                m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, LDA_REG, 0, 0));
+            } else {
+                m_kernel.add_instr(Inst::neon_movi_zero(A_VREGS[l_k], true, false));
+            }
+        }
+
+        // pairs of rows: 16-bit ZIP of the columns 0, 1 and 2, 3, then 32-bit ZIP of the results
+        for (uint32_t l_half = 0; l_half < (l_pairs_m + 1) / 2; l_half++) {
+            m_kernel.add_instr(Inst::neon_zip(ZIP_VREGS[l_half], A_VREGS[0], A_VREGS[1], 1 + l_half, Inst::h));
+            m_kernel.add_instr(Inst::neon_zip(ZIP_VREGS[2 + l_half], A_VREGS[2], A_VREGS[3], 1 + l_half, Inst::h));
+        }
+        for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+            m_kernel.add_instr(Inst::neon_zip(A_VREGS[l_pm], ZIP_VREGS[l_pm / 2], ZIP_VREGS[2 + l_pm / 2], 1 + l_pm % 2, Inst::s));
+        }
+
+        for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+            // i_k values of the two columns, an odd last column multiplies its own values a second time
+            for (uint32_t l_co = 0; l_co < 2 && 2 * l_pn + l_co < i_n; l_co++) {
+                Inst::gpr_t l_b_ptr = WORKING_B_REGS[2 * l_pn + l_co];
+                if (i_k == K_STEP) {
+                    m_kernel.add_instr(Inst::neon_ldr(B_VREGS[l_co], l_b_ptr, 2 * K_STEP, Inst::d));
+                } else {
+                    load_bytes(m_kernel, B_VREGS[l_co], l_b_ptr, 0, 2 * i_k);
+                    m_kernel.add_instr(Inst::base_add_imm(l_b_ptr, l_b_ptr, 2 * i_k, 0));
+                }
+            }
+            Inst::simd_fp_t l_b = B_VREGS[0];
+            if (2 * l_pn + 1 < i_n) {
+                m_kernel.add_instr(Inst::neon_zip(B_VREGS[2], B_VREGS[0], B_VREGS[1], 1));
+                l_b = B_VREGS[2];
+            }
+
+            for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+                m_kernel.add_instr(Inst::neon_bfmmla(l_acc(l_pm, l_pn), A_VREGS[l_pm], l_b));
+            }
+        }
+    };
+
+    // BR loop
+    std::size_t l_br_loop_pos = 0;
+    if (br_size > 1) {
+        mov_imm32(m_kernel, BR_LOOP_COUNT_REG, br_size);
+        l_br_loop_pos = m_kernel.get_size();
+    }
+
+    // K loop
+    if (k >= K_STEP) {
+        mov_imm32(m_kernel, K_LOOP_COUNT_REG, k / K_STEP);
+        std::size_t l_k_loop_pos = m_kernel.get_size();
+
+        l_gen_k_step(K_STEP);
+
+        m_kernel.add_instr(Inst::base_sub_imm(K_LOOP_COUNT_REG, K_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(K_LOOP_COUNT_REG, (static_cast<int32_t>(l_k_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (k % K_STEP != 0) {
+        l_gen_k_step(k % K_STEP);
+    }
+
+    if (br_size > 1) {
+        // next matrices of the batch
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, BR_STEP_A_REG, 0, 0));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n], BR_STEP_B_REG, 0, 0));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(BR_LOOP_COUNT_REG, BR_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(BR_LOOP_COUNT_REG, (static_cast<int32_t>(l_br_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+
+    // activations are elementwise and are applied to the 2x2 blocks, the A registers are free
+    if (m_act == act_t::relu) {
+        m_kernel.add_instr(Inst::neon_movi_zero(A_VREGS[0], true, false));
+        for (uint32_t l_ac = 0; l_ac < l_pairs_m * l_pairs_n; l_ac++) {
+            Inst::simd_fp_t l_reg = static_cast<Inst::simd_fp_t>(l_ac);
+            m_kernel.add_instr(Inst::neon_fmax_vector(l_reg, l_reg, A_VREGS[0], false));
+        }
+    } else if (Activation::is_rational(m_act)) {
+        Activation::gen_table_neon(m_kernel, HELP_REG);
+        Activation::gen_neon(m_kernel, m_act, 0, l_pairs_m * l_pairs_n, HELP_REG);
+    }
+
+    // store block of C: UZP of two accumulators gives four rows of the columns n and n + 1
+    m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+    for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+        bool l_pair = (2 * l_pn + 1 < i_n);
+        if (l_pair) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(C_PAIR_REG, HELP_REG, LDC_REG, 0, 0));
+        }
+        for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+            Inst::simd_fp_t l_first = l_acc(2 * l_cv, l_pn);
+            Inst::simd_fp_t l_second = (2 * l_cv + 1 < l_pairs_m) ? l_acc(2 * l_cv + 1, l_pn) : l_first;
+
+            m_kernel.add_instr(Inst::neon_uzp(A_VREGS[0], l_first, l_second, 1, Inst::s));
+            store_bytes(m_kernel, A_VREGS[0], HELP_REG, l_cv * 16, l_c_bytes(l_cv));
+            if (l_pair) {
+                m_kernel.add_instr(Inst::neon_uzp(A_VREGS[1], l_first, l_second, 2, Inst::s));
+                store_bytes(m_kernel, A_VREGS[1], C_PAIR_REG, l_cv * 16, l_c_bytes(l_cv));
+            }
+        }
+        if (l_pn + 1 < l_pairs_n) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 1));
+        }
+    }
+}
+
+mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate_bf16(uint32_t m,
+                                                                                uint32_t n,
+                                                                                uint32_t k,
+                                                                                uint32_t br_size) {
+    BRGEMM_EXPECT(backend::Cpu::has_bf16());
+    BRGEMM_EXPECT(m > 0 && n > 0 && k > 0 && br_size > 0);
+
+    // blocking: up to four pairs of rows and ten columns, i.e., 20 accumulators
+    uint32_t l_m_block = 2 * MAX_M_PAIRS;
+    if (m_blocking.m_vectors > 0) {
+        BRGEMM_EXPECT(m_blocking.m_vectors <= MAX_M_PAIRS);
+        l_m_block = 2 * m_blocking.m_vectors;
+    }
+    l_m_block = (l_m_block < m) ? l_m_block : m;
+    uint32_t l_n_block = MAX_N_BLOCK;
+    if (m_blocking.n > 0) {
+        BRGEMM_EXPECT(m_blocking.n <= MAX_N_BLOCK);
+        l_n_block = m_blocking.n;
+    }
+    l_n_block = (l_n_block < n) ? l_n_block : n;
+
+    uint32_t l_full_m = m / l_m_block;
+    uint32_t l_rem_m = m % l_m_block;
+
+    uint32_t l_full_n = n / l_n_block;
+    uint32_t l_rem_n = n % l_n_block;
+
+    // procedure call standard (store to stack)
+    // GR
+    m_kernel.add_instr(0xa9bf53f3);
+    m_kernel.add_instr(0xa9bf5bf5);
+    m_kernel.add_instr(0xa9bf63f7);
+    m_kernel.add_instr(0xa9bf6bf9);
+    m_kernel.add_instr(0xa9bf73fb);
+    // NEON, lower 64 bits of v8-v15
+    m_kernel.add_instr(0x6DBF27E8);
+    m_kernel.add_instr(0x6DBF2FEA);
+    m_kernel.add_instr(0x6DBF37EC);
+    m_kernel.add_instr(0x6DBF3FEE);
+
+    // leading dimensions and BR strides in bytes, 16-bit values in A and B, 32-bit values in C
+    m_kernel.add_instr(Inst::base_lsl_imm(LDA_REG, LDA_REG, 1));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDB_REG, LDB_REG, 1));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDC_REG, LDC_REG, 2));
+
+    if (m_prefetch.k_distance > 0) {
+        mov_imm32(m_kernel, PREFETCH_OFFSET_A_REG, m_prefetch.k_distance);
+        m_kernel.add_instr(Inst::base_mul_reg(PREFETCH_OFFSET_A_REG, PREFETCH_OFFSET_A_REG, LDA_REG));
+    }
+
+    if (br_size > 1) {
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_A_REG, BR_STEP_A_REG, 1));
+        mov_imm32(m_kernel, HELP_REG, k);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDA_REG));
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_A_REG, BR_STEP_A_REG, HELP_REG, 0, 0));
+
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_B_REG, BR_STEP_B_REG, 1));
+        mov_imm32(m_kernel, HELP_REG, k * 2);
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_B_REG, BR_STEP_B_REG, HELP_REG, 0, 0));
+    }
+
+    // all register blocks of a column block
+    auto l_gen_m_loop = [&](uint32_t i_n) {
+        m_kernel.add_instr(Inst::base_movz(M_OFFSET_REG, 0, 0));
+
+        if (l_full_m > 0) {
+            mov_imm32(m_kernel, M_LOOP_COUNT_REG, l_full_m);
+            std::size_t l_m_loop_pos = m_kernel.get_size();
+
+            gen_block_bf16(l_m_block, i_n, k, br_size);
+
+            m_kernel.add_instr(Inst::base_add_imm(M_OFFSET_REG, M_OFFSET_REG, l_m_block * 4, 0));
+            m_kernel.add_instr(Inst::base_sub_imm(M_LOOP_COUNT_REG, M_LOOP_COUNT_REG, 1, 0));
+            m_kernel.add_instr(Inst::base_br_cbnz(M_LOOP_COUNT_REG, (static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+        }
+        if (l_rem_m > 0) {
+            gen_block_bf16(l_rem_m, i_n, k, br_size);
+        }
+    };
+
+    // N loop
+    if (l_full_n > 0) {
+        mov_imm32(m_kernel, N_LOOP_COUNT_REG, l_full_n);
+        std::size_t l_n_loop_pos = m_kernel.get_size();
+
+        l_gen_m_loop(l_n_block);
+
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDB_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(B_COL_REG, B_COL_REG, HELP_REG, 0, 0));
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDC_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(C_COL_REG, C_COL_REG, HELP_REG, 0, 0));
+
+        // the bias argument on the stack is advanced in place to the next column block
+        if (m_bias == bias_t::n) {
+            m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+            m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, l_n_block * 4, 0));
+            m_kernel.add_instr(Inst::base_str_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(N_LOOP_COUNT_REG, N_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(N_LOOP_COUNT_REG, (static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (l_rem_n > 0) {
+        l_gen_m_loop(l_rem_n);
+    }
+
+    // procedure call standard (load from stack)
+    m_kernel.add_instr(0x6CC13FEE);
+    m_kernel.add_instr(0x6CC137EC);
+    m_kernel.add_instr(0x6CC12FEA);
+    m_kernel.add_instr(0x6CC127E8);
+
+    m_kernel.add_instr(0xa8c173fb);
+    m_kernel.add_instr(0xa8c16bf9);
+    m_kernel.add_instr(0xa8c163f7);
+    m_kernel.add_instr(0xa8c15bf5);
+    m_kernel.add_instr(0xa8c153f3);
+
+    m_kernel.add_instr(Inst::base_ret());
+
+    m_kernel.set_kernel();
+
+    return error_t::success;
+}
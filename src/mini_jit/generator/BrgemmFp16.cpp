@@ -0,0 +1,480 @@
+#include "../instructions/instructions.h"
+#include "Brgemm.h"
+
+using Inst = mini_jit::instructions::InstGen;
+
+/*
+ * Register usage of the half-precision NEON BRGEMM kernels (AAPCS64).
+ *
+ * Arguments: x0 = A, x1 = B, x2 = C, x3 = lda, x4 = ldb, x5 = ldc,
+ *            x6 = br_stride_a, x7 = br_stride_b, stack = bias.
+ *
+ * A vector register holds eight rows of a column of A. The fp16 kernels accumulate in half precision
+ * with FMLA on .8h arrangements, an accumulator holds the same eight rows of C. The fp16_fp32 kernels
+ * accumulate in single precision with FMLAL (lower four rows) and FMLAL2 (upper four rows), i.e.,
+ * every vector of A feeds two accumulators.
+ *
+ * The by-element forms of FMLA (.h) and FMLAL only address v0-v15 as multiplier, B is loaded to v0 and v1.
+ * A remainder of rows is loaded and stored lane by lane without touching the memory behind the block.
+ */
+namespace {
+    //! A, constant
+    constexpr Inst::gpr_t A_REG = Inst::x0;
+    //! B of the current column block
+    constexpr Inst::gpr_t B_COL_REG = Inst::x1;
+    //! C of the current column block
+    constexpr Inst::gpr_t C_COL_REG = Inst::x2;
+
+    //! leading dimensions in bytes
+    constexpr Inst::gpr_t LDA_REG = Inst::x3;
+    constexpr Inst::gpr_t LDB_REG = Inst::x4;
+    constexpr Inst::gpr_t LDC_REG = Inst::x5;
+
+    //! steps from the end of the K loop to the next matrices of the batch in bytes
+    constexpr Inst::gpr_t BR_STEP_A_REG = Inst::x6;
+    constexpr Inst::gpr_t BR_STEP_B_REG = Inst::x7;
+
+    //! offset of the current register block in a column of C in bytes, half of it in a column of A for fp16_fp32
+    constexpr Inst::gpr_t M_OFFSET_REG = Inst::x8;
+
+    //! working pointer of A
+    constexpr Inst::gpr_t WORKING_A_REG = Inst::x10;
+    //! offset of the A values prefetched in the K loop
+    constexpr Inst::gpr_t PREFETCH_OFFSET_A_REG = Inst::x11;
+    //! BR strides in bytes, used to prefetch the next matrices of the batch
+    constexpr Inst::gpr_t BR_STRIDE_A_REG = Inst::x16;
+    constexpr Inst::gpr_t BR_STRIDE_B_REG = Inst::x17;
+    //! working pointers of B, one per column, advanced by the loads
+    constexpr Inst::gpr_t WORKING_B_REGS[9] = {Inst::x19, Inst::x20, Inst::x21, Inst::x22, Inst::x23,
+                                               Inst::x24, Inst::x25, Inst::x26, Inst::x27};
+    //! address of the lanes of partial loads and stores
+    constexpr Inst::gpr_t LANE_REG = Inst::x28;
+
+    //! loop counters
+    constexpr Inst::gpr_t M_LOOP_COUNT_REG = Inst::x9;
+    constexpr Inst::gpr_t K_LOOP_COUNT_REG = Inst::x12;
+    constexpr Inst::gpr_t BR_LOOP_COUNT_REG = Inst::x13;
+    constexpr Inst::gpr_t N_LOOP_COUNT_REG = Inst::x14;
+
+    constexpr Inst::gpr_t HELP_REG = Inst::x15;
+
+    //! vector registers of A and the values of B, the accumulators start at v2
+    constexpr Inst::simd_fp_t A_VREGS[4] = {Inst::v24, Inst::v25, Inst::v26, Inst::v27};
+    constexpr Inst::simd_fp_t B_VREGS[2] = {Inst::v0, Inst::v1};
+    constexpr uint32_t FIRST_ACCUMULATOR = 2;
+
+    //! rows of a vector of A, maximum number of vectors of A, columns and accumulators of a register block
+    constexpr uint32_t A_ROWS = 8;
+    constexpr uint32_t MAX_M_VECTORS = 4;
+    constexpr uint32_t MAX_N_BLOCK = 9;
+    constexpr uint32_t MAX_ACCUMULATORS = 22;
+
+    //! unrolling of the K loop
+    constexpr uint32_t K_UNROLL = 4;
+
+    //! offset of the bias argument on the stack once the callee-saved registers are stored
+    constexpr uint32_t BIAS_ARG_OFFSET = 9 * 16;
+
+    /**
+     * Moves an unsigned 32-bit value to the given X register.
+     **/
+    void mov_imm32(mini_jit::backend::Kernel& i_kernel,
+                   Inst::gpr_t i_reg,
+                   uint32_t i_value) {
+        i_kernel.add_instr(Inst::base_movz(i_reg, i_value & 0xffff, 0));
+        if (i_value > 0xffff) {
+            i_kernel.add_instr(Inst::base_movk(i_reg, i_value >> 16, 16));
+        }
+    }
+
+    /**
+     * Scalar or 128-bit register of the given size in bytes.
+     **/
+    Inst::arr_spec_t reg_spec(uint32_t i_bytes) {
+        return (i_bytes == 16) ? Inst::q : (i_bytes == 8) ? Inst::d
+                                       : (i_bytes == 4)   ? Inst::s
+                                                          : Inst::h;
+    }
+
+    /**
+     * Loads i_bytes (even, at most 16) bytes into the lower part of a vector register without touching the memory behind them.
+     * The largest power of two is loaded first, which zeroes the register, the rest is inserted lane by lane.
+     **/
+    void load_bytes(mini_jit::backend::Kernel& i_kernel,
+                    Inst::simd_fp_t i_reg,
+                    Inst::gpr_t i_base,
+                    uint32_t i_offset,
+                    uint32_t i_bytes) {
+        uint32_t l_first = 16;
+        while (l_first > i_bytes) {
+            l_first /= 2;
+        }
+        i_kernel.add_instr(Inst::neon_ldr_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+
+        uint32_t l_done = l_first;
+        for (uint32_t l_piece = l_first / 2; l_done < i_bytes; l_piece /= 2) {
+            if (i_bytes - l_done >= l_piece) {
+                i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_done, 0));
+                if (l_piece == 4) {
+                    i_kernel.add_instr(Inst::neon_ld1_scalar_index(i_reg, LANE_REG, l_done / 4));
+                } else {
+                    i_kernel.add_instr(Inst::neon_ld1_h_index(i_reg, LANE_REG, l_done / 2));
+                }
+                l_done += l_piece;
+            }
+        }
+    }
+
+    /**
+     * Stores the lower i_bytes (even, at most 16) bytes of a vector register, see load_bytes.
+     **/
+    void store_bytes(mini_jit::backend::Kernel& i_kernel,
+                     Inst::simd_fp_t i_reg,
+                     Inst::gpr_t i_base,
+                     uint32_t i_offset,
+                     uint32_t i_bytes) {
+        uint32_t l_first = 16;
+        while (l_first > i_bytes) {
+            l_first /= 2;
+        }
+        i_kernel.add_instr(Inst::neon_str_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+
+        uint32_t l_done = l_first;
+        for (uint32_t l_piece = l_first / 2; l_done < i_bytes; l_piece /= 2) {
+            if (i_bytes - l_done >= l_piece) {
+                i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_done, 0));
+                if (l_piece == 4) {
+                    i_kernel.add_instr(Inst::neon_st1_scalar_index(i_reg, LANE_REG, l_done / 4));
+                } else {
+                    i_kernel.add_instr(Inst::neon_st1_h_index(i_reg, LANE_REG, l_done / 2));
+                }
+                l_done += l_piece;
+            }
+        }
+    }
+}  // namespace
+
+void mini_jit::generator::Brgemm::gen_block_fp16(uint32_t i_m,
+                                                 uint32_t i_n,
+                                                 uint32_t k,
+                                                 uint32_t br_size,
+                                                 bool is_relu) {
+    bool l_fp32 = (m_dtype == dtype_t::fp16_fp32);
+    // rows and bytes of the values of an accumulator
+    uint32_t l_c_rows = l_fp32 ? 4 : 8;
+    uint32_t l_size_c = l_fp32 ? 4 : 2;
+    uint32_t l_a_vectors = (i_m + A_ROWS - 1) / A_ROWS;
+    uint32_t l_c_vectors = (i_m + l_c_rows - 1) / l_c_rows;
+
+    // accumulator of row vector i and column j: j * l_c_vectors + i
+    auto l_acc = [&](uint32_t i_cv, uint32_t i_n) {
+        return static_cast<Inst::simd_fp_t>(FIRST_ACCUMULATOR + i_n * l_c_vectors + i_cv);
+    };
+    // bytes of a vector of C (A), less than 16 in the last vector of a remainder
+    auto l_bytes_c = [&](uint32_t i_cv) {
+        uint32_t l_rows = i_m - i_cv * l_c_rows;
+        return ((l_rows < l_c_rows) ? l_rows : l_c_rows) * l_size_c;
+    };
+    auto l_bytes_a = [&](uint32_t i_av) {
+        uint32_t l_rows = i_m - i_av * A_ROWS;
+        return ((l_rows < A_ROWS) ? l_rows : A_ROWS) * 2;
+    };
+    auto l_load = [&](Inst::simd_fp_t i_reg, Inst::gpr_t i_base, uint32_t i_offset, uint32_t i_bytes) {
+        if (i_bytes == 16) {
+            m_kernel.add_instr(Inst::neon_ldr_imm(i_reg, i_base, i_offset, Inst::q));
+        } else {
+            load_bytes(m_kernel, i_reg, i_base, i_offset, i_bytes);
+        }
+    };
+
+    if (m_bias == bias_t::none) {
+        // load block of C
+        m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                l_load(l_acc(l_cv, l_n), HELP_REG, l_cv * 16, l_bytes_c(l_cv));
+            }
+            if (l_n + 1 < i_n) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 0));
+            }
+        }
+    } else if (m_bias == bias_t::zero) {
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                m_kernel.add_instr(Inst::neon_movi_zero(l_acc(l_cv, l_n), true, false));
+            }
+        }
+    } else {
+        // initialize the block with the bias of its rows or of the current column block
+        m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        if (m_bias == bias_t::m) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, M_OFFSET_REG, 0, 0));
+        }
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                if (m_bias == bias_t::m) {
+                    l_load(l_acc(l_cv, l_n), HELP_REG, l_cv * 16, l_bytes_c(l_cv));
+                } else if (l_fp32) {
+                    m_kernel.add_instr(Inst::neon_ld1r(l_acc(l_cv, l_n), HELP_REG, false));
+                } else {
+                    m_kernel.add_instr(Inst::neon_ld1r_h(l_acc(l_cv, l_n), HELP_REG));
+                }
+            }
+            if (m_bias == bias_t::n && l_n + 1 < i_n) {
+                m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, l_size_c, 0));
+            }
+        }
+    }
+
+    // working pointers of A and B
+    m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, A_REG, M_OFFSET_REG, l_fp32 ? 1 : 0, l_fp32 ? 1 : 0));
+    m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REGS[0], B_COL_REG));
+    for (uint32_t l_n = 1; l_n < i_n; l_n++) {
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n - 1], LDB_REG, 0, 0));
+    }
+
+    // one or more steps in K, the loads of B advance the working pointers to the next row
+    uint32_t l_b_count = 0;
+    auto l_gen_k_steps = [&](uint32_t i_steps) {
+        for (uint32_t l_k = 0; l_k < i_steps; l_k++) {
+            if (m_prefetch.k_distance > 0) {
+                m_kernel.add_instr(Inst::base_prfm_register(Inst::pldl1keep, WORKING_A_REG, PREFETCH_OFFSET_A_REG));
+            }
+            for (uint32_t l_av = 0; l_av < l_a_vectors; l_av++) {
+                l_load(A_VREGS[l_av], WORKING_A_REG, l_av * 16, l_bytes_a(l_av));
+            }
+            m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, LDA_REG, 0, 0));
+
+            for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+                Inst::simd_fp_t l_b = B_VREGS[l_b_count++ % 2];
+                m_kernel.add_instr(Inst::neon_ldr(l_b, WORKING_B_REGS[l_n], 2, Inst::h));
+                for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                    if (l_fp32) {
+                        m_kernel.add_instr(Inst::neon_fmlal_element(l_acc(l_cv, l_n), A_VREGS[l_cv / 2], l_b, 0, l_cv % 2 != 0));
+                    } else {
+                        m_kernel.add_instr(Inst::neon_fmla_element_h(l_acc(l_cv, l_n), A_VREGS[l_cv], l_b, 0));
+                    }
+                }
+            }
+        }
+    };
+
+    // BR loop
+    std::size_t l_br_loop_pos = 0;
+    if (br_size > 1) {
+        mov_imm32(m_kernel, BR_LOOP_COUNT_REG, br_size);
+        l_br_loop_pos = m_kernel.get_size();
+
+        if (m_prefetch.next_br) {
+            // first cache line of each column of the next A block
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, WORKING_A_REG, BR_STRIDE_A_REG, 0, 0));
+            for (uint32_t l_k = 0; l_k < k; l_k++) {
+                m_kernel.add_instr(Inst::base_prfm_imm(Inst::pldl2keep, HELP_REG, 0));
+                if (l_k + 1 < k) {
+                    m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDA_REG, 0, 0));
+                }
+            }
+            // K values of each column of the next B block
+            for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, WORKING_B_REGS[l_n], BR_STRIDE_B_REG, 0, 0));
+                for (uint32_t l_li = 0; l_li < (k * 2 + 63) / 64; l_li++) {
+                    m_kernel.add_instr(Inst::base_prfm_imm(Inst::pldl2keep, HELP_REG, l_li * 64));
+                }
+            }
+        }
+    }
+
+    // K loop
+    uint32_t l_k_unroll = (k < K_UNROLL) ? k : K_UNROLL;
+    mov_imm32(m_kernel, K_LOOP_COUNT_REG, k / l_k_unroll);
+    std::size_t l_k_loop_pos = m_kernel.get_size();
+
+    l_gen_k_steps(l_k_unroll);
+
+    m_kernel.add_instr(Inst::base_sub_imm(K_LOOP_COUNT_REG, K_LOOP_COUNT_REG, 1, 0));
+    m_kernel.add_instr(Inst::base_br_cbnz(K_LOOP_COUNT_REG, (static_cast<int32_t>(l_k_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+
+    if (k % l_k_unroll != 0) {
+        l_gen_k_steps(k % l_k_unroll);
+    }
+
+    if (br_size > 1) {
+        // next matrices of the batch
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, BR_STEP_A_REG, 0, 0));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n], BR_STEP_B_REG, 0, 0));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(BR_LOOP_COUNT_REG, BR_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(BR_LOOP_COUNT_REG, (static_cast<int32_t>(l_br_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+
+    // ReLU, the A registers are free
+    if (is_relu) {
+        m_kernel.add_instr(Inst::neon_movi_zero(A_VREGS[0], true, false));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                if (l_fp32) {
+                    m_kernel.add_instr(Inst::neon_fmax_vector(l_acc(l_cv, l_n), l_acc(l_cv, l_n), A_VREGS[0], false));
+                } else {
+                    m_kernel.add_instr(Inst::neon_fmax_vector_h(l_acc(l_cv, l_n), l_acc(l_cv, l_n), A_VREGS[0]));
+                }
+            }
+        }
+    } else if (Activation::is_rational(m_act)) {
+        // single precision accumulators of the fp16_fp32 kernels only
+        Activation::gen_table_neon(m_kernel, HELP_REG);
+        Activation::gen_neon(m_kernel, m_act, FIRST_ACCUMULATOR, l_c_vectors * i_n, HELP_REG);
+    }
+
+    // store block of C
+    m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+    for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+        for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+            if (l_bytes_c(l_cv) == 16) {
+                m_kernel.add_instr(Inst::neon_str_imm(l_acc(l_cv, l_n), HELP_REG, l_cv * 16, Inst::q));
+            } else {
+                store_bytes(m_kernel, l_acc(l_cv, l_n), HELP_REG, l_cv * 16, l_bytes_c(l_cv));
+            }
+        }
+        if (l_n + 1 < i_n) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 0));
+        }
+    }
+}
+
+mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate_fp16(uint32_t m,
+                                                                                uint32_t n,
+                                                                                uint32_t k,
+                                                                                uint32_t br_size,
+                                                                                bool is_relu) {
+    bool l_fp32 = (m_dtype == dtype_t::fp16_fp32);
+    BRGEMM_EXPECT(l_fp32 ? backend::Cpu::has_fp16_fp32() : backend::Cpu::has_fp16());
+    BRGEMM_EXPECT(m > 0 && n > 0 && k > 0 && br_size > 0);
+
+    // blocking: up to four (two for fp16_fp32) vectors of A in M, as many columns as the accumulators allow
+    uint32_t l_c_per_a = l_fp32 ? 2 : 1;
+    uint32_t l_size_c = l_fp32 ? 4 : 2;
+    uint32_t l_m_vectors = (m + A_ROWS - 1) / A_ROWS;
+    uint32_t l_max_m_vectors = MAX_M_VECTORS / l_c_per_a;
+    l_m_vectors = (l_m_vectors < l_max_m_vectors) ? l_m_vectors : l_max_m_vectors;
+    if (m_blocking.m_vectors > 0) {
+        BRGEMM_EXPECT(m_blocking.m_vectors <= MAX_M_VECTORS);
+        l_m_vectors = m_blocking.m_vectors;
+    }
+    uint32_t l_n_block = MAX_ACCUMULATORS / (l_m_vectors * l_c_per_a);
+    l_n_block = (l_n_block < MAX_N_BLOCK) ? l_n_block : MAX_N_BLOCK;
+    if (m_blocking.n > 0) {
+        BRGEMM_EXPECT(m_blocking.n <= l_n_block);
+        l_n_block = m_blocking.n;
+    }
+    l_n_block = (l_n_block < n) ? l_n_block : n;
+
+    uint32_t l_m_block = A_ROWS * l_m_vectors;
+    uint32_t l_full_m = m / l_m_block;
+    uint32_t l_rem_m = m % l_m_block;
+
+    uint32_t l_full_n = n / l_n_block;
+    uint32_t l_rem_n = n % l_n_block;
+
+    // procedure call standard (store to stack)
+    // GR
+    m_kernel.add_instr(0xa9bf53f3);
+    m_kernel.add_instr(0xa9bf5bf5);
+    m_kernel.add_instr(0xa9bf63f7);
+    m_kernel.add_instr(0xa9bf6bf9);
+    m_kernel.add_instr(0xa9bf73fb);
+    // NEON, lower 64 bits of v8-v15
+    m_kernel.add_instr(0x6DBF27E8);
+    m_kernel.add_instr(0x6DBF2FEA);
+    m_kernel.add_instr(0x6DBF37EC);
+    m_kernel.add_instr(0x6DBF3FEE);
+
+    // leading dimensions and BR strides in bytes
+    m_kernel.add_instr(Inst::base_lsl_imm(LDA_REG, LDA_REG, 1));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDB_REG, LDB_REG, 1));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDC_REG, LDC_REG, l_fp32 ? 2 : 1));
+
+    if (m_prefetch.k_distance > 0) {
+        mov_imm32(m_kernel, PREFETCH_OFFSET_A_REG, m_prefetch.k_distance);
+        m_kernel.add_instr(Inst::base_mul_reg(PREFETCH_OFFSET_A_REG, PREFETCH_OFFSET_A_REG, LDA_REG));
+    }
+
+    if (br_size > 1) {
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STRIDE_A_REG, BR_STEP_A_REG, 1));
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STRIDE_B_REG, BR_STEP_B_REG, 1));
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_A_REG, BR_STEP_A_REG, 1));
+        mov_imm32(m_kernel, HELP_REG, k);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDA_REG));
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_A_REG, BR_STEP_A_REG, HELP_REG, 0, 0));
+
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_B_REG, BR_STEP_B_REG, 1));
+        mov_imm32(m_kernel, HELP_REG, k * 2);
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_B_REG, BR_STEP_B_REG, HELP_REG, 0, 0));
+    }
+
+    // all register blocks of a column block
+    auto l_gen_m_loop = [&](uint32_t i_n) {
+        m_kernel.add_instr(Inst::base_movz(M_OFFSET_REG, 0, 0));
+
+        if (l_full_m > 0) {
+            mov_imm32(m_kernel, M_LOOP_COUNT_REG, l_full_m);
+            std::size_t l_m_loop_pos = m_kernel.get_size();
+
+            gen_block_fp16(l_m_block, i_n, k, br_size, is_relu);
+
+            m_kernel.add_instr(Inst::base_add_imm(M_OFFSET_REG, M_OFFSET_REG, l_m_block * l_size_c, 0));
+            m_kernel.add_instr(Inst::base_sub_imm(M_LOOP_COUNT_REG, M_LOOP_COUNT_REG, 1, 0));
+            m_kernel.add_instr(Inst::base_br_cbnz(M_LOOP_COUNT_REG, (static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+        }
+        if (l_rem_m > 0) {
+            gen_block_fp16(l_rem_m, i_n, k, br_size, is_relu);
+        }
+    };
+
+    // N loop
+    if (l_full_n > 0) {
+        mov_imm32(m_kernel, N_LOOP_COUNT_REG, l_full_n);
+        std::size_t l_n_loop_pos = m_kernel.get_size();
+
+        l_gen_m_loop(l_n_block);
+
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDB_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(B_COL_REG, B_COL_REG, HELP_REG, 0, 0));
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDC_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(C_COL_REG, C_COL_REG, HELP_REG, 0, 0));
+
+        // the bias argument on the stack is advanced in place to the next column block
+        if (m_bias == bias_t::n) {
+            m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+            m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, l_n_block * l_size_c, 0));
+            m_kernel.add_instr(Inst::base_str_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(N_LOOP_COUNT_REG, N_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(N_LOOP_COUNT_REG, (static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (l_rem_n > 0) {
+        l_gen_m_loop(l_rem_n);
+    }
+
+    // procedure call standard (load from stack)
+    m_kernel.add_instr(0x6CC13FEE);
+    m_kernel.add_instr(0x6CC137EC);
+    m_kernel.add_instr(0x6CC12FEA);
+    m_kernel.add_instr(0x6CC127E8);
+
+    m_kernel.add_instr(0xa8c173fb);
+    m_kernel.add_instr(0xa8c16bf9);
+    m_kernel.add_instr(0xa8c163f7);
+    m_kernel.add_instr(0xa8c15bf5);
+    m_kernel.add_instr(0xa8c153f3);
+
+    m_kernel.add_instr(Inst::base_ret());
+
+    m_kernel.set_kernel();
+
+    return error_t::success;
+}
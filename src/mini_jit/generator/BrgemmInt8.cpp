@@ -0,0 +1,489 @@
+#include "../instructions/instructions.h"
+#include "Brgemm.h"
+
+using Inst = mini_jit::instructions::InstGen;
+
+/*
+ * Register usage of the int8 NEON BRGEMM kernels (AAPCS64).
+ *
+ * Arguments: x0 = A, x1 = B, x2 = C, x3 = lda, x4 = ldb, x5 = ldc,
+ *            x6 = br_stride_a, x7 = br_stride_b, stack = scales and bias.
+ *
+ * SMMLA multiplies a 2x8 block of A with an 8x2 block of B and accumulates a 2x2 block of 32-bit
+ * integers in the same order as BFMMLA: c(m,n), c(m,n+1), c(m+1,n), c(m+1,n+1). The kernels pack
+ * eight columns of A per K step in registers: three ZIP stages turn the columns into the pairs of
+ * rows SMMLA expects, while the eight values of a column of B are already contiguous.
+ *
+ * The integer accumulators start at zero and are dequantized once after the BR loop:
+ * C = scale(n) * acc + C, or + bias(n), or + 0 for bias_t::zero.
+ */
+namespace {
+    //! A, constant
+    constexpr Inst::gpr_t A_REG = Inst::x0;
+    //! B of the current column block
+    constexpr Inst::gpr_t B_COL_REG = Inst::x1;
+    //! C of the current column block
+    constexpr Inst::gpr_t C_COL_REG = Inst::x2;
+
+    //! leading dimensions in bytes
+    constexpr Inst::gpr_t LDA_REG = Inst::x3;
+    constexpr Inst::gpr_t LDB_REG = Inst::x4;
+    constexpr Inst::gpr_t LDC_REG = Inst::x5;
+
+    //! steps from the end of the K loop to the next matrices of the batch in bytes
+    constexpr Inst::gpr_t BR_STEP_A_REG = Inst::x6;
+    constexpr Inst::gpr_t BR_STEP_B_REG = Inst::x7;
+
+    //! offset of the current register block in a column of C in bytes, a quarter of it in a column of A
+    constexpr Inst::gpr_t M_OFFSET_REG = Inst::x8;
+
+    //! working pointer of A
+    constexpr Inst::gpr_t WORKING_A_REG = Inst::x10;
+    //! offset of the A values prefetched in the K loop
+    constexpr Inst::gpr_t PREFETCH_OFFSET_A_REG = Inst::x11;
+    //! second column of a pair of columns of C
+    constexpr Inst::gpr_t C_PAIR_REG = Inst::x16;
+    //! address of the lanes of partial loads and stores
+    constexpr Inst::gpr_t LANE_REG = Inst::x17;
+    //! working pointers of B, one per column, advanced by the loads
+    constexpr Inst::gpr_t WORKING_B_REGS[8] = {Inst::x19, Inst::x20, Inst::x21, Inst::x22,
+                                               Inst::x23, Inst::x24, Inst::x25, Inst::x26};
+    //! scales and bias of the current column pair
+    constexpr Inst::gpr_t SCALE_REG = Inst::x27;
+    constexpr Inst::gpr_t BIAS_REG = Inst::x28;
+
+    //! loop counters
+    constexpr Inst::gpr_t M_LOOP_COUNT_REG = Inst::x9;
+    constexpr Inst::gpr_t K_LOOP_COUNT_REG = Inst::x12;
+    constexpr Inst::gpr_t BR_LOOP_COUNT_REG = Inst::x13;
+    constexpr Inst::gpr_t N_LOOP_COUNT_REG = Inst::x14;
+
+    constexpr Inst::gpr_t HELP_REG = Inst::x15;
+
+    //! columns of A, the first four are overwritten by the second ZIP stage, the last four by the packed pairs of rows
+    constexpr Inst::simd_fp_t A_VREGS[8] = {Inst::v16, Inst::v17, Inst::v18, Inst::v19,
+                                            Inst::v20, Inst::v21, Inst::v22, Inst::v23};
+    //! interleaved pairs of columns of A
+    constexpr Inst::simd_fp_t ZIP_VREGS[4] = {Inst::v24, Inst::v25, Inst::v26, Inst::v27};
+    //! columns of B
+    constexpr Inst::simd_fp_t B_VREGS[3] = {Inst::v28, Inst::v29, Inst::v30};
+
+    //! maximum number of pairs of rows and of columns of a register block
+    constexpr uint32_t MAX_M_PAIRS = 4;
+    constexpr uint32_t MAX_N_BLOCK = 8;
+
+    //! depth of a SMMLA
+    constexpr uint32_t K_STEP = 8;
+
+    //! offset of the scale argument on the stack once the callee-saved registers are stored
+    constexpr uint32_t SCALE_ARG_OFFSET = 9 * 16;
+
+    /**
+     * Moves an unsigned 32-bit value to the given X register.
+     **/
+    void mov_imm32(mini_jit::backend::Kernel& i_kernel,
+                   Inst::gpr_t i_reg,
+                   uint32_t i_value) {
+        i_kernel.add_instr(Inst::base_movz(i_reg, i_value & 0xffff, 0));
+        if (i_value > 0xffff) {
+            i_kernel.add_instr(Inst::base_movk(i_reg, i_value >> 16, 16));
+        }
+    }
+
+    /**
+     * Scalar or 128-bit register of the given size in bytes.
+     **/
+    Inst::arr_spec_t reg_spec(uint32_t i_bytes) {
+        return (i_bytes == 16) ? Inst::q : (i_bytes == 8) ? Inst::d
+                                       : (i_bytes == 4)   ? Inst::s
+                                       : (i_bytes == 2)   ? Inst::h
+                                                          : Inst::b;
+    }
+
+    /**
+     * Loads i_bytes (at most 16) bytes into the lower part of a vector register without touching the memory behind them.
+     * The largest power of two is loaded first, which zeroes the register, the rest is inserted lane by lane.
+     **/
+    void load_bytes(mini_jit::backend::Kernel& i_kernel,
+                    Inst::simd_fp_t i_reg,
+                    Inst::gpr_t i_base,
+                    uint32_t i_offset,
+                    uint32_t i_bytes) {
+        uint32_t l_first = 16;
+        while (l_first > i_bytes) {
+            l_first /= 2;
+        }
+        i_kernel.add_instr(Inst::neon_ldr_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+
+        uint32_t l_done = l_first;
+        for (uint32_t l_piece = l_first / 2; l_done < i_bytes; l_piece /= 2) {
+            if (i_bytes - l_done >= l_piece) {
+                i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_done, 0));
+                if (l_piece == 4) {
+                    i_kernel.add_instr(Inst::neon_ld1_scalar_index(i_reg, LANE_REG, l_done / 4));
+                } else if (l_piece == 2) {
+                    i_kernel.add_instr(Inst::neon_ld1_h_index(i_reg, LANE_REG, l_done / 2));
+                } else {
+                    i_kernel.add_instr(Inst::neon_ld1_b_index(i_reg, LANE_REG, l_done));
+                }
+                l_done += l_piece;
+            }
+        }
+    }
+
+    /**
+     * Stores the lower i_bytes (multiple of 4, at most 16) bytes of a vector register, see load_bytes.
+     **/
+    void store_bytes(mini_jit::backend::Kernel& i_kernel,
+                     Inst::simd_fp_t i_reg,
+                     Inst::gpr_t i_base,
+                     uint32_t i_offset,
+                     uint32_t i_bytes) {
+        uint32_t l_first = 16;
+        while (l_first > i_bytes) {
+            l_first /= 2;
+        }
+        i_kernel.add_instr(Inst::neon_str_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+
+        if (l_first < i_bytes) {
+            // a single 32-bit value is left
+            i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_first, 0));
+            i_kernel.add_instr(Inst::neon_st1_scalar_index(i_reg, LANE_REG, l_first / 4));
+        }
+    }
+
+    /**
+     * Loads the 32-bit values of the columns n and n + 1 at i_base to the pattern of an accumulator: v(n), v(n+1), v(n), v(n+1).
+     * The second value is zero for an odd last column.
+     **/
+    void load_column_pair(mini_jit::backend::Kernel& i_kernel,
+                          Inst::simd_fp_t i_reg,
+                          Inst::gpr_t i_base,
+                          bool i_pair) {
+        if (i_pair) {
+            i_kernel.add_instr(Inst::neon_ld1r(i_reg, i_base, true));
+        } else {
+            i_kernel.add_instr(Inst::neon_ldr_imm(i_reg, i_base, 0, Inst::s));
+            i_kernel.add_instr(Inst::neon_zip(i_reg, i_reg, i_reg, 1));
+        }
+    }
+}  // namespace
+
+void mini_jit::generator::Brgemm::gen_block_int8(uint32_t i_m,
+                                                 uint32_t i_n,
+                                                 uint32_t n,
+                                                 uint32_t k,
+                                                 uint32_t br_size) {
+    // pairs of rows and columns, the accumulator of row pair p and column pair q is q * l_pairs_m + p
+    uint32_t l_pairs_m = (i_m + 1) / 2;
+    uint32_t l_pairs_n = (i_n + 1) / 2;
+    auto l_acc = [&](uint32_t i_pm, uint32_t i_pn) {
+        return static_cast<Inst::simd_fp_t>(i_pn * l_pairs_m + i_pm);
+    };
+    // bytes of the rows of C held by the first (rows 0-3) or second (rows 4-7) vector of a column
+    auto l_c_bytes = [&](uint32_t i_half) {
+        uint32_t l_rows = (i_half == 0) ? i_m : i_m - 4;
+        return 4 * ((l_rows < 4) ? l_rows : 4);
+    };
+    uint32_t l_c_vectors = (i_m + 3) / 4;
+
+    for (uint32_t l_ac = 0; l_ac < l_pairs_m * l_pairs_n; l_ac++) {
+        m_kernel.add_instr(Inst::neon_movi_zero(static_cast<Inst::simd_fp_t>(l_ac), true, false));
+    }
+
+    // working pointers of A and B
+    m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, A_REG, M_OFFSET_REG, 1, 2));
+    m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REGS[0], B_COL_REG));
+    for (uint32_t l_n = 1; l_n < i_n; l_n++) {
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n - 1], LDB_REG, 0, 0));
+    }
+
+    // one step of i_k (at most eight) rows of B, the missing rows are zero in both A and B
+    auto l_gen_k_step = [&](uint32_t i_k) {
+        if (m_prefetch.k_distance > 0) {
+            m_kernel.add_instr(Inst::base_prfm_register(Inst::pldl1keep, WORKING_A_REG, PREFETCH_OFFSET_A_REG));
+        }
+
+        // columns of A
+        for (uint32_t l_k = 0; l_k < K_STEP; l_k++) {
+            if (l_k < i_k) {
+                load_bytes(m_kernel, A_VREGS[l_k], WORKING_A_REG, 0, i_m);
+                m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, LDA_REG, 0, 0));
+            } else {
+                m_kernel.add_instr(Inst::neon_movi_zero(A_VREGS[l_k], true, false));
+            }
+        }
+
+        // pairs of rows: 8-bit ZIP of neighbouring columns, 16-bit ZIP of the results gives four columns of
+        // the rows 0-3 (ZIP1) and 4-7 (ZIP2), 32-bit ZIP of the columns 0-3 and 4-7 gives the pairs of rows
+        for (uint32_t l_zi = 0; l_zi < 4; l_zi++) {
+            m_kernel.add_instr(Inst::neon_zip(ZIP_VREGS[l_zi], A_VREGS[2 * l_zi], A_VREGS[2 * l_zi + 1], 1, Inst::b));
+        }
+        for (uint32_t l_half = 0; l_half < (l_pairs_m + 1) / 2; l_half++) {
+            m_kernel.add_instr(Inst::neon_zip(A_VREGS[l_half], ZIP_VREGS[0], ZIP_VREGS[1], 1 + l_half, Inst::h));
+            m_kernel.add_instr(Inst::neon_zip(A_VREGS[2 + l_half], ZIP_VREGS[2], ZIP_VREGS[3], 1 + l_half, Inst::h));
+        }
+        for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+            m_kernel.add_instr(Inst::neon_zip(A_VREGS[4 + l_pm], A_VREGS[l_pm / 2], A_VREGS[2 + l_pm / 2], 1 + l_pm % 2, Inst::s));
+        }
+
+        for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+            // i_k values of the two columns, the upper half is zero for an odd last column
+            for (uint32_t l_co = 0; l_co < 2 && 2 * l_pn + l_co < i_n; l_co++) {
+                Inst::gpr_t l_b_ptr = WORKING_B_REGS[2 * l_pn + l_co];
+                if (i_k == K_STEP) {
+                    m_kernel.add_instr(Inst::neon_ldr(B_VREGS[l_co], l_b_ptr, K_STEP, Inst::d));
+                } else {
+                    load_bytes(m_kernel, B_VREGS[l_co], l_b_ptr, 0, i_k);
+                    m_kernel.add_instr(Inst::base_add_imm(l_b_ptr, l_b_ptr, i_k, 0));
+                }
+            }
+            Inst::simd_fp_t l_b = B_VREGS[0];
+            if (2 * l_pn + 1 < i_n) {
+                m_kernel.add_instr(Inst::neon_zip(B_VREGS[2], B_VREGS[0], B_VREGS[1], 1));
+                l_b = B_VREGS[2];
+            }
+
+            for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+                m_kernel.add_instr(Inst::neon_smmla(l_acc(l_pm, l_pn), A_VREGS[4 + l_pm], l_b));
+            }
+        }
+    };
+
+    // BR loop
+    std::size_t l_br_loop_pos = 0;
+    if (br_size > 1) {
+        mov_imm32(m_kernel, BR_LOOP_COUNT_REG, br_size);
+        l_br_loop_pos = m_kernel.get_size();
+    }
+
+    // K loop
+    if (k >= K_STEP) {
+        mov_imm32(m_kernel, K_LOOP_COUNT_REG, k / K_STEP);
+        std::size_t l_k_loop_pos = m_kernel.get_size();
+
+        l_gen_k_step(K_STEP);
+
+        m_kernel.add_instr(Inst::base_sub_imm(K_LOOP_COUNT_REG, K_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(K_LOOP_COUNT_REG, (static_cast<int32_t>(l_k_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (k % K_STEP != 0) {
+        l_gen_k_step(k % K_STEP);
+    }
+
+    if (br_size > 1) {
+        // next matrices of the batch
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, BR_STEP_A_REG, 0, 0));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n], BR_STEP_B_REG, 0, 0));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(BR_LOOP_COUNT_REG, BR_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(BR_LOOP_COUNT_REG, (static_cast<int32_t>(l_br_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+
+    // dequantization: scales of the columns of the current column block, followed by the bias for bias_t::n
+    m_kernel.add_instr(Inst::base_ldr_imm(SCALE_REG, Inst::sp, SCALE_ARG_OFFSET));
+    if (m_bias == bias_t::n) {
+        mov_imm32(m_kernel, HELP_REG, n * 4);
+        m_kernel.add_instr(Inst::base_add_shifted_register(BIAS_REG, SCALE_REG, HELP_REG, 0, 0));
+    }
+    m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+    for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+        bool l_pair = (2 * l_pn + 1 < i_n);
+
+        load_column_pair(m_kernel, B_VREGS[0], SCALE_REG, l_pair);
+        if (m_bias == bias_t::n) {
+            load_column_pair(m_kernel, B_VREGS[1], BIAS_REG, l_pair);
+        } else if (m_bias == bias_t::none) {
+            // C of the column pair, zipped to the layout of the accumulators one at a time
+            for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                load_bytes(m_kernel, A_VREGS[l_cv], HELP_REG, l_cv * 16, l_c_bytes(l_cv));
+            }
+            if (l_pair) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(C_PAIR_REG, HELP_REG, LDC_REG, 0, 0));
+                for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+                    load_bytes(m_kernel, A_VREGS[2 + l_cv], C_PAIR_REG, l_cv * 16, l_c_bytes(l_cv));
+                }
+            }
+        }
+
+        for (uint32_t l_pm = 0; l_pm < l_pairs_m; l_pm++) {
+            Inst::simd_fp_t l_reg = l_acc(l_pm, l_pn);
+            m_kernel.add_instr(Inst::neon_scvtf(l_reg, l_reg));
+            m_kernel.add_instr(Inst::neon_fmul_vector(l_reg, l_reg, B_VREGS[0], false));
+            if (m_bias == bias_t::n) {
+                m_kernel.add_instr(Inst::neon_fadd_vector(l_reg, l_reg, B_VREGS[1], false));
+            } else if (m_bias == bias_t::none) {
+                Inst::simd_fp_t const* l_col_1 = l_pair ? A_VREGS + 2 : A_VREGS;
+                m_kernel.add_instr(Inst::neon_zip(ZIP_VREGS[0], A_VREGS[l_pm / 2], l_col_1[l_pm / 2], 1 + l_pm % 2, Inst::s));
+                m_kernel.add_instr(Inst::neon_fadd_vector(l_reg, l_reg, ZIP_VREGS[0], false));
+            }
+        }
+
+        if (l_pn + 1 < l_pairs_n) {
+            m_kernel.add_instr(Inst::base_add_imm(SCALE_REG, SCALE_REG, 8, 0));
+            if (m_bias == bias_t::n) {
+                m_kernel.add_instr(Inst::base_add_imm(BIAS_REG, BIAS_REG, 8, 0));
+            } else if (m_bias == bias_t::none) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 1));
+            }
+        }
+    }
+
+    // activations are elementwise and are applied to the 2x2 blocks, the A registers are free
+    if (m_act == act_t::relu) {
+        m_kernel.add_instr(Inst::neon_movi_zero(A_VREGS[0], true, false));
+        for (uint32_t l_ac = 0; l_ac < l_pairs_m * l_pairs_n; l_ac++) {
+            Inst::simd_fp_t l_reg = static_cast<Inst::simd_fp_t>(l_ac);
+            m_kernel.add_instr(Inst::neon_fmax_vector(l_reg, l_reg, A_VREGS[0], false));
+        }
+    } else if (Activation::is_rational(m_act)) {
+        Activation::gen_table_neon(m_kernel, HELP_REG);
+        Activation::gen_neon(m_kernel, m_act, 0, l_pairs_m * l_pairs_n, HELP_REG);
+    }
+
+    // store block of C: UZP of two accumulators gives four rows of the columns n and n + 1
+    m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+    for (uint32_t l_pn = 0; l_pn < l_pairs_n; l_pn++) {
+        bool l_pair = (2 * l_pn + 1 < i_n);
+        if (l_pair) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(C_PAIR_REG, HELP_REG, LDC_REG, 0, 0));
+        }
+        for (uint32_t l_cv = 0; l_cv < l_c_vectors; l_cv++) {
+            Inst::simd_fp_t l_first = l_acc(2 * l_cv, l_pn);
+            Inst::simd_fp_t l_second = (2 * l_cv + 1 < l_pairs_m) ? l_acc(2 * l_cv + 1, l_pn) : l_first;
+
+            m_kernel.add_instr(Inst::neon_uzp(A_VREGS[0], l_first, l_second, 1, Inst::s));
+            store_bytes(m_kernel, A_VREGS[0], HELP_REG, l_cv * 16, l_c_bytes(l_cv));
+            if (l_pair) {
+                m_kernel.add_instr(Inst::neon_uzp(A_VREGS[1], l_first, l_second, 2, Inst::s));
+                store_bytes(m_kernel, A_VREGS[1], C_PAIR_REG, l_cv * 16, l_c_bytes(l_cv));
+            }
+        }
+        if (l_pn + 1 < l_pairs_n) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 1));
+        }
+    }
+}
+
+mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate_int8(uint32_t m,
+                                                                                uint32_t n,
+                                                                                uint32_t k,
+                                                                                uint32_t br_size) {
+    BRGEMM_EXPECT(backend::Cpu::has_int8());
+    BRGEMM_EXPECT(m > 0 && n > 0 && k > 0 && br_size > 0);
+
+    // blocking: up to four pairs of rows and eight columns, i.e., 16 accumulators
+    uint32_t l_m_block = 2 * MAX_M_PAIRS;
+    if (m_blocking.m_vectors > 0) {
+        BRGEMM_EXPECT(m_blocking.m_vectors <= MAX_M_PAIRS);
+        l_m_block = 2 * m_blocking.m_vectors;
+    }
+    l_m_block = (l_m_block < m) ? l_m_block : m;
+    uint32_t l_n_block = MAX_N_BLOCK;
+    if (m_blocking.n > 0) {
+        BRGEMM_EXPECT(m_blocking.n <= MAX_N_BLOCK);
+        l_n_block = m_blocking.n;
+    }
+    l_n_block = (l_n_block < n) ? l_n_block : n;
+
+    uint32_t l_full_m = m / l_m_block;
+    uint32_t l_rem_m = m % l_m_block;
+
+    uint32_t l_full_n = n / l_n_block;
+    uint32_t l_rem_n = n % l_n_block;
+
+    // procedure call standard (store to stack)
+    // GR
+    m_kernel.add_instr(0xa9bf53f3);
+    m_kernel.add_instr(0xa9bf5bf5);
+    m_kernel.add_instr(0xa9bf63f7);
+    m_kernel.add_instr(0xa9bf6bf9);
+    m_kernel.add_instr(0xa9bf73fb);
+    // NEON, lower 64 bits of v8-v15
+    m_kernel.add_instr(0x6DBF27E8);
+    m_kernel.add_instr(0x6DBF2FEA);
+    m_kernel.add_instr(0x6DBF37EC);
+    m_kernel.add_instr(0x6DBF3FEE);
+
+    // leading dimensions and BR strides in bytes, 8-bit values in A and B, 32-bit values in C
+    m_kernel.add_instr(Inst::base_lsl_imm(LDC_REG, LDC_REG, 2));
+
+    if (m_prefetch.k_distance > 0) {
+        mov_imm32(m_kernel, PREFETCH_OFFSET_A_REG, m_prefetch.k_distance);
+        m_kernel.add_instr(Inst::base_mul_reg(PREFETCH_OFFSET_A_REG, PREFETCH_OFFSET_A_REG, LDA_REG));
+    }
+
+    if (br_size > 1) {
+        mov_imm32(m_kernel, HELP_REG, k);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDA_REG));
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_A_REG, BR_STEP_A_REG, HELP_REG, 0, 0));
+
+        mov_imm32(m_kernel, HELP_REG, k);
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_B_REG, BR_STEP_B_REG, HELP_REG, 0, 0));
+    }
+
+    // all register blocks of a column block
+    auto l_gen_m_loop = [&](uint32_t i_n) {
+        m_kernel.add_instr(Inst::base_movz(M_OFFSET_REG, 0, 0));
+
+        if (l_full_m > 0) {
+            mov_imm32(m_kernel, M_LOOP_COUNT_REG, l_full_m);
+            std::size_t l_m_loop_pos = m_kernel.get_size();
+
+            gen_block_int8(l_m_block, i_n, n, k, br_size);
+
+            m_kernel.add_instr(Inst::base_add_imm(M_OFFSET_REG, M_OFFSET_REG, l_m_block * 4, 0));
+            m_kernel.add_instr(Inst::base_sub_imm(M_LOOP_COUNT_REG, M_LOOP_COUNT_REG, 1, 0));
+            m_kernel.add_instr(Inst::base_br_cbnz(M_LOOP_COUNT_REG, (static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+        }
+        if (l_rem_m > 0) {
+            gen_block_int8(l_rem_m, i_n, n, k, br_size);
+        }
+    };
+
+    // N loop
+    if (l_full_n > 0) {
+        mov_imm32(m_kernel, N_LOOP_COUNT_REG, l_full_n);
+        std::size_t l_n_loop_pos = m_kernel.get_size();
+
+        l_gen_m_loop(l_n_block);
+
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDB_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(B_COL_REG, B_COL_REG, HELP_REG, 0, 0));
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDC_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(C_COL_REG, C_COL_REG, HELP_REG, 0, 0));
+
+        // the scale argument on the stack is advanced in place to the next column block
+        m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, SCALE_ARG_OFFSET));
+        m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, l_n_block * 4, 0));
+        m_kernel.add_instr(Inst::base_str_imm(HELP_REG, Inst::sp, SCALE_ARG_OFFSET));
+
+        m_kernel.add_instr(Inst::base_sub_imm(N_LOOP_COUNT_REG, N_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(N_LOOP_COUNT_REG, (static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (l_rem_n > 0) {
+        l_gen_m_loop(l_rem_n);
+    }
+
+    // procedure call standard (load from stack)
+    m_kernel.add_instr(0x6CC13FEE);
+    m_kernel.add_instr(0x6CC137EC);
+    m_kernel.add_instr(0x6CC12FEA);
+    m_kernel.add_instr(0x6CC127E8);
+
+    m_kernel.add_instr(0xa8c173fb);
+    m_kernel.add_instr(0xa8c16bf9);
+    m_kernel.add_instr(0xa8c163f7);
+    m_kernel.add_instr(0xa8c15bf5);
+    m_kernel.add_instr(0xa8c153f3);
+
+    m_kernel.add_instr(Inst::base_ret());
+
+    m_kernel.set_kernel();
+
+    return error_t::success;
+}
@@ -0,0 +1,366 @@
+#include "../instructions/instructions.h"
+#include "Brgemm.h"
+
+using Inst = mini_jit::instructions::InstGen;
+
+/*
+ * Register usage of the SVE BRGEMM kernels (AAPCS64).
+ *
+ * Arguments: x0 = A, x1 = B, x2 = C, x3 = lda, x4 = ldb, x5 = ldc,
+ *            x6 = br_stride_a, x7 = br_stride_b, stack = bias.
+ *
+ * The kernels are vector-length agnostic: the rows of a register block are
+ * selected at runtime through WHILELT predicates, which also cover the M remainder.
+ */
+namespace {
+    //! A, constant
+    constexpr Inst::gpr_t A_REG = Inst::x0;
+    //! B of the current column block
+    constexpr Inst::gpr_t B_COL_REG = Inst::x1;
+    //! C of the current column block
+    constexpr Inst::gpr_t C_COL_REG = Inst::x2;
+
+    //! leading dimensions in bytes
+    constexpr Inst::gpr_t LDA_REG = Inst::x3;
+    constexpr Inst::gpr_t LDB_REG = Inst::x4;
+    constexpr Inst::gpr_t LDC_REG = Inst::x5;
+
+    //! steps from the end of the K loop to the next matrices of the batch in bytes
+    constexpr Inst::gpr_t BR_STEP_A_REG = Inst::x6;
+    constexpr Inst::gpr_t BR_STEP_B_REG = Inst::x7;
+
+    //! first row of the current register block and number of rows
+    constexpr Inst::gpr_t M_INDEX_REG = Inst::x8;
+    constexpr Inst::gpr_t M_SIZE_REG = Inst::x9;
+
+    //! working pointer of A
+    constexpr Inst::gpr_t WORKING_A_REG = Inst::x10;
+    //! offset of the A values prefetched in the K loop
+    constexpr Inst::gpr_t PREFETCH_OFFSET_A_REG = Inst::x11;
+    //! BR strides in bytes, used to prefetch the next matrices of the batch
+    constexpr Inst::gpr_t BR_STRIDE_A_REG = Inst::x16;
+    constexpr Inst::gpr_t BR_STRIDE_B_REG = Inst::x17;
+    //! working pointers of B, one per column
+    constexpr Inst::gpr_t WORKING_B_REGS[10] = {Inst::x19, Inst::x20, Inst::x21, Inst::x22, Inst::x23,
+                                                Inst::x24, Inst::x25, Inst::x26, Inst::x27, Inst::x28};
+
+    //! loop counters
+    constexpr Inst::gpr_t K_LOOP_COUNT_REG = Inst::x12;
+    constexpr Inst::gpr_t BR_LOOP_COUNT_REG = Inst::x13;
+    constexpr Inst::gpr_t N_LOOP_COUNT_REG = Inst::x14;
+
+    constexpr Inst::gpr_t HELP_REG = Inst::x15;
+
+    //! predicates of the row vectors and of all lanes
+    constexpr Inst::pred_t M_PREDS[2] = {Inst::p0, Inst::p1};
+    constexpr Inst::pred_t ALL_PRED = Inst::p2;
+
+    //! vector registers of A and the broadcasted values of B, the accumulators start at z0
+    constexpr Inst::simd_fp_t A_VREGS[2] = {Inst::v28, Inst::v29};
+    constexpr Inst::simd_fp_t B_VREGS[2] = {Inst::v30, Inst::v31};
+
+    //! maximum number of columns of a register block
+    constexpr uint32_t MAX_N_BLOCK = 10;
+
+    //! unrolling of the K loop
+    constexpr uint32_t K_UNROLL = 4;
+
+    //! offset of the bias argument on the stack once the callee-saved registers are stored
+    constexpr uint32_t BIAS_ARG_OFFSET = 9 * 16;
+
+    /**
+     * Moves an unsigned 32-bit value to the given X register.
+     **/
+    void mov_imm32(mini_jit::backend::Kernel& i_kernel,
+                   Inst::gpr_t i_reg,
+                   uint32_t i_value) {
+        i_kernel.add_instr(Inst::base_movz(i_reg, i_value & 0xffff, 0));
+        if (i_value > 0xffff) {
+            i_kernel.add_instr(Inst::base_movk(i_reg, i_value >> 16, 16));
+        }
+    }
+}  // namespace
+
+void mini_jit::generator::Brgemm::gen_block_sve(uint32_t i_m_vectors,
+                                                uint32_t i_n,
+                                                uint32_t k,
+                                                uint32_t br_size,
+                                                bool is_relu) {
+    // accumulator of row vector i and column j: j * i_m_vectors + i
+    auto l_acc = [&](uint32_t i_m, uint32_t i_n) {
+        return static_cast<Inst::simd_fp_t>(i_n * i_m_vectors + i_m);
+    };
+
+    if (m_bias == bias_t::none) {
+        // load block of C
+        m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_INDEX_REG, 0, 2));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                m_kernel.add_instr(Inst::sve_ld1w(l_acc(l_m, l_n), M_PREDS[l_m], HELP_REG, l_m));
+            }
+            if (l_n + 1 < i_n) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 0));
+            }
+        }
+    } else if (m_bias == bias_t::zero) {
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                m_kernel.add_instr(Inst::sve_dup_zero(l_acc(l_m, l_n)));
+            }
+        }
+    } else {
+        // initialize the block with the bias of its rows or of the current column block
+        m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        if (m_bias == bias_t::m) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, M_INDEX_REG, 0, 2));
+        }
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                if (m_bias == bias_t::m) {
+                    m_kernel.add_instr(Inst::sve_ld1w(l_acc(l_m, l_n), M_PREDS[l_m], HELP_REG, l_m));
+                } else {
+                    m_kernel.add_instr(Inst::sve_ld1rw(l_acc(l_m, l_n), ALL_PRED, HELP_REG, l_n * 4));
+                }
+            }
+        }
+    }
+
+    // working pointers of A and B
+    m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, A_REG, M_INDEX_REG, 0, 2));
+    m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REGS[0], B_COL_REG));
+    for (uint32_t l_n = 1; l_n < i_n; l_n++) {
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n - 1], LDB_REG, 0, 0));
+    }
+
+    // one or more steps in K, the values of B are addressed through immediate offsets
+    uint32_t l_b_count = 0;
+    auto l_gen_k_steps = [&](uint32_t i_steps) {
+        for (uint32_t l_k = 0; l_k < i_steps; l_k++) {
+            if (m_prefetch.k_distance > 0) {
+                m_kernel.add_instr(Inst::base_prfm_register(Inst::pldl1keep, WORKING_A_REG, PREFETCH_OFFSET_A_REG));
+            }
+            if (m_prefetch.next_br && br_size > 1) {
+                // first cache line of the column of the next A block
+                m_kernel.add_instr(Inst::base_prfm_register(Inst::pldl2keep, WORKING_A_REG, BR_STRIDE_A_REG));
+            }
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                m_kernel.add_instr(Inst::sve_ld1w(A_VREGS[l_m], M_PREDS[l_m], WORKING_A_REG, l_m));
+            }
+            m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, LDA_REG, 0, 0));
+
+            for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+                Inst::simd_fp_t l_b = B_VREGS[l_b_count++ % 2];
+                m_kernel.add_instr(Inst::sve_ld1rw(l_b, ALL_PRED, WORKING_B_REGS[l_n], l_k * 4));
+                for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                    m_kernel.add_instr(Inst::sve_fmla(l_acc(l_m, l_n), M_PREDS[l_m], A_VREGS[l_m], l_b));
+                }
+            }
+        }
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            m_kernel.add_instr(Inst::base_add_imm(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n], i_steps * 4, 0));
+        }
+    };
+
+    // BR loop
+    std::size_t l_br_loop_pos = 0;
+    if (br_size > 1) {
+        mov_imm32(m_kernel, BR_LOOP_COUNT_REG, br_size);
+        l_br_loop_pos = m_kernel.get_size();
+
+        if (m_prefetch.next_br) {
+            // the next B block is shared by all row blocks, only the first one prefetches it
+            uint32_t l_lines_b = (k * 4 + 63) / 64;
+            uint32_t l_mov_size = (l_lines_b > 0xffff) ? 2 : 1;
+            m_kernel.add_instr(Inst::base_br_cbnz(M_INDEX_REG, static_cast<int32_t>(i_n + l_mov_size + 5)));
+
+            // one cache line of all columns of the next B block per iteration
+            m_kernel.add_instr(Inst::base_mov_register(HELP_REG, BR_STRIDE_B_REG));
+            mov_imm32(m_kernel, K_LOOP_COUNT_REG, l_lines_b);
+            std::size_t l_pf_loop_pos = m_kernel.get_size();
+            for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+                m_kernel.add_instr(Inst::base_prfm_register(Inst::pldl2keep, WORKING_B_REGS[l_n], HELP_REG));
+            }
+            m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, 64, 0));
+            m_kernel.add_instr(Inst::base_sub_imm(K_LOOP_COUNT_REG, K_LOOP_COUNT_REG, 1, 0));
+            m_kernel.add_instr(Inst::base_br_cbnz(K_LOOP_COUNT_REG, (static_cast<int32_t>(l_pf_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+        }
+    }
+
+    // K loop
+    uint32_t l_k_unroll = (k < K_UNROLL) ? k : K_UNROLL;
+    mov_imm32(m_kernel, K_LOOP_COUNT_REG, k / l_k_unroll);
+    std::size_t l_k_loop_pos = m_kernel.get_size();
+
+    l_gen_k_steps(l_k_unroll);
+
+    m_kernel.add_instr(Inst::base_sub_imm(K_LOOP_COUNT_REG, K_LOOP_COUNT_REG, 1, 0));
+    m_kernel.add_instr(Inst::base_br_cbnz(K_LOOP_COUNT_REG, (static_cast<int32_t>(l_k_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+
+    if (k % l_k_unroll != 0) {
+        l_gen_k_steps(k % l_k_unroll);
+    }
+
+    if (br_size > 1) {
+        // next matrices of the batch
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, BR_STEP_A_REG, 0, 0));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n], BR_STEP_B_REG, 0, 0));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(BR_LOOP_COUNT_REG, BR_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(BR_LOOP_COUNT_REG, (static_cast<int32_t>(l_br_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+
+    // ReLU
+    if (is_relu) {
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                m_kernel.add_instr(Inst::sve_fmax_zero(l_acc(l_m, l_n), ALL_PRED));
+            }
+        }
+    }
+
+    // rational activation, z24-z27 are free and the store resets HELP_REG
+    if (Activation::is_rational(m_act)) {
+        Activation::gen_table_sve(m_kernel, HELP_REG);
+        Activation::gen_sve(m_kernel, m_act, i_m_vectors * i_n, ALL_PRED, HELP_REG);
+    }
+
+    // store block of C
+    m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_INDEX_REG, 0, 2));
+    for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+        for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+            m_kernel.add_instr(Inst::sve_st1w(l_acc(l_m, l_n), M_PREDS[l_m], HELP_REG, l_m));
+        }
+        if (l_n + 1 < i_n) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 0));
+        }
+    }
+}
+
+mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate_sve(uint32_t m,
+                                                                               uint32_t n,
+                                                                               uint32_t k,
+                                                                               uint32_t br_size,
+                                                                               bool is_relu) {
+    BRGEMM_EXPECT(m > 0 && n > 0 && k > 0 && br_size > 0);
+
+    // blocking: one vector if M fits into the minimum vector length of 128 bits, two otherwise
+    uint32_t l_m_vectors = (m <= 4) ? 1 : 2;
+    uint32_t l_n_block = (n < MAX_N_BLOCK) ? n : MAX_N_BLOCK;
+    if (m_blocking.m_vectors > 0) {
+        BRGEMM_EXPECT(m_blocking.m_vectors <= 2);
+        l_m_vectors = m_blocking.m_vectors;
+    }
+    if (m_blocking.n > 0) {
+        BRGEMM_EXPECT(m_blocking.n <= MAX_N_BLOCK);
+        l_n_block = (m_blocking.n < n) ? m_blocking.n : n;
+    }
+
+    uint32_t l_full_n = n / l_n_block;
+    uint32_t l_rem_n = n % l_n_block;
+
+    // procedure call standard (store to stack)
+    // GR
+    m_kernel.add_instr(0xa9bf53f3);
+    m_kernel.add_instr(0xa9bf5bf5);
+    m_kernel.add_instr(0xa9bf63f7);
+    m_kernel.add_instr(0xa9bf6bf9);
+    m_kernel.add_instr(0xa9bf73fb);
+    // NEON, lower 64 bits of z8-z15
+    m_kernel.add_instr(0x6DBF27E8);
+    m_kernel.add_instr(0x6DBF2FEA);
+    m_kernel.add_instr(0x6DBF37EC);
+    m_kernel.add_instr(0x6DBF3FEE);
+
+    // leading dimensions and BR strides in bytes
+    m_kernel.add_instr(Inst::base_lsl_imm(LDA_REG, LDA_REG, 2));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDB_REG, LDB_REG, 2));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDC_REG, LDC_REG, 2));
+
+    if (m_prefetch.k_distance > 0) {
+        mov_imm32(m_kernel, PREFETCH_OFFSET_A_REG, m_prefetch.k_distance);
+        m_kernel.add_instr(Inst::base_mul_reg(PREFETCH_OFFSET_A_REG, PREFETCH_OFFSET_A_REG, LDA_REG));
+    }
+
+    if (br_size > 1) {
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STRIDE_A_REG, BR_STEP_A_REG, 2));
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STRIDE_B_REG, BR_STEP_B_REG, 2));
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_A_REG, BR_STEP_A_REG, 2));
+        mov_imm32(m_kernel, HELP_REG, k);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDA_REG));
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_A_REG, BR_STEP_A_REG, HELP_REG, 0, 0));
+
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_B_REG, BR_STEP_B_REG, 2));
+        mov_imm32(m_kernel, HELP_REG, k * 4);
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_B_REG, BR_STEP_B_REG, HELP_REG, 0, 0));
+    }
+
+    m_kernel.add_instr(Inst::sve_ptrue(ALL_PRED));
+    mov_imm32(m_kernel, M_SIZE_REG, m);
+
+    // all register blocks of a column block, the last one is predicated through WHILELT
+    auto l_gen_m_loop = [&](uint32_t i_n) {
+        m_kernel.add_instr(Inst::base_movz(M_INDEX_REG, 0, 0));
+        m_kernel.add_instr(Inst::sve_whilelt(M_PREDS[0], M_INDEX_REG, M_SIZE_REG));
+        std::size_t l_m_loop_pos = m_kernel.get_size();
+
+        if (l_m_vectors > 1) {
+            m_kernel.add_instr(Inst::base_mov_register(HELP_REG, M_INDEX_REG));
+            m_kernel.add_instr(Inst::sve_incw(HELP_REG, 1));
+            m_kernel.add_instr(Inst::sve_whilelt(M_PREDS[1], HELP_REG, M_SIZE_REG));
+        }
+
+        gen_block_sve(l_m_vectors, i_n, k, br_size, is_relu);
+
+        m_kernel.add_instr(Inst::sve_incw(M_INDEX_REG, l_m_vectors));
+        m_kernel.add_instr(Inst::sve_whilelt(M_PREDS[0], M_INDEX_REG, M_SIZE_REG));
+        m_kernel.add_instr(Inst::base_b_cond(Inst::cond_t::mi, (static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    };
+
+    // N loop
+    if (l_full_n > 0) {
+        mov_imm32(m_kernel, N_LOOP_COUNT_REG, l_full_n);
+        std::size_t l_n_loop_pos = m_kernel.get_size();
+
+        l_gen_m_loop(l_n_block);
+
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDB_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(B_COL_REG, B_COL_REG, HELP_REG, 0, 0));
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDC_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(C_COL_REG, C_COL_REG, HELP_REG, 0, 0));
+
+        // the bias argument on the stack is advanced in place to the next column block
+        if (m_bias == bias_t::n) {
+            m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+            m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, l_n_block * 4, 0));
+            m_kernel.add_instr(Inst::base_str_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(N_LOOP_COUNT_REG, N_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(N_LOOP_COUNT_REG, (static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (l_rem_n > 0) {
+        l_gen_m_loop(l_rem_n);
+    }
+
+    // procedure call standard (load from stack)
+    m_kernel.add_instr(0x6CC13FEE);
+    m_kernel.add_instr(0x6CC137EC);
+    m_kernel.add_instr(0x6CC12FEA);
+    m_kernel.add_instr(0x6CC127E8);
+
+    m_kernel.add_instr(0xa8c173fb);
+    m_kernel.add_instr(0xa8c16bf9);
+    m_kernel.add_instr(0xa8c163f7);
+    m_kernel.add_instr(0xa8c15bf5);
+    m_kernel.add_instr(0xa8c153f3);
+
+    m_kernel.add_instr(Inst::base_ret());
+
+    m_kernel.set_kernel();
+
+    return error_t::success;
+}
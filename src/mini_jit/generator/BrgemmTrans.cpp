@@ -0,0 +1,493 @@
+#include "../instructions/instructions.h"
+#include "Brgemm.h"
+
+using Inst = mini_jit::instructions::InstGen;
+
+/*
+ * Register usage of the single precision NEON BRGEMM kernels with transposed operands (AAPCS64).
+ *
+ * Arguments: x0 = A, x1 = B, x2 = C, x3 = lda, x4 = ldb, x5 = ldc,
+ *            x6 = br_stride_a, x7 = br_stride_b, stack = bias.
+ *
+ * A row-major C is computed as C^T = B^T * A^T, i.e., x0 and x1, x3 and x4 and x6 and x7 are swapped at entry.
+ *
+ * The K loop processes four columns of A per iteration. A vector of A holds four rows of a column:
+ * a column-major A is loaded directly, four rows of a row-major A are loaded and transposed with TRN1/TRN2
+ * on .4s and ZIP1/ZIP2 on .2d arrangements. A column-major B is loaded per column, a row-major B per row
+ * in groups of four columns, FMLA (element) multiplies with the value of the lane.
+ */
+namespace {
+    //! A, constant
+    constexpr Inst::gpr_t A_REG = Inst::x0;
+    //! B of the current column block
+    constexpr Inst::gpr_t B_COL_REG = Inst::x1;
+    //! C of the current column block
+    constexpr Inst::gpr_t C_COL_REG = Inst::x2;
+
+    //! leading dimensions in bytes
+    constexpr Inst::gpr_t LDA_REG = Inst::x3;
+    constexpr Inst::gpr_t LDB_REG = Inst::x4;
+    constexpr Inst::gpr_t LDC_REG = Inst::x5;
+
+    //! steps from the end of the K loop to the next matrices of the batch in bytes
+    constexpr Inst::gpr_t BR_STEP_A_REG = Inst::x6;
+    constexpr Inst::gpr_t BR_STEP_B_REG = Inst::x7;
+
+    //! offset of the current register block in a column of C in bytes
+    constexpr Inst::gpr_t M_OFFSET_REG = Inst::x8;
+
+    //! working pointer of A
+    constexpr Inst::gpr_t WORKING_A_REG = Inst::x10;
+    //! row of a row-major A which is loaded
+    constexpr Inst::gpr_t ROW_A_REG = Inst::x11;
+    //! A of the current register block and step to the next one in bytes
+    constexpr Inst::gpr_t A_BLOCK_REG = Inst::x16;
+    constexpr Inst::gpr_t M_STEP_A_REG = Inst::x17;
+    //! working pointers of B, one per column of a column-major B, the first one walks over the rows of a row-major B
+    constexpr Inst::gpr_t WORKING_B_REGS[9] = {Inst::x19, Inst::x20, Inst::x21, Inst::x22, Inst::x23,
+                                               Inst::x24, Inst::x25, Inst::x26, Inst::x27};
+    //! address of the lanes of partial loads and stores
+    constexpr Inst::gpr_t LANE_REG = Inst::x28;
+
+    //! loop counters
+    constexpr Inst::gpr_t M_LOOP_COUNT_REG = Inst::x9;
+    constexpr Inst::gpr_t K_LOOP_COUNT_REG = Inst::x12;
+    constexpr Inst::gpr_t BR_LOOP_COUNT_REG = Inst::x13;
+    constexpr Inst::gpr_t N_LOOP_COUNT_REG = Inst::x14;
+
+    constexpr Inst::gpr_t HELP_REG = Inst::x15;
+
+    //! vectors of A: column j of the step, row vector i at v16 + 2 * j + i, the accumulators start at v0
+    constexpr uint32_t FIRST_A_VREG = 16;
+    //! results of TRN1/TRN2 of the rows of a row-major A
+    constexpr Inst::simd_fp_t TRN_VREGS[4] = {Inst::v24, Inst::v25, Inst::v26, Inst::v27};
+    //! values of B, v28-v31 are the temporaries of the rational activations once the block is computed
+    constexpr Inst::simd_fp_t B_VREGS[4] = {Inst::v28, Inst::v29, Inst::v30, Inst::v31};
+
+    //! lanes of FMLA (element)
+    constexpr Inst::element_spec_t LANES[4] = {Inst::S4_0, Inst::S4_1, Inst::S4_2, Inst::S4_3};
+
+    //! rows of a vector, maximum number of vectors in M direction, columns and accumulators of a register block
+    constexpr uint32_t VECTOR_ROWS = 4;
+    constexpr uint32_t MAX_M_VECTORS = 2;
+    constexpr uint32_t MAX_N_BLOCK = 9;
+    constexpr uint32_t MAX_ACCUMULATORS = 16;
+
+    //! columns of A per iteration of the K loop
+    constexpr uint32_t K_STEP = 4;
+
+    //! offset of the bias argument on the stack once the callee-saved registers are stored
+    constexpr uint32_t BIAS_ARG_OFFSET = 9 * 16;
+
+    /**
+     * Moves an unsigned 32-bit value to the given X register.
+     **/
+    void mov_imm32(mini_jit::backend::Kernel& i_kernel,
+                   Inst::gpr_t i_reg,
+                   uint32_t i_value) {
+        i_kernel.add_instr(Inst::base_movz(i_reg, i_value & 0xffff, 0));
+        if (i_value > 0xffff) {
+            i_kernel.add_instr(Inst::base_movk(i_reg, i_value >> 16, 16));
+        }
+    }
+
+    /**
+     * Scalar or 128-bit register of the given size in bytes.
+     **/
+    Inst::arr_spec_t reg_spec(uint32_t i_bytes) {
+        return (i_bytes == 16) ? Inst::q : (i_bytes == 8) ? Inst::d
+                                                          : Inst::s;
+    }
+
+    /**
+     * Loads i_bytes (a multiple of four, at most 16) bytes into the lower part of a vector register without touching the memory behind them.
+     * The largest power of two is loaded first, which zeroes the register, a remaining value is inserted into its lane.
+     **/
+    void load_bytes(mini_jit::backend::Kernel& i_kernel,
+                    Inst::simd_fp_t i_reg,
+                    Inst::gpr_t i_base,
+                    uint32_t i_offset,
+                    uint32_t i_bytes) {
+        uint32_t l_first = (i_bytes == 16) ? 16 : (i_bytes >= 8) ? 8
+                                                                 : 4;
+        i_kernel.add_instr(Inst::neon_ldr_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+        if (i_bytes > l_first) {
+            i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_first, 0));
+            i_kernel.add_instr(Inst::neon_ld1_scalar_index(i_reg, LANE_REG, l_first / 4));
+        }
+    }
+
+    /**
+     * Stores the lower i_bytes (a multiple of four, at most 16) bytes of a vector register, see load_bytes.
+     **/
+    void store_bytes(mini_jit::backend::Kernel& i_kernel,
+                     Inst::simd_fp_t i_reg,
+                     Inst::gpr_t i_base,
+                     uint32_t i_offset,
+                     uint32_t i_bytes) {
+        uint32_t l_first = (i_bytes == 16) ? 16 : (i_bytes >= 8) ? 8
+                                                                 : 4;
+        i_kernel.add_instr(Inst::neon_str_imm(i_reg, i_base, i_offset, reg_spec(l_first)));
+        if (i_bytes > l_first) {
+            i_kernel.add_instr(Inst::base_add_imm(LANE_REG, i_base, i_offset + l_first, 0));
+            i_kernel.add_instr(Inst::neon_st1_scalar_index(i_reg, LANE_REG, l_first / 4));
+        }
+    }
+}  // namespace
+
+void mini_jit::generator::Brgemm::gen_block_trans(uint32_t i_m,
+                                                  uint32_t i_n,
+                                                  uint32_t k,
+                                                  uint32_t br_size,
+                                                  bool is_relu) {
+    uint32_t l_m_vectors = (i_m + VECTOR_ROWS - 1) / VECTOR_ROWS;
+
+    // accumulator of row vector i and column j: j * l_m_vectors + i
+    auto l_acc = [&](uint32_t i_mv, uint32_t i_n) {
+        return static_cast<Inst::simd_fp_t>(i_n * l_m_vectors + i_mv);
+    };
+    auto l_a = [&](uint32_t i_mv, uint32_t i_k) {
+        return static_cast<Inst::simd_fp_t>(FIRST_A_VREG + i_k * MAX_M_VECTORS + i_mv);
+    };
+    // rows of a vector, less than four in the last vector of a remainder
+    auto l_rows = [&](uint32_t i_mv) {
+        uint32_t l_left = i_m - i_mv * VECTOR_ROWS;
+        return (l_left < VECTOR_ROWS) ? l_left : VECTOR_ROWS;
+    };
+    auto l_load = [&](Inst::simd_fp_t i_reg, Inst::gpr_t i_base, uint32_t i_offset, uint32_t i_bytes) {
+        if (i_bytes == 16) {
+            m_kernel.add_instr(Inst::neon_ldr_imm(i_reg, i_base, i_offset, Inst::q));
+        } else {
+            load_bytes(m_kernel, i_reg, i_base, i_offset, i_bytes);
+        }
+    };
+    uint32_t l_num_b_regs = m_trans_b ? 1 : i_n;
+
+    if (m_bias == bias_t::none) {
+        // load block of C
+        m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                l_load(l_acc(l_mv, l_n), HELP_REG, l_mv * 16, l_rows(l_mv) * 4);
+            }
+            if (l_n + 1 < i_n) {
+                m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 0));
+            }
+        }
+    } else if (m_bias == bias_t::zero) {
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                m_kernel.add_instr(Inst::neon_movi_zero(l_acc(l_mv, l_n), true, false));
+            }
+        }
+    } else {
+        // initialize the block with the bias of its rows or of the current column block
+        m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        if (m_bias == bias_t::m) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, M_OFFSET_REG, 0, 0));
+        }
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                if (m_bias == bias_t::m) {
+                    l_load(l_acc(l_mv, l_n), HELP_REG, l_mv * 16, l_rows(l_mv) * 4);
+                } else {
+                    m_kernel.add_instr(Inst::neon_ld1r(l_acc(l_mv, l_n), HELP_REG, false));
+                }
+            }
+            if (m_bias == bias_t::n && l_n + 1 < i_n) {
+                m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, 4, 0));
+            }
+        }
+    }
+
+    // working pointers of A and B
+    m_kernel.add_instr(Inst::base_mov_register(WORKING_A_REG, A_BLOCK_REG));
+    m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REGS[0], B_COL_REG));
+    for (uint32_t l_n = 1; l_n < l_num_b_regs; l_n++) {
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n - 1], LDB_REG, 0, 0));
+    }
+
+    // i_k_step (at most four) columns of A and rows of B
+    uint32_t l_b_count = 0;
+    auto l_gen_k_step = [&](uint32_t i_k_step) {
+        if (!m_trans_a) {
+            for (uint32_t l_k = 0; l_k < i_k_step; l_k++) {
+                for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                    l_load(l_a(l_mv, l_k), WORKING_A_REG, l_mv * 16, l_rows(l_mv) * 4);
+                }
+                m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, LDA_REG, 0, 0));
+            }
+        } else {
+            // i_k_step values of each row, the rows of a vector are transposed in the registers of its columns
+            m_kernel.add_instr(Inst::base_mov_register(ROW_A_REG, WORKING_A_REG));
+            for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                for (uint32_t l_row = 0; l_row < l_rows(l_mv); l_row++) {
+                    l_load(l_a(l_mv, l_row), ROW_A_REG, 0, i_k_step * 4);
+                    if (l_mv + 1 < l_m_vectors || l_row + 1 < l_rows(l_mv)) {
+                        m_kernel.add_instr(Inst::base_add_shifted_register(ROW_A_REG, ROW_A_REG, LDA_REG, 0, 0));
+                    }
+                }
+                // rows r0, r1, r2, r3: trn1(r0, r1) = (a00, a10, a02, a12), trn2(r0, r1) = (a01, a11, a03, a13), ...
+                m_kernel.add_instr(Inst::neon_trn(TRN_VREGS[0], l_a(l_mv, 0), l_a(l_mv, 1), 1));
+                m_kernel.add_instr(Inst::neon_trn(TRN_VREGS[1], l_a(l_mv, 0), l_a(l_mv, 1), 2));
+                m_kernel.add_instr(Inst::neon_trn(TRN_VREGS[2], l_a(l_mv, 2), l_a(l_mv, 3), 1));
+                m_kernel.add_instr(Inst::neon_trn(TRN_VREGS[3], l_a(l_mv, 2), l_a(l_mv, 3), 2));
+                // ... and the 64-bit halves form the columns
+                for (uint32_t l_k = 0; l_k < i_k_step; l_k++) {
+                    m_kernel.add_instr(Inst::neon_zip(l_a(l_mv, l_k), TRN_VREGS[l_k % 2], TRN_VREGS[2 + l_k % 2], 1 + l_k / 2, Inst::d));
+                }
+            }
+            m_kernel.add_instr(Inst::base_add_imm(WORKING_A_REG, WORKING_A_REG, i_k_step * 4, 0));
+        }
+
+        if (!m_trans_b) {
+            // i_k_step values of each column, the loads advance the working pointers
+            for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+                Inst::simd_fp_t l_b = B_VREGS[l_b_count++ % 2];
+                if (i_k_step == K_STEP) {
+                    m_kernel.add_instr(Inst::neon_ldr(l_b, WORKING_B_REGS[l_n], 16, Inst::q));
+                } else {
+                    load_bytes(m_kernel, l_b, WORKING_B_REGS[l_n], 0, i_k_step * 4);
+                    m_kernel.add_instr(Inst::base_add_imm(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n], i_k_step * 4, 0));
+                }
+                for (uint32_t l_k = 0; l_k < i_k_step; l_k++) {
+                    for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                        m_kernel.add_instr(Inst::neon_fmla_element(l_acc(l_mv, l_n), l_a(l_mv, l_k), l_b, LANES[l_k]));
+                    }
+                }
+            }
+        } else {
+            // the row of B in groups of four columns
+            for (uint32_t l_k = 0; l_k < i_k_step; l_k++) {
+                for (uint32_t l_nb = 0; l_nb < i_n; l_nb += 4) {
+                    Inst::simd_fp_t l_b = B_VREGS[l_b_count++ % 4];
+                    uint32_t l_cols = (i_n - l_nb < 4) ? i_n - l_nb : 4;
+                    l_load(l_b, WORKING_B_REGS[0], l_nb * 4, l_cols * 4);
+                    for (uint32_t l_n = l_nb; l_n < l_nb + l_cols; l_n++) {
+                        for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                            m_kernel.add_instr(Inst::neon_fmla_element(l_acc(l_mv, l_n), l_a(l_mv, l_k), l_b, LANES[l_n - l_nb]));
+                        }
+                    }
+                }
+                m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[0], WORKING_B_REGS[0], LDB_REG, 0, 0));
+            }
+        }
+    };
+
+    // BR loop
+    std::size_t l_br_loop_pos = 0;
+    if (br_size > 1) {
+        mov_imm32(m_kernel, BR_LOOP_COUNT_REG, br_size);
+        l_br_loop_pos = m_kernel.get_size();
+    }
+
+    // K loop
+    if (k >= K_STEP) {
+        mov_imm32(m_kernel, K_LOOP_COUNT_REG, k / K_STEP);
+        std::size_t l_k_loop_pos = m_kernel.get_size();
+
+        l_gen_k_step(K_STEP);
+
+        m_kernel.add_instr(Inst::base_sub_imm(K_LOOP_COUNT_REG, K_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(K_LOOP_COUNT_REG, (static_cast<int32_t>(l_k_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (k % K_STEP != 0) {
+        l_gen_k_step(k % K_STEP);
+    }
+
+    if (br_size > 1) {
+        // next matrices of the batch
+        m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REG, WORKING_A_REG, BR_STEP_A_REG, 0, 0));
+        for (uint32_t l_n = 0; l_n < l_num_b_regs; l_n++) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REGS[l_n], WORKING_B_REGS[l_n], BR_STEP_B_REG, 0, 0));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(BR_LOOP_COUNT_REG, BR_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(BR_LOOP_COUNT_REG, (static_cast<int32_t>(l_br_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+
+    // ReLU, the B registers are free
+    if (is_relu) {
+        m_kernel.add_instr(Inst::neon_movi_zero(B_VREGS[0], true, false));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+                m_kernel.add_instr(Inst::neon_fmax_vector(l_acc(l_mv, l_n), l_acc(l_mv, l_n), B_VREGS[0], false));
+            }
+        }
+    } else if (Activation::is_rational(m_act)) {
+        Activation::gen_table_neon(m_kernel, HELP_REG);
+        Activation::gen_neon(m_kernel, m_act, 0, l_m_vectors * i_n, HELP_REG);
+    }
+
+    // store block of C
+    m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, C_COL_REG, M_OFFSET_REG, 0, 0));
+    for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+        for (uint32_t l_mv = 0; l_mv < l_m_vectors; l_mv++) {
+            if (l_rows(l_mv) == VECTOR_ROWS) {
+                m_kernel.add_instr(Inst::neon_str_imm(l_acc(l_mv, l_n), HELP_REG, l_mv * 16, Inst::q));
+            } else {
+                store_bytes(m_kernel, l_acc(l_mv, l_n), HELP_REG, l_mv * 16, l_rows(l_mv) * 4);
+            }
+        }
+        if (l_n + 1 < i_n) {
+            m_kernel.add_instr(Inst::base_add_shifted_register(HELP_REG, HELP_REG, LDC_REG, 0, 0));
+        }
+    }
+}
+
+mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate_trans(uint32_t m,
+                                                                                 uint32_t n,
+                                                                                 uint32_t k,
+                                                                                 uint32_t br_size,
+                                                                                 bool is_relu) {
+    BRGEMM_EXPECT(m > 0 && n > 0 && k > 0 && br_size > 0);
+
+    // blocking: up to two vectors in M, as many columns as the accumulators allow
+    uint32_t l_m_vectors = (m + VECTOR_ROWS - 1) / VECTOR_ROWS;
+    l_m_vectors = (l_m_vectors < MAX_M_VECTORS) ? l_m_vectors : MAX_M_VECTORS;
+    if (m_blocking.m_vectors > 0) {
+        BRGEMM_EXPECT(m_blocking.m_vectors <= MAX_M_VECTORS);
+        l_m_vectors = m_blocking.m_vectors;
+    }
+    uint32_t l_n_block = MAX_ACCUMULATORS / l_m_vectors;
+    l_n_block = (l_n_block < MAX_N_BLOCK) ? l_n_block : MAX_N_BLOCK;
+    if (m_blocking.n > 0) {
+        BRGEMM_EXPECT(m_blocking.n <= l_n_block);
+        l_n_block = m_blocking.n;
+    }
+    l_n_block = (l_n_block < n) ? l_n_block : n;
+
+    uint32_t l_m_block = VECTOR_ROWS * l_m_vectors;
+    uint32_t l_full_m = m / l_m_block;
+    uint32_t l_rem_m = m % l_m_block;
+
+    uint32_t l_full_n = n / l_n_block;
+    uint32_t l_rem_n = n % l_n_block;
+
+    // procedure call standard (store to stack)
+    // GR
+    m_kernel.add_instr(0xa9bf53f3);
+    m_kernel.add_instr(0xa9bf5bf5);
+    m_kernel.add_instr(0xa9bf63f7);
+    m_kernel.add_instr(0xa9bf6bf9);
+    m_kernel.add_instr(0xa9bf73fb);
+    // NEON, lower 64 bits of v8-v15
+    m_kernel.add_instr(0x6DBF27E8);
+    m_kernel.add_instr(0x6DBF2FEA);
+    m_kernel.add_instr(0x6DBF37EC);
+    m_kernel.add_instr(0x6DBF3FEE);
+
+    // C^T = B^T * A^T: B takes the role of A
+    if (m_swap_ab) {
+        Inst::gpr_t const l_pairs[3][2] = {{A_REG, B_COL_REG}, {LDA_REG, LDB_REG}, {BR_STEP_A_REG, BR_STEP_B_REG}};
+        for (auto const& l_pair : l_pairs) {
+            m_kernel.add_instr(Inst::base_mov_register(HELP_REG, l_pair[0]));
+            m_kernel.add_instr(Inst::base_mov_register(l_pair[0], l_pair[1]));
+            m_kernel.add_instr(Inst::base_mov_register(l_pair[1], HELP_REG));
+        }
+    }
+
+    // leading dimensions in bytes
+    m_kernel.add_instr(Inst::base_lsl_imm(LDA_REG, LDA_REG, 2));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDB_REG, LDB_REG, 2));
+    m_kernel.add_instr(Inst::base_lsl_imm(LDC_REG, LDC_REG, 2));
+
+    // step of A to the next register block: l_m_block rows
+    mov_imm32(m_kernel, M_STEP_A_REG, m_trans_a ? l_m_block : l_m_block * 4);
+    if (m_trans_a) {
+        m_kernel.add_instr(Inst::base_mul_reg(M_STEP_A_REG, M_STEP_A_REG, LDA_REG));
+    }
+
+    // the K loop advances A by k columns and B by k rows
+    if (br_size > 1) {
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_A_REG, BR_STEP_A_REG, 2));
+        if (m_trans_a) {
+            mov_imm32(m_kernel, HELP_REG, k * 4);
+        } else {
+            mov_imm32(m_kernel, HELP_REG, k);
+            m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDA_REG));
+        }
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_A_REG, BR_STEP_A_REG, HELP_REG, 0, 0));
+
+        m_kernel.add_instr(Inst::base_lsl_imm(BR_STEP_B_REG, BR_STEP_B_REG, 2));
+        if (m_trans_b) {
+            mov_imm32(m_kernel, HELP_REG, k);
+            m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDB_REG));
+        } else {
+            mov_imm32(m_kernel, HELP_REG, k * 4);
+        }
+        m_kernel.add_instr(Inst::base_sub_shifted_register(BR_STEP_B_REG, BR_STEP_B_REG, HELP_REG, 0, 0));
+    }
+
+    // all register blocks of a column block
+    auto l_gen_m_loop = [&](uint32_t i_n) {
+        m_kernel.add_instr(Inst::base_movz(M_OFFSET_REG, 0, 0));
+        m_kernel.add_instr(Inst::base_mov_register(A_BLOCK_REG, A_REG));
+
+        if (l_full_m > 0) {
+            mov_imm32(m_kernel, M_LOOP_COUNT_REG, l_full_m);
+            std::size_t l_m_loop_pos = m_kernel.get_size();
+
+            gen_block_trans(l_m_block, i_n, k, br_size, is_relu);
+
+            m_kernel.add_instr(Inst::base_add_imm(M_OFFSET_REG, M_OFFSET_REG, l_m_block * 4, 0));
+            m_kernel.add_instr(Inst::base_add_shifted_register(A_BLOCK_REG, A_BLOCK_REG, M_STEP_A_REG, 0, 0));
+            m_kernel.add_instr(Inst::base_sub_imm(M_LOOP_COUNT_REG, M_LOOP_COUNT_REG, 1, 0));
+            m_kernel.add_instr(Inst::base_br_cbnz(M_LOOP_COUNT_REG, (static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+        }
+        if (l_rem_m > 0) {
+            gen_block_trans(l_rem_m, i_n, k, br_size, is_relu);
+        }
+    };
+
+    // N loop
+    if (l_full_n > 0) {
+        mov_imm32(m_kernel, N_LOOP_COUNT_REG, l_full_n);
+        std::size_t l_n_loop_pos = m_kernel.get_size();
+
+        l_gen_m_loop(l_n_block);
+
+        // next l_n_block columns of B: columns of a column-major B, values of the rows of a row-major B
+        if (m_trans_b) {
+            m_kernel.add_instr(Inst::base_add_imm(B_COL_REG, B_COL_REG, l_n_block * 4, 0));
+        } else {
+            mov_imm32(m_kernel, HELP_REG, l_n_block);
+            m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDB_REG));
+            m_kernel.add_instr(Inst::base_add_shifted_register(B_COL_REG, B_COL_REG, HELP_REG, 0, 0));
+        }
+        mov_imm32(m_kernel, HELP_REG, l_n_block);
+        m_kernel.add_instr(Inst::base_mul_reg(HELP_REG, HELP_REG, LDC_REG));
+        m_kernel.add_instr(Inst::base_add_shifted_register(C_COL_REG, C_COL_REG, HELP_REG, 0, 0));
+
+        // the bias argument on the stack is advanced in place to the next column block
+        if (m_bias == bias_t::n) {
+            m_kernel.add_instr(Inst::base_ldr_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+            m_kernel.add_instr(Inst::base_add_imm(HELP_REG, HELP_REG, l_n_block * 4, 0));
+            m_kernel.add_instr(Inst::base_str_imm(HELP_REG, Inst::sp, BIAS_ARG_OFFSET));
+        }
+
+        m_kernel.add_instr(Inst::base_sub_imm(N_LOOP_COUNT_REG, N_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(N_LOOP_COUNT_REG, (static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+    }
+    if (l_rem_n > 0) {
+        l_gen_m_loop(l_rem_n);
+    }
+
+    // procedure call standard (load from stack)
+    m_kernel.add_instr(0x6CC13FEE);
+    m_kernel.add_instr(0x6CC137EC);
+    m_kernel.add_instr(0x6CC12FEA);
+    m_kernel.add_instr(0x6CC127E8);
+
+    m_kernel.add_instr(0xa8c173fb);
+    m_kernel.add_instr(0xa8c16bf9);
+    m_kernel.add_instr(0xa8c163f7);
+    m_kernel.add_instr(0xa8c15bf5);
+    m_kernel.add_instr(0xa8c153f3);
+
+    m_kernel.add_instr(Inst::base_ret());
+
+    m_kernel.set_kernel();
+
+    return error_t::success;
+}
@@ -0,0 +1,721 @@
+#include "../instructions/instructions_x86.h"
+#include "Brgemm.h"
+
+using X86 = mini_jit::instructions::InstGenX86;
+
+/*
+ * Register usage of the x86-64 BRGEMM kernels (System V ABI).
+ *
+ * Arguments: rdi = A, rsi = B, rdx = C, rcx = lda, r8 = ldb, r9 = ldc,
+ *            stack = br_stride_a, br_stride_b, bias.
+ *
+ * The single precision kernels support transposed operands: a row-major A is gathered with VGATHERDPS
+ * using the offsets of the rows of a vector, a row-major B is broadcast from the current row,
+ * a row-major C is computed as C^T = B^T * A^T by swapping A and B at entry.
+ */
+namespace {
+    //! A, constant
+    constexpr X86::gpr_t A_REG = X86::rdi;
+    //! B of the current column block
+    constexpr X86::gpr_t B_COL_REG = X86::rsi;
+    //! C of the current column block
+    constexpr X86::gpr_t C_COL_REG = X86::rdx;
+    //! A of the current row block
+    constexpr X86::gpr_t A_ROW_REG = X86::rax;
+    //! C of the current register block
+    constexpr X86::gpr_t C_BLOCK_REG = X86::r9;
+
+    //! leading dimensions in bytes
+    constexpr X86::gpr_t LDA_REG = X86::rcx;
+    constexpr X86::gpr_t LDB_REG = X86::r8;
+    constexpr X86::gpr_t LDB3_REG = X86::r10;
+
+    //! working pointer of A, also used to walk over the columns of C
+    constexpr X86::gpr_t WORKING_A_REG = X86::r11;
+    //! working pointers of B, each covers five columns
+    constexpr X86::gpr_t WORKING_B_REGS[3] = {X86::r12, X86::r13, X86::r14};
+
+    //! loop counters
+    constexpr X86::gpr_t M_LOOP_COUNT_REG = X86::rbx;
+    constexpr X86::gpr_t BR_LOOP_COUNT_REG = X86::rbp;
+    constexpr X86::gpr_t K_LOOP_COUNT_REG = X86::r15;
+
+    //! callee-saved registers
+    constexpr X86::gpr_t SAVED_REGS[6] = {X86::rbx, X86::rbp, X86::r12, X86::r13, X86::r14, X86::r15};
+
+    //! stack slots
+    constexpr int32_t STACK_SIZE = 352;
+    constexpr int32_t LDC_SLOT = 0;
+    constexpr int32_t BR_STEP_A_SLOT = 8;
+    constexpr int32_t BR_STEP_B_SLOT = 16;
+    constexpr int32_t N_LOOP_COUNT_SLOT = 24;
+    constexpr int32_t N_STEP_B_SLOT = 32;
+    constexpr int32_t N_STEP_C_SLOT = 40;
+    constexpr int32_t BIAS_COL_SLOT = 48;
+    constexpr int32_t INT8_OFFSET_SLOT = 56;
+    constexpr int32_t MASK_SLOT = 64;
+    constexpr int32_t ACT_SLOT = 96;
+    constexpr int32_t M_STEP_A_SLOT = 160;
+    constexpr int32_t GATHER_MASK_SLOT = 192;
+    constexpr int32_t GATHER_INDEX_SLOT = 224;
+    constexpr int32_t BR_STRIDE_A_ARG = STACK_SIZE + 6 * 8 + 8;
+    constexpr int32_t BR_STRIDE_B_ARG = STACK_SIZE + 6 * 8 + 16;
+    constexpr int32_t BIAS_ARG = STACK_SIZE + 6 * 8 + 24;
+
+    //! AVX2 register holding the mask of the M remainder
+    constexpr X86::simd_t AVX2_MASK_REG = X86::v15;
+
+    //! AVX-512 masks of the gathers: all lanes, and the copy consumed by a gather
+    constexpr X86::mask_t GATHER_ALL_MASK = X86::k4;
+    constexpr X86::mask_t GATHER_MASK = X86::k3;
+
+    //! maximum number of columns of a register block
+    constexpr uint32_t MAX_N_BLOCK = 15;
+
+    /**
+     * Address of B in the given column of the register block.
+     **/
+    X86::mem_t column_b(uint32_t i_col) {
+        X86::gpr_t l_base = WORKING_B_REGS[i_col / 5];
+
+        switch (i_col % 5) {
+            case 0:
+                return X86::mem(l_base);
+            case 1:
+                return X86::mem(l_base, LDB_REG, 1);
+            case 2:
+                return X86::mem(l_base, LDB_REG, 2);
+            case 3:
+                return X86::mem(l_base, LDB3_REG, 1);
+            default:
+                return X86::mem(l_base, LDB_REG, 4);
+        }
+    }
+}  // namespace
+
+void mini_jit::generator::Brgemm::gen_block_x86(backend::Cpu::isa_t i_isa,
+                                                uint32_t i_m_vectors,
+                                                uint32_t i_m_mask,
+                                                uint32_t i_n,
+                                                uint32_t n,
+                                                uint32_t k,
+                                                uint32_t br_size,
+                                                bool is_relu) {
+    bool l_avx512 = (i_isa == backend::Cpu::isa_t::avx512);
+    bool l_fp64 = (m_dtype == dtype_t::fp64);
+    bool l_bf16 = (m_dtype == dtype_t::bf16);
+    bool l_int8 = (m_dtype == dtype_t::int8);
+    bool l_fp16 = (m_dtype == dtype_t::fp16);
+    bool l_fp16_fp32 = (m_dtype == dtype_t::fp16_fp32);
+    int32_t l_vector_bytes = l_avx512 ? 64 : 32;
+    int32_t l_size = l_fp64 ? 8 : l_fp16 ? 2 : 4;
+    int32_t l_size_ab = (l_bf16 || l_fp16_fp32) ? 2 : l_int8 ? 1 : l_size;
+    // bytes of A per vector of C
+    int32_t l_vector_bytes_a = l_vector_bytes / l_size * l_size_ab;
+
+    // accumulator of row vector i and column j: j * i_m_vectors + i, followed by A and B,
+    // the bf16 and int8 kernels interleave columns of A in a temporary register before B,
+    // the int8 kernels keep the offsets of the row vectors and the constant 0x80 behind B,
+    // the kernels with a row-major A hold the offsets of the gathered rows in the temporary register
+    // and the AVX2 mask of a gather behind B
+    uint32_t l_reg_a = i_m_vectors * i_n;
+    X86::simd_t l_reg_t = static_cast<X86::simd_t>(l_reg_a + i_m_vectors);
+    X86::simd_t l_reg_b = static_cast<X86::simd_t>(l_reg_a + i_m_vectors + ((l_bf16 || l_int8 || m_trans_a) ? 1 : 0));
+    X86::simd_t l_reg_gather_mask = static_cast<X86::simd_t>(l_reg_b + 1);
+    uint32_t l_reg_offset = l_reg_b + 1;
+    X86::simd_t l_reg_0x80 = static_cast<X86::simd_t>(l_reg_offset + i_m_vectors);
+
+    auto l_load = [&](X86::simd_t i_reg, X86::mem_t i_mem, bool i_masked) {
+        if (l_fp16) {
+            m_kernel.add_instr(X86::avx512_vmovdqu16_load(i_reg, i_mem, i_masked ? X86::k1 : X86::k0));
+        } else if (l_avx512) {
+            m_kernel.add_instr(X86::avx512_vmovups_load(i_reg, i_mem, i_masked ? X86::k1 : X86::k0));
+        } else if (i_masked) {
+            m_kernel.add_instr(X86::avx_vmaskmovps_load(i_reg, AVX2_MASK_REG, i_mem));
+        } else {
+            m_kernel.add_instr(X86::avx_vmovups_load(i_reg, i_mem));
+        }
+    };
+    auto l_store = [&](X86::mem_t i_mem, X86::simd_t i_reg, bool i_masked) {
+        if (l_fp16) {
+            m_kernel.add_instr(X86::avx512_vmovdqu16_store(i_mem, i_reg, i_masked ? X86::k1 : X86::k0));
+        } else if (l_avx512) {
+            m_kernel.add_instr(X86::avx512_vmovups_store(i_mem, i_reg, i_masked ? X86::k1 : X86::k0));
+        } else if (i_masked) {
+            m_kernel.add_instr(X86::avx_vmaskmovps_store(i_mem, AVX2_MASK_REG, i_reg));
+        } else {
+            m_kernel.add_instr(X86::avx_vmovups_store(i_mem, i_reg));
+        }
+    };
+    auto l_broadcast = [&](X86::simd_t i_reg, X86::mem_t i_mem) {
+        if (l_fp16) {
+            m_kernel.add_instr(X86::avx512_vpbroadcastw(i_reg, i_mem));
+        } else if (l_avx512) {
+            m_kernel.add_instr(l_fp64 ? X86::avx512_vbroadcastsd(i_reg, i_mem) : X86::avx512_vbroadcastss(i_reg, i_mem));
+        } else {
+            m_kernel.add_instr(l_fp64 ? X86::avx_vbroadcastsd(i_reg, i_mem) : X86::avx_vbroadcastss(i_reg, i_mem));
+        }
+    };
+
+    // values of a column of a row-major A at the offsets of the rows of the vector
+    auto l_gather = [&](X86::simd_t i_reg, uint32_t i_m, bool i_masked) {
+        X86::mem_t l_index = X86::mem(X86::rsp, GATHER_INDEX_SLOT + i_m * l_vector_bytes);
+        if (l_avx512) {
+            m_kernel.add_instr(X86::avx512_vmovups_load(l_reg_t, l_index));
+            m_kernel.add_instr(X86::avx512_kmovw_mask(GATHER_MASK, i_masked ? X86::k1 : GATHER_ALL_MASK));
+            m_kernel.add_instr(X86::avx512_vgatherdps(i_reg, X86::vsib(WORKING_A_REG, l_reg_t, 1), GATHER_MASK));
+        } else {
+            m_kernel.add_instr(X86::avx_vmovups_load(l_reg_t, l_index));
+            m_kernel.add_instr(X86::avx_vmovups_load(l_reg_gather_mask, X86::mem(X86::rsp, i_masked ? MASK_SLOT : GATHER_MASK_SLOT)));
+            m_kernel.add_instr(X86::avx_vgatherdps(i_reg, X86::vsib(WORKING_A_REG, l_reg_t, 1), l_reg_gather_mask));
+        }
+    };
+
+    // B of a column: the working pointers of a column-major B cover five columns each, a row-major B has one
+    auto l_column_b = [&](uint32_t i_col) {
+        return m_trans_b ? X86::mem(WORKING_B_REGS[0], i_col * l_size_ab) : column_b(i_col);
+    };
+    uint32_t l_num_b_ptrs = m_trans_b ? 1 : (i_n + 4) / 5;
+
+    if (l_int8) {
+        // 32-bit integer accumulators and offsets, C and the bias are added by the dequantization
+        for (uint32_t l_acc = 0; l_acc < i_n * i_m_vectors; l_acc++) {
+            X86::simd_t l_reg = static_cast<X86::simd_t>(l_acc);
+            m_kernel.add_instr(X86::avx512_vpxord(l_reg, l_reg, l_reg));
+        }
+        for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+            X86::simd_t l_reg = static_cast<X86::simd_t>(l_reg_offset + l_m);
+            m_kernel.add_instr(X86::avx512_vpxord(l_reg, l_reg, l_reg));
+        }
+        m_kernel.add_instr(X86::avx512_vbroadcastss(l_reg_0x80, X86::mem(X86::rsp, INT8_OFFSET_SLOT)));
+    } else if (m_bias == bias_t::none) {
+        // load block of C
+        m_kernel.add_instr(X86::base_mov_register(WORKING_A_REG, C_BLOCK_REG));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                l_load(static_cast<X86::simd_t>(l_n * i_m_vectors + l_m),
+                       X86::mem(WORKING_A_REG, l_m * l_vector_bytes),
+                       i_m_mask != 0 && l_m == i_m_vectors - 1);
+            }
+            if (l_n + 1 < i_n) {
+                m_kernel.add_instr(X86::base_add_load(WORKING_A_REG, X86::mem(X86::rsp, LDC_SLOT)));
+            }
+        }
+    } else if (m_bias == bias_t::zero) {
+        for (uint32_t l_acc = 0; l_acc < i_n * i_m_vectors; l_acc++) {
+            X86::simd_t l_reg = static_cast<X86::simd_t>(l_acc);
+            if (l_avx512) {
+                m_kernel.add_instr(X86::avx512_vpxord(l_reg, l_reg, l_reg));
+            } else {
+                m_kernel.add_instr(X86::avx_vxorps(l_reg, l_reg, l_reg));
+            }
+        }
+    } else if (m_bias == bias_t::m) {
+        // bias of the rows, at the offset of the register block in its column of C
+        m_kernel.add_instr(X86::base_mov_register(WORKING_A_REG, C_BLOCK_REG));
+        m_kernel.add_instr(X86::base_sub_register(WORKING_A_REG, C_COL_REG));
+        m_kernel.add_instr(X86::base_add_load(WORKING_A_REG, X86::mem(X86::rsp, BIAS_ARG)));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                l_load(static_cast<X86::simd_t>(l_n * i_m_vectors + l_m),
+                       X86::mem(WORKING_A_REG, l_m * l_vector_bytes),
+                       i_m_mask != 0 && l_m == i_m_vectors - 1);
+            }
+        }
+    } else {
+        // bias of the columns, broadcast over the rows
+        m_kernel.add_instr(X86::base_mov_load(WORKING_A_REG, X86::mem(X86::rsp, BIAS_COL_SLOT)));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                l_broadcast(static_cast<X86::simd_t>(l_n * i_m_vectors + l_m), X86::mem(WORKING_A_REG, l_n * l_size));
+            }
+        }
+    }
+
+    // working pointers of A and B
+    m_kernel.add_instr(X86::base_mov_register(WORKING_A_REG, A_ROW_REG));
+    m_kernel.add_instr(X86::base_mov_register(WORKING_B_REGS[0], B_COL_REG));
+    for (uint32_t l_bp = 1; l_bp < l_num_b_ptrs; l_bp++) {
+        m_kernel.add_instr(X86::base_lea(WORKING_B_REGS[l_bp], X86::mem(WORKING_B_REGS[l_bp - 1], LDB_REG, 4)));
+        m_kernel.add_instr(X86::base_add_register(WORKING_B_REGS[l_bp], LDB_REG));
+    }
+
+    // BR loop
+    std::size_t l_br_loop_pos = 0;
+    if (br_size > 1) {
+        m_kernel.add_instr(X86::base_mov_imm(BR_LOOP_COUNT_REG, br_size));
+        l_br_loop_pos = m_kernel.get_size();
+    }
+
+    /*
+     * i_k_rows (at most four) rows of B in the int8 kernels: VPDPBUSD multiplies unsigned bytes with signed bytes,
+     * B is made unsigned by adding 0x80, i.e., A * (B + 128) is accumulated and 128 * A is subtracted by the dequantization.
+     */
+    auto l_gen_k_step_int8 = [&](uint32_t i_k_rows) {
+        // four values of four columns of A in the 32-bit lanes, missing columns are zero
+        for (uint32_t l_k = 0; l_k < i_k_rows; l_k++) {
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                X86::simd_t l_a = static_cast<X86::simd_t>(l_reg_a + l_m);
+                X86::mask_t l_mask = (i_m_mask != 0 && l_m == i_m_vectors - 1) ? X86::k1 : X86::k0;
+                X86::mem_t l_mem = (l_k % 2 == 0) ? X86::mem(WORKING_A_REG, l_m * 16) : X86::mem(WORKING_A_REG, LDA_REG, 1, l_m * 16);
+                if (l_k == 0) {
+                    m_kernel.add_instr(X86::avx512_vpmovzxbd_load(l_a, l_mem, l_mask));
+                } else {
+                    m_kernel.add_instr(X86::avx512_vpmovzxbd_load(l_reg_t, l_mem, l_mask));
+                    m_kernel.add_instr(X86::avx512_vpslld_imm(l_reg_t, l_reg_t, 8 * l_k));
+                    m_kernel.add_instr(X86::avx512_vpord(l_a, l_a, l_reg_t));
+                }
+            }
+            if (l_k % 2 == 1) {
+                m_kernel.add_instr(X86::base_lea(WORKING_A_REG, X86::mem(WORKING_A_REG, LDA_REG, 2)));
+            }
+        }
+        if (i_k_rows % 2 == 1) {
+            m_kernel.add_instr(X86::base_add_register(WORKING_A_REG, LDA_REG));
+        }
+        for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+            m_kernel.add_instr(X86::avx512_vpdpbusd(static_cast<X86::simd_t>(l_reg_offset + l_m),
+                                                    l_reg_0x80,
+                                                    static_cast<X86::simd_t>(l_reg_a + l_m)));
+        }
+
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            if (i_k_rows == 4) {
+                m_kernel.add_instr(X86::avx512_vbroadcastss(l_reg_b, l_column_b(l_n)));
+            } else {
+                // only the i_k_rows values of the column are read, the ones behind them are multiplied by zero
+                m_kernel.add_instr(X86::avx512_vmovdqu8_load(l_reg_b, l_column_b(l_n), X86::k2));
+                m_kernel.add_instr(X86::avx512_vpbroadcastd(l_reg_b, l_reg_b));
+            }
+            m_kernel.add_instr(X86::avx512_vpxord(l_reg_b, l_reg_b, l_reg_0x80));
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                m_kernel.add_instr(X86::avx512_vpdpbusd(static_cast<X86::simd_t>(l_n * i_m_vectors + l_m),
+                                                        l_reg_b,
+                                                        static_cast<X86::simd_t>(l_reg_a + l_m)));
+            }
+        }
+
+        for (uint32_t l_bp = 0; l_bp < l_num_b_ptrs; l_bp++) {
+            m_kernel.add_instr(X86::base_add_imm(WORKING_B_REGS[l_bp], i_k_rows));
+        }
+    };
+
+    // i_k_rows rows of B, a bf16 step covers one or two
+    auto l_gen_k_step = [&](uint32_t i_k_rows) {
+        if (l_int8) {
+            l_gen_k_step_int8(i_k_rows);
+            return;
+        }
+        for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+            X86::simd_t l_a = static_cast<X86::simd_t>(l_reg_a + l_m);
+            bool l_masked = i_m_mask != 0 && l_m == i_m_vectors - 1;
+            if (l_fp16_fp32) {
+                m_kernel.add_instr(X86::avx512_vcvtph2ps_load(l_a, X86::mem(WORKING_A_REG, l_m * l_vector_bytes_a), l_masked ? X86::k1 : X86::k0));
+                continue;
+            }
+            if (m_trans_a) {
+                l_gather(l_a, l_m, l_masked);
+                continue;
+            }
+            if (!l_bf16) {
+                l_load(l_a, X86::mem(WORKING_A_REG, l_m * l_vector_bytes_a), l_masked);
+                continue;
+            }
+            // pairs of values of two columns in the 32-bit lanes: low half column k, high half column k + 1
+            X86::mask_t l_mask = l_masked ? X86::k1 : X86::k0;
+            m_kernel.add_instr(X86::avx512_vpmovzxwd_load(l_a, X86::mem(WORKING_A_REG, l_m * l_vector_bytes_a), l_mask));
+            if (i_k_rows == 2) {
+                m_kernel.add_instr(X86::avx512_vpmovzxwd_load(l_reg_t, X86::mem(WORKING_A_REG, LDA_REG, 1, l_m * l_vector_bytes_a), l_mask));
+                m_kernel.add_instr(X86::avx512_vpslld_imm(l_reg_t, l_reg_t, 16));
+                m_kernel.add_instr(X86::avx512_vpord(l_a, l_a, l_reg_t));
+            }
+        }
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            if (l_fp16_fp32) {
+                // the half-precision value of B is widened in the register
+                m_kernel.add_instr(X86::avx512_vpbroadcastw(l_reg_b, l_column_b(l_n)));
+                m_kernel.add_instr(X86::avx512_vcvtph2ps(l_reg_b, l_reg_b));
+            } else if (!l_bf16) {
+                l_broadcast(l_reg_b, l_column_b(l_n));
+            } else if (i_k_rows == 2) {
+                m_kernel.add_instr(X86::avx512_vbroadcastss(l_reg_b, l_column_b(l_n)));
+            } else {
+                m_kernel.add_instr(X86::avx512_vpbroadcastw(l_reg_b, l_column_b(l_n)));
+            }
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                X86::simd_t l_acc = static_cast<X86::simd_t>(l_n * i_m_vectors + l_m);
+                X86::simd_t l_a = static_cast<X86::simd_t>(l_reg_a + l_m);
+                if (l_bf16) {
+                    m_kernel.add_instr(X86::avx512_vdpbf16ps(l_acc, l_a, l_reg_b));
+                } else if (l_fp16) {
+                    m_kernel.add_instr(X86::avx512_vfmadd231ph(l_acc, l_a, l_reg_b));
+                } else if (l_avx512) {
+                    m_kernel.add_instr(l_fp64 ? X86::avx512_vfmadd231pd(l_acc, l_a, l_reg_b) : X86::avx512_vfmadd231ps(l_acc, l_a, l_reg_b));
+                } else {
+                    m_kernel.add_instr(l_fp64 ? X86::avx_vfmadd231pd(l_acc, l_a, l_reg_b) : X86::avx_vfmadd231ps(l_acc, l_a, l_reg_b));
+                }
+            }
+        }
+
+        // next column of A and row of B
+        if (i_k_rows == 2) {
+            m_kernel.add_instr(X86::base_lea(WORKING_A_REG, X86::mem(WORKING_A_REG, LDA_REG, 2)));
+        } else if (m_trans_a) {
+            m_kernel.add_instr(X86::base_add_imm(WORKING_A_REG, l_size_ab));
+        } else {
+            m_kernel.add_instr(X86::base_add_register(WORKING_A_REG, LDA_REG));
+        }
+        for (uint32_t l_bp = 0; l_bp < l_num_b_ptrs; l_bp++) {
+            if (m_trans_b) {
+                m_kernel.add_instr(X86::base_add_register(WORKING_B_REGS[l_bp], LDB_REG));
+            } else {
+                m_kernel.add_instr(X86::base_add_imm(WORKING_B_REGS[l_bp], i_k_rows * l_size_ab));
+            }
+        }
+    };
+
+    // K loop, the bf16 (int8) kernels process two (four) rows of B per iteration and the remaining ones after the loop
+    uint32_t l_k_rows = l_bf16 ? 2 : l_int8 ? 4 : 1;
+    if (k >= l_k_rows) {
+        m_kernel.add_instr(X86::base_mov_imm(K_LOOP_COUNT_REG, k / l_k_rows));
+        std::size_t l_k_loop_pos = m_kernel.get_size();
+
+        // prefetch A of a later K iteration, the distance is given by the scale of LDA
+        if (m_prefetch.k_distance > 0 && !m_trans_a) {
+            uint32_t l_scale = 1;
+            while (l_scale * 2 <= m_prefetch.k_distance && l_scale < 8) {
+                l_scale *= 2;
+            }
+            m_kernel.add_instr(X86::base_prefetch(X86::mem(WORKING_A_REG, LDA_REG, l_scale)));
+        }
+
+        l_gen_k_step(l_k_rows);
+
+        m_kernel.add_instr(X86::base_sub_imm(K_LOOP_COUNT_REG, 1));
+        m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(l_k_loop_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+    }
+    if (k % l_k_rows != 0) {
+        l_gen_k_step(k % l_k_rows);
+    }
+
+    if (br_size > 1) {
+        // next matrices of the batch
+        m_kernel.add_instr(X86::base_add_load(WORKING_A_REG, X86::mem(X86::rsp, BR_STEP_A_SLOT)));
+        for (uint32_t l_bp = 0; l_bp < l_num_b_ptrs; l_bp++) {
+            m_kernel.add_instr(X86::base_add_load(WORKING_B_REGS[l_bp], X86::mem(X86::rsp, BR_STEP_B_SLOT)));
+        }
+
+        m_kernel.add_instr(X86::base_sub_imm(BR_LOOP_COUNT_REG, 1));
+        m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(l_br_loop_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+    }
+
+    // dequantization: C = scale(n) * (acc - offset) + C, or + bias(n), or + 0, the B register holds the scale
+    if (l_int8) {
+        m_kernel.add_instr(X86::base_mov_load(WORKING_B_REGS[0], X86::mem(X86::rsp, BIAS_COL_SLOT)));
+        m_kernel.add_instr(X86::base_mov_register(WORKING_A_REG, C_BLOCK_REG));
+        for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+            m_kernel.add_instr(X86::avx512_vbroadcastss(l_reg_b, X86::mem(WORKING_B_REGS[0], l_n * 4)));
+            for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+                X86::simd_t l_reg = static_cast<X86::simd_t>(l_n * i_m_vectors + l_m);
+                m_kernel.add_instr(X86::avx512_vpsubd(l_reg, l_reg, static_cast<X86::simd_t>(l_reg_offset + l_m)));
+                m_kernel.add_instr(X86::avx512_vcvtdq2ps(l_reg, l_reg));
+                m_kernel.add_instr(X86::avx512_vmulps(l_reg, l_reg, l_reg_b));
+                if (m_bias == bias_t::none) {
+                    l_load(l_reg_t, X86::mem(WORKING_A_REG, l_m * l_vector_bytes), i_m_mask != 0 && l_m == i_m_vectors - 1);
+                    m_kernel.add_instr(X86::avx512_vaddps(l_reg, l_reg, l_reg_t));
+                } else if (m_bias == bias_t::n) {
+                    m_kernel.add_instr(X86::avx512_vbroadcastss(l_reg_t, X86::mem(WORKING_B_REGS[0], (n + l_n) * 4)));
+                    m_kernel.add_instr(X86::avx512_vaddps(l_reg, l_reg, l_reg_t));
+                }
+            }
+            if (m_bias == bias_t::none && l_n + 1 < i_n) {
+                m_kernel.add_instr(X86::base_add_load(WORKING_A_REG, X86::mem(X86::rsp, LDC_SLOT)));
+            }
+        }
+    }
+
+    // ReLU, the A registers are free
+    if (is_relu) {
+        X86::simd_t l_zero = static_cast<X86::simd_t>(l_reg_a);
+        if (l_avx512) {
+            m_kernel.add_instr(X86::avx512_vpxord(l_zero, l_zero, l_zero));
+        } else {
+            m_kernel.add_instr(X86::avx_vxorps(l_zero, l_zero, l_zero));
+        }
+        for (uint32_t l_acc = 0; l_acc < i_m_vectors * i_n; l_acc++) {
+            X86::simd_t l_reg = static_cast<X86::simd_t>(l_acc);
+            if (l_fp16) {
+                m_kernel.add_instr(X86::avx512_vmaxph(l_reg, l_reg, l_zero));
+            } else if (l_avx512) {
+                m_kernel.add_instr(l_fp64 ? X86::avx512_vmaxpd(l_reg, l_reg, l_zero) : X86::avx512_vmaxps(l_reg, l_reg, l_zero));
+            } else {
+                m_kernel.add_instr(l_fp64 ? X86::avx_vmaxpd(l_reg, l_reg, l_zero) : X86::avx_vmaxps(l_reg, l_reg, l_zero));
+            }
+        }
+    }
+
+    // rational activation, the A and B registers are free
+    if (Activation::is_rational(m_act)) {
+        Activation::gen_x86(m_kernel, l_avx512, m_act, i_m_vectors * i_n, l_reg_a, X86::mem(X86::rsp, ACT_SLOT));
+    }
+
+    // store block of C
+    m_kernel.add_instr(X86::base_mov_register(WORKING_A_REG, C_BLOCK_REG));
+    for (uint32_t l_n = 0; l_n < i_n; l_n++) {
+        for (uint32_t l_m = 0; l_m < i_m_vectors; l_m++) {
+            l_store(X86::mem(WORKING_A_REG, l_m * l_vector_bytes),
+                    static_cast<X86::simd_t>(l_n * i_m_vectors + l_m),
+                    i_m_mask != 0 && l_m == i_m_vectors - 1);
+        }
+        if (l_n + 1 < i_n) {
+            m_kernel.add_instr(X86::base_add_load(WORKING_A_REG, X86::mem(X86::rsp, LDC_SLOT)));
+        }
+    }
+}
+
+mini_jit::generator::Brgemm::error_t mini_jit::generator::Brgemm::generate_x86(uint32_t m,
+                                                                               uint32_t n,
+                                                                               uint32_t k,
+                                                                               uint32_t br_size,
+                                                                               bool is_relu) {
+    backend::Cpu::isa_t l_isa = backend::Cpu::get_isa();
+    BRGEMM_EXPECT(l_isa == backend::Cpu::isa_t::avx2 || l_isa == backend::Cpu::isa_t::avx512);
+    BRGEMM_EXPECT(m > 0 && n > 0 && k > 0 && br_size > 0);
+
+    bool l_avx512 = (l_isa == backend::Cpu::isa_t::avx512);
+    bool l_bf16 = (m_dtype == dtype_t::bf16);
+    bool l_int8 = (m_dtype == dtype_t::int8);
+    BRGEMM_EXPECT(!l_bf16 || (l_avx512 && backend::Cpu::has_bf16()));
+    BRGEMM_EXPECT(!l_int8 || (l_avx512 && backend::Cpu::has_int8()));
+    bool l_fp16 = (m_dtype == dtype_t::fp16);
+    bool l_fp16_fp32 = (m_dtype == dtype_t::fp16_fp32);
+    BRGEMM_EXPECT(!l_fp16 || (l_avx512 && backend::Cpu::has_fp16()));
+    BRGEMM_EXPECT(!l_fp16_fp32 || (l_avx512 && backend::Cpu::has_fp16_fp32()));
+
+    // size of the values of C and the bias, A and B hold 16-bit (8-bit) values in the bf16 and fp16_fp32 (int8) kernels
+    uint32_t l_size = (m_dtype == dtype_t::fp64) ? 8 : l_fp16 ? 2 : 4;
+    uint32_t l_shift = (m_dtype == dtype_t::fp64) ? 3 : l_fp16 ? 1 : 2;
+    uint32_t l_size_ab = (l_bf16 || l_fp16_fp32) ? 2 : l_int8 ? 1 : l_size;
+    uint32_t l_shift_ab = (l_bf16 || l_fp16_fp32) ? 1 : l_int8 ? 0 : l_shift;
+    uint32_t l_vector_length = (l_avx512 ? 64 : 32) / l_size;
+
+    // blocking: up to two vectors in M, as many columns as the registers allow
+    uint32_t l_m_vectors = (m + l_vector_length - 1) / l_vector_length;
+    l_m_vectors = (l_m_vectors < 2) ? l_m_vectors : 2;
+    if (m_blocking.m_vectors > 0) {
+        l_m_vectors = m_blocking.m_vectors;
+    }
+    uint32_t l_m_block = l_m_vectors * l_vector_length;
+
+    uint32_t l_full_m = m / l_m_block;
+    uint32_t l_rem_m = m % l_m_block;
+    uint32_t l_rem_m_vectors = (l_rem_m + l_vector_length - 1) / l_vector_length;
+    uint32_t l_rem_m_mask = l_rem_m % l_vector_length;
+
+    // accumulators, A vectors and one broadcasted B value (and the mask for AVX2, the temporary of bf16,
+    // the temporary, offsets of the row vectors and constant of int8),
+    // a rational activation uses four temporary registers after the accumulators
+    uint32_t l_num_regs = l_avx512 ? 32 : (l_rem_m_mask != 0 ? 15 : 16);
+    uint32_t l_num_reserved = l_int8 ? 2 * l_m_vectors + 3 : l_m_vectors + (l_bf16 ? 2 : 1);
+    // the gathers of a row-major A use the offsets of the rows (and the AVX2 mask of a gather)
+    if (m_trans_a) {
+        BRGEMM_EXPECT(l_m_vectors <= 2);
+        l_num_reserved += l_avx512 ? 1 : 2;
+    }
+    if (Activation::is_rational(m_act) && l_num_reserved < 4) {
+        l_num_reserved = 4;
+    }
+    BRGEMM_EXPECT(l_m_vectors + l_num_reserved <= l_num_regs);
+    uint32_t l_n_block = (l_num_regs - l_num_reserved) / l_m_vectors;
+    l_n_block = (l_n_block < MAX_N_BLOCK) ? l_n_block : MAX_N_BLOCK;
+    if (m_blocking.n > 0) {
+        // blockings tuned without activation are narrowed to free the temporary registers
+        BRGEMM_EXPECT(m_blocking.n <= l_n_block || Activation::is_rational(m_act));
+        l_n_block = (m_blocking.n < l_n_block) ? m_blocking.n : l_n_block;
+    }
+    l_n_block = (l_n_block < n) ? l_n_block : n;
+
+    uint32_t l_full_n = n / l_n_block;
+    uint32_t l_rem_n = n % l_n_block;
+
+    // procedure call standard
+    for (X86::gpr_t l_reg : SAVED_REGS) {
+        m_kernel.add_instr(X86::base_push(l_reg));
+    }
+    m_kernel.add_instr(X86::base_sub_imm(X86::rsp, STACK_SIZE));
+
+    // C^T = B^T * A^T: B takes the role of A, the BR strides are read swapped
+    if (m_swap_ab) {
+        m_kernel.add_instr(X86::base_mov_register(X86::r11, A_REG));
+        m_kernel.add_instr(X86::base_mov_register(A_REG, B_COL_REG));
+        m_kernel.add_instr(X86::base_mov_register(B_COL_REG, X86::r11));
+        m_kernel.add_instr(X86::base_mov_register(X86::r11, LDA_REG));
+        m_kernel.add_instr(X86::base_mov_register(LDA_REG, LDB_REG));
+        m_kernel.add_instr(X86::base_mov_register(LDB_REG, X86::r11));
+    }
+    int32_t l_br_stride_a_arg = m_swap_ab ? BR_STRIDE_B_ARG : BR_STRIDE_A_ARG;
+    int32_t l_br_stride_b_arg = m_swap_ab ? BR_STRIDE_A_ARG : BR_STRIDE_B_ARG;
+
+    // leading dimensions in bytes
+    m_kernel.add_instr(X86::base_shl_imm(LDA_REG, l_shift_ab));
+    m_kernel.add_instr(X86::base_shl_imm(LDB_REG, l_shift_ab));
+    m_kernel.add_instr(X86::base_shl_imm(X86::r9, l_shift));
+    m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, LDC_SLOT), X86::r9));
+    m_kernel.add_instr(X86::base_lea(LDB3_REG, X86::mem(LDB_REG, LDB_REG, 2)));
+
+    // steps from the end of the K loop to the next matrices of the batch,
+    // the K loop advances A by k columns and B by k rows
+    if (br_size > 1) {
+        m_kernel.add_instr(X86::base_mov_load(X86::r11, X86::mem(X86::rsp, l_br_stride_a_arg)));
+        m_kernel.add_instr(X86::base_shl_imm(X86::r11, l_shift_ab));
+        if (m_trans_a) {
+            m_kernel.add_instr(X86::base_sub_imm(X86::r11, k * l_size_ab));
+        } else {
+            m_kernel.add_instr(X86::base_imul_imm(X86::r12, LDA_REG, k));
+            m_kernel.add_instr(X86::base_sub_register(X86::r11, X86::r12));
+        }
+        m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, BR_STEP_A_SLOT), X86::r11));
+
+        m_kernel.add_instr(X86::base_mov_load(X86::r11, X86::mem(X86::rsp, l_br_stride_b_arg)));
+        m_kernel.add_instr(X86::base_shl_imm(X86::r11, l_shift_ab));
+        if (m_trans_b) {
+            m_kernel.add_instr(X86::base_imul_imm(X86::r12, LDB_REG, k));
+            m_kernel.add_instr(X86::base_sub_register(X86::r11, X86::r12));
+        } else {
+            m_kernel.add_instr(X86::base_sub_imm(X86::r11, k * l_size_ab));
+        }
+        m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, BR_STEP_B_SLOT), X86::r11));
+    }
+
+    // steps to the next column block, the columns of a row-major B are contiguous
+    if (m_trans_b) {
+        m_kernel.add_instr(X86::base_mov_imm(X86::r11, l_n_block * l_size_ab));
+    } else {
+        m_kernel.add_instr(X86::base_imul_imm(X86::r11, LDB_REG, l_n_block));
+    }
+    m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, N_STEP_B_SLOT), X86::r11));
+    m_kernel.add_instr(X86::base_imul_imm(X86::r11, X86::r9, l_n_block));
+    m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, N_STEP_C_SLOT), X86::r11));
+
+    // bias of the first column block, the int8 kernels always read the scales
+    if (m_bias == bias_t::n || l_int8) {
+        m_kernel.add_instr(X86::base_mov_load(X86::r11, X86::mem(X86::rsp, BIAS_ARG)));
+        m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, BIAS_COL_SLOT), X86::r11));
+    }
+
+    // constant 0x80 in all bytes and mask of the last rows of B in the int8 kernels
+    if (l_int8) {
+        m_kernel.add_instr(X86::base_mov_store_imm32(X86::mem(X86::rsp, INT8_OFFSET_SLOT), static_cast<int32_t>(0x80808080)));
+        if (k % 4 != 0) {
+            m_kernel.add_instr(X86::base_mov_imm(X86::r11, (1 << (k % 4)) - 1));
+            m_kernel.add_instr(X86::avx512_kmovw(X86::k2, X86::r11));
+        }
+    }
+
+    // step to the next row block of a row-major A and offsets of the rows of its vectors,
+    // the gathers of full vectors use all lanes
+    if (m_trans_a) {
+        m_kernel.add_instr(X86::base_imul_imm(X86::r11, LDA_REG, l_m_block));
+        m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, M_STEP_A_SLOT), X86::r11));
+
+        m_kernel.add_instr(X86::base_mov_imm(X86::r11, 0));
+        for (uint32_t l_row = 0; l_row < l_m_block; l_row++) {
+            m_kernel.add_instr(X86::base_mov_store32(X86::mem(X86::rsp, GATHER_INDEX_SLOT + 4 * l_row), X86::r11));
+            if (l_row + 1 < l_m_block) {
+                m_kernel.add_instr(X86::base_add_register(X86::r11, LDA_REG));
+            }
+        }
+
+        if (l_avx512) {
+            m_kernel.add_instr(X86::base_mov_imm(X86::r11, 0xFFFF));
+            m_kernel.add_instr(X86::avx512_kmovw(GATHER_ALL_MASK, X86::r11));
+        } else {
+            for (uint32_t l_la = 0; l_la < 8; l_la++) {
+                m_kernel.add_instr(X86::base_mov_store_imm32(X86::mem(X86::rsp, GATHER_MASK_SLOT + 4 * l_la), -1));
+            }
+        }
+    }
+
+    // constants of the activation
+    if (Activation::is_rational(m_act)) {
+        Activation::gen_table_x86(m_kernel, X86::mem(X86::rsp, ACT_SLOT));
+    }
+
+    // mask of the M remainder, double precision values span two 32-bit lanes of the masked moves,
+    // the half-precision moves take a mask of up to 32 16-bit lanes
+    if (l_rem_m_mask != 0) {
+        uint32_t l_mask_lanes = l_rem_m_mask * l_size / 4;
+        if (l_fp16) {
+            m_kernel.add_instr(X86::base_mov_imm(X86::r11, static_cast<int32_t>((1u << l_rem_m_mask) - 1)));
+            m_kernel.add_instr(X86::avx512_kmovd(X86::k1, X86::r11));
+        } else if (l_avx512) {
+            m_kernel.add_instr(X86::base_mov_imm(X86::r11, (1 << l_mask_lanes) - 1));
+            m_kernel.add_instr(X86::avx512_kmovw(X86::k1, X86::r11));
+        } else {
+            for (uint32_t l_la = 0; l_la < 8; l_la++) {
+                m_kernel.add_instr(X86::base_mov_store_imm32(X86::mem(X86::rsp, MASK_SLOT + 4 * l_la),
+                                                             l_la < l_mask_lanes ? -1 : 0));
+            }
+            m_kernel.add_instr(X86::avx_vmovups_load(AVX2_MASK_REG, X86::mem(X86::rsp, MASK_SLOT)));
+        }
+    }
+
+    // all register blocks of a column block
+    auto l_gen_m_loop = [&](uint32_t i_n) {
+        m_kernel.add_instr(X86::base_mov_register(A_ROW_REG, A_REG));
+        m_kernel.add_instr(X86::base_mov_register(C_BLOCK_REG, C_COL_REG));
+
+        if (l_full_m > 0) {
+            m_kernel.add_instr(X86::base_mov_imm(M_LOOP_COUNT_REG, l_full_m));
+            std::size_t l_m_loop_pos = m_kernel.get_size();
+
+            gen_block_x86(l_isa, l_m_vectors, 0, i_n, n, k, br_size, is_relu);
+
+            if (m_trans_a) {
+                m_kernel.add_instr(X86::base_add_load(A_ROW_REG, X86::mem(X86::rsp, M_STEP_A_SLOT)));
+            } else {
+                m_kernel.add_instr(X86::base_add_imm(A_ROW_REG, l_m_block * l_size_ab));
+            }
+            m_kernel.add_instr(X86::base_add_imm(C_BLOCK_REG, l_m_block * l_size));
+            m_kernel.add_instr(X86::base_sub_imm(M_LOOP_COUNT_REG, 1));
+            m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+        }
+        if (l_rem_m > 0) {
+            gen_block_x86(l_isa, l_rem_m_vectors, l_rem_m_mask, i_n, n, k, br_size, is_relu);
+        }
+    };
+
+    // N loop
+    if (l_full_n > 0) {
+        m_kernel.add_instr(X86::base_mov_imm(X86::r11, l_full_n));
+        m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, N_LOOP_COUNT_SLOT), X86::r11));
+        std::size_t l_n_loop_pos = m_kernel.get_size();
+
+        l_gen_m_loop(l_n_block);
+
+        m_kernel.add_instr(X86::base_add_load(B_COL_REG, X86::mem(X86::rsp, N_STEP_B_SLOT)));
+        m_kernel.add_instr(X86::base_add_load(C_COL_REG, X86::mem(X86::rsp, N_STEP_C_SLOT)));
+        if (m_bias == bias_t::n || l_int8) {
+            m_kernel.add_instr(X86::base_mov_load(X86::r11, X86::mem(X86::rsp, BIAS_COL_SLOT)));
+            m_kernel.add_instr(X86::base_add_imm(X86::r11, l_n_block * l_size));
+            m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, BIAS_COL_SLOT), X86::r11));
+        }
+        m_kernel.add_instr(X86::base_sub_store_imm(X86::mem(X86::rsp, N_LOOP_COUNT_SLOT), 1));
+        m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+    }
+    if (l_rem_n > 0) {
+        l_gen_m_loop(l_rem_n);
+    }
+
+    // procedure call standard
+    m_kernel.add_instr(X86::base_add_imm(X86::rsp, STACK_SIZE));
+    for (int32_t l_re = 5; l_re >= 0; l_re--) {
+        m_kernel.add_instr(X86::base_pop(SAVED_REGS[l_re]));
+    }
+    m_kernel.add_instr(X86::avx_vzeroupper());
+    m_kernel.add_instr(X86::base_ret());
+
+    m_kernel.set_kernel();
+
+    return error_t::success;
+}
@@ -0,0 +1,234 @@
+#include "KernelCache.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "../backend/Cpu.h"
+#include "TuningTable.h"
+
+namespace mini_jit::generator {
+
+    std::mutex KernelCache::m_mutex;
+    backend::CodeArena KernelCache::m_arena;
+    std::unordered_map<std::string, std::unique_ptr<Brgemm>> KernelCache::m_brgemms;
+    std::unordered_map<std::string, std::unique_ptr<Unary>> KernelCache::m_unaries;
+    std::string KernelCache::m_cache_dir = std::getenv("MINI_JIT_CACHE_DIR") != nullptr ? std::getenv("MINI_JIT_CACHE_DIR") : "";
+
+    void KernelCache::set_cache_dir(std::string const& dir) {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        m_cache_dir = dir;
+    }
+
+    std::string KernelCache::get_cache_dir() {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        return m_cache_dir;
+    }
+
+    uint64_t KernelCache::hash(std::string const& key) {
+        // 64-bit FNV-1a, stable across runs and compilers
+        uint64_t l_hash = 0xcbf29ce484222325;
+        for (char l_char : key) {
+            l_hash ^= static_cast<unsigned char>(l_char);
+            l_hash *= 0x100000001b3;
+        }
+        return l_hash;
+    }
+
+    std::string KernelCache::cache_path(std::string const& signature) {
+        static std::string const l_fingerprint = backend::Cpu::fingerprint();
+
+        uint64_t l_hash = hash(signature + "_v" + std::to_string(GENERATOR_VERSION));
+
+        char l_hash_hex[17];
+        std::snprintf(l_hash_hex,
+                      sizeof(l_hash_hex),
+                      "%016llx",
+                      static_cast<unsigned long long>(l_hash));
+
+        return m_cache_dir + "/" + l_hash_hex + "_" + l_fingerprint + ".bin";
+    }
+
+    template <typename T>
+    void KernelCache::store(T const& generator,
+                            std::string const& signature,
+                            std::string const& path) {
+        std::string l_path_tmp = path + ".tmp" + std::to_string(getpid());
+
+        // the on-disk cache is best effort, failing to write only costs the next run a JIT
+        try {
+            generator.store(l_path_tmp.c_str(), GENERATOR_VERSION, hash(signature));
+        } catch (std::runtime_error const&) {
+            std::remove(l_path_tmp.c_str());
+            return;
+        }
+
+        if (std::rename(l_path_tmp.c_str(),
+                        path.c_str()) != 0) {
+            std::remove(l_path_tmp.c_str());
+        }
+    }
+
+    std::string KernelCache::brgemm_signature(uint32_t m,
+                                              uint32_t n,
+                                              uint32_t k,
+                                              uint32_t br_size,
+                                              uint32_t trans_a,
+                                              uint32_t trans_b,
+                                              uint32_t trans_c,
+                                              Brgemm::dtype_t dtype,
+                                              bool is_relu,
+                                              Brgemm::prefetch_t const& prefetch,
+                                              Brgemm::blocking_t const& blocking,
+                                              Brgemm::bias_t bias,
+                                              Brgemm::act_t act) {
+        std::string l_signature = "brgemm_m" + std::to_string(m) +
+                                  "_n" + std::to_string(n) +
+                                  "_k" + std::to_string(k) +
+                                  "_br" + std::to_string(br_size) +
+                                  "_t" + std::to_string(trans_a) + std::to_string(trans_b) + std::to_string(trans_c) +
+                                  "_d" + std::to_string(static_cast<uint32_t>(dtype)) +
+                                  "_r" + std::to_string(is_relu);
+        if (prefetch.k_distance > 0 || prefetch.next_br) {
+            l_signature += "_pf" + std::to_string(prefetch.k_distance) + "_" + std::to_string(prefetch.next_br);
+        }
+        if (blocking.m_vectors > 0 || blocking.n > 0) {
+            l_signature += "_b" + std::to_string(blocking.m_vectors) + "x" + std::to_string(blocking.n);
+        }
+        if (bias != Brgemm::bias_t::none) {
+            l_signature += "_bias" + std::to_string(static_cast<uint32_t>(bias));
+        }
+        if (act != Brgemm::act_t::none) {
+            l_signature += "_act" + std::to_string(static_cast<uint32_t>(act));
+        }
+        return l_signature;
+    }
+
+    std::string KernelCache::unary_signature(uint32_t m,
+                                             uint32_t n,
+                                             Unary::dtype_t dtype,
+                                             Unary::ptype_t ptype) {
+        return "unary_m" + std::to_string(m) +
+               "_n" + std::to_string(n) +
+               "_d" + std::to_string(static_cast<uint32_t>(dtype)) +
+               "_p" + std::to_string(static_cast<uint32_t>(ptype));
+    }
+
+    Brgemm::kernel_t KernelCache::get_brgemm(uint32_t m,
+                                             uint32_t n,
+                                             uint32_t k,
+                                             uint32_t br_size,
+                                             uint32_t trans_a,
+                                             uint32_t trans_b,
+                                             uint32_t trans_c,
+                                             Brgemm::dtype_t dtype,
+                                             bool is_relu,
+                                             Brgemm::prefetch_t const& prefetch,
+                                             Brgemm::bias_t bias,
+                                             Brgemm::act_t act) {
+        // tuned register blocking, new FP32 shapes are tuned first in autotuning mode,
+        // the table holds blockings of column-major operands
+        Brgemm::blocking_t l_blocking;
+        if ((trans_a | trans_b | trans_c) == 0 &&
+            !TuningTable::lookup(m, n, k, br_size, l_blocking) &&
+            TuningTable::get_autotune() &&
+            dtype == Brgemm::dtype_t::fp32) {
+            l_blocking = TuningTable::tune(m, n, k, br_size);
+        }
+
+        std::string l_signature = brgemm_signature(m, n, k, br_size, trans_a, trans_b, trans_c, dtype, is_relu, prefetch, l_blocking, bias, act);
+
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        auto l_it = m_brgemms.find(l_signature);
+        if (l_it != m_brgemms.end()) {
+            // the kernel might have been added inside the still open batch of another thread
+            Brgemm::kernel_t l_kernel = l_it->second->get_kernel();
+            m_arena.seal(reinterpret_cast<void const*>(l_kernel));
+            return l_kernel;
+        }
+
+        std::unique_ptr<Brgemm> l_brgemm = std::make_unique<Brgemm>();
+        l_brgemm->set_arena(&m_arena);
+        l_brgemm->set_prefetch(prefetch);
+        l_brgemm->set_blocking(l_blocking);
+        std::string l_path = m_cache_dir.empty() ? "" : cache_path(l_signature);
+
+        if (l_path.empty() || l_brgemm->load(l_path.c_str(), GENERATOR_VERSION, hash(l_signature)) != Brgemm::error_t::success) {
+            Brgemm::error_t l_err = l_brgemm->generate(m, n, k, br_size, trans_a, trans_b, trans_c, dtype, is_relu, bias, act);
+            if (l_err != Brgemm::error_t::success) {
+                return nullptr;
+            }
+
+            if (!l_path.empty()) {
+                store(*l_brgemm, l_signature, l_path);
+            }
+        }
+
+        Brgemm::kernel_t l_kernel = l_brgemm->get_kernel();
+        m_brgemms.emplace(l_signature, std::move(l_brgemm));
+
+        return l_kernel;
+    }
+
+    Unary::kernel_t KernelCache::get_unary(uint32_t m,
+                                           uint32_t n,
+                                           Unary::dtype_t dtype,
+                                           Unary::ptype_t ptype) {
+        std::string l_signature = unary_signature(m, n, dtype, ptype);
+
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        auto l_it = m_unaries.find(l_signature);
+        if (l_it != m_unaries.end()) {
+            // the kernel might have been added inside the still open batch of another thread
+            Unary::kernel_t l_kernel = l_it->second->get_kernel();
+            m_arena.seal(reinterpret_cast<void const*>(l_kernel));
+            return l_kernel;
+        }
+
+        std::unique_ptr<Unary> l_unary = std::make_unique<Unary>();
+        l_unary->set_arena(&m_arena);
+        std::string l_path = m_cache_dir.empty() ? "" : cache_path(l_signature);
+
+        if (l_path.empty() || l_unary->load(l_path.c_str(), GENERATOR_VERSION, hash(l_signature)) != Unary::error_t::success) {
+            Unary::error_t l_err = l_unary->generate(m, n, dtype, ptype);
+            if (l_err != Unary::error_t::success) {
+                return nullptr;
+            }
+
+            if (!l_path.empty()) {
+                store(*l_unary, l_signature, l_path);
+            }
+        }
+
+        Unary::kernel_t l_kernel = l_unary->get_kernel();
+        m_unaries.emplace(l_signature, std::move(l_unary));
+
+        return l_kernel;
+    }
+
+    std::size_t KernelCache::size() {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        return m_brgemms.size() + m_unaries.size();
+    }
+
+    std::size_t KernelCache::code_size() {
+        return m_arena.get_size_used();
+    }
+
+    void KernelCache::clear() {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        m_brgemms.clear();
+        m_unaries.clear();
+        m_arena.release();
+    }
+
+}  // namespace mini_jit::generator
@@ -0,0 +1,189 @@
+#ifndef MINI_JIT_GENERATOR_KERNEL_CACHE_H
+#define MINI_JIT_GENERATOR_KERNEL_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "../backend/CodeArena.h"
+#include "Brgemm.h"
+#include "Unary.h"
+
+namespace mini_jit::generator {
+    class KernelCache;
+}
+
+/**
+ * Process-wide registry of generated kernels.
+ *
+ * Kernels are keyed by the full signature of the primitive, a repeated
+ * request returns the already generated kernel instead of JITting it again.
+ * If a cache directory is set, generated kernels are additionally stored on
+ * disk and loaded by later runs on a host with the same CPU fingerprint.
+ * The code of all kernels is packed into a single code arena.
+ * All functions are thread-safe.
+ **/
+class mini_jit::generator::KernelCache {
+   private:
+    //! guards the kernel maps
+    static std::mutex m_mutex;
+
+    //! code arena holding all cached kernels, defined before the maps such that it is destroyed after them
+    static backend::CodeArena m_arena;
+
+    //! generated BRGEMM kernels by signature
+    static std::unordered_map<std::string, std::unique_ptr<Brgemm>> m_brgemms;
+
+    //! generated unary kernels by signature
+    static std::unordered_map<std::string, std::unique_ptr<Unary>> m_unaries;
+
+    //! directory of the on-disk cache, disabled if empty
+    static std::string m_cache_dir;
+
+    /**
+     * @brief 64-bit FNV-1a hash of the given key.
+     **/
+    static uint64_t hash(std::string const& key);
+
+    /**
+     * @brief Path of the on-disk kernel with the given signature.
+     *
+     * The file name combines a hash of the signature and the code generator
+     * version with the CPU fingerprint of the host.
+     **/
+    static std::string cache_path(std::string const& signature);
+
+    /**
+     * @brief Stores a kernel in the on-disk cache.
+     *
+     * The kernel is written to a temporary file first and renamed afterwards,
+     * such that concurrent processes never read a partially written kernel.
+     * The file header holds the generator version and the hash of the signature,
+     * a kernel is only loaded if both match.
+     **/
+    template <typename T>
+    static void store(T const& generator,
+                      std::string const& signature,
+                      std::string const& path);
+
+   public:
+    //! version of the code generators, has to be increased whenever the generated code changes
+    static constexpr uint32_t GENERATOR_VERSION = 3;
+
+    /**
+     * Groups the kernels requested by the calling thread during its lifetime.
+     *
+     * The kernels are made executable together with a single cache clear once
+     * the outermost batch ends. Kernels returned inside a batch must not be
+     * called before that. A lookup hitting a kernel of a still open batch makes
+     * the pending kernels executable before returning it.
+     **/
+    class Batch {
+       public:
+        Batch() {
+            m_arena.begin_batch();
+        }
+
+        ~Batch() {
+            m_arena.end_batch();
+        }
+
+        Batch(Batch const&) = delete;
+        Batch& operator=(Batch const&) = delete;
+    };
+
+    /**
+     * @brief Sets the directory of the on-disk cache.
+     *
+     * The default is the value of the environment variable MINI_JIT_CACHE_DIR.
+     *
+     * @param dir existing directory, an empty string disables the on-disk cache.
+     **/
+    static void set_cache_dir(std::string const& dir);
+
+    /**
+     * @brief Gets the directory of the on-disk cache.
+     **/
+    static std::string get_cache_dir();
+
+    /**
+     * @brief Builds the signature of a BRGEMM kernel.
+     **/
+    static std::string brgemm_signature(uint32_t m,
+                                        uint32_t n,
+                                        uint32_t k,
+                                        uint32_t br_size,
+                                        uint32_t trans_a,
+                                        uint32_t trans_b,
+                                        uint32_t trans_c,
+                                        Brgemm::dtype_t dtype,
+                                        bool is_relu,
+                                        Brgemm::prefetch_t const& prefetch = {},
+                                        Brgemm::blocking_t const& blocking = {},
+                                        Brgemm::bias_t bias = Brgemm::bias_t::none,
+                                        Brgemm::act_t act = Brgemm::act_t::none);
+
+    /**
+     * @brief Builds the signature of a unary kernel.
+     **/
+    static std::string unary_signature(uint32_t m,
+                                       uint32_t n,
+                                       Unary::dtype_t dtype,
+                                       Unary::ptype_t ptype);
+
+    /**
+     * @brief Get a BRGEMM kernel, generates it on the first request.
+     *
+     * The parameters are the ones of Brgemm::generate and Brgemm::set_prefetch.
+     * The register blocking is taken from the TuningTable, in autotuning mode
+     * a new FP32 shape is tuned before its kernel is generated.
+     *
+     * @return kernel on success, nullptr if the kernel could not be generated.
+     **/
+    static Brgemm::kernel_t get_brgemm(uint32_t m,
+                                       uint32_t n,
+                                       uint32_t k,
+                                       uint32_t br_size,
+                                       uint32_t trans_a,
+                                       uint32_t trans_b,
+                                       uint32_t trans_c,
+                                       Brgemm::dtype_t dtype,
+                                       bool is_relu,
+                                       Brgemm::prefetch_t const& prefetch = {},
+                                       Brgemm::bias_t bias = Brgemm::bias_t::none,
+                                       Brgemm::act_t act = Brgemm::act_t::none);
+
+    /**
+     * @brief Get a unary kernel, generates it on the first request.
+     *
+     * The parameters are the ones of Unary::generate.
+     *
+     * @return kernel on success, nullptr if the kernel could not be generated.
+     **/
+    static Unary::kernel_t get_unary(uint32_t m,
+                                     uint32_t n,
+                                     Unary::dtype_t dtype,
+                                     Unary::ptype_t ptype);
+
+    /**
+     * @brief Number of kernels held by the cache.
+     **/
+    static std::size_t size();
+
+    /**
+     * @brief Number of bytes of the code arena occupied by kernels.
+     **/
+    static std::size_t code_size();
+
+    /**
+     * @brief Releases all cached kernels.
+     *
+     * Kernels handed out before are invalid afterwards.
+     * The on-disk cache is not touched.
+     **/
+    static void clear();
+};
+
+#endif
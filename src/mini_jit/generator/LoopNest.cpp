@@ -0,0 +1,260 @@
+#include "LoopNest.h"
+
+#include <algorithm>
+
+#include "../instructions/instructions.h"
+
+namespace inst = mini_jit::instructions;
+
+namespace mini_jit::generator {
+    LoopNest::error_t LoopNest::generate(std::vector<nest_t> const& nests) {
+        std::size_t l_num_loops = 0;
+        for (nest_t const& l_nest : nests) {
+            for (loop_t const& l_loop : l_nest.loops) {
+                if (l_loop.size < 1) {
+                    return error_t::bad_param;
+                }
+            }
+            for (std::vector<call_t> const& l_calls : l_nest.calls) {
+                for (call_t const& l_call : l_calls) {
+                    if (l_call.kernel == nullptr) {
+                        return error_t::bad_param;
+                    }
+                }
+            }
+            for (ptr_t const& l_ptr : l_nest.ptrs) {
+                if (l_ptr.kind == ptr_t::kind_t::arg && (l_ptr.value < 0 || l_ptr.value >= 4096)) {
+                    return error_t::bad_param;
+                }
+            }
+            l_num_loops = std::max(l_num_loops, l_nest.loops.size());
+        }
+
+        // the counters of the stack frame are reused by the nests
+        gen_prologue(l_num_loops);
+        for (nest_t const& l_nest : nests) {
+            for (uint32_t l_pt = 0; l_pt < 4; l_pt++) {
+                gen_load_ptr(l_pt, l_nest.ptrs[l_pt]);
+            }
+            gen_loops(l_nest, 0, true, true);
+        }
+        gen_epilogue(l_num_loops);
+
+        m_kernel.set_kernel();
+
+        return error_t::success;
+    }
+
+    LoopNest::kernel_t LoopNest::get_kernel() const {
+        return reinterpret_cast<kernel_t>(const_cast<void*>(m_kernel.get_kernel()));
+    }
+
+    void LoopNest::gen_loops(nest_t const& i_nest,
+                             std::size_t i_id_loop,
+                             bool i_first_access,
+                             bool i_last_access) {
+        if (i_id_loop == i_nest.loops.size()) {
+            gen_calls(i_nest.calls[(i_first_access ? 1 : 0) + (i_last_access ? 2 : 0)], i_nest.params);
+            return;
+        }
+
+        loop_t const& l_loop = i_nest.loops[i_id_loop];
+        if (!l_loop.k || l_loop.size == 1 || (!i_first_access && !i_last_access)) {
+            gen_iterations(i_nest, i_id_loop, l_loop.size, i_first_access, i_last_access);
+        } else {
+            // only the first and last iteration of a K loop keep the respective access
+            int64_t l_middle = l_loop.size - (i_first_access ? 1 : 0) - (i_last_access ? 1 : 0);
+            if (i_first_access) {
+                gen_iterations(i_nest, i_id_loop, 1, true, false);
+            }
+            gen_iterations(i_nest, i_id_loop, l_middle, false, false);
+            if (i_last_access) {
+                gen_iterations(i_nest, i_id_loop, 1, false, true);
+            }
+        }
+
+        // back to the pointers of the enclosing iteration
+        gen_advance(l_loop, -l_loop.size);
+    }
+
+    void LoopNest::gen_iterations(nest_t const& i_nest,
+                                  std::size_t i_id_loop,
+                                  int64_t i_count,
+                                  bool i_first_access,
+                                  bool i_last_access) {
+        if (i_count == 0) {
+            return;
+        }
+
+        std::size_t l_pos = 0;
+        if (i_count > 1) {
+            l_pos = gen_loop_begin(i_id_loop, i_count);
+        }
+
+        gen_loops(i_nest, i_id_loop + 1, i_first_access, i_last_access);
+        gen_advance(i_nest.loops[i_id_loop], 1);
+
+        if (i_count > 1) {
+            gen_loop_end(i_id_loop, l_pos);
+        }
+    }
+
+    void LoopNest::gen_calls(std::vector<call_t> const& i_calls,
+                             params_t const& i_params) {
+        for (call_t const& l_call : i_calls) {
+            gen_call(l_call, i_params);
+        }
+    }
+
+    void LoopNest::gen_advance(loop_t const& i_loop,
+                               int64_t i_sign) {
+        gen_add_ptr(0, i_sign * i_loop.stride_in0);
+        gen_add_ptr(1, i_sign * i_loop.stride_in1);
+        gen_add_ptr(2, i_sign * i_loop.stride_out);
+        gen_add_ptr(3, i_sign * i_loop.stride_bias);
+    }
+}  // namespace mini_jit::generator
+
+#if !defined(__x86_64__)
+/*
+ * Register usage of the AArch64 loop nest.
+ *
+ * x19-x22: pointers of in0, in1, out and bias
+ * x23: argument array
+ * [sp]: ninth argument of the BRGEMM kernels (bias)
+ * [sp + 16 + 8 * i]: iteration counter of loop i
+ */
+namespace {
+    //! pointers, preserved across the calls
+    constexpr inst::InstGen::gpr_t PTR_REGS[4] = {inst::InstGen::x19,
+                                                   inst::InstGen::x20,
+                                                   inst::InstGen::x21,
+                                                   inst::InstGen::x22};
+
+    //! argument array, preserved across the calls
+    constexpr inst::InstGen::gpr_t ARGS_REG = inst::InstGen::x23;
+
+    //! scratch registers
+    constexpr inst::InstGen::gpr_t HELP_REG = inst::InstGen::x9;
+    constexpr inst::InstGen::gpr_t CALL_REG = inst::InstGen::x16;
+
+    //! offset of the loop counters
+    constexpr uint32_t COUNTER_OFFSET = 16;
+
+    uint32_t frame_size(std::size_t i_num_loops) {
+        return (COUNTER_OFFSET + 8 * i_num_loops + 15) / 16 * 16;
+    }
+
+    /**
+     * Generates the instructions moving a 64-bit value to a register.
+     **/
+    void gen_mov_imm64(mini_jit::backend::Kernel& i_kernel,
+                       inst::InstGen::gpr_t i_reg,
+                       int64_t i_value) {
+        uint64_t l_value = static_cast<uint64_t>(i_value);
+        i_kernel.add_instr(inst::InstGen::base_movz(i_reg, l_value & 0xFFFF, 0));
+        for (uint8_t l_shift = 16; l_shift < 64; l_shift += 16) {
+            if (((l_value >> l_shift) & 0xFFFF) != 0) {
+                i_kernel.add_instr(inst::InstGen::base_movk(i_reg, (l_value >> l_shift) & 0xFFFF, l_shift));
+            }
+        }
+    }
+}  // namespace
+
+namespace mini_jit::generator {
+    void LoopNest::gen_prologue(std::size_t i_num_loops) {
+        // procedure call standard (store to stack): frame record and x19-x28
+        m_kernel.add_instr(0xa9bf7bfd);
+        m_kernel.add_instr(0xa9bf53f3);
+        m_kernel.add_instr(0xa9bf5bf5);
+        m_kernel.add_instr(0xa9bf63f7);
+        m_kernel.add_instr(0xa9bf6bf9);
+        m_kernel.add_instr(0xa9bf73fb);
+
+        m_kernel.add_instr(inst::InstGen::base_sub_imm(inst::InstGen::sp, inst::InstGen::sp, frame_size(i_num_loops), 0));
+
+        m_kernel.add_instr(inst::InstGen::base_mov_register(ARGS_REG, inst::InstGen::x0));
+    }
+
+    void LoopNest::gen_epilogue(std::size_t i_num_loops) {
+        m_kernel.add_instr(inst::InstGen::base_add_imm(inst::InstGen::sp, inst::InstGen::sp, frame_size(i_num_loops), 0));
+
+        // procedure call standard (load from stack)
+        m_kernel.add_instr(0xa8c173fb);
+        m_kernel.add_instr(0xa8c16bf9);
+        m_kernel.add_instr(0xa8c163f7);
+        m_kernel.add_instr(0xa8c15bf5);
+        m_kernel.add_instr(0xa8c153f3);
+        m_kernel.add_instr(0xa8c17bfd);
+
+        m_kernel.add_instr(inst::InstGen::base_ret());
+    }
+
+    void LoopNest::gen_load_ptr(uint32_t i_ptr,
+                                ptr_t const& i_src) {
+        if (i_src.kind == ptr_t::kind_t::arg) {
+            m_kernel.add_instr(inst::InstGen::base_ldr_imm(PTR_REGS[i_ptr], ARGS_REG, 8 * i_src.value));
+        } else if (i_src.kind == ptr_t::kind_t::address) {
+            gen_mov_imm64(m_kernel, PTR_REGS[i_ptr], i_src.value);
+        } else {
+            m_kernel.add_instr(inst::InstGen::base_mov_register(PTR_REGS[i_ptr], inst::InstGen::xzr));
+        }
+    }
+
+    void LoopNest::gen_add_ptr(uint32_t i_ptr,
+                               int64_t i_value) {
+        if (i_value == 0) {
+            return;
+        }
+
+        if (i_value > 0 && i_value < 4096) {
+            m_kernel.add_instr(inst::InstGen::base_add_imm(PTR_REGS[i_ptr], PTR_REGS[i_ptr], i_value, 0));
+        } else if (i_value < 0 && i_value > -4096) {
+            m_kernel.add_instr(inst::InstGen::base_sub_imm(PTR_REGS[i_ptr], PTR_REGS[i_ptr], -i_value, 0));
+        } else {
+            gen_mov_imm64(m_kernel, HELP_REG, i_value);
+            m_kernel.add_instr(inst::InstGen::base_add_shifted_register(PTR_REGS[i_ptr], PTR_REGS[i_ptr], HELP_REG, 0, 0));
+        }
+    }
+
+    void LoopNest::gen_call(call_t const& i_call,
+                            params_t const& i_params) {
+        if (i_call.kind == call_t::kind_t::brgemm) {
+            m_kernel.add_instr(inst::InstGen::base_mov_register(inst::InstGen::x0, PTR_REGS[0]));
+            m_kernel.add_instr(inst::InstGen::base_mov_register(inst::InstGen::x1, PTR_REGS[1]));
+            m_kernel.add_instr(inst::InstGen::base_mov_register(inst::InstGen::x2, PTR_REGS[2]));
+            gen_mov_imm64(m_kernel, inst::InstGen::x3, i_params.lda);
+            gen_mov_imm64(m_kernel, inst::InstGen::x4, i_params.ldb);
+            gen_mov_imm64(m_kernel, inst::InstGen::x5, i_params.ldc);
+            gen_mov_imm64(m_kernel, inst::InstGen::x6, i_params.br_stride_a);
+            gen_mov_imm64(m_kernel, inst::InstGen::x7, i_params.br_stride_b);
+            m_kernel.add_instr(inst::InstGen::base_str_imm(i_call.bias ? PTR_REGS[3] : inst::InstGen::xzr, inst::InstGen::sp, 0));
+        } else {
+            m_kernel.add_instr(inst::InstGen::base_mov_register(inst::InstGen::x0, PTR_REGS[2]));
+            m_kernel.add_instr(inst::InstGen::base_mov_register(inst::InstGen::x1, PTR_REGS[2]));
+            gen_mov_imm64(m_kernel, inst::InstGen::x2, i_params.ldc);
+            gen_mov_imm64(m_kernel, inst::InstGen::x3, i_params.ldc);
+        }
+
+        gen_mov_imm64(m_kernel, CALL_REG, reinterpret_cast<int64_t>(i_call.kernel));
+        m_kernel.add_instr(inst::InstGen::base_blr(CALL_REG));
+    }
+
+    std::size_t LoopNest::gen_loop_begin(std::size_t i_id_loop,
+                                         int64_t i_count) {
+        gen_mov_imm64(m_kernel, HELP_REG, i_count);
+        m_kernel.add_instr(inst::InstGen::base_str_imm(HELP_REG, inst::InstGen::sp, COUNTER_OFFSET + 8 * i_id_loop));
+
+        return m_kernel.get_size();
+    }
+
+    void LoopNest::gen_loop_end(std::size_t i_id_loop,
+                                std::size_t i_pos) {
+        m_kernel.add_instr(inst::InstGen::base_ldr_imm(HELP_REG, inst::InstGen::sp, COUNTER_OFFSET + 8 * i_id_loop));
+        m_kernel.add_instr(inst::InstGen::base_sub_imm(HELP_REG, HELP_REG, 1, 0));
+        m_kernel.add_instr(inst::InstGen::base_str_imm(HELP_REG, inst::InstGen::sp, COUNTER_OFFSET + 8 * i_id_loop));
+        m_kernel.add_instr(inst::InstGen::base_br_cbnz(HELP_REG,
+                                                       (static_cast<int64_t>(i_pos) - static_cast<int64_t>(m_kernel.get_size())) / 4));
+    }
+}  // namespace mini_jit::generator
+#endif
@@ -0,0 +1,173 @@
+#ifndef MINI_JIT_GENERATOR_LOOP_NEST_H
+#define MINI_JIT_GENERATOR_LOOP_NEST_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../backend/Cpu.h"
+#include "../backend/Kernel.h"
+
+namespace mini_jit::generator {
+    class LoopNest;
+}
+
+/**
+ * Generator of loop nests which call previously generated kernels on the innermost blocks.
+ * Several nests, e.g., the operations of an einsum tree, can be generated into one function.
+ *
+ * The trip counts and strides are immediates of the generated code. The first and last
+ * iterations of contraction loops are peeled, the calls of a block are selected at
+ * generation time by whether the block is accessed for the first and/or last time.
+ **/
+class mini_jit::generator::LoopNest {
+   private:
+    //! kernel backend
+    backend::Kernel m_kernel;
+
+   public:
+    /// loop of the nest
+    struct loop_t {
+        //! number of iterations
+        int64_t size = 1;
+        //! strides of the pointers in bytes
+        int64_t stride_in0 = 0;
+        int64_t stride_in1 = 0;
+        int64_t stride_out = 0;
+        int64_t stride_bias = 0;
+        //! true if the loop revisits the output blocks (contraction loop)
+        bool k = false;
+    };
+
+    /// kernel called on a block
+    struct call_t {
+        /// calling convention of the kernel
+        enum class kind_t : uint32_t {
+            //! Brgemm::kernel_t on (in0, in1, out)
+            brgemm = 0,
+            //! Unary::kernel_t on (out, out)
+            unary = 1
+        };
+
+        kind_t kind = kind_t::brgemm;
+        //! entry point of the kernel
+        void const* kernel = nullptr;
+        //! brgemm: pass the pointer of the bias, nullptr otherwise
+        bool bias = false;
+    };
+
+    /// runtime parameters of the called kernels
+    struct params_t {
+        //! leading dimensions of the brgemm kernels (elements)
+        int64_t lda = 0;
+        int64_t ldb = 0;
+        int64_t ldc = 0;
+        //! batch-reduce strides of the brgemm kernels (elements)
+        int64_t br_stride_a = 0;
+        int64_t br_stride_b = 0;
+    };
+
+    /// base pointer of a nest
+    struct ptr_t {
+        /// origin of the pointer
+        enum class kind_t : uint32_t {
+            //! nullptr
+            none = 0,
+            //! element value of the argument array
+            arg = 1,
+            //! fixed address
+            address = 2
+        };
+
+        kind_t kind = kind_t::none;
+        //! index of the argument or the address
+        int64_t value = 0;
+    };
+
+    /// loops of one operation
+    struct nest_t {
+        //! loops from the outermost to the innermost one
+        std::vector<loop_t> loops;
+        //! kernels called on a block, indexed by first_access + 2 * last_access
+        std::vector<call_t> calls[4];
+        //! runtime parameters of the called kernels
+        params_t params;
+        //! base pointers of in0, in1, out and bias
+        ptr_t ptrs[4];
+    };
+
+    /// error codes
+    enum class error_t : int32_t {
+        success = 0,
+        bad_param = -1
+    };
+
+    /**
+     * @brief Generates one function executing the given nests one after another.
+     *
+     * @param nests loop nests in execution order.
+     * @return error_t::success on success, another error_t value otherwise.
+     **/
+    error_t generate(std::vector<nest_t> const& nests);
+
+    /*
+     * Kernel type.
+     * The kernel is a function that takes the following parameter:
+     * - args: Array of pointers, referenced by the base pointers of kind ptr_t::kind_t::arg.
+     */
+    using kernel_t = void (*)(void const* const* args);
+
+    /**
+     * @brief Get the generated loop nest.
+     * @return pointer to the generated kernel.
+     **/
+    kernel_t get_kernel() const;
+
+   private:
+    /**
+     * @brief Generates the loops starting at i_id_loop for blocks with the given access.
+     **/
+    void gen_loops(nest_t const& i_nest,
+                   std::size_t i_id_loop,
+                   bool i_first_access,
+                   bool i_last_access);
+
+    /**
+     * @brief Generates i_count iterations of loop i_id_loop, each executing the inner loops.
+     **/
+    void gen_iterations(nest_t const& i_nest,
+                        std::size_t i_id_loop,
+                        int64_t i_count,
+                        bool i_first_access,
+                        bool i_last_access);
+
+    /**
+     * @brief Generates the calls of one block.
+     **/
+    void gen_calls(std::vector<call_t> const& i_calls,
+                   params_t const& i_params);
+
+    /**
+     * @brief Generates ptr += i_sign * stride for the four pointers of loop i_loop.
+     **/
+    void gen_advance(loop_t const& i_loop,
+                     int64_t i_sign);
+
+    /**
+     * @brief ISA-specific building blocks, implemented for AArch64 and x86-64.
+     **/
+    void gen_prologue(std::size_t i_num_loops);
+    void gen_epilogue(std::size_t i_num_loops);
+    void gen_load_ptr(uint32_t i_ptr,
+                      ptr_t const& i_src);
+    void gen_add_ptr(uint32_t i_ptr,
+                     int64_t i_value);
+    void gen_call(call_t const& i_call,
+                  params_t const& i_params);
+    //! starts a counted loop, returns the position of the loop body
+    std::size_t gen_loop_begin(std::size_t i_id_loop,
+                               int64_t i_count);
+    void gen_loop_end(std::size_t i_id_loop,
+                      std::size_t i_pos);
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "../instructions/instructions_x86.h"
+#include "LoopNest.h"
+
+#if defined(__x86_64__)
+using X86 = mini_jit::instructions::InstGenX86;
+
+/*
+ * Register usage of the x86-64 loop nest (System V ABI).
+ *
+ * rbx, r12-r14: pointers of in0, in1, out and bias
+ * r15: argument array
+ * [rsp], [rsp + 8], [rsp + 16]: seventh to ninth argument of the BRGEMM kernels
+ * [rsp + 24 + 8 * i]: iteration counter of loop i
+ */
+namespace {
+    //! pointers, preserved across the calls
+    constexpr X86::gpr_t PTR_REGS[4] = {X86::rbx, X86::r12, X86::r13, X86::r14};
+
+    //! argument array, preserved across the calls
+    constexpr X86::gpr_t ARGS_REG = X86::r15;
+
+    //! scratch register
+    constexpr X86::gpr_t HELP_REG = X86::rax;
+
+    //! offset of the loop counters
+    constexpr int32_t COUNTER_OFFSET = 24;
+
+    /**
+     * Size of the stack frame, rsp is 16-byte aligned at the calls after the return address and the five pushes.
+     **/
+    int32_t frame_size(std::size_t i_num_loops) {
+        int32_t l_size = COUNTER_OFFSET + 8 * static_cast<int32_t>(i_num_loops);
+        return (l_size + 15) / 16 * 16;
+    }
+
+    bool is_imm32(int64_t i_value) {
+        return i_value >= INT32_MIN && i_value <= INT32_MAX;
+    }
+
+    /**
+     * Generates the instructions moving a 64-bit value to a register.
+     **/
+    void gen_mov_imm(mini_jit::backend::Kernel& i_kernel,
+                     X86::gpr_t i_reg,
+                     int64_t i_value) {
+        if (is_imm32(i_value)) {
+            i_kernel.add_instr(X86::base_mov_imm(i_reg, static_cast<int32_t>(i_value)));
+        } else {
+            i_kernel.add_instr(X86::base_mov_imm64(i_reg, i_value));
+        }
+    }
+}  // namespace
+
+namespace mini_jit::generator {
+    void LoopNest::gen_prologue(std::size_t i_num_loops) {
+        for (X86::gpr_t l_reg : PTR_REGS) {
+            m_kernel.add_instr(X86::base_push(l_reg));
+        }
+        m_kernel.add_instr(X86::base_push(ARGS_REG));
+        m_kernel.add_instr(X86::base_sub_imm(X86::rsp, frame_size(i_num_loops)));
+
+        m_kernel.add_instr(X86::base_mov_register(ARGS_REG, X86::rdi));
+    }
+
+    void LoopNest::gen_epilogue(std::size_t i_num_loops) {
+        m_kernel.add_instr(X86::base_add_imm(X86::rsp, frame_size(i_num_loops)));
+        m_kernel.add_instr(X86::base_pop(ARGS_REG));
+        for (int32_t l_re = 3; l_re >= 0; l_re--) {
+            m_kernel.add_instr(X86::base_pop(PTR_REGS[l_re]));
+        }
+
+        m_kernel.add_instr(X86::base_ret());
+    }
+
+    void LoopNest::gen_load_ptr(uint32_t i_ptr,
+                                ptr_t const& i_src) {
+        if (i_src.kind == ptr_t::kind_t::arg) {
+            m_kernel.add_instr(X86::base_mov_load(PTR_REGS[i_ptr], X86::mem(ARGS_REG, 8 * static_cast<int32_t>(i_src.value))));
+        } else {
+            gen_mov_imm(m_kernel, PTR_REGS[i_ptr], i_src.kind == ptr_t::kind_t::address ? i_src.value : 0);
+        }
+    }
+
+    void LoopNest::gen_add_ptr(uint32_t i_ptr,
+                               int64_t i_value) {
+        if (i_value == 0) {
+            return;
+        }
+
+        if (is_imm32(i_value)) {
+            m_kernel.add_instr(X86::base_add_imm(PTR_REGS[i_ptr], static_cast<int32_t>(i_value)));
+        } else {
+            m_kernel.add_instr(X86::base_mov_imm64(HELP_REG, i_value));
+            m_kernel.add_instr(X86::base_add_register(PTR_REGS[i_ptr], HELP_REG));
+        }
+    }
+
+    void LoopNest::gen_call(call_t const& i_call,
+                            params_t const& i_params) {
+        if (i_call.kind == call_t::kind_t::brgemm) {
+            // arguments on the stack
+            gen_mov_imm(m_kernel, HELP_REG, i_params.br_stride_a);
+            m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, 0), HELP_REG));
+            gen_mov_imm(m_kernel, HELP_REG, i_params.br_stride_b);
+            m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, 8), HELP_REG));
+            if (i_call.bias) {
+                m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, 16), PTR_REGS[3]));
+            } else {
+                m_kernel.add_instr(X86::base_mov_imm(HELP_REG, 0));
+                m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, 16), HELP_REG));
+            }
+
+            m_kernel.add_instr(X86::base_mov_register(X86::rdi, PTR_REGS[0]));
+            m_kernel.add_instr(X86::base_mov_register(X86::rsi, PTR_REGS[1]));
+            m_kernel.add_instr(X86::base_mov_register(X86::rdx, PTR_REGS[2]));
+            gen_mov_imm(m_kernel, X86::rcx, i_params.lda);
+            gen_mov_imm(m_kernel, X86::r8, i_params.ldb);
+            gen_mov_imm(m_kernel, X86::r9, i_params.ldc);
+        } else {
+            m_kernel.add_instr(X86::base_mov_register(X86::rdi, PTR_REGS[2]));
+            m_kernel.add_instr(X86::base_mov_register(X86::rsi, PTR_REGS[2]));
+            gen_mov_imm(m_kernel, X86::rdx, i_params.ldc);
+            gen_mov_imm(m_kernel, X86::rcx, i_params.ldc);
+        }
+
+        m_kernel.add_instr(X86::base_mov_imm64(HELP_REG, reinterpret_cast<int64_t>(i_call.kernel)));
+        m_kernel.add_instr(X86::base_call(HELP_REG));
+    }
+
+    std::size_t LoopNest::gen_loop_begin(std::size_t i_id_loop,
+                                         int64_t i_count) {
+        gen_mov_imm(m_kernel, HELP_REG, i_count);
+        m_kernel.add_instr(X86::base_mov_store(X86::mem(X86::rsp, COUNTER_OFFSET + 8 * static_cast<int32_t>(i_id_loop)), HELP_REG));
+
+        return m_kernel.get_size();
+    }
+
+    void LoopNest::gen_loop_end(std::size_t i_id_loop,
+                                std::size_t i_pos) {
+        m_kernel.add_instr(X86::base_sub_store_imm(X86::mem(X86::rsp, COUNTER_OFFSET + 8 * static_cast<int32_t>(i_id_loop)), 1));
+        m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(i_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+    }
+}  // namespace mini_jit::generator
+#endif
@@ -0,0 +1,197 @@
+#include "TuningTable.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../backend/Cpu.h"
+
+namespace {
+    /**
+     * Autotuning mode given by the environment variable MINI_JIT_AUTOTUNE.
+     **/
+    bool autotune_from_env() {
+        char const* l_autotune = std::getenv("MINI_JIT_AUTOTUNE");
+
+        return l_autotune != nullptr && std::strcmp(l_autotune, "0") != 0;
+    }
+}  // namespace
+
+namespace mini_jit::generator {
+
+    std::mutex TuningTable::m_mutex;
+    std::map<TuningTable::key_t, Brgemm::blocking_t> TuningTable::m_table;
+    bool TuningTable::m_autotune = autotune_from_env();
+
+    void TuningTable::set_autotune(bool autotune) {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        m_autotune = autotune;
+    }
+
+    bool TuningTable::get_autotune() {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        return m_autotune;
+    }
+
+    bool TuningTable::lookup(uint32_t m,
+                             uint32_t n,
+                             uint32_t k,
+                             uint32_t br_size,
+                             Brgemm::blocking_t& o_blocking) {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        auto l_it = m_table.find(key_t{m, n, k, br_size});
+        if (l_it == m_table.end()) {
+            return false;
+        }
+
+        o_blocking = l_it->second;
+        return true;
+    }
+
+    void TuningTable::record(uint32_t m,
+                             uint32_t n,
+                             uint32_t k,
+                             uint32_t br_size,
+                             Brgemm::blocking_t const& blocking) {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        m_table[key_t{m, n, k, br_size}] = blocking;
+    }
+
+    double TuningTable::time_kernel(Brgemm::kernel_t kernel,
+                                    uint32_t m,
+                                    uint32_t n,
+                                    uint32_t k,
+                                    uint32_t br_size) {
+        // small values keep the accumulated C finite, the padding covers vector loads of the last B column
+        std::vector<float> l_a(m * k * br_size + 16, 0.001f);
+        std::vector<float> l_b(k * n * br_size + 16, 0.001f);
+        std::vector<float> l_c(m * n + 16, 0.0f);
+
+        // about 1e7 floating point operations per measurement
+        uint64_t l_flops = 2ull * m * n * k * br_size;
+        uint64_t l_reps = (l_flops < 10000000) ? 10000000 / l_flops : 1;
+
+        kernel(l_a.data(), l_b.data(), l_c.data(), m, k, m, m * k, k * n, nullptr);
+
+        double l_best = std::numeric_limits<double>::max();
+        for (int l_me = 0; l_me < 3; l_me++) {
+            auto l_start = std::chrono::steady_clock::now();
+            for (uint64_t l_re = 0; l_re < l_reps; l_re++) {
+                kernel(l_a.data(), l_b.data(), l_c.data(), m, k, m, m * k, k * n, nullptr);
+            }
+            std::chrono::duration<double> l_duration = std::chrono::steady_clock::now() - l_start;
+
+            l_best = (l_duration.count() < l_best) ? l_duration.count() : l_best;
+        }
+
+        return l_best;
+    }
+
+    Brgemm::blocking_t TuningTable::tune(uint32_t m,
+                                         uint32_t n,
+                                         uint32_t k,
+                                         uint32_t br_size) {
+        // the heuristic is the baseline, an earlier entry would replace it
+        {
+            std::lock_guard<std::mutex> l_lock(m_mutex);
+            m_table.erase(key_t{m, n, k, br_size});
+        }
+
+        Brgemm::blocking_t l_best_blocking;
+        double l_best_time = std::numeric_limits<double>::max();
+
+        Brgemm l_heuristic;
+        if (l_heuristic.generate(m, n, k, br_size, 0, 0, 0, Brgemm::dtype_t::fp32, false) == Brgemm::error_t::success) {
+            l_best_time = time_kernel(l_heuristic.get_kernel(), m, n, k, br_size);
+        }
+
+        // the generators reject blocks which do not fit into the registers
+        for (uint32_t l_mv = 1; l_mv <= MAX_M_VECTORS; l_mv++) {
+            for (uint32_t l_nb = 1; l_nb <= MAX_N_BLOCK && l_nb <= n; l_nb++) {
+                Brgemm::blocking_t l_blocking;
+                l_blocking.m_vectors = l_mv;
+                l_blocking.n = l_nb;
+
+                Brgemm l_brgemm;
+                l_brgemm.set_blocking(l_blocking);
+                if (l_brgemm.generate(m, n, k, br_size, 0, 0, 0, Brgemm::dtype_t::fp32, false) != Brgemm::error_t::success) {
+                    continue;
+                }
+
+                double l_time = time_kernel(l_brgemm.get_kernel(), m, n, k, br_size);
+                if (l_time < l_best_time) {
+                    l_best_time = l_time;
+                    l_best_blocking = l_blocking;
+                }
+            }
+        }
+
+        record(m, n, k, br_size, l_best_blocking);
+
+        return l_best_blocking;
+    }
+
+    Brgemm::error_t TuningTable::store(char const* path) {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        std::ofstream l_file(path);
+        if (!l_file) {
+            return Brgemm::error_t::io_error;
+        }
+
+        // header: CPU fingerprint, entries: m n k br_size m_vectors n_block
+        l_file << backend::Cpu::fingerprint() << "\n";
+        for (auto const& l_entry : m_table) {
+            l_file << std::get<0>(l_entry.first) << " "
+                   << std::get<1>(l_entry.first) << " "
+                   << std::get<2>(l_entry.first) << " "
+                   << std::get<3>(l_entry.first) << " "
+                   << l_entry.second.m_vectors << " "
+                   << l_entry.second.n << "\n";
+        }
+
+        return l_file ? Brgemm::error_t::success : Brgemm::error_t::io_error;
+    }
+
+    Brgemm::error_t TuningTable::load(char const* path) {
+        std::ifstream l_file(path);
+        std::string l_fingerprint;
+        if (!l_file || !std::getline(l_file, l_fingerprint)) {
+            return Brgemm::error_t::io_error;
+        }
+        if (l_fingerprint != backend::Cpu::fingerprint()) {
+            return Brgemm::error_t::bad_param;
+        }
+
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        uint32_t l_m, l_n, l_k, l_br_size;
+        Brgemm::blocking_t l_blocking;
+        while (l_file >> l_m >> l_n >> l_k >> l_br_size >> l_blocking.m_vectors >> l_blocking.n) {
+            m_table[key_t{l_m, l_n, l_k, l_br_size}] = l_blocking;
+        }
+
+        return l_file.eof() ? Brgemm::error_t::success : Brgemm::error_t::io_error;
+    }
+
+    std::size_t TuningTable::size() {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        return m_table.size();
+    }
+
+    void TuningTable::clear() {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        m_table.clear();
+    }
+
+}  // namespace mini_jit::generator
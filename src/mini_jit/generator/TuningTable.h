@@ -0,0 +1,126 @@
+#ifndef MINI_JIT_GENERATOR_TUNING_TABLE_H
+#define MINI_JIT_GENERATOR_TUNING_TABLE_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "Brgemm.h"
+
+namespace mini_jit::generator {
+    class TuningTable;
+}
+
+/**
+ * Process-wide table of autotuned register blockings of BRGEMM kernels.
+ *
+ * tune() generates a kernel for every register block of a shape which fits
+ * into the registers of the host, times the candidates in-process and records
+ * the fastest one. Brgemm::generate uses the recorded blocking instead of the
+ * built-in heuristic. In autotuning mode the KernelCache tunes every new shape
+ * before generating its kernel.
+ * All functions are thread-safe.
+ **/
+class mini_jit::generator::TuningTable {
+   private:
+    //! shape of a kernel: m, n, k and br_size
+    using key_t = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>;
+
+    //! guards the table
+    static std::mutex m_mutex;
+
+    //! tuned blockings by shape
+    static std::map<key_t, Brgemm::blocking_t> m_table;
+
+    //! true if the KernelCache tunes new shapes
+    static bool m_autotune;
+
+    /**
+     * @brief Time a kernel on column-major matrices without padding.
+     *
+     * @return best time of a few measurements in seconds.
+     **/
+    static double time_kernel(Brgemm::kernel_t kernel,
+                              uint32_t m,
+                              uint32_t n,
+                              uint32_t k,
+                              uint32_t br_size);
+
+   public:
+    //! largest number of vector registers in M direction tried by tune()
+    static constexpr uint32_t MAX_M_VECTORS = 4;
+
+    //! largest number of columns tried by tune()
+    static constexpr uint32_t MAX_N_BLOCK = 15;
+
+    /**
+     * @brief Enables or disables the autotuning mode of the KernelCache.
+     *
+     * The default is enabled if the environment variable MINI_JIT_AUTOTUNE is set to a value other than 0.
+     **/
+    static void set_autotune(bool autotune);
+
+    /**
+     * @brief Gets whether the autotuning mode is enabled.
+     **/
+    static bool get_autotune();
+
+    /**
+     * @brief Looks up the tuned blocking of a shape.
+     *
+     * @param o_blocking set to the tuned blocking if the shape was tuned, {0, 0} stands for the heuristic.
+     * @return true if the shape was tuned, false otherwise.
+     **/
+    static bool lookup(uint32_t m,
+                       uint32_t n,
+                       uint32_t k,
+                       uint32_t br_size,
+                       Brgemm::blocking_t& o_blocking);
+
+    /**
+     * @brief Records the blocking of a shape, replacing an earlier entry.
+     **/
+    static void record(uint32_t m,
+                       uint32_t n,
+                       uint32_t k,
+                       uint32_t br_size,
+                       Brgemm::blocking_t const& blocking);
+
+    /**
+     * @brief Tunes the register blocking of a FP32 BRGEMM shape and records the fastest one.
+     *
+     * The built-in heuristic competes as well, it is recorded as {0, 0} if no candidate beats it.
+     *
+     * @return fastest blocking.
+     **/
+    static Brgemm::blocking_t tune(uint32_t m,
+                                   uint32_t n,
+                                   uint32_t k,
+                                   uint32_t br_size);
+
+    /**
+     * @brief Writes the table to a text file, tagged with the CPU fingerprint of the host.
+     * @return error_t::success on success, error_t::io_error if the file could not be written.
+     **/
+    static Brgemm::error_t store(char const* path);
+
+    /**
+     * @brief Adds the entries of a file written by store() to the table.
+     * @return error_t::success on success, error_t::io_error if the file could not be read,
+     *         error_t::bad_param if it was tuned on a different CPU.
+     **/
+    static Brgemm::error_t load(char const* path);
+
+    /**
+     * @brief Number of tuned shapes.
+     **/
+    static std::size_t size();
+
+    /**
+     * @brief Removes all entries.
+     **/
+    static void clear();
+};
+
+#endif
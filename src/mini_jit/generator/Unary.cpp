@@ -20,8 +20,6 @@ namespace mini_jit::generator {
         Util::KernelSize kernelsize;
     } AreaDefinition;
 
-    mini_jit::backend::Kernel Unary::m_kernel;
-
     void Unary::gen_transpose_micro_4x4(uint32_t i_m,
                                         uint32_t i_n) {
         // ldr
@@ -413,10 +411,132 @@ namespace mini_jit::generator {
                                                        (loop_pos_n - m_kernel.get_size()) / 4 - 1));
     }
 
+    // v0-v23 hold a chunk of the column, v28-v31 are the temporaries of the activation
+    void Unary::gen_activation(uint32_t m,
+                               uint32_t n,
+                               Activation::act_t act) {
+        Activation::gen_table_neon(m_kernel, inst::InstGen::x15);
+
+        // help for N loops: jumps of the working pointers from the end of a column to the next one
+        m_kernel.add_instr(inst::InstGen::base_mov_imm(inst::InstGen::x14, m * 4, 0));
+
+        m_kernel.add_instr(inst::InstGen::base_sub_shifted_register(inst::InstGen::x13,
+                                                                    inst::InstGen::x3,
+                                                                    inst::InstGen::x14,
+                                                                    0,
+                                                                    0));
+        m_kernel.add_instr(inst::InstGen::base_sub_shifted_register(inst::InstGen::x14,
+                                                                    inst::InstGen::x2,
+                                                                    inst::InstGen::x14,
+                                                                    0,
+                                                                    0));
+
+        int reg_for_m_col = m / 4;
+        int use_loop = reg_for_m_col / 24;
+        reg_for_m_col -= use_loop * 24;
+
+        // set N loop counter
+        m_kernel.add_instr(inst::InstGen::base_mov_imm(Util::N_LOOP_COUNT_REG, n, 0));
+        // sub N loop register
+        m_kernel.add_instr(inst::InstGen::base_sub_imm(Util::N_LOOP_COUNT_REG,
+                                                       Util::N_LOOP_COUNT_REG,
+                                                       1,
+                                                       0));
+        std::size_t loop_pos_n = m_kernel.get_size();
+
+        for (; use_loop > -1; use_loop--) {
+            size_t num_full = use_loop > 0 ? 24 : reg_for_m_col;
+            size_t num_rem = use_loop > 0 ? 0 : (m % 4);
+
+            for (size_t i = 0; i < num_full; i++) {
+                m_kernel.add_instr(inst::InstGen::neon_ldr(static_cast<inst::InstGen::simd_fp_t>(inst::InstGen::v0 + i), inst::InstGen::x7, 16, inst::InstGen::arr_spec_t::q));
+            }
+            for (size_t i = 0; i < num_rem; i++) {
+                m_kernel.add_instr(inst::InstGen::neon_ld1_scalar_index(static_cast<inst::InstGen::simd_fp_t>(inst::InstGen::v0 + num_full), inst::InstGen::x7, i));
+                m_kernel.add_instr(inst::InstGen::base_add_imm(inst::InstGen::x7, inst::InstGen::x7, 4, 0));
+            }
+
+            Activation::gen_neon(m_kernel, act, 0, num_full + (num_rem > 0 ? 1 : 0), inst::InstGen::x15);
+
+            for (size_t i = 0; i < num_full; i++) {
+                m_kernel.add_instr(inst::InstGen::neon_str(static_cast<inst::InstGen::simd_fp_t>(inst::InstGen::v0 + i), inst::InstGen::x8, 16, inst::InstGen::arr_spec_t::q));
+            }
+            for (size_t i = 0; i < num_rem; i++) {
+                m_kernel.add_instr(inst::InstGen::neon_st1_scalar_index(static_cast<inst::InstGen::simd_fp_t>(inst::InstGen::v0 + num_full), inst::InstGen::x8, i));
+                m_kernel.add_instr(inst::InstGen::base_add_imm(inst::InstGen::x8, inst::InstGen::x8, 4, 0));
+            }
+        }
+        m_kernel.add_instr(inst::InstGen::base_add_shifted_register(inst::InstGen::x7, inst::InstGen::x7, inst::InstGen::x14, 0, 0));
+        m_kernel.add_instr(inst::InstGen::base_add_shifted_register(inst::InstGen::x8, inst::InstGen::x8, inst::InstGen::x13, 0, 0));
+        m_kernel.add_instr(inst::InstGen::base_br_cbnz(Util::N_LOOP_COUNT_REG,
+                                                       (loop_pos_n - m_kernel.get_size()) / 4 - 1));
+    }
+
+    Activation::act_t Unary::to_act(Unary::ptype_t ptype) {
+        switch (ptype) {
+            case Unary::ptype_t::gelu:
+                return Activation::act_t::gelu;
+            case Unary::ptype_t::sigmoid:
+                return Activation::act_t::sigmoid;
+            case Unary::ptype_t::tanh:
+                return Activation::act_t::tanh;
+            case Unary::ptype_t::silu:
+                return Activation::act_t::silu;
+            default:
+                return Activation::act_t::none;
+        }
+    }
+
     Unary::error_t Unary::generate(uint32_t m,
                                    uint32_t n,
                                    Unary::dtype_t dtype,
                                    Unary::ptype_t ptype) {
+        bool l_conversion = (ptype == Unary::ptype_t::to_bf16 || ptype == Unary::ptype_t::from_bf16);
+        bool l_conversion_fp16 = (ptype == Unary::ptype_t::to_fp16 || ptype == Unary::ptype_t::from_fp16);
+        if (ptype != Unary::ptype_t::zero && ptype != Unary::ptype_t::identity && ptype != Unary::ptype_t::relu && ptype != Unary::ptype_t::trans && !l_conversion && !l_conversion_fp16 && to_act(ptype) == Activation::act_t::none) {
+            return Unary::error_t::bad_param;
+        }
+
+        // bf16 is the data type of the conversions only
+        if (l_conversion != (dtype == Unary::dtype_t::bf16)) {
+            return Unary::error_t::bad_param;
+        }
+        if (l_conversion && !backend::Cpu::has_bf16()) {
+            return Unary::error_t::bad_param;
+        }
+
+        // fp16 is the data type of its conversions, zero, identity and ReLU
+        if (l_conversion_fp16 && dtype != Unary::dtype_t::fp16) {
+            return Unary::error_t::bad_param;
+        }
+        if (dtype == Unary::dtype_t::fp16 && !l_conversion_fp16 && ptype != Unary::ptype_t::zero && ptype != Unary::ptype_t::identity && ptype != Unary::ptype_t::relu) {
+            return Unary::error_t::bad_param;
+        }
+        if (dtype == Unary::dtype_t::fp16 && !backend::Cpu::has_fp16_fp32()) {
+            return Unary::error_t::bad_param;
+        }
+        if (dtype == Unary::dtype_t::fp16 && ptype == Unary::ptype_t::relu && !backend::Cpu::has_fp16()) {
+            return Unary::error_t::bad_param;
+        }
+
+        // the activations are evaluated in single precision only
+        if (dtype == Unary::dtype_t::fp64 && to_act(ptype) != Activation::act_t::none) {
+            return Unary::error_t::bad_param;
+        }
+
+#if defined(__x86_64__)
+        return generate_x86(m, n, dtype, ptype);
+#else
+        if (dtype == Unary::dtype_t::fp64) {
+            return generate_fp64(m, n, ptype);
+        }
+        if (dtype == Unary::dtype_t::bf16) {
+            return generate_bf16(m, n, ptype);
+        }
+        if (dtype == Unary::dtype_t::fp16) {
+            return generate_fp16(m, n, ptype);
+        }
+
         // procedure call standard (store to stack)
         m_kernel.add_instr(0x6DBF27E8);
         m_kernel.add_instr(0x6DBF2FEA);
@@ -442,6 +562,8 @@ namespace mini_jit::generator {
             gen_identity(m, n);
         } else if (ptype == Unary::ptype_t::relu) {
             gen_relu(m, n);
+        } else {
+            gen_activation(m, n, to_act(ptype));
         }
 
         // procedure call standard (load from stack)
@@ -455,12 +577,32 @@ namespace mini_jit::generator {
 
         m_kernel.set_kernel();
 
-        m_kernel.write("output_test.bin");
-
         return Unary::error_t::success;
+#endif
     }
 
     mini_jit::generator::Unary::kernel_t mini_jit::generator::Unary::get_kernel() const {
         return reinterpret_cast<kernel_t>(const_cast<void*>(m_kernel.get_kernel()));
     }
+
+    void mini_jit::generator::Unary::set_arena(mini_jit::backend::CodeArena* arena) {
+        m_kernel.set_arena(arena);
+    }
+
+    mini_jit::generator::Unary::error_t mini_jit::generator::Unary::load(char const* path,
+                                                                         uint32_t version,
+                                                                         uint64_t signature) {
+        if (!m_kernel.load(path, version, signature)) {
+            return Unary::error_t::io_error;
+        }
+        m_kernel.set_kernel();
+
+        return Unary::error_t::success;
+    }
+
+    void mini_jit::generator::Unary::store(char const* path,
+                                          uint32_t version,
+                                          uint64_t signature) const {
+        m_kernel.store(path, version, signature);
+    }
 }  // namespace mini_jit::generator
\ No newline at end of file
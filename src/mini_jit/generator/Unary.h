@@ -3,6 +3,7 @@
 
 #include <cstdint>
 
+#include "../backend/Cpu.h"
 #include "../backend/Kernel.h"
 #include "Util.h"
 
@@ -12,7 +13,8 @@ namespace mini_jit::generator {
 
 class mini_jit::generator::Unary {
    private:
-    static mini_jit::backend::Kernel m_kernel;
+    //! kernel backend
+    mini_jit::backend::Kernel m_kernel;
 
    public:
     int32_t fops = 0;
@@ -20,7 +22,11 @@ class mini_jit::generator::Unary {
     /// data type
     enum class dtype_t : uint32_t {
         fp32 = 0,
-        fp64 = 1
+        fp64 = 1,
+        //! conversions between single precision and bfloat16
+        bf16 = 2,
+        //! zero, identity and ReLU on half-precision values, conversions between single and half precision
+        fp16 = 3
     };
 
     /// primitive type
@@ -28,12 +34,26 @@ class mini_jit::generator::Unary {
         zero = 0,
         identity = 1,
         relu = 2,
-        trans = 3
+        trans = 3,
+        gelu = 5,
+        sigmoid = 6,
+        tanh = 7,
+        silu = 8,
+        //! B := A rounded to bfloat16 (round to nearest even), A in fp32
+        to_bf16 = 9,
+        //! B := A widened to fp32, A in bfloat16
+        from_bf16 = 10,
+        //! B := A rounded to half precision (round to nearest even), A in fp32
+        to_fp16 = 11,
+        //! B := A widened to fp32, A in half precision
+        from_fp16 = 12
     };
 
     /// error codes
     enum class error_t : int32_t {
-        success = 0
+        success = 0,
+        bad_param = -1,
+        io_error = -2
     };
 
     void gen_transpose_micro_4x4(uint32_t i_m,
@@ -53,12 +73,27 @@ class mini_jit::generator::Unary {
     void gen_identity(uint32_t m,
                       uint32_t n);
 
+    /**
+     * @brief Generates B := act(A) for one of the activations evaluated by Activation.
+     **/
+    void gen_activation(uint32_t m,
+                        uint32_t n,
+                        Activation::act_t act);
+
+    /**
+     * @brief Activation of a primitive type, Activation::act_t::none if the type is no activation.
+     **/
+    static Activation::act_t to_act(ptype_t ptype);
+
     /**
      * @brief Generate a kernel for a unary primitive.
      * @param m       Number of rows in A and B.
      * @param n       Number of columns in A and B.
      * @param trans_b 0 if B is stored in column-major order, 1 if B is stored in row-major order.
-     * @param dtype   Data type of the matrices.
+     * @param dtype   Data type of the matrices, the activations are evaluated in fp32 only,
+     *                bf16 is the type of the conversions to_bf16 and from_bf16 and requires backend::Cpu::has_bf16(),
+     *                fp16 is the type of the conversions to_fp16 and from_fp16 and supports zero, identity and ReLU, it requires backend::Cpu::has_fp16_fp32(),
+     *                the half-precision ReLU requires backend::Cpu::has_fp16().
      * @param ptype   Primitive type.
      * @return error_t::success on success, another error_t value otherwise.
      **/
@@ -85,6 +120,66 @@ class mini_jit::generator::Unary {
      * @return pointer to the generated kernel.
      **/
     kernel_t get_kernel() const;
+
+    /**
+     * @brief Place the kernel in the given code arena instead of mapping it separately.
+     * @param arena code arena which owns the kernel memory, has to be set before generate() or load().
+     **/
+    void set_arena(mini_jit::backend::CodeArena* arena);
+
+    /**
+     * @brief Load a previously stored kernel instead of generating it.
+     * @param path path to a file written by store().
+     * @param version version of the code generator, has to match the stored one.
+     * @param signature hash of the kernel signature, has to match the stored one.
+     * @return error_t::success on success, error_t::io_error if the file could not be read or does not match.
+     **/
+    error_t load(char const* path,
+                 uint32_t version,
+                 uint64_t signature);
+
+    /**
+     * @brief Store the generated kernel, e.g., to warm-start a later run through load().
+     * @param path path to the file.
+     * @param version version of the code generator.
+     * @param signature hash of the kernel signature.
+     **/
+    void store(char const* path,
+               uint32_t version,
+               uint64_t signature) const;
+
+   private:
+    /**
+     * @brief Generate the kernel for x86-64 using AVX2 or AVX-512 instructions.
+     **/
+    error_t generate_x86(uint32_t m,
+                         uint32_t n,
+                         dtype_t dtype,
+                         ptype_t ptype);
+
+    /**
+     * @brief Generate a double precision kernel for AArch64 using NEON instructions on .2d arrangements:
+     *        zero, identity, ReLU or the transposition through 2x2 blocks.
+     **/
+    error_t generate_fp64(uint32_t m,
+                          uint32_t n,
+                          ptype_t ptype);
+
+    /**
+     * @brief Generate a conversion between single precision and bfloat16 for AArch64
+     *        using the NEON instructions BFCVTN (to_bf16) and SHLL (from_bf16).
+     **/
+    error_t generate_bf16(uint32_t m,
+                          uint32_t n,
+                          ptype_t ptype);
+
+    /**
+     * @brief Generate a half-precision kernel for AArch64: zero, identity or ReLU (FMAX on .8h),
+     *        or a conversion from and to single precision using FCVTN (to_fp16) and FCVTL (from_fp16).
+     **/
+    error_t generate_fp16(uint32_t m,
+                          uint32_t n,
+                          ptype_t ptype);
 };
 
 #endif
\ No newline at end of file
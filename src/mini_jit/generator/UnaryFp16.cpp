@@ -0,0 +1,142 @@
+#include "../instructions/instructions.h"
+#include "Unary.h"
+
+using Inst = mini_jit::instructions::InstGen;
+
+/*
+ * Register usage of the half-precision NEON unary kernels (AAPCS64).
+ *
+ * Arguments: x0 = A, x1 = B, x2 = ld_a, x3 = ld_b.
+ *
+ * Only the caller-saved registers v0-v2 and v31 are used.
+ */
+namespace {
+    //! A and B of the current column
+    constexpr Inst::gpr_t A_REG = Inst::x0;
+    constexpr Inst::gpr_t B_REG = Inst::x1;
+
+    //! leading dimensions in bytes
+    constexpr Inst::gpr_t LDA_REG = Inst::x2;
+    constexpr Inst::gpr_t LDB_REG = Inst::x3;
+
+    //! loop counters
+    constexpr Inst::gpr_t N_LOOP_COUNT_REG = Inst::x9;
+    constexpr Inst::gpr_t M_LOOP_COUNT_REG = Inst::x10;
+
+    //! working pointers, advanced by the loads and stores
+    constexpr Inst::gpr_t WORKING_A_REG = Inst::x11;
+    constexpr Inst::gpr_t WORKING_B_REG = Inst::x12;
+
+    //! register holding zero
+    constexpr Inst::simd_fp_t ZERO_REG = Inst::v31;
+
+    //! values per iteration of the M loop
+    constexpr uint32_t M_BLOCK = 8;
+
+    /**
+     * Moves an unsigned 32-bit value to the given X register.
+     **/
+    void mov_imm32(mini_jit::backend::Kernel& i_kernel,
+                   Inst::gpr_t i_reg,
+                   uint32_t i_value) {
+        i_kernel.add_instr(Inst::base_movz(i_reg, i_value & 0xffff, 0));
+        if (i_value > 0xffff) {
+            i_kernel.add_instr(Inst::base_movk(i_reg, i_value >> 16, 16));
+        }
+    }
+
+    /**
+     * Scalar or 128-bit register of the given size in bytes.
+     **/
+    Inst::arr_spec_t reg_spec(uint32_t i_bytes) {
+        return (i_bytes == 16) ? Inst::q : (i_bytes == 8) ? Inst::d
+                                       : (i_bytes == 4)   ? Inst::s
+                                                          : Inst::h;
+    }
+}  // namespace
+
+namespace mini_jit::generator {
+    Unary::error_t Unary::generate_fp16(uint32_t m,
+                                        uint32_t n,
+                                        ptype_t ptype) {
+        if (m == 0 || n == 0) {
+            return Unary::error_t::bad_param;
+        }
+        bool l_to_fp16 = (ptype == ptype_t::to_fp16);
+        bool l_from_fp16 = (ptype == ptype_t::from_fp16);
+
+        // leading dimensions in bytes
+        m_kernel.add_instr(Inst::base_lsl_imm(LDA_REG, LDA_REG, l_to_fp16 ? 2 : 1));
+        m_kernel.add_instr(Inst::base_lsl_imm(LDB_REG, LDB_REG, l_from_fp16 ? 2 : 1));
+
+        if (ptype == ptype_t::zero || ptype == ptype_t::relu) {
+            m_kernel.add_instr(Inst::neon_movi_zero(ZERO_REG, true, false));
+        }
+
+        // i_count (8, 4, 2 or 1) values at the working pointers
+        auto l_gen_values = [&](uint32_t i_count) {
+            uint32_t l_bytes_half = 2 * i_count;
+            uint32_t l_bytes_single = 4 * ((i_count < 4) ? i_count : 4);
+            if (l_to_fp16) {
+                // FCVTN narrows four values, FCVTN2 the next four to the upper half
+                m_kernel.add_instr(Inst::neon_ldr(Inst::v0, WORKING_A_REG, l_bytes_single, reg_spec(l_bytes_single)));
+                m_kernel.add_instr(Inst::neon_fcvtn(Inst::v2, Inst::v0, false));
+                if (i_count == 8) {
+                    m_kernel.add_instr(Inst::neon_ldr(Inst::v1, WORKING_A_REG, 16, Inst::q));
+                    m_kernel.add_instr(Inst::neon_fcvtn(Inst::v2, Inst::v1, true));
+                }
+                m_kernel.add_instr(Inst::neon_str(Inst::v2, WORKING_B_REG, l_bytes_half, reg_spec(l_bytes_half)));
+            } else if (l_from_fp16) {
+                // FCVTL widens the lower four values, FCVTL2 the upper four
+                m_kernel.add_instr(Inst::neon_ldr(Inst::v0, WORKING_A_REG, l_bytes_half, reg_spec(l_bytes_half)));
+                m_kernel.add_instr(Inst::neon_fcvtl(Inst::v1, Inst::v0, false));
+                m_kernel.add_instr(Inst::neon_str(Inst::v1, WORKING_B_REG, l_bytes_single, reg_spec(l_bytes_single)));
+                if (i_count == 8) {
+                    m_kernel.add_instr(Inst::neon_fcvtl(Inst::v2, Inst::v0, true));
+                    m_kernel.add_instr(Inst::neon_str(Inst::v2, WORKING_B_REG, 16, Inst::q));
+                }
+            } else if (ptype == ptype_t::zero) {
+                m_kernel.add_instr(Inst::neon_str(ZERO_REG, WORKING_B_REG, l_bytes_half, reg_spec(l_bytes_half)));
+            } else {
+                m_kernel.add_instr(Inst::neon_ldr(Inst::v0, WORKING_A_REG, l_bytes_half, reg_spec(l_bytes_half)));
+                if (ptype == ptype_t::relu) {
+                    m_kernel.add_instr(Inst::neon_fmax_vector_h(Inst::v0, Inst::v0, ZERO_REG));
+                }
+                m_kernel.add_instr(Inst::neon_str(Inst::v0, WORKING_B_REG, l_bytes_half, reg_spec(l_bytes_half)));
+            }
+        };
+
+        // N loop
+        mov_imm32(m_kernel, N_LOOP_COUNT_REG, n);
+        std::size_t l_n_loop_pos = m_kernel.get_size();
+        m_kernel.add_instr(Inst::base_mov_register(WORKING_A_REG, A_REG));
+        m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REG, B_REG));
+
+        // M loop, the remainder is processed in blocks of four, two and one value
+        if (m / M_BLOCK > 0) {
+            mov_imm32(m_kernel, M_LOOP_COUNT_REG, m / M_BLOCK);
+            std::size_t l_m_loop_pos = m_kernel.get_size();
+
+            l_gen_values(M_BLOCK);
+
+            m_kernel.add_instr(Inst::base_sub_imm(M_LOOP_COUNT_REG, M_LOOP_COUNT_REG, 1, 0));
+            m_kernel.add_instr(Inst::base_br_cbnz(M_LOOP_COUNT_REG, (static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+        }
+        for (uint32_t l_count = M_BLOCK / 2; l_count > 0; l_count /= 2) {
+            if (m % (2 * l_count) >= l_count) {
+                l_gen_values(l_count);
+            }
+        }
+
+        m_kernel.add_instr(Inst::base_add_shifted_register(A_REG, A_REG, LDA_REG, 0, 0));
+        m_kernel.add_instr(Inst::base_add_shifted_register(B_REG, B_REG, LDB_REG, 0, 0));
+        m_kernel.add_instr(Inst::base_sub_imm(N_LOOP_COUNT_REG, N_LOOP_COUNT_REG, 1, 0));
+        m_kernel.add_instr(Inst::base_br_cbnz(N_LOOP_COUNT_REG, (static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size())) / 4));
+
+        m_kernel.add_instr(Inst::base_ret());
+
+        m_kernel.set_kernel();
+
+        return Unary::error_t::success;
+    }
+}  // namespace mini_jit::generator
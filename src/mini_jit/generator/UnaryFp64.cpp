@@ -0,0 +1,173 @@
+#include "../instructions/instructions.h"
+#include "Unary.h"
+
+using Inst = mini_jit::instructions::InstGen;
+
+/*
+ * Register usage of the double precision NEON unary kernels (AAPCS64).
+ *
+ * Arguments: x0 = A, x1 = B, x2 = ld_a, x3 = ld_b.
+ *
+ * Only the caller-saved registers v0-v7 and v31 are used.
+ */
+namespace {
+    //! A and B of the current column (block)
+    constexpr Inst::gpr_t A_REG = Inst::x0;
+    constexpr Inst::gpr_t B_REG = Inst::x1;
+
+    //! leading dimensions in bytes
+    constexpr Inst::gpr_t LDA_REG = Inst::x2;
+    constexpr Inst::gpr_t LDB_REG = Inst::x3;
+
+    //! loop counters
+    constexpr Inst::gpr_t N_LOOP_COUNT_REG = Inst::x9;
+    constexpr Inst::gpr_t M_LOOP_COUNT_REG = Inst::x10;
+
+    //! working pointers, the transposition reads two columns of A
+    constexpr Inst::gpr_t WORKING_A_REGS[2] = {Inst::x11, Inst::x12};
+    constexpr Inst::gpr_t WORKING_B_REG = Inst::x13;
+
+    constexpr Inst::gpr_t HELP_REG = Inst::x14;
+
+    //! register holding zero
+    constexpr Inst::simd_fp_t ZERO_REG = Inst::v31;
+
+    //! vectors per iteration of the M loop
+    constexpr uint32_t M_UNROLL = 8;
+
+    /**
+     * Moves an unsigned 32-bit value to the given X register.
+     **/
+    void mov_imm32(mini_jit::backend::Kernel& i_kernel,
+                   Inst::gpr_t i_reg,
+                   uint32_t i_value) {
+        i_kernel.add_instr(Inst::base_movz(i_reg, i_value & 0xffff, 0));
+        if (i_value > 0xffff) {
+            i_kernel.add_instr(Inst::base_movk(i_reg, i_value >> 16, 16));
+        }
+    }
+
+    /**
+     * Generates a loop with the given number of iterations around the body, nothing if the count is zero.
+     **/
+    template <typename F>
+    void gen_loop(mini_jit::backend::Kernel& i_kernel,
+                  Inst::gpr_t i_count_reg,
+                  uint32_t i_count,
+                  F&& i_body) {
+        if (i_count == 0) {
+            return;
+        }
+        mov_imm32(i_kernel, i_count_reg, i_count);
+        std::size_t l_loop_pos = i_kernel.get_size();
+
+        i_body();
+
+        i_kernel.add_instr(Inst::base_sub_imm(i_count_reg, i_count_reg, 1, 0));
+        i_kernel.add_instr(Inst::base_br_cbnz(i_count_reg, (static_cast<int32_t>(l_loop_pos) - static_cast<int32_t>(i_kernel.get_size())) / 4));
+    }
+}  // namespace
+
+namespace mini_jit::generator {
+    Unary::error_t Unary::generate_fp64(uint32_t m,
+                                        uint32_t n,
+                                        ptype_t ptype) {
+        if (m == 0 || n == 0) {
+            return Unary::error_t::bad_param;
+        }
+
+        // leading dimensions in bytes
+        m_kernel.add_instr(Inst::base_lsl_imm(LDA_REG, LDA_REG, 3));
+        m_kernel.add_instr(Inst::base_lsl_imm(LDB_REG, LDB_REG, 3));
+
+        if (ptype == ptype_t::trans) {
+            // B(j, i) = A(i, j): two columns of A are read in pairs of rows, ZIP1 and ZIP2 form two columns of B
+            auto l_gen_column_pair = [&](bool i_odd_row) {
+                Inst::arr_spec_t l_spec = i_odd_row ? Inst::d : Inst::q;
+                m_kernel.add_instr(Inst::neon_ldr(Inst::v0, WORKING_A_REGS[0], i_odd_row ? 8 : 16, l_spec));
+                m_kernel.add_instr(Inst::neon_ldr(Inst::v1, WORKING_A_REGS[1], i_odd_row ? 8 : 16, l_spec));
+                m_kernel.add_instr(Inst::neon_zip(Inst::v2, Inst::v0, Inst::v1, 1));
+                m_kernel.add_instr(Inst::neon_str_imm(Inst::v2, WORKING_B_REG, 0, Inst::q));
+                m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REG, WORKING_B_REG, LDB_REG, 0, 0));
+                if (!i_odd_row) {
+                    m_kernel.add_instr(Inst::neon_zip(Inst::v3, Inst::v0, Inst::v1, 2));
+                    m_kernel.add_instr(Inst::neon_str_imm(Inst::v3, WORKING_B_REG, 0, Inst::q));
+                    m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REG, WORKING_B_REG, LDB_REG, 0, 0));
+                }
+            };
+
+            gen_loop(m_kernel, N_LOOP_COUNT_REG, n / 2, [&]() {
+                m_kernel.add_instr(Inst::base_mov_register(WORKING_A_REGS[0], A_REG));
+                m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_A_REGS[1], A_REG, LDA_REG, 0, 0));
+                m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REG, B_REG));
+
+                gen_loop(m_kernel, M_LOOP_COUNT_REG, m / 2, [&]() {
+                    l_gen_column_pair(false);
+                });
+                if (m % 2 != 0) {
+                    l_gen_column_pair(true);
+                }
+
+                m_kernel.add_instr(Inst::base_add_shifted_register(A_REG, A_REG, LDA_REG, 0, 0));
+                m_kernel.add_instr(Inst::base_add_shifted_register(A_REG, A_REG, LDA_REG, 0, 0));
+                m_kernel.add_instr(Inst::base_add_imm(B_REG, B_REG, 16, 0));
+            });
+
+            // last column of A, element by element
+            if (n % 2 != 0) {
+                m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REG, B_REG));
+                gen_loop(m_kernel, M_LOOP_COUNT_REG, m, [&]() {
+                    m_kernel.add_instr(Inst::neon_ldr(Inst::v0, A_REG, 8, Inst::d));
+                    m_kernel.add_instr(Inst::neon_str_imm(Inst::v0, WORKING_B_REG, 0, Inst::d));
+                    m_kernel.add_instr(Inst::base_add_shifted_register(WORKING_B_REG, WORKING_B_REG, LDB_REG, 0, 0));
+                });
+            }
+        } else {
+            if (ptype == ptype_t::zero || ptype == ptype_t::relu) {
+                m_kernel.add_instr(Inst::neon_movi_zero(ZERO_REG, true, false));
+            }
+
+            // B = op(A) for the given number of vectors, the last one holds a single row if i_odd_row is set
+            auto l_gen_vectors = [&](uint32_t i_num_vectors, bool i_odd_row) {
+                for (uint32_t l_ve = 0; l_ve < i_num_vectors; l_ve++) {
+                    bool l_half = i_odd_row && (l_ve + 1 == i_num_vectors);
+                    Inst::simd_fp_t l_reg = static_cast<Inst::simd_fp_t>(l_ve);
+                    if (ptype == ptype_t::zero) {
+                        continue;
+                    }
+                    m_kernel.add_instr(Inst::neon_ldr(l_reg, WORKING_A_REGS[0], l_half ? 8 : 16, l_half ? Inst::d : Inst::q));
+                    if (ptype == ptype_t::relu) {
+                        m_kernel.add_instr(Inst::neon_fmax_vector(l_reg, l_reg, ZERO_REG, true));
+                    }
+                }
+                for (uint32_t l_ve = 0; l_ve < i_num_vectors; l_ve++) {
+                    bool l_half = i_odd_row && (l_ve + 1 == i_num_vectors);
+                    Inst::simd_fp_t l_reg = (ptype == ptype_t::zero) ? ZERO_REG : static_cast<Inst::simd_fp_t>(l_ve);
+                    m_kernel.add_instr(Inst::neon_str(l_reg, WORKING_B_REG, l_half ? 8 : 16, l_half ? Inst::d : Inst::q));
+                }
+            };
+
+            uint32_t l_rem_m = m % (2 * M_UNROLL);
+            gen_loop(m_kernel, N_LOOP_COUNT_REG, n, [&]() {
+                m_kernel.add_instr(Inst::base_mov_register(WORKING_A_REGS[0], A_REG));
+                m_kernel.add_instr(Inst::base_mov_register(WORKING_B_REG, B_REG));
+
+                gen_loop(m_kernel, M_LOOP_COUNT_REG, m / (2 * M_UNROLL), [&]() {
+                    l_gen_vectors(M_UNROLL, false);
+                });
+                if (l_rem_m > 0) {
+                    l_gen_vectors((l_rem_m + 1) / 2, l_rem_m % 2 != 0);
+                }
+
+                m_kernel.add_instr(Inst::base_add_shifted_register(A_REG, A_REG, LDA_REG, 0, 0));
+                m_kernel.add_instr(Inst::base_add_shifted_register(B_REG, B_REG, LDB_REG, 0, 0));
+            });
+        }
+
+        m_kernel.add_instr(Inst::base_ret());
+
+        m_kernel.set_kernel();
+
+        return Unary::error_t::success;
+    }
+}  // namespace mini_jit::generator
@@ -0,0 +1,248 @@
+#include "../instructions/instructions_x86.h"
+#include "Unary.h"
+
+using X86 = mini_jit::instructions::InstGenX86;
+
+/*
+ * Register usage of the x86-64 unary kernels (System V ABI).
+ *
+ * Arguments: rdi = A, rsi = B, rdx = ld_a, rcx = ld_b.
+ */
+namespace {
+    //! A and B of the current column
+    constexpr X86::gpr_t A_REG = X86::rdi;
+    constexpr X86::gpr_t B_REG = X86::rsi;
+
+    //! leading dimensions in bytes
+    constexpr X86::gpr_t LDA_REG = X86::rdx;
+    constexpr X86::gpr_t LDB_REG = X86::rcx;
+
+    //! loop counters
+    constexpr X86::gpr_t N_LOOP_COUNT_REG = X86::r8;
+    constexpr X86::gpr_t M_LOOP_COUNT_REG = X86::r9;
+
+    //! working pointers
+    constexpr X86::gpr_t WORKING_A_REG = X86::r10;
+    constexpr X86::gpr_t WORKING_B_REG = X86::r11;
+
+    //! vectors per iteration of the M loop
+    constexpr uint32_t M_UNROLL = 4;
+
+    //! AVX2 registers holding the mask of the M remainder and zero
+    constexpr X86::simd_t AVX2_MASK_REG = X86::v15;
+    constexpr X86::simd_t AVX2_ZERO_REG = X86::v14;
+
+    //! AVX-512 register holding zero
+    constexpr X86::simd_t AVX512_ZERO_REG = X86::v31;
+
+    //! stack slot of the AVX2 mask in the red zone
+    constexpr int32_t MASK_SLOT = -32;
+
+    //! stack slots of the activation constants in the red zone, below the mask
+    constexpr int32_t ACT_SLOT = MASK_SLOT - 4 * static_cast<int32_t>(mini_jit::generator::Activation::NUM_CONSTANTS);
+
+    //! first of the four temporaries of the activation, the loaded vectors use v0-v3
+    constexpr X86::simd_t ACT_TEMP_REG = X86::v4;
+}  // namespace
+
+namespace mini_jit::generator {
+    Unary::error_t Unary::generate_x86(uint32_t m,
+                                       uint32_t n,
+                                       dtype_t dtype,
+                                       ptype_t ptype) {
+        backend::Cpu::isa_t l_isa = backend::Cpu::get_isa();
+        if (l_isa != backend::Cpu::isa_t::avx2 && l_isa != backend::Cpu::isa_t::avx512) {
+            return Unary::error_t::bad_param;
+        }
+        if (m == 0 || n == 0) {
+            return Unary::error_t::bad_param;
+        }
+
+        bool l_avx512 = (l_isa == backend::Cpu::isa_t::avx512);
+        bool l_fp64 = (dtype == dtype_t::fp64);
+        // the conversions read or write bfloat16 or half-precision values, i.e., half of the bytes of a single precision vector
+        bool l_to_bf16 = (ptype == ptype_t::to_bf16);
+        bool l_from_bf16 = (ptype == ptype_t::from_bf16);
+        bool l_to_fp16 = (ptype == ptype_t::to_fp16);
+        bool l_from_fp16 = (ptype == ptype_t::from_fp16);
+        bool l_to_half = l_to_bf16 || l_to_fp16;
+        bool l_from_half = l_from_bf16 || l_from_fp16;
+        // zero, identity and ReLU on half-precision values
+        bool l_fp16 = (dtype == dtype_t::fp16) && !l_to_half && !l_from_half;
+        if ((dtype == dtype_t::bf16 || dtype == dtype_t::fp16) && !l_avx512) {
+            return Unary::error_t::bad_param;
+        }
+
+        int32_t l_size = l_fp64 ? 8 : l_fp16 ? 2 : 4;
+        int32_t l_vector_bytes = l_avx512 ? 64 : 32;
+        uint32_t l_vector_length = l_vector_bytes / l_size;
+        X86::simd_t l_zero = l_avx512 ? AVX512_ZERO_REG : AVX2_ZERO_REG;
+
+        int32_t l_vector_bytes_a = l_from_half ? l_vector_bytes / 2 : l_vector_bytes;
+        int32_t l_vector_bytes_b = l_to_half ? l_vector_bytes / 2 : l_vector_bytes;
+
+        // leading dimensions in bytes
+        m_kernel.add_instr(X86::base_shl_imm(LDA_REG, l_fp64 ? 3 : ((l_from_half || l_fp16) ? 1 : 2)));
+        m_kernel.add_instr(X86::base_shl_imm(LDB_REG, l_fp64 ? 3 : ((l_to_half || l_fp16) ? 1 : 2)));
+
+        m_kernel.add_instr(X86::base_mov_imm(N_LOOP_COUNT_REG, n));
+        std::size_t l_n_loop_pos = 0;
+
+        if (ptype == ptype_t::trans) {
+            // B(j, i) = A(i, j), element by element
+            l_n_loop_pos = m_kernel.get_size();
+            m_kernel.add_instr(X86::base_mov_register(WORKING_A_REG, A_REG));
+            m_kernel.add_instr(X86::base_mov_register(WORKING_B_REG, B_REG));
+
+            m_kernel.add_instr(X86::base_mov_imm(M_LOOP_COUNT_REG, m));
+            std::size_t l_m_loop_pos = m_kernel.get_size();
+            if (l_fp64) {
+                m_kernel.add_instr(X86::avx_vmovsd_load(X86::v0, X86::mem(WORKING_A_REG)));
+                m_kernel.add_instr(X86::avx_vmovsd_store(X86::mem(WORKING_B_REG), X86::v0));
+            } else {
+                m_kernel.add_instr(X86::avx_vmovss_load(X86::v0, X86::mem(WORKING_A_REG)));
+                m_kernel.add_instr(X86::avx_vmovss_store(X86::mem(WORKING_B_REG), X86::v0));
+            }
+            m_kernel.add_instr(X86::base_add_imm(WORKING_A_REG, l_size));
+            m_kernel.add_instr(X86::base_add_register(WORKING_B_REG, LDB_REG));
+            m_kernel.add_instr(X86::base_sub_imm(M_LOOP_COUNT_REG, 1));
+            m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+
+            m_kernel.add_instr(X86::base_add_register(A_REG, LDA_REG));
+            m_kernel.add_instr(X86::base_add_imm(B_REG, l_size));
+        } else {
+            uint32_t l_full_m = m / (M_UNROLL * l_vector_length);
+            uint32_t l_rem_m_vectors = (m % (M_UNROLL * l_vector_length)) / l_vector_length;
+            uint32_t l_rem_m_mask = m % l_vector_length;
+
+            // constants of the activation
+            Activation::act_t l_act = to_act(ptype);
+            if (l_act != Activation::act_t::none) {
+                Activation::gen_table_x86(m_kernel, X86::mem(X86::rsp, ACT_SLOT));
+            }
+
+            // zero and mask of the M remainder, double precision values span two 32-bit lanes of the masked moves
+            if (ptype == ptype_t::zero || ptype == ptype_t::relu) {
+                if (l_avx512) {
+                    m_kernel.add_instr(X86::avx512_vpxord(l_zero, l_zero, l_zero));
+                } else {
+                    m_kernel.add_instr(X86::avx_vxorps(l_zero, l_zero, l_zero));
+                }
+            }
+            if (l_rem_m_mask != 0) {
+                uint32_t l_mask_lanes = l_rem_m_mask * l_size / 4;
+                if (l_fp16) {
+                    // up to 32 16-bit lanes
+                    m_kernel.add_instr(X86::base_mov_imm(M_LOOP_COUNT_REG, static_cast<int32_t>((1u << l_rem_m_mask) - 1)));
+                    m_kernel.add_instr(X86::avx512_kmovd(X86::k1, M_LOOP_COUNT_REG));
+                } else if (l_avx512) {
+                    m_kernel.add_instr(X86::base_mov_imm(M_LOOP_COUNT_REG, (1 << l_mask_lanes) - 1));
+                    m_kernel.add_instr(X86::avx512_kmovw(X86::k1, M_LOOP_COUNT_REG));
+                } else {
+                    for (uint32_t l_la = 0; l_la < 8; l_la++) {
+                        m_kernel.add_instr(X86::base_mov_store_imm32(X86::mem(X86::rsp, MASK_SLOT + 4 * l_la),
+                                                                     l_la < l_mask_lanes ? -1 : 0));
+                    }
+                    m_kernel.add_instr(X86::avx_vmovups_load(AVX2_MASK_REG, X86::mem(X86::rsp, MASK_SLOT)));
+                }
+            }
+
+            // B = op(A) for i_num_vectors vectors at the working pointers
+            auto l_gen_vectors = [&](uint32_t i_num_vectors, bool i_masked_last) {
+                for (uint32_t l_ve = 0; l_ve < i_num_vectors; l_ve++) {
+                    X86::simd_t l_reg = static_cast<X86::simd_t>(l_ve);
+                    X86::mem_t l_mem_a = X86::mem(WORKING_A_REG, l_ve * l_vector_bytes_a);
+                    bool l_masked = i_masked_last && (l_ve + 1 == i_num_vectors);
+
+                    if (ptype == ptype_t::zero) {
+                        continue;
+                    } else if (l_fp16) {
+                        m_kernel.add_instr(X86::avx512_vmovdqu16_load(l_reg, l_mem_a, l_masked ? X86::k1 : X86::k0));
+                    } else if (l_from_fp16) {
+                        m_kernel.add_instr(X86::avx512_vcvtph2ps_load(l_reg, l_mem_a, l_masked ? X86::k1 : X86::k0));
+                    } else if (l_from_bf16) {
+                        // bfloat16 is the upper half of a single precision value
+                        m_kernel.add_instr(X86::avx512_vpmovzxwd_load(l_reg, l_mem_a, l_masked ? X86::k1 : X86::k0));
+                        m_kernel.add_instr(X86::avx512_vpslld_imm(l_reg, l_reg, 16));
+                    } else if (l_avx512) {
+                        m_kernel.add_instr(X86::avx512_vmovups_load(l_reg, l_mem_a, l_masked ? X86::k1 : X86::k0));
+                    } else if (l_masked) {
+                        m_kernel.add_instr(X86::avx_vmaskmovps_load(l_reg, AVX2_MASK_REG, l_mem_a));
+                    } else {
+                        m_kernel.add_instr(X86::avx_vmovups_load(l_reg, l_mem_a));
+                    }
+
+                    if (l_to_bf16) {
+                        m_kernel.add_instr(X86::avx512_vcvtneps2bf16(l_reg, l_reg));
+                    } else if (ptype == ptype_t::relu) {
+                        if (l_fp16) {
+                            m_kernel.add_instr(X86::avx512_vmaxph(l_reg, l_reg, l_zero));
+                        } else if (l_avx512) {
+                            m_kernel.add_instr(l_fp64 ? X86::avx512_vmaxpd(l_reg, l_reg, l_zero) : X86::avx512_vmaxps(l_reg, l_reg, l_zero));
+                        } else {
+                            m_kernel.add_instr(l_fp64 ? X86::avx_vmaxpd(l_reg, l_reg, l_zero) : X86::avx_vmaxps(l_reg, l_reg, l_zero));
+                        }
+                    }
+                }
+
+                if (l_act != Activation::act_t::none) {
+                    Activation::gen_x86(m_kernel, l_avx512, l_act, i_num_vectors, ACT_TEMP_REG, X86::mem(X86::rsp, ACT_SLOT));
+                }
+
+                for (uint32_t l_ve = 0; l_ve < i_num_vectors; l_ve++) {
+                    X86::simd_t l_reg = (ptype == ptype_t::zero) ? l_zero : static_cast<X86::simd_t>(l_ve);
+                    X86::mem_t l_mem_b = X86::mem(WORKING_B_REG, l_ve * l_vector_bytes_b);
+                    bool l_masked = i_masked_last && (l_ve + 1 == i_num_vectors);
+
+                    if (l_fp16) {
+                        m_kernel.add_instr(X86::avx512_vmovdqu16_store(l_mem_b, l_reg, l_masked ? X86::k1 : X86::k0));
+                    } else if (l_to_fp16) {
+                        m_kernel.add_instr(X86::avx512_vcvtps2ph_store(l_mem_b, l_reg, l_masked ? X86::k1 : X86::k0));
+                    } else if (l_to_bf16 && l_masked) {
+                        // the masked store of 16-bit values truncates the zero-extended 32-bit lanes
+                        m_kernel.add_instr(X86::avx512_vpmovzxwd(l_reg, l_reg));
+                        m_kernel.add_instr(X86::avx512_vpmovdw_store(l_mem_b, l_reg, X86::k1));
+                    } else if (l_to_bf16) {
+                        m_kernel.add_instr(X86::avx_vmovups_store(l_mem_b, l_reg));
+                    } else if (l_avx512) {
+                        m_kernel.add_instr(X86::avx512_vmovups_store(l_mem_b, l_reg, l_masked ? X86::k1 : X86::k0));
+                    } else if (l_masked) {
+                        m_kernel.add_instr(X86::avx_vmaskmovps_store(l_mem_b, AVX2_MASK_REG, l_reg));
+                    } else {
+                        m_kernel.add_instr(X86::avx_vmovups_store(l_mem_b, l_reg));
+                    }
+                }
+            };
+
+            l_n_loop_pos = m_kernel.get_size();
+            m_kernel.add_instr(X86::base_mov_register(WORKING_A_REG, A_REG));
+            m_kernel.add_instr(X86::base_mov_register(WORKING_B_REG, B_REG));
+
+            if (l_full_m > 0) {
+                m_kernel.add_instr(X86::base_mov_imm(M_LOOP_COUNT_REG, l_full_m));
+                std::size_t l_m_loop_pos = m_kernel.get_size();
+
+                l_gen_vectors(M_UNROLL, false);
+
+                m_kernel.add_instr(X86::base_add_imm(WORKING_A_REG, M_UNROLL * l_vector_bytes_a));
+                m_kernel.add_instr(X86::base_add_imm(WORKING_B_REG, M_UNROLL * l_vector_bytes_b));
+                m_kernel.add_instr(X86::base_sub_imm(M_LOOP_COUNT_REG, 1));
+                m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(l_m_loop_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+            }
+            l_gen_vectors(l_rem_m_vectors + (l_rem_m_mask != 0 ? 1 : 0), l_rem_m_mask != 0);
+
+            m_kernel.add_instr(X86::base_add_register(A_REG, LDA_REG));
+            m_kernel.add_instr(X86::base_add_register(B_REG, LDB_REG));
+        }
+
+        m_kernel.add_instr(X86::base_sub_imm(N_LOOP_COUNT_REG, 1));
+        m_kernel.add_instr(X86::base_jnz(static_cast<int32_t>(l_n_loop_pos) - static_cast<int32_t>(m_kernel.get_size() + X86::JNZ_SIZE)));
+
+        m_kernel.add_instr(X86::avx_vzeroupper());
+        m_kernel.add_instr(X86::base_ret());
+
+        m_kernel.set_kernel();
+
+        return Unary::error_t::success;
+    }
+}  // namespace mini_jit::generator
@@ -390,7 +390,8 @@ namespace mini_jit::generator {
     void Util::generator_store_reg_block(backend::Kernel &i_kernel,
                                          Util::KernelSize &i_kernelsize,
                                          InstGen::gpr_t i_register,
-                                         bool is_relu) {
+                                         bool is_relu,
+                                         Activation::act_t act) {
         int32_t l_n_count = 0;
         int32_t l_reg_count = 0;
 
@@ -400,6 +401,10 @@ namespace mini_jit::generator {
                 i_kernel.add_instr(InstGen::neon_fmax_vector(static_cast<InstGen::simd_fp_t>(i), static_cast<InstGen::simd_fp_t>(i), InstGen::v31, false));
             }
         }
+        if (Activation::is_rational(act)) {
+            Activation::gen_table_neon(i_kernel, HELP_REG_2);
+            Activation::gen_neon(i_kernel, act, 0, i_kernelsize.N * ((i_kernelsize.M + 3) / 4), HELP_REG_2);
+        }
 
         // prepare C restore register Help 1
         i_kernel.add_instr(InstGen::base_mov_imm(Util::HELP_REG_1, i_kernelsize.N, 0));
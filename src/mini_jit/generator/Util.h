@@ -7,6 +7,7 @@
 
 #include "../backend/Kernel.h"
 #include "../instructions/instructions.h"
+#include "Activation.h"
 
 namespace mini_jit::generator {
 
@@ -39,6 +40,9 @@ namespace mini_jit::generator {
         inline static constexpr mini_jit::instructions::InstGen::gpr_t BR_STRIDE_A = mini_jit::instructions::InstGen::x17;
         inline static constexpr mini_jit::instructions::InstGen::gpr_t BR_STRIDE_B = mini_jit::instructions::InstGen::x19;
 
+        inline static constexpr mini_jit::instructions::InstGen::gpr_t PREFETCH_OFFSET_A_REG = mini_jit::instructions::InstGen::x6;
+        inline static constexpr mini_jit::instructions::InstGen::gpr_t BIAS_REG = mini_jit::instructions::InstGen::x28;
+
         struct KernelSize {
             int M;
             int N;
@@ -107,11 +111,14 @@ namespace mini_jit::generator {
 
         /**
          * @brief Store a block of B with the given kernel size to vector registers
+         *
+         * A rational activation uses HELP_REG_2 as pointer to its constants and v28-v31 as temporary registers.
          */
         static void generator_store_reg_block(backend::Kernel &i_kernel,
                                               Util::KernelSize &i_kernelsize,
                                               mini_jit::instructions::InstGen::gpr_t i_register,
-                                              bool is_relu);
+                                              bool is_relu,
+                                              Activation::act_t act = Activation::act_t::none);
     };
 }  // namespace mini_jit::generator
 #endif
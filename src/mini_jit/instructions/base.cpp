@@ -139,11 +139,15 @@ namespace mini_jit {
 
         // lsl  <W/X>d, <W/X>n, #imm6
         uint32_t InstGen::base_lsl_imm(gpr_t Wd, gpr_t Wn, uint32_t shift) {
-            // LSL #n is an alias for UBFM Rd, Rn, #(-n & 31), #(31 - n)
-            uint32_t immr = (-shift) & 0x1F;
-            uint32_t imms = 31 - shift;
+            // LSL #n is an alias for UBFM Rd, Rn, #(-n % size), #(size - 1 - n)
+            uint32_t sf = (Wd >> 5) & 0x1u;
+            uint32_t size_mask = sf ? 0x3F : 0x1F;
+            uint32_t immr = (-shift) & size_mask;
+            uint32_t imms = size_mask - shift;
 
             uint32_t ins = 0x53000000u;
+            ins |= sf << 31;  // sf → bit 31
+            ins |= sf << 22;  // N → bit 22
             ins |= (immr & 0x3F) << 16;
             ins |= (imms & 0x3F) << 10;
             ins |= (Wn & 0x1F) << 5;
@@ -161,10 +165,75 @@ namespace mini_jit {
             return ins;
         }
 
+        // b.<cond>  #+imm19
+        uint32_t InstGen::base_b_cond(cond_t cond, int32_t imm19) {
+            uint32_t ins = 0x54000000u;
+            ins |= (cond & 0xFu);             // cond → bits [3:0]
+            ins |= (imm19 & 0x7FFFFu) << 5;  // imm19 → bits [23:5]
+            return ins;
+        }
+
+        // b  #+imm26
+        uint32_t InstGen::base_b(int32_t imm26) {
+            uint32_t ins = 0x14000000u;
+            ins |= (imm26 & 0x3FFFFFFu);  // imm26 → bits [25:0]
+            return ins;
+        }
+
+        // adr  <Xd>, #+imm21
+        uint32_t InstGen::base_adr(gpr_t Xd, int32_t imm21) {
+            uint32_t ins = 0x10000000u;
+            ins |= (Xd & 0x1Fu);
+            ins |= (imm21 & 0x3u) << 29;           // immlo → bits [30:29]
+            ins |= ((imm21 >> 2) & 0x7FFFFu) << 5;  // immhi → bits [23:5]
+            return ins;
+        }
+
+        // prfm  <prfop>, [<Xn|SP>, #+imm]
+        uint32_t InstGen::base_prfm_imm(prfop_t prfop, gpr_t Xn, uint32_t imm) {
+            uint32_t ins = 0xF9800000u;
+            ins |= (prfop & 0x1Fu);                // prfop → bits [4:0]
+            ins |= (Xn & 0x1Fu) << 5;              // Rn → bits [9:5]
+            ins |= ((imm / 8) & 0xFFFu) << 10;    // imm12 → bits [21:10]
+            return ins;
+        }
+
+        // prfm  <prfop>, [<Xn|SP>, <Xm>]
+        uint32_t InstGen::base_prfm_register(prfop_t prfop, gpr_t Xn, gpr_t Xm) {
+            uint32_t ins = 0xF8A06800u;
+            ins |= (prfop & 0x1Fu);
+            ins |= (Xn & 0x1Fu) << 5;
+            ins |= (Xm & 0x1Fu) << 16;  // Rm → bits [20:16]
+            return ins;
+        }
+
+        // ldr  <Xt>, [<Xn|SP>, #imm]
+        uint32_t InstGen::base_ldr_imm(gpr_t Xt, gpr_t Xn, uint32_t imm) {
+            uint32_t ins = 0xF9400000u;
+            ins |= (Xt & 0x1Fu);
+            ins |= (Xn & 0x1Fu) << 5;
+            ins |= ((imm / 8) & 0xFFFu) << 10;  // imm12 → bits [21:10]
+            return ins;
+        }
+
+        // str  <Xt>, [<Xn|SP>, #imm]
+        uint32_t InstGen::base_str_imm(gpr_t Xt, gpr_t Xn, uint32_t imm) {
+            uint32_t ins = 0xF9000000u;
+            ins |= (Xt & 0x1Fu);
+            ins |= (Xn & 0x1Fu) << 5;
+            ins |= ((imm / 8) & 0xFFFu) << 10;
+            return ins;
+        }
+
         uint32_t InstGen::base_ret() {
             return 0xd65f03c0;
         }
 
+        // blr  <Xn>
+        uint32_t InstGen::base_blr(gpr_t Xn) {
+            return 0xD63F0000u | ((Xn & 0x1Fu) << 5);
+        }
+
         uint32_t InstGen::base_mul_reg(gpr_t dst,
                                        gpr_t src_1,
                                        gpr_t src_0) {
@@ -119,6 +119,44 @@ class mini_jit::instructions::InstGen {
         v31 = 31
     } simd_fp_t;
 
+    //! SVE predicate registers, the SVE vector registers z0-z31 share the ids of simd_fp_t
+    typedef enum : uint32_t {
+        p0 = 0,
+        p1 = 1,
+        p2 = 2,
+        p3 = 3,
+        p4 = 4,
+        p5 = 5,
+        p6 = 6,
+        p7 = 7,
+        p8 = 8,
+        p9 = 9,
+        p10 = 10,
+        p11 = 11,
+        p12 = 12,
+        p13 = 13,
+        p14 = 14,
+        p15 = 15
+    } pred_t;
+
+    //! prefetch operations of PRFM
+    typedef enum : uint32_t {
+        pldl1keep = 0x0,
+        pldl1strm = 0x1,
+        pldl2keep = 0x2,
+        pldl3keep = 0x4
+    } prfop_t;
+
+    //! condition codes of B.cond
+    typedef enum : uint32_t {
+        eq = 0x0,
+        ne = 0x1,
+        mi = 0x4,  // SVE: first
+        pl = 0x5,  // SVE: nfrst
+        lt = 0xb,
+        ge = 0xa
+    } cond_t;
+
     //! arrangement specifiers
     typedef enum : uint32_t {
         b = 0x0,
@@ -227,11 +265,73 @@ class mini_jit::instructions::InstGen {
      */
     static uint32_t base_mul_reg(gpr_t dst, gpr_t src_1, gpr_t src_0);
 
+    /**
+     * @brief Generates a B.cond (Branch Conditionally) instruction.
+     *
+     * @param cond condition code.
+     * @param imm19 offset in instructions relative to this instruction.
+     */
+    static uint32_t base_b_cond(cond_t cond, int32_t imm19);
+
+    /**
+     * @brief Generates a B (Branch) instruction.
+     *
+     * @param imm26 offset in instructions relative to this instruction.
+     */
+    static uint32_t base_b(int32_t imm26);
+
+    /**
+     * @brief Generates an ADR instruction: Xd = address of this instruction + imm21.
+     *
+     * @param Xd destination register.
+     * @param imm21 offset in bytes (-1 MiB to 1 MiB).
+     */
+    static uint32_t base_adr(gpr_t Xd, int32_t imm21);
+
+    /**
+     * @brief Generates a PRFM (immediate) instruction.
+     *
+     * @param prfop prefetch operation.
+     * @param Xn base address register.
+     * @param imm offset in bytes (multiple of 8, 0 to 32760).
+     */
+    static uint32_t base_prfm_imm(prfop_t prfop, gpr_t Xn, uint32_t imm);
+
+    /**
+     * @brief Generates a PRFM (register) instruction: prefetch [Xn + Xm].
+     */
+    static uint32_t base_prfm_register(prfop_t prfop, gpr_t Xn, gpr_t Xm);
+
+    /**
+     * @brief Generates a LDR (immediate, unsigned offset) instruction: Xt = [Xn + imm].
+     *
+     * @param Xt destination register.
+     * @param Xn base address register.
+     * @param imm offset in bytes (multiple of 8, 0 to 32760).
+     */
+    static uint32_t base_ldr_imm(gpr_t Xt, gpr_t Xn, uint32_t imm);
+
+    /**
+     * @brief Generates a STR (immediate, unsigned offset) instruction: [Xn + imm] = Xt.
+     *
+     * @param Xt source register.
+     * @param Xn base address register.
+     * @param imm offset in bytes (multiple of 8, 0 to 32760).
+     */
+    static uint32_t base_str_imm(gpr_t Xt, gpr_t Xn, uint32_t imm);
+
     /**
      * @brief Generates a RET (Return from Subroutine) instruction.
      */
     static uint32_t base_ret();
 
+    /**
+     * @brief Generates a BLR (Branch with Link to Register) instruction.
+     *
+     * @param Xn register holding the address of the subroutine.
+     */
+    static uint32_t base_blr(gpr_t Xn);
+
     /**
      * @brief Generates an FMLA (vector) instruction.
      *
@@ -321,6 +421,29 @@ class mini_jit::instructions::InstGen {
                                      simd_fp_t reg_src2,
                                      bool is_double_precision);
 
+    static uint32_t neon_fmin_vector(simd_fp_t reg_dest,
+                                     simd_fp_t reg_src1,
+                                     simd_fp_t reg_src2,
+                                     bool is_double_precision);
+
+    static uint32_t neon_fadd_vector(simd_fp_t reg_dest,
+                                     simd_fp_t reg_src1,
+                                     simd_fp_t reg_src2,
+                                     bool is_double_precision);
+
+    static uint32_t neon_fmul_vector(simd_fp_t reg_dest,
+                                     simd_fp_t reg_src1,
+                                     simd_fp_t reg_src2,
+                                     bool is_double_precision);
+
+    /**
+     * @brief Generates an FDIV (vector) instruction: reg_dest = reg_src1 / reg_src2.
+     **/
+    static uint32_t neon_fdiv_vector(simd_fp_t reg_dest,
+                                     simd_fp_t reg_src1,
+                                     simd_fp_t reg_src2,
+                                     bool is_double_precision);
+
     static uint32_t neon_ld1_multiple(simd_fp_t base_reg,
                                       gpr_t src_reg,
                                       ld1_opcode_t op_code,
@@ -338,12 +461,471 @@ class mini_jit::instructions::InstGen {
     static uint32_t neon_zip(simd_fp_t reg_dst,
                              simd_fp_t reg_src1,
                              simd_fp_t reg_src2,
-                             int variant /* 1 or 2 */);
+                             int variant /* 1 or 2 */,
+                             arr_spec_t arr_spec = d /* element size: b, h, s or d */);
+
+    /**
+     * @brief Generates a UZP1 or UZP2 instruction on 128-bit registers.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src1 first source register.
+     * @param reg_src2 second source register.
+     * @param variant 1 for the even elements, 2 for the odd elements.
+     * @param arr_spec element size: b, h, s or d.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_uzp(simd_fp_t reg_dst,
+                             simd_fp_t reg_src1,
+                             simd_fp_t reg_src2,
+                             int variant,
+                             arr_spec_t arr_spec);
+
+    /**
+     * @brief Generates a BFMMLA instruction: the 2x4 BF16 matrix in reg_src1 times the
+     *        transposed 2x4 BF16 matrix in reg_src2 is added to the 2x2 FP32 matrix in reg_dest.
+     *
+     * @param reg_dest destination register (.4s), row-major 2x2 block.
+     * @param reg_src1 first source register (.8h), row-major 2x4 block.
+     * @param reg_src2 second source register (.8h), column-major 4x2 block.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_bfmmla(simd_fp_t reg_dest,
+                                simd_fp_t reg_src1,
+                                simd_fp_t reg_src2);
+
+    /**
+     * @brief Generates a BFCVTN (lower half) or BFCVTN2 (upper half) instruction
+     *        which converts four FP32 values to BF16 with round to nearest even.
+     *
+     * @param reg_dst destination register (.4h or .8h).
+     * @param reg_src source register (.4s).
+     * @param upper true for BFCVTN2, which writes the upper half of reg_dst.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_bfcvtn(simd_fp_t reg_dst,
+                                simd_fp_t reg_src,
+                                bool upper);
+
+    /**
+     * @brief Generates a SHLL (lower half) or SHLL2 (upper half) instruction
+     *        which widens four 16-bit values to 32 bits and shifts them left by 16, i.e., BF16 to FP32.
+     *
+     * @param reg_dst destination register (.4s).
+     * @param reg_src source register (.4h or .8h).
+     * @param upper true for SHLL2, which reads the upper half of reg_src.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_shll(simd_fp_t reg_dst,
+                              simd_fp_t reg_src,
+                              bool upper);
+
+    /**
+     * @brief Generates an LD1 (single structure) instruction for a 16-bit lane.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src address register.
+     * @param index lane index (0 to 7).
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_ld1_h_index(simd_fp_t reg_dst,
+                                     gpr_t reg_src,
+                                     int index);
+
+    /**
+     * @brief Generates an ST1 (single structure) instruction for a 16-bit lane.
+     *
+     * @param reg_src source register.
+     * @param reg_dst address register.
+     * @param index lane index (0 to 7).
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_st1_h_index(simd_fp_t reg_src,
+                                     gpr_t reg_dst,
+                                     int index);
+
+    /**
+     * @brief Generates an LD1 (single structure) instruction for an 8-bit lane.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src address register.
+     * @param index lane index (0 to 15).
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_ld1_b_index(simd_fp_t reg_dst,
+                                     gpr_t reg_src,
+                                     int index);
+
+    /**
+     * @brief Generates an SMMLA instruction: the signed 2x8 INT8 matrix in reg_src1 times the
+     *        transposed signed 2x8 INT8 matrix in reg_src2 is added to the 2x2 INT32 matrix in reg_dest.
+     *
+     * @param reg_dest destination register (.4s), row-major 2x2 block.
+     * @param reg_src1 first source register (.16b), row-major 2x8 block.
+     * @param reg_src2 second source register (.16b), column-major 8x2 block.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_smmla(simd_fp_t reg_dest,
+                               simd_fp_t reg_src1,
+                               simd_fp_t reg_src2);
+
+    /**
+     * @brief Generates an SCVTF (vector, .4s) instruction which converts signed 32-bit integers to FP32.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_scvtf(simd_fp_t reg_dst,
+                               simd_fp_t reg_src);
+
+    /**
+     * @brief Generates an FMLA (by element) instruction on half-precision values (FEAT_FP16):
+     *        reg_dest.8h += reg_src1.8h * reg_src2.h[index].
+     *
+     * @param reg_dest destination register.
+     * @param reg_src1 first source register.
+     * @param reg_src2 second source register, v0 to v15.
+     * @param index element index (0 to 7).
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_fmla_element_h(simd_fp_t reg_dest,
+                                        simd_fp_t reg_src1,
+                                        simd_fp_t reg_src2,
+                                        uint32_t index);
+
+    /**
+     * @brief Generates an FMLAL (lower half) or FMLAL2 (upper half) by element instruction (FEAT_FHM)
+     *        which multiplies four half-precision values with a half-precision element and accumulates in FP32:
+     *        reg_dest.4s += reg_src1.4h * reg_src2.h[index].
+     *
+     * @param reg_dest destination register (.4s).
+     * @param reg_src1 first source register (.8h), the lower or upper four values are used.
+     * @param reg_src2 second source register, v0 to v15.
+     * @param index element index (0 to 7).
+     * @param upper true for FMLAL2, which reads the upper half of reg_src1.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_fmlal_element(simd_fp_t reg_dest,
+                                       simd_fp_t reg_src1,
+                                       simd_fp_t reg_src2,
+                                       uint32_t index,
+                                       bool upper);
+
+    /**
+     * @brief Generates an FMAX (vector) instruction on half-precision values (.8h, FEAT_FP16).
+     *
+     * @param reg_dest destination register.
+     * @param reg_src1 first source register.
+     * @param reg_src2 second source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_fmax_vector_h(simd_fp_t reg_dest,
+                                       simd_fp_t reg_src1,
+                                       simd_fp_t reg_src2);
+
+    /**
+     * @brief Generates an LD1R instruction which broadcasts a 16-bit value to all eight lanes.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src address register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_ld1r_h(simd_fp_t reg_dst,
+                                gpr_t reg_src);
+
+    /**
+     * @brief Generates an FCVTN (lower half) or FCVTN2 (upper half) instruction
+     *        which converts four FP32 values to half precision with the rounding mode of FPCR.
+     *
+     * @param reg_dst destination register (.4h or .8h).
+     * @param reg_src source register (.4s).
+     * @param upper true for FCVTN2, which writes the upper half of reg_dst.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_fcvtn(simd_fp_t reg_dst,
+                               simd_fp_t reg_src,
+                               bool upper);
+
+    /**
+     * @brief Generates an FCVTL (lower half) or FCVTL2 (upper half) instruction
+     *        which widens four half-precision values to FP32.
+     *
+     * @param reg_dst destination register (.4s).
+     * @param reg_src source register (.4h or .8h).
+     * @param upper true for FCVTL2, which reads the upper half of reg_src.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_fcvtl(simd_fp_t reg_dst,
+                               simd_fp_t reg_src,
+                               bool upper);
     static uint32_t neon_eor(simd_fp_t reg_dst,
                              simd_fp_t reg_src1,
                              simd_fp_t reg_src2);
     static uint32_t neon_ldr_reg_offset(simd_fp_t reg_dst,
                                         gpr_t reg_src,
                                         gpr_t reg_offset);
+
+    /**
+     * @brief Generates an LD1R instruction which broadcasts a 32-bit value to all four lanes,
+     *        or a 64-bit value to both lanes.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src address register.
+     * @param is_double_precision broadcast a 64-bit value (.2d) instead of a 32-bit value (.4s).
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_ld1r(simd_fp_t reg_dst,
+                              gpr_t reg_src,
+                              bool is_double_precision = false);
+
+    /**
+     * @brief Generates an LDR (immediate, unsigned offset) instruction for a 128-bit register.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src base address register.
+     * @param imm offset in bytes (multiple of 16, 0 to 65520).
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_ldr_q_imm(simd_fp_t reg_dst,
+                                   gpr_t reg_src,
+                                   uint32_t imm);
+
+    /**
+     * @brief Generates an LDR (immediate, unsigned offset) instruction for a scalar or 128-bit register.
+     *
+     * @param reg_dst destination register.
+     * @param reg_src base address register.
+     * @param imm offset in bytes, a multiple of the register size.
+     * @param i_dtype size of the register: b, h, s, d or q.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_ldr_imm(simd_fp_t reg_dst,
+                                 gpr_t reg_src,
+                                 uint32_t imm,
+                                 arr_spec_t i_dtype);
+
+    /**
+     * @brief Generates an STR (immediate, unsigned offset) instruction for a scalar or 128-bit register.
+     *
+     * @param reg_src source register.
+     * @param reg_dst base address register.
+     * @param imm offset in bytes, a multiple of the register size.
+     * @param i_dtype size of the register: b, h, s, d or q.
+     *
+     * @return instruction.
+     **/
+    static uint32_t neon_str_imm(simd_fp_t reg_src,
+                                 gpr_t reg_dst,
+                                 uint32_t imm,
+                                 arr_spec_t i_dtype);
+
+    /**
+     * @brief Generates a PTRUE instruction which activates all 32-bit lanes.
+     *
+     * @param pred_dst destination predicate.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_ptrue(pred_t pred_dst);
+
+    /**
+     * @brief Generates a WHILELT instruction for 32-bit lanes: lane i is active if reg_src1 + i < reg_src2.
+     *
+     * Sets the condition flags, B.cond with mi (first) branches if the first lane is active.
+     *
+     * @param pred_dst destination predicate.
+     * @param reg_src1 first source register (X).
+     * @param reg_src2 second source register (X).
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_whilelt(pred_t pred_dst,
+                                gpr_t reg_src1,
+                                gpr_t reg_src2);
+
+    /**
+     * @brief Generates an INCW instruction: reg += mul * number of 32-bit lanes.
+     *
+     * @param reg register (X) which is incremented.
+     * @param mul multiplier (1 to 16).
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_incw(gpr_t reg,
+                             uint32_t mul);
+
+    /**
+     * @brief Generates an LD1W (scalar plus immediate) instruction, inactive lanes are zeroed.
+     *
+     * @param reg_dst destination register.
+     * @param pred governing predicate.
+     * @param add_src base address register.
+     * @param imm4 offset in multiples of the vector length (-8 to 7).
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_ld1w(simd_fp_t reg_dst,
+                             pred_t pred,
+                             gpr_t add_src,
+                             int32_t imm4);
+
+    /**
+     * @brief Generates an ST1W (scalar plus immediate) instruction, only active lanes are written.
+     *
+     * @param reg_src source register.
+     * @param pred governing predicate.
+     * @param add_dst base address register.
+     * @param imm4 offset in multiples of the vector length (-8 to 7).
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_st1w(simd_fp_t reg_src,
+                             pred_t pred,
+                             gpr_t add_dst,
+                             int32_t imm4);
+
+    /**
+     * @brief Generates an LD1RW instruction which broadcasts a 32-bit value to all active lanes.
+     *
+     * @param reg_dst destination register.
+     * @param pred governing predicate.
+     * @param add_src base address register.
+     * @param imm offset in bytes (multiple of 4, 0 to 252).
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_ld1rw(simd_fp_t reg_dst,
+                              pred_t pred,
+                              gpr_t add_src,
+                              uint32_t imm);
+
+    /**
+     * @brief Generates a predicated FMLA (vectors) instruction for 32-bit lanes.
+     *
+     * @param reg_dest destination register.
+     * @param pred governing predicate, inactive lanes are not modified.
+     * @param reg_src1 first source register.
+     * @param reg_src2 second source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_fmla(simd_fp_t reg_dest,
+                             pred_t pred,
+                             simd_fp_t reg_src1,
+                             simd_fp_t reg_src2);
+
+    /**
+     * @brief Generates a predicated FMAX (immediate) instruction with #0.0 for 32-bit lanes.
+     *
+     * @param reg_dest destination and source register.
+     * @param pred governing predicate, inactive lanes are not modified.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_fmax_zero(simd_fp_t reg_dest,
+                                  pred_t pred);
+
+    /**
+     * @brief Generates a DUP (immediate) instruction with #0 for 32-bit lanes.
+     *
+     * @param reg_dest destination register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_dup_zero(simd_fp_t reg_dest);
+
+    /**
+     * @brief Generates an unpredicated FADD (vectors) instruction for 32-bit lanes.
+     *
+     * @param reg_dest destination register.
+     * @param reg_src1 first source register.
+     * @param reg_src2 second source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_fadd(simd_fp_t reg_dest,
+                             simd_fp_t reg_src1,
+                             simd_fp_t reg_src2);
+
+    /**
+     * @brief Generates an unpredicated FMUL (vectors) instruction for 32-bit lanes.
+     *
+     * @param reg_dest destination register.
+     * @param reg_src1 first source register.
+     * @param reg_src2 second source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_fmul(simd_fp_t reg_dest,
+                             simd_fp_t reg_src1,
+                             simd_fp_t reg_src2);
+
+    /**
+     * @brief Generates a predicated FMIN (vectors) instruction for 32-bit lanes: reg_dest = min(reg_dest, reg_src).
+     *
+     * @param reg_dest destination and first source register.
+     * @param pred governing predicate, inactive lanes are not modified.
+     * @param reg_src second source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_fmin(simd_fp_t reg_dest,
+                             pred_t pred,
+                             simd_fp_t reg_src);
+
+    /**
+     * @brief Generates a predicated FMAX (vectors) instruction for 32-bit lanes: reg_dest = max(reg_dest, reg_src).
+     *
+     * @param reg_dest destination and first source register.
+     * @param pred governing predicate, inactive lanes are not modified.
+     * @param reg_src second source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_fmax(simd_fp_t reg_dest,
+                             pred_t pred,
+                             simd_fp_t reg_src);
+
+    /**
+     * @brief Generates a predicated FDIV (vectors) instruction for 32-bit lanes: reg_dest = reg_dest / reg_src.
+     *
+     * @param reg_dest destination and dividend register.
+     * @param pred governing predicate, inactive lanes are not modified.
+     * @param reg_src divisor register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_fdiv(simd_fp_t reg_dest,
+                             pred_t pred,
+                             simd_fp_t reg_src);
+
+    /**
+     * @brief Generates a MOV (vector, unpredicated) instruction, an alias of ORR.
+     *
+     * @param reg_dest destination register.
+     * @param reg_src source register.
+     *
+     * @return instruction.
+     **/
+    static uint32_t sve_mov(simd_fp_t reg_dest,
+                            simd_fp_t reg_src);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,746 @@
+#ifndef MINI_JIT_INSTRUCTIONS_INSTRUCTIONS_X86_H
+#define MINI_JIT_INSTRUCTIONS_INSTRUCTIONS_X86_H
+
+#include <cstdint>
+#include <vector>
+
+namespace mini_jit::instructions {
+    class InstGenX86;
+}
+
+/**
+ * Encoder for the x86-64 instructions used by the generators.
+ *
+ * General-purpose instructions operate on 64-bit registers.
+ * avx_* instructions are VEX encoded and operate on ymm registers (xmm for scalars),
+ * avx512_* instructions are EVEX encoded and operate on zmm registers.
+ **/
+class mini_jit::instructions::InstGenX86 {
+   public:
+    //! encoded instruction
+    using inst_t = std::vector<uint8_t>;
+
+    //! general-purpose registers
+    typedef enum : uint32_t {
+        rax = 0,
+        rcx = 1,
+        rdx = 2,
+        rbx = 3,
+        rsp = 4,
+        rbp = 5,
+        rsi = 6,
+        rdi = 7,
+        r8 = 8,
+        r9 = 9,
+        r10 = 10,
+        r11 = 11,
+        r12 = 12,
+        r13 = 13,
+        r14 = 14,
+        r15 = 15,
+
+        none = 16
+    } gpr_t;
+
+    //! vector registers (xmm, ymm or zmm depending on the instruction)
+    typedef enum : uint32_t {
+        v0 = 0,
+        v1 = 1,
+        v2 = 2,
+        v3 = 3,
+        v4 = 4,
+        v5 = 5,
+        v6 = 6,
+        v7 = 7,
+        v8 = 8,
+        v9 = 9,
+        v10 = 10,
+        v11 = 11,
+        v12 = 12,
+        v13 = 13,
+        v14 = 14,
+        v15 = 15,
+        v16 = 16,
+        v17 = 17,
+        v18 = 18,
+        v19 = 19,
+        v20 = 20,
+        v21 = 21,
+        v22 = 22,
+        v23 = 23,
+        v24 = 24,
+        v25 = 25,
+        v26 = 26,
+        v27 = 27,
+        v28 = 28,
+        v29 = 29,
+        v30 = 30,
+        v31 = 31
+    } simd_t;
+
+    //! opmask registers, k0 disables masking
+    typedef enum : uint32_t {
+        k0 = 0,
+        k1 = 1,
+        k2 = 2,
+        k3 = 3,
+        k4 = 4,
+        k5 = 5,
+        k6 = 6,
+        k7 = 7
+    } mask_t;
+
+    //! memory operand: [base + index * scale + disp]
+    struct mem_t {
+        gpr_t base = none;
+        gpr_t index = none;
+        uint32_t scale = 1;
+        int32_t disp = 0;
+        //! index holds the number of a vector register (VSIB addressing of the gathers)
+        bool vsib = false;
+    };
+
+    /**
+     * @brief Memory operand [base + disp].
+     **/
+    static mem_t mem(gpr_t base,
+                     int32_t disp = 0);
+
+    /**
+     * @brief Memory operand [base + index * scale + disp].
+     * @param scale 1, 2, 4 or 8.
+     **/
+    static mem_t mem(gpr_t base,
+                     gpr_t index,
+                     uint32_t scale,
+                     int32_t disp = 0);
+
+    /**
+     * @brief Memory operand of a gather: [base + index[i] * scale + disp] for every 32-bit lane i of index.
+     * @param scale 1, 2, 4 or 8.
+     **/
+    static mem_t vsib(gpr_t base,
+                      simd_t index,
+                      uint32_t scale,
+                      int32_t disp = 0);
+
+    /**
+     * @brief Generates a PUSH instruction.
+     */
+    static inst_t base_push(gpr_t reg);
+
+    /**
+     * @brief Generates a POP instruction.
+     */
+    static inst_t base_pop(gpr_t reg);
+
+    /**
+     * @brief Generates a RET instruction.
+     */
+    static inst_t base_ret();
+
+    /**
+     * @brief Generates a MOV (register) instruction: dst = src.
+     */
+    static inst_t base_mov_register(gpr_t dst,
+                                    gpr_t src);
+
+    /**
+     * @brief Generates a MOV (immediate) instruction, the immediate is sign-extended.
+     */
+    static inst_t base_mov_imm(gpr_t dst,
+                               int32_t imm32);
+
+    /**
+     * @brief Generates a MOV (64-bit immediate) instruction.
+     */
+    static inst_t base_mov_imm64(gpr_t dst,
+                                 int64_t imm64);
+
+    /**
+     * @brief Generates a CALL (register) instruction.
+     */
+    static inst_t base_call(gpr_t reg);
+
+    /**
+     * @brief Generates a MOV (load) instruction: dst = [src].
+     */
+    static inst_t base_mov_load(gpr_t dst,
+                                mem_t src);
+
+    /**
+     * @brief Generates a MOV (store) instruction: [dst] = src.
+     */
+    static inst_t base_mov_store(mem_t dst,
+                                 gpr_t src);
+
+    /**
+     * @brief Generates a 32-bit MOV (store) instruction: [dst] = low 32 bits of src.
+     */
+    static inst_t base_mov_store32(mem_t dst,
+                                   gpr_t src);
+
+    /**
+     * @brief Generates a 32-bit MOV (store immediate) instruction: [dst] = imm32.
+     */
+    static inst_t base_mov_store_imm32(mem_t dst,
+                                       int32_t imm32);
+
+    /**
+     * @brief Generates a LEA instruction: dst = address of src.
+     */
+    static inst_t base_lea(gpr_t dst,
+                           mem_t src);
+
+    /**
+     * @brief Generates an ADD (register) instruction: dst += src.
+     */
+    static inst_t base_add_register(gpr_t dst,
+                                    gpr_t src);
+
+    /**
+     * @brief Generates an ADD (memory) instruction: dst += [src].
+     */
+    static inst_t base_add_load(gpr_t dst,
+                                mem_t src);
+
+    /**
+     * @brief Generates an ADD (immediate) instruction: dst += imm32.
+     */
+    static inst_t base_add_imm(gpr_t dst,
+                               int32_t imm32);
+
+    /**
+     * @brief Generates a SUB (register) instruction: dst -= src.
+     */
+    static inst_t base_sub_register(gpr_t dst,
+                                    gpr_t src);
+
+    /**
+     * @brief Generates a SUB (immediate) instruction: dst -= imm32.
+     */
+    static inst_t base_sub_imm(gpr_t dst,
+                               int32_t imm32);
+
+    /**
+     * @brief Generates a SUB (memory destination) instruction: [dst] -= imm32.
+     */
+    static inst_t base_sub_store_imm(mem_t dst,
+                                     int32_t imm32);
+
+    /**
+     * @brief Generates an IMUL (immediate) instruction: dst = src * imm32.
+     */
+    static inst_t base_imul_imm(gpr_t dst,
+                                gpr_t src,
+                                int32_t imm32);
+
+    /**
+     * @brief Generates a SHL (immediate) instruction: dst <<= imm8.
+     */
+    static inst_t base_shl_imm(gpr_t dst,
+                               uint8_t imm8);
+
+    /**
+     * @brief Generates a JNZ instruction.
+     * @param rel32 offset in bytes relative to the end of the instruction.
+     */
+    static inst_t base_jnz(int32_t rel32);
+
+    /**
+     * @brief Size of base_jnz in bytes.
+     */
+    static constexpr int32_t JNZ_SIZE = 6;
+
+    /**
+     * @brief Generates a PREFETCHT0 instruction, or PREFETCHT1 if l2 is set.
+     */
+    static inst_t base_prefetch(mem_t src,
+                                bool l2 = false);
+
+    /**
+     * @brief Generates a VZEROUPPER instruction.
+     */
+    static inst_t avx_vzeroupper();
+
+    /**
+     * @brief Generates a VMOVUPS (load, ymm) instruction.
+     */
+    static inst_t avx_vmovups_load(simd_t dst,
+                                   mem_t src);
+
+    /**
+     * @brief Generates a VMOVUPS (store, ymm) instruction.
+     */
+    static inst_t avx_vmovups_store(mem_t dst,
+                                    simd_t src);
+
+    /**
+     * @brief Generates a VMASKMOVPS (load, ymm) instruction, lanes with a cleared sign bit in mask are zeroed.
+     */
+    static inst_t avx_vmaskmovps_load(simd_t dst,
+                                      simd_t mask,
+                                      mem_t src);
+
+    /**
+     * @brief Generates a VMASKMOVPS (store, ymm) instruction, only lanes with a set sign bit in mask are written.
+     */
+    static inst_t avx_vmaskmovps_store(mem_t dst,
+                                       simd_t mask,
+                                       simd_t src);
+
+    /**
+     * @brief Generates a VMOVSS (load, xmm) instruction.
+     */
+    static inst_t avx_vmovss_load(simd_t dst,
+                                  mem_t src);
+
+    /**
+     * @brief Generates a VMOVSS (store, xmm) instruction.
+     */
+    static inst_t avx_vmovss_store(mem_t dst,
+                                   simd_t src);
+
+    /**
+     * @brief Generates a VMOVSD (load, xmm) instruction.
+     */
+    static inst_t avx_vmovsd_load(simd_t dst,
+                                  mem_t src);
+
+    /**
+     * @brief Generates a VMOVSD (store, xmm) instruction.
+     */
+    static inst_t avx_vmovsd_store(mem_t dst,
+                                   simd_t src);
+
+    /**
+     * @brief Generates a VBROADCASTSS (ymm) instruction.
+     */
+    static inst_t avx_vbroadcastss(simd_t dst,
+                                   mem_t src);
+
+    /**
+     * @brief Generates a VBROADCASTSD (ymm) instruction.
+     */
+    static inst_t avx_vbroadcastsd(simd_t dst,
+                                   mem_t src);
+
+    /**
+     * @brief Generates a VFMADD231PS (ymm) instruction: dst += src1 * src2.
+     */
+    static inst_t avx_vfmadd231ps(simd_t dst,
+                                  simd_t src1,
+                                  simd_t src2);
+
+    /**
+     * @brief Generates a VFMADD231PD (ymm) instruction: dst += src1 * src2.
+     */
+    static inst_t avx_vfmadd231pd(simd_t dst,
+                                  simd_t src1,
+                                  simd_t src2);
+
+    /**
+     * @brief Generates a VXORPS (ymm) instruction.
+     */
+    static inst_t avx_vxorps(simd_t dst,
+                             simd_t src1,
+                             simd_t src2);
+
+    /**
+     * @brief Generates a VMAXPS (ymm) instruction.
+     */
+    static inst_t avx_vmaxps(simd_t dst,
+                             simd_t src1,
+                             simd_t src2);
+
+    /**
+     * @brief Generates a VMAXPD (ymm) instruction.
+     */
+    static inst_t avx_vmaxpd(simd_t dst,
+                             simd_t src1,
+                             simd_t src2);
+
+    /**
+     * @brief Generates a VMINPS (ymm) instruction.
+     */
+    static inst_t avx_vminps(simd_t dst,
+                             simd_t src1,
+                             simd_t src2);
+
+    /**
+     * @brief Generates a VADDPS (ymm) instruction.
+     */
+    static inst_t avx_vaddps(simd_t dst,
+                             simd_t src1,
+                             simd_t src2);
+
+    /**
+     * @brief Generates a VMULPS (ymm) instruction.
+     */
+    static inst_t avx_vmulps(simd_t dst,
+                             simd_t src1,
+                             simd_t src2);
+
+    /**
+     * @brief Generates a VDIVPS (ymm) instruction: dst = src1 / src2.
+     */
+    static inst_t avx_vdivps(simd_t dst,
+                             simd_t src1,
+                             simd_t src2);
+
+    /**
+     * @brief Generates a VGATHERDPS (ymm) instruction which loads the lanes whose mask has the sign bit set,
+     *        the other lanes of dst are kept. The mask is cleared, dst, index and mask have to differ.
+     * @param src memory operand with a vector index, see vsib().
+     */
+    static inst_t avx_vgatherdps(simd_t dst,
+                                 mem_t src,
+                                 simd_t mask);
+
+    /**
+     * @brief Generates a KMOVW instruction: mask = low 16 bits of src.
+     */
+    static inst_t avx512_kmovw(mask_t dst,
+                               gpr_t src);
+
+    /**
+     * @brief Generates a KMOVW instruction which copies a mask.
+     */
+    static inst_t avx512_kmovw_mask(mask_t dst,
+                                    mask_t src);
+
+    /**
+     * @brief Generates a VGATHERDPS (zmm) instruction which loads the lanes of the mask, the other lanes of dst are kept.
+     *        The mask (not k0) is cleared, dst and the index have to differ.
+     * @param src memory operand with a vector index, see vsib().
+     */
+    static inst_t avx512_vgatherdps(simd_t dst,
+                                    mem_t src,
+                                    mask_t mask);
+
+    /**
+     * @brief Generates a VMOVUPS (load, zmm) instruction, masked lanes are zeroed.
+     */
+    static inst_t avx512_vmovups_load(simd_t dst,
+                                      mem_t src,
+                                      mask_t mask = k0);
+
+    /**
+     * @brief Generates a VMOVUPS (store, zmm) instruction, only unmasked lanes are written.
+     */
+    static inst_t avx512_vmovups_store(mem_t dst,
+                                       simd_t src,
+                                       mask_t mask = k0);
+
+    /**
+     * @brief Generates a VBROADCASTSS (zmm) instruction.
+     */
+    static inst_t avx512_vbroadcastss(simd_t dst,
+                                      mem_t src);
+
+    /**
+     * @brief Generates a VBROADCASTSD (zmm) instruction.
+     */
+    static inst_t avx512_vbroadcastsd(simd_t dst,
+                                      mem_t src);
+
+    /**
+     * @brief Generates a VFMADD231PS (zmm) instruction: dst += src1 * src2.
+     */
+    static inst_t avx512_vfmadd231ps(simd_t dst,
+                                     simd_t src1,
+                                     simd_t src2);
+
+    /**
+     * @brief Generates a VFMADD231PD (zmm) instruction: dst += src1 * src2.
+     */
+    static inst_t avx512_vfmadd231pd(simd_t dst,
+                                     simd_t src1,
+                                     simd_t src2);
+
+    /**
+     * @brief Generates a VPXORD (zmm) instruction.
+     */
+    static inst_t avx512_vpxord(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VMAXPS (zmm) instruction.
+     */
+    static inst_t avx512_vmaxps(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VMAXPD (zmm) instruction.
+     */
+    static inst_t avx512_vmaxpd(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VMINPS (zmm) instruction.
+     */
+    static inst_t avx512_vminps(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VADDPS (zmm) instruction.
+     */
+    static inst_t avx512_vaddps(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VMULPS (zmm) instruction.
+     */
+    static inst_t avx512_vmulps(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VDIVPS (zmm) instruction: dst = src1 / src2.
+     */
+    static inst_t avx512_vdivps(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VDPBF16PS (zmm) instruction: dst += the sums of the products of
+     *        the pairs of BF16 values in src1 and src2, accumulated in FP32 (AVX512_BF16).
+     */
+    static inst_t avx512_vdpbf16ps(simd_t dst,
+                                   simd_t src1,
+                                   simd_t src2);
+
+    /**
+     * @brief Generates a VCVTNEPS2BF16 instruction converting the FP32 values of a zmm
+     *        to the BF16 values of a ymm with round to nearest even (AVX512_BF16).
+     */
+    static inst_t avx512_vcvtneps2bf16(simd_t dst,
+                                       simd_t src);
+
+    /**
+     * @brief Generates a VPMOVZXWD instruction which zero extends sixteen 16-bit values
+     *        of memory to the 32-bit lanes of a zmm.
+     */
+    static inst_t avx512_vpmovzxwd_load(simd_t dst,
+                                        mem_t src,
+                                        mask_t mask = k0);
+
+    /**
+     * @brief Generates a VPMOVZXWD instruction which zero extends the 16-bit values of a ymm
+     *        to the 32-bit lanes of a zmm.
+     */
+    static inst_t avx512_vpmovzxwd(simd_t dst,
+                                   simd_t src);
+
+    /**
+     * @brief Generates a VPMOVDW instruction which truncates the 32-bit lanes of a zmm
+     *        and stores them as sixteen 16-bit values.
+     */
+    static inst_t avx512_vpmovdw_store(mem_t dst,
+                                       simd_t src,
+                                       mask_t mask = k0);
+
+    /**
+     * @brief Generates a VPBROADCASTW (zmm) instruction which broadcasts a 16-bit value of memory.
+     */
+    static inst_t avx512_vpbroadcastw(simd_t dst,
+                                      mem_t src);
+
+    /**
+     * @brief Generates a VPSLLD (zmm) instruction: dst = src << imm8 in every 32-bit lane.
+     */
+    static inst_t avx512_vpslld_imm(simd_t dst,
+                                    simd_t src,
+                                    uint8_t imm8);
+
+    /**
+     * @brief Generates a VPORD (zmm) instruction.
+     */
+    static inst_t avx512_vpord(simd_t dst,
+                               simd_t src1,
+                               simd_t src2);
+
+    /**
+     * @brief Generates a VPDPBUSD (zmm) instruction: the products of the unsigned bytes of src1
+     *        and the signed bytes of src2 are summed in groups of four and added to the 32-bit lanes of dst.
+     */
+    static inst_t avx512_vpdpbusd(simd_t dst,
+                                  simd_t src1,
+                                  simd_t src2);
+
+    /**
+     * @brief Generates a VPMOVZXBD instruction which zero extends sixteen 8-bit values
+     *        of memory to the 32-bit lanes of a zmm.
+     */
+    static inst_t avx512_vpmovzxbd_load(simd_t dst,
+                                        mem_t src,
+                                        mask_t mask = k0);
+
+    /**
+     * @brief Generates a VMOVDQU8 (zmm) load, the masked bytes are zeroed and not accessed.
+     */
+    static inst_t avx512_vmovdqu8_load(simd_t dst,
+                                       mem_t src,
+                                       mask_t mask = k0);
+
+    /**
+     * @brief Generates a VPBROADCASTD (zmm) instruction which broadcasts the lowest 32-bit lane of src.
+     */
+    static inst_t avx512_vpbroadcastd(simd_t dst,
+                                      simd_t src);
+
+    /**
+     * @brief Generates a VCVTDQ2PS (zmm) instruction which converts signed 32-bit integers to single precision.
+     */
+    static inst_t avx512_vcvtdq2ps(simd_t dst,
+                                   simd_t src);
+
+    /**
+     * @brief Generates a VPSUBD (zmm) instruction: dst = src1 - src2 in every 32-bit lane.
+     */
+    static inst_t avx512_vpsubd(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a KMOVD instruction: mask = low 32 bits of src.
+     */
+    static inst_t avx512_kmovd(mask_t dst,
+                               gpr_t src);
+
+    /**
+     * @brief Generates a VMOVDQU16 (load, zmm) instruction, masked 16-bit lanes are zeroed.
+     */
+    static inst_t avx512_vmovdqu16_load(simd_t dst,
+                                        mem_t src,
+                                        mask_t mask = k0);
+
+    /**
+     * @brief Generates a VMOVDQU16 (store, zmm) instruction, only the 16-bit lanes of the mask are written.
+     */
+    static inst_t avx512_vmovdqu16_store(mem_t dst,
+                                         simd_t src,
+                                         mask_t mask = k0);
+
+    /**
+     * @brief Generates a VFMADD231PH (zmm, AVX512_FP16) instruction: dst += src1 * src2 on 32 half-precision values.
+     */
+    static inst_t avx512_vfmadd231ph(simd_t dst,
+                                     simd_t src1,
+                                     simd_t src2);
+
+    /**
+     * @brief Generates a VMAXPH (zmm, AVX512_FP16) instruction.
+     */
+    static inst_t avx512_vmaxph(simd_t dst,
+                                simd_t src1,
+                                simd_t src2);
+
+    /**
+     * @brief Generates a VCVTPH2PS (zmm) instruction which widens sixteen half-precision values of memory,
+     *        masked lanes are zeroed.
+     */
+    static inst_t avx512_vcvtph2ps_load(simd_t dst,
+                                        mem_t src,
+                                        mask_t mask = k0);
+
+    /**
+     * @brief Generates a VCVTPH2PS (zmm) instruction which widens the sixteen half-precision values in the lower half of src.
+     */
+    static inst_t avx512_vcvtph2ps(simd_t dst,
+                                   simd_t src);
+
+    /**
+     * @brief Generates a VCVTPS2PH (zmm) instruction which rounds sixteen single precision values
+     *        to half precision (round to nearest even) and stores them.
+     */
+    static inst_t avx512_vcvtps2ph_store(mem_t dst,
+                                         simd_t src,
+                                         mask_t mask = k0);
+
+   private:
+    /**
+     * Appends ModRM, SIB and displacement of a memory operand.
+     *
+     * @param reg value of the ModRM.reg field.
+     * @param mem memory operand.
+     * @param disp_scale scale of compressed 8-bit displacements (EVEX), 1 otherwise.
+     * @param ins instruction which is extended.
+     **/
+    static void encode_mem(uint32_t reg,
+                           mem_t const& mem,
+                           int32_t disp_scale,
+                           inst_t& ins);
+
+    /**
+     * Generates a REX.W instruction with a memory operand.
+     **/
+    static inst_t legacy_mem(std::vector<uint8_t> const& opcode,
+                             uint32_t reg,
+                             mem_t const& mem,
+                             bool rex_w = true);
+
+    /**
+     * Generates a REX.W instruction with a register operand (ModRM.mod = 11).
+     **/
+    static inst_t legacy_reg(std::vector<uint8_t> const& opcode,
+                             uint32_t reg,
+                             uint32_t rm);
+
+    /**
+     * Generates a VEX instruction.
+     *
+     * @param map opcode map: 1 = 0F, 2 = 0F38, 3 = 0F3A.
+     * @param pp implied prefix: 0 = none, 1 = 66, 2 = F3, 3 = F2.
+     * @param l256 true for 256-bit vectors.
+     * @param opcode opcode byte.
+     * @param reg ModRM.reg register.
+     * @param vvvv VEX.vvvv register.
+     * @param rm ModRM.rm register, ignored if mem is given.
+     * @param mem memory operand or nullptr.
+     * @param w VEX.W bit, selects the double precision variant of some opcodes.
+     **/
+    static inst_t vex(uint32_t map,
+                      uint32_t pp,
+                      bool l256,
+                      uint8_t opcode,
+                      uint32_t reg,
+                      uint32_t vvvv,
+                      uint32_t rm,
+                      mem_t const* mem,
+                      bool w = false);
+
+    /**
+     * Generates a 512-bit EVEX instruction.
+     *
+     * @param map opcode map: 1 = 0F, 2 = 0F38, 3 = 0F3A.
+     * @param pp implied prefix: 0 = none, 1 = 66, 2 = F3, 3 = F2.
+     * @param opcode opcode byte.
+     * @param reg ModRM.reg register.
+     * @param vvvv EVEX.vvvv register.
+     * @param rm ModRM.rm register, ignored if mem is given.
+     * @param mem memory operand or nullptr.
+     * @param disp_scale scale of compressed 8-bit displacements.
+     * @param mask opmask register.
+     * @param zeroing zeroing instead of merging masking.
+     * @param w EVEX.W bit, selects the double precision variant of an opcode.
+     **/
+    static inst_t evex(uint32_t map,
+                       uint32_t pp,
+                       uint8_t opcode,
+                       uint32_t reg,
+                       uint32_t vvvv,
+                       uint32_t rm,
+                       mem_t const* mem,
+                       int32_t disp_scale,
+                       mask_t mask,
+                       bool zeroing,
+                       bool w = false);
+};
+
+#endif
@@ -244,6 +244,110 @@ uint32_t mini_jit::instructions::InstGen::neon_fmax_vector(simd_fp_t reg_dest,
     return l_ins;
 }
 
+uint32_t mini_jit::instructions::InstGen::neon_fmin_vector(simd_fp_t reg_dest,
+                                                           simd_fp_t reg_src1,
+                                                           simd_fp_t reg_src2,
+                                                           bool is_double_precision) {
+    // Base encoding for FMIN (vector), element-wise
+    uint32_t l_ins = 0x0ea0f400;
+
+    // Set Q = 1 (128-bit vector)
+    l_ins |= (1 << 30);
+
+    // Set sz bit (bit 22): 0 for 32-bit (single), 1 for 64-bit (double)
+    if (is_double_precision)
+        l_ins |= (1 << 22);
+
+    // Set Rm (source register 2) bits [20:16]
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    // Set Rn (source register 1) bits [9:5]
+    l_ins |= (reg_src1 & 0x1f) << 5;
+
+    // Set Rd (destination register) bits [4:0]
+    l_ins |= (reg_dest & 0x1f);
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fadd_vector(simd_fp_t reg_dest,
+                                                           simd_fp_t reg_src1,
+                                                           simd_fp_t reg_src2,
+                                                           bool is_double_precision) {
+    // Base encoding for FADD (vector), element-wise
+    uint32_t l_ins = 0x0e20d400;
+
+    // Set Q = 1 (128-bit vector)
+    l_ins |= (1 << 30);
+
+    // Set sz bit (bit 22): 0 for 32-bit (single), 1 for 64-bit (double)
+    if (is_double_precision)
+        l_ins |= (1 << 22);
+
+    // Set Rm (source register 2) bits [20:16]
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    // Set Rn (source register 1) bits [9:5]
+    l_ins |= (reg_src1 & 0x1f) << 5;
+
+    // Set Rd (destination register) bits [4:0]
+    l_ins |= (reg_dest & 0x1f);
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fmul_vector(simd_fp_t reg_dest,
+                                                           simd_fp_t reg_src1,
+                                                           simd_fp_t reg_src2,
+                                                           bool is_double_precision) {
+    // Base encoding for FMUL (vector), element-wise
+    uint32_t l_ins = 0x2e20dc00;
+
+    // Set Q = 1 (128-bit vector)
+    l_ins |= (1 << 30);
+
+    // Set sz bit (bit 22): 0 for 32-bit (single), 1 for 64-bit (double)
+    if (is_double_precision)
+        l_ins |= (1 << 22);
+
+    // Set Rm (source register 2) bits [20:16]
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    // Set Rn (source register 1) bits [9:5]
+    l_ins |= (reg_src1 & 0x1f) << 5;
+
+    // Set Rd (destination register) bits [4:0]
+    l_ins |= (reg_dest & 0x1f);
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fdiv_vector(simd_fp_t reg_dest,
+                                                           simd_fp_t reg_src1,
+                                                           simd_fp_t reg_src2,
+                                                           bool is_double_precision) {
+    // Base encoding for FDIV (vector), element-wise
+    uint32_t l_ins = 0x2e20fc00;
+
+    // Set Q = 1 (128-bit vector)
+    l_ins |= (1 << 30);
+
+    // Set sz bit (bit 22): 0 for 32-bit (single), 1 for 64-bit (double)
+    if (is_double_precision)
+        l_ins |= (1 << 22);
+
+    // Set Rm (source register 2) bits [20:16]
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    // Set Rn (source register 1) bits [9:5]
+    l_ins |= (reg_src1 & 0x1f) << 5;
+
+    // Set Rd (destination register) bits [4:0]
+    l_ins |= (reg_dest & 0x1f);
+
+    return l_ins;
+}
+
 uint32_t mini_jit::instructions::InstGen::neon_ld1_multiple(simd_fp_t reg_base,
                                                             gpr_t reg_src,
                                                             ld1_opcode_t op_code,
@@ -307,18 +411,48 @@ uint32_t mini_jit::instructions::InstGen::neon_trn(simd_fp_t reg_dst,
 uint32_t mini_jit::instructions::InstGen::neon_zip(simd_fp_t reg_dst,
                                                    simd_fp_t reg_src1,
                                                    simd_fp_t reg_src2,
-                                                   int variant /* 1 or 2 */) {
+                                                   int variant /* 1 or 2 */,
+                                                   arr_spec_t arr_spec) {
     uint32_t l_ins = 0;
 
     if (variant == 1) {
-        l_ins = 0x4ec03800;  // ZIP1
+        l_ins = 0x4e003800;  // ZIP1
     } else if (variant == 2) {
-        l_ins = 0x4ec07800;  // ZIP2
+        l_ins = 0x4e007800;  // ZIP2
     } else {
         std::cerr << "Invalid variant for ZIP instruction: " << variant << std::endl;
         return 0;  // Invalid variant
     }
 
+    // size, bits 23:22
+    l_ins |= (arr_spec >> 30) << 22;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_uzp(simd_fp_t reg_dst,
+                                                   simd_fp_t reg_src1,
+                                                   simd_fp_t reg_src2,
+                                                   int variant,
+                                                   arr_spec_t arr_spec) {
+    uint32_t l_ins = 0;
+
+    if (variant == 1) {
+        l_ins = 0x4e001800;  // UZP1
+    } else if (variant == 2) {
+        l_ins = 0x4e005800;  // UZP2
+    } else {
+        std::cerr << "Invalid variant for UZP instruction: " << variant << std::endl;
+        return 0;  // Invalid variant
+    }
+
+    // size, bits 23:22
+    l_ins |= (arr_spec >> 30) << 22;
+
     l_ins |= (reg_dst & 0x1f);
     l_ins |= (reg_src1 & 0x1f) << 5;
     l_ins |= (reg_src2 & 0x1f) << 16;
@@ -326,6 +460,214 @@ uint32_t mini_jit::instructions::InstGen::neon_zip(simd_fp_t reg_dst,
     return l_ins;
 }
 
+uint32_t mini_jit::instructions::InstGen::neon_bfmmla(simd_fp_t reg_dest,
+                                                      simd_fp_t reg_src1,
+                                                      simd_fp_t reg_src2) {
+    uint32_t l_ins = 0x6e40ec00;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_bfcvtn(simd_fp_t reg_dst,
+                                                      simd_fp_t reg_src,
+                                                      bool upper) {
+    uint32_t l_ins = 0x0ea16800;
+
+    // Q selects BFCVTN2
+    if (upper) {
+        l_ins |= 0x40000000;
+    }
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_shll(simd_fp_t reg_dst,
+                                                    simd_fp_t reg_src,
+                                                    bool upper) {
+    // SHLL Vd.4S, Vn.4H, #16
+    uint32_t l_ins = 0x2e613800;
+
+    // Q selects SHLL2
+    if (upper) {
+        l_ins |= 0x40000000;
+    }
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_ld1_h_index(simd_fp_t reg_dst,
+                                                           gpr_t reg_src,
+                                                           int index) {
+    uint32_t l_ins = 0x0d404000;
+
+    // index = Q:S:size<1>
+    l_ins |= ((index >> 2) & 0x1) << 30;
+    l_ins |= ((index >> 1) & 0x1) << 12;
+    l_ins |= (index & 0x1) << 11;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_st1_h_index(simd_fp_t reg_src,
+                                                           gpr_t reg_dst,
+                                                           int index) {
+    uint32_t l_ins = 0x0d004000;
+
+    // index = Q:S:size<1>
+    l_ins |= ((index >> 2) & 0x1) << 30;
+    l_ins |= ((index >> 1) & 0x1) << 12;
+    l_ins |= (index & 0x1) << 11;
+
+    l_ins |= (reg_src & 0x1f);
+    l_ins |= (reg_dst & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_ld1_b_index(simd_fp_t reg_dst,
+                                                           gpr_t reg_src,
+                                                           int index) {
+    uint32_t l_ins = 0x0d400000;
+
+    // index = Q:S:size
+    l_ins |= ((index >> 3) & 0x1) << 30;
+    l_ins |= ((index >> 2) & 0x1) << 12;
+    l_ins |= (index & 0x3) << 10;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_smmla(simd_fp_t reg_dest,
+                                                     simd_fp_t reg_src1,
+                                                     simd_fp_t reg_src2) {
+    uint32_t l_ins = 0x4e80a400;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_scvtf(simd_fp_t reg_dst,
+                                                     simd_fp_t reg_src) {
+    uint32_t l_ins = 0x4e21d800;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fmla_element_h(simd_fp_t reg_dest,
+                                                              simd_fp_t reg_src1,
+                                                              simd_fp_t reg_src2,
+                                                              uint32_t index) {
+    uint32_t l_ins = 0x4f001000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    // Rm has four bits, the index is split into H:L:M
+    l_ins |= (reg_src2 & 0xf) << 16;
+    l_ins |= ((index >> 2) & 0x1) << 11;
+    l_ins |= ((index >> 1) & 0x1) << 21;
+    l_ins |= (index & 0x1) << 20;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fmlal_element(simd_fp_t reg_dest,
+                                                             simd_fp_t reg_src1,
+                                                             simd_fp_t reg_src2,
+                                                             uint32_t index,
+                                                             bool upper) {
+    uint32_t l_ins = 0x4f800000;
+
+    // FMLAL2 sets bit 29 and bit 15
+    if (upper) {
+        l_ins |= 0x20008000;
+    }
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0xf) << 16;
+    l_ins |= ((index >> 2) & 0x1) << 11;
+    l_ins |= ((index >> 1) & 0x1) << 21;
+    l_ins |= (index & 0x1) << 20;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fmax_vector_h(simd_fp_t reg_dest,
+                                                             simd_fp_t reg_src1,
+                                                             simd_fp_t reg_src2) {
+    uint32_t l_ins = 0x4e403400;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_ld1r_h(simd_fp_t reg_dst,
+                                                      gpr_t reg_src) {
+    uint32_t l_ins = 0x4d40c400;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fcvtn(simd_fp_t reg_dst,
+                                                     simd_fp_t reg_src,
+                                                     bool upper) {
+    uint32_t l_ins = 0x0e216800;
+
+    // Q selects FCVTN2
+    if (upper) {
+        l_ins |= 0x40000000;
+    }
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_fcvtl(simd_fp_t reg_dst,
+                                                     simd_fp_t reg_src,
+                                                     bool upper) {
+    uint32_t l_ins = 0x0e217800;
+
+    // Q selects FCVTL2
+    if (upper) {
+        l_ins |= 0x40000000;
+    }
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
 uint32_t mini_jit::instructions::InstGen::neon_eor(simd_fp_t reg_dst,
                                                    simd_fp_t reg_src1,
                                                    simd_fp_t reg_src2) {
@@ -348,4 +690,62 @@ uint32_t mini_jit::instructions::InstGen::neon_ldr_reg_offset(simd_fp_t reg_dst,
     l_ins |= (reg_offset & 0x1f) << 16;
 
     return l_ins;
-}
\ No newline at end of file
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_ld1r(simd_fp_t reg_dst,
+                                                    gpr_t reg_src,
+                                                    bool is_double_precision) {
+    uint32_t l_ins = 0x4d40c800;
+
+    // size = 0b11 broadcasts 64-bit elements
+    if (is_double_precision) {
+        l_ins |= 0x400;
+    }
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_ldr_q_imm(simd_fp_t reg_dst,
+                                                         gpr_t reg_src,
+                                                         uint32_t imm) {
+    uint32_t l_ins = 0x3dc00000;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+    l_ins |= ((imm / 16) & 0xfff) << 10;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_ldr_imm(simd_fp_t reg_dst,
+                                                       gpr_t reg_src,
+                                                       uint32_t imm,
+                                                       arr_spec_t i_dtype) {
+    uint32_t l_ins = 0x3d400000;
+    uint32_t l_size = (i_dtype == q) ? 16 : (i_dtype == d) ? 8 : (i_dtype == s) ? 4 : (i_dtype == h) ? 2 : 1;
+
+    l_ins |= i_dtype;
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+    l_ins |= ((imm / l_size) & 0xfff) << 10;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::neon_str_imm(simd_fp_t reg_src,
+                                                       gpr_t reg_dst,
+                                                       uint32_t imm,
+                                                       arr_spec_t i_dtype) {
+    uint32_t l_ins = 0x3d000000;
+    uint32_t l_size = (i_dtype == q) ? 16 : (i_dtype == d) ? 8 : (i_dtype == s) ? 4 : (i_dtype == h) ? 2 : 1;
+
+    l_ins |= i_dtype;
+    l_ins |= (reg_src & 0x1f);
+    l_ins |= (reg_dst & 0x1f) << 5;
+    l_ins |= ((imm / l_size) & 0xfff) << 10;
+
+    return l_ins;
+}
@@ -0,0 +1,191 @@
+#include "instructions.h"
+
+uint32_t mini_jit::instructions::InstGen::sve_ptrue(pred_t pred_dst) {
+    // ptrue <Pd>.s, all
+    uint32_t l_ins = 0x2598e3e0;
+
+    l_ins |= (pred_dst & 0xf);
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_whilelt(pred_t pred_dst,
+                                                      gpr_t reg_src1,
+                                                      gpr_t reg_src2) {
+    // whilelt <Pd>.s, <Xn>, <Xm>
+    uint32_t l_ins = 0x25a01400;
+
+    l_ins |= (pred_dst & 0xf);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_incw(gpr_t reg,
+                                                   uint32_t mul) {
+    // incw <Xdn>, all, mul #<imm>
+    uint32_t l_ins = 0x04b0e3e0;
+
+    l_ins |= (reg & 0x1f);
+    l_ins |= ((mul - 1) & 0xf) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_ld1w(simd_fp_t reg_dst,
+                                                   pred_t pred,
+                                                   gpr_t add_src,
+                                                   int32_t imm4) {
+    // ld1w {<Zt>.s}, <Pg>/z, [<Xn|SP>, #<imm>, mul vl]
+    uint32_t l_ins = 0xa540a000;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (add_src & 0x1f) << 5;
+    l_ins |= (pred & 0x7) << 10;
+    l_ins |= (imm4 & 0xf) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_st1w(simd_fp_t reg_src,
+                                                   pred_t pred,
+                                                   gpr_t add_dst,
+                                                   int32_t imm4) {
+    // st1w {<Zt>.s}, <Pg>, [<Xn|SP>, #<imm>, mul vl]
+    uint32_t l_ins = 0xe540e000;
+
+    l_ins |= (reg_src & 0x1f);
+    l_ins |= (add_dst & 0x1f) << 5;
+    l_ins |= (pred & 0x7) << 10;
+    l_ins |= (imm4 & 0xf) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_ld1rw(simd_fp_t reg_dst,
+                                                    pred_t pred,
+                                                    gpr_t add_src,
+                                                    uint32_t imm) {
+    // ld1rw {<Zt>.s}, <Pg>/z, [<Xn|SP>, #<imm>]
+    uint32_t l_ins = 0x8540c000;
+
+    l_ins |= (reg_dst & 0x1f);
+    l_ins |= (add_src & 0x1f) << 5;
+    l_ins |= (pred & 0x7) << 10;
+    l_ins |= ((imm / 4) & 0x3f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_fmla(simd_fp_t reg_dest,
+                                                   pred_t pred,
+                                                   simd_fp_t reg_src1,
+                                                   simd_fp_t reg_src2) {
+    // fmla <Zda>.s, <Pg>/m, <Zn>.s, <Zm>.s
+    uint32_t l_ins = 0x65a00000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (pred & 0x7) << 10;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_fmax_zero(simd_fp_t reg_dest,
+                                                        pred_t pred) {
+    // fmax <Zdn>.s, <Pg>/m, <Zdn>.s, #0.0
+    uint32_t l_ins = 0x659e8000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (pred & 0x7) << 10;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_dup_zero(simd_fp_t reg_dest) {
+    // dup <Zd>.s, #0
+    uint32_t l_ins = 0x25b8c000;
+
+    l_ins |= (reg_dest & 0x1f);
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_fadd(simd_fp_t reg_dest,
+                                                   simd_fp_t reg_src1,
+                                                   simd_fp_t reg_src2) {
+    // fadd <Zd>.s, <Zn>.s, <Zm>.s
+    uint32_t l_ins = 0x65800000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_fmul(simd_fp_t reg_dest,
+                                                   simd_fp_t reg_src1,
+                                                   simd_fp_t reg_src2) {
+    // fmul <Zd>.s, <Zn>.s, <Zm>.s
+    uint32_t l_ins = 0x65800800;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src1 & 0x1f) << 5;
+    l_ins |= (reg_src2 & 0x1f) << 16;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_fmin(simd_fp_t reg_dest,
+                                                   pred_t pred,
+                                                   simd_fp_t reg_src) {
+    // fmin <Zdn>.s, <Pg>/m, <Zdn>.s, <Zm>.s
+    uint32_t l_ins = 0x65878000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+    l_ins |= (pred & 0x7) << 10;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_fmax(simd_fp_t reg_dest,
+                                                   pred_t pred,
+                                                   simd_fp_t reg_src) {
+    // fmax <Zdn>.s, <Pg>/m, <Zdn>.s, <Zm>.s
+    uint32_t l_ins = 0x65868000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+    l_ins |= (pred & 0x7) << 10;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_fdiv(simd_fp_t reg_dest,
+                                                   pred_t pred,
+                                                   simd_fp_t reg_src) {
+    // fdiv <Zdn>.s, <Pg>/m, <Zdn>.s, <Zm>.s
+    uint32_t l_ins = 0x658d8000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+    l_ins |= (pred & 0x7) << 10;
+
+    return l_ins;
+}
+
+uint32_t mini_jit::instructions::InstGen::sve_mov(simd_fp_t reg_dest,
+                                                  simd_fp_t reg_src) {
+    // orr <Zd>.d, <Zn>.d, <Zn>.d
+    uint32_t l_ins = 0x04603000;
+
+    l_ins |= (reg_dest & 0x1f);
+    l_ins |= (reg_src & 0x1f) << 5;
+    l_ins |= (reg_src & 0x1f) << 16;
+
+    return l_ins;
+}
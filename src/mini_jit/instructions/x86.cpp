@@ -0,0 +1,758 @@
+#include "instructions_x86.h"
+
+namespace mini_jit {
+    namespace instructions {
+
+        InstGenX86::mem_t InstGenX86::mem(gpr_t base,
+                                          int32_t disp) {
+            return mem_t{base, none, 1, disp};
+        }
+
+        InstGenX86::mem_t InstGenX86::mem(gpr_t base,
+                                          gpr_t index,
+                                          uint32_t scale,
+                                          int32_t disp) {
+            return mem_t{base, index, scale, disp};
+        }
+
+        InstGenX86::mem_t InstGenX86::vsib(gpr_t base,
+                                           simd_t index,
+                                           uint32_t scale,
+                                           int32_t disp) {
+            return mem_t{base, static_cast<gpr_t>(index), scale, disp, true};
+        }
+
+        void InstGenX86::encode_mem(uint32_t reg,
+                                    mem_t const& mem,
+                                    int32_t disp_scale,
+                                    inst_t& ins) {
+            uint32_t l_base = mem.base & 0x7u;
+            bool l_has_index = mem.vsib || (mem.index != none);
+            bool l_need_sib = l_has_index || (l_base == 0x4u);
+
+            // mod: no displacement (not possible for rbp/r13), 8-bit or 32-bit displacement
+            uint32_t l_mod = 0x2u;
+            if (mem.disp == 0 && l_base != 0x5u) {
+                l_mod = 0x0u;
+            } else if (mem.disp % disp_scale == 0 && mem.disp / disp_scale >= -128 && mem.disp / disp_scale <= 127) {
+                l_mod = 0x1u;
+            }
+
+            ins.push_back((l_mod << 6) | ((reg & 0x7u) << 3) | (l_need_sib ? 0x4u : l_base));
+
+            if (l_need_sib) {
+                uint32_t l_scale = (mem.scale == 8) ? 3 : (mem.scale == 4) ? 2
+                                                      : (mem.scale == 2)   ? 1
+                                                                           : 0;
+                uint32_t l_index = l_has_index ? (mem.index & 0x7u) : 0x4u;
+                ins.push_back((l_scale << 6) | (l_index << 3) | l_base);
+            }
+
+            if (l_mod == 0x1u) {
+                ins.push_back(static_cast<uint8_t>(mem.disp / disp_scale));
+            } else if (l_mod == 0x2u) {
+                for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                    ins.push_back((static_cast<uint32_t>(mem.disp) >> (8 * l_by)) & 0xFFu);
+                }
+            }
+        }
+
+        InstGenX86::inst_t InstGenX86::legacy_mem(std::vector<uint8_t> const& opcode,
+                                                  uint32_t reg,
+                                                  mem_t const& mem,
+                                                  bool rex_w) {
+            inst_t ins;
+            uint32_t l_rex = 0x40u;
+            l_rex |= rex_w ? 0x8u : 0x0u;                                 // W
+            l_rex |= ((reg >> 3) & 0x1u) << 2;                            // R
+            l_rex |= (mem.index != none) ? ((mem.index >> 3) & 0x1u) << 1 : 0x0u;  // X
+            l_rex |= (mem.base >> 3) & 0x1u;                              // B
+            if (l_rex != 0x40u) {
+                ins.push_back(l_rex);
+            }
+            ins.insert(ins.end(), opcode.begin(), opcode.end());
+            encode_mem(reg, mem, 1, ins);
+            return ins;
+        }
+
+        InstGenX86::inst_t InstGenX86::legacy_reg(std::vector<uint8_t> const& opcode,
+                                                  uint32_t reg,
+                                                  uint32_t rm) {
+            inst_t ins;
+            ins.push_back(0x48u | (((reg >> 3) & 0x1u) << 2) | ((rm >> 3) & 0x1u));  // REX.W R B
+            ins.insert(ins.end(), opcode.begin(), opcode.end());
+            ins.push_back(0xC0u | ((reg & 0x7u) << 3) | (rm & 0x7u));
+            return ins;
+        }
+
+        InstGenX86::inst_t InstGenX86::vex(uint32_t map,
+                                           uint32_t pp,
+                                           bool l256,
+                                           uint8_t opcode,
+                                           uint32_t reg,
+                                           uint32_t vvvv,
+                                           uint32_t rm,
+                                           mem_t const* mem,
+                                           bool w) {
+            inst_t ins;
+            uint32_t l_r = (reg >> 3) & 0x1u;
+            uint32_t l_x = (mem != nullptr && (mem->vsib || mem->index != none)) ? ((mem->index >> 3) & 0x1u) : 0x0u;
+            uint32_t l_b = (mem != nullptr) ? ((mem->base >> 3) & 0x1u) : ((rm >> 3) & 0x1u);
+            uint32_t l_tail = ((~vvvv & 0xFu) << 3) | ((l256 ? 1u : 0u) << 2) | (pp & 0x3u);
+
+            if (l_x == 0 && l_b == 0 && map == 1 && !w) {
+                // two-byte VEX
+                ins.push_back(0xC5u);
+                ins.push_back(((l_r ^ 0x1u) << 7) | l_tail);
+            } else {
+                // three-byte VEX
+                ins.push_back(0xC4u);
+                ins.push_back(((l_r ^ 0x1u) << 7) | ((l_x ^ 0x1u) << 6) | ((l_b ^ 0x1u) << 5) | (map & 0x1Fu));
+                ins.push_back(((w ? 1u : 0u) << 7) | l_tail);
+            }
+            ins.push_back(opcode);
+
+            if (mem != nullptr) {
+                encode_mem(reg, *mem, 1, ins);
+            } else {
+                ins.push_back(0xC0u | ((reg & 0x7u) << 3) | (rm & 0x7u));
+            }
+            return ins;
+        }
+
+        InstGenX86::inst_t InstGenX86::evex(uint32_t map,
+                                            uint32_t pp,
+                                            uint8_t opcode,
+                                            uint32_t reg,
+                                            uint32_t vvvv,
+                                            uint32_t rm,
+                                            mem_t const* mem,
+                                            int32_t disp_scale,
+                                            mask_t mask,
+                                            bool zeroing,
+                                            bool w) {
+            inst_t ins;
+            uint32_t l_r = (reg >> 3) & 0x1u;
+            uint32_t l_r2 = (reg >> 4) & 0x1u;
+            uint32_t l_x = 0x0u;
+            uint32_t l_b = 0x0u;
+            // V' extends vvvv, or the vector index of the gathers
+            uint32_t l_v2 = (vvvv >> 4) & 0x1u;
+            if (mem != nullptr) {
+                l_x = (mem->vsib || mem->index != none) ? ((mem->index >> 3) & 0x1u) : 0x0u;
+                l_b = (mem->base >> 3) & 0x1u;
+                if (mem->vsib) {
+                    l_v2 = (mem->index >> 4) & 0x1u;
+                }
+            } else {
+                l_x = (rm >> 4) & 0x1u;
+                l_b = (rm >> 3) & 0x1u;
+            }
+
+            ins.push_back(0x62u);
+            // P0: R X B R' 0 m m m, the maps 5 and 6 hold the AVX512_FP16 instructions
+            ins.push_back(((l_r ^ 0x1u) << 7) | ((l_x ^ 0x1u) << 6) | ((l_b ^ 0x1u) << 5) | ((l_r2 ^ 0x1u) << 4) | (map & 0x7u));
+            // P1: W vvvv 1 p p
+            ins.push_back(((w ? 1u : 0u) << 7) | ((~vvvv & 0xFu) << 3) | 0x4u | (pp & 0x3u));
+            // P2: z L'L b V' a a a, 512-bit vectors
+            ins.push_back(((zeroing ? 1u : 0u) << 7) | (0x2u << 5) | ((l_v2 ^ 0x1u) << 3) | (mask & 0x7u));
+            ins.push_back(opcode);
+
+            if (mem != nullptr) {
+                encode_mem(reg, *mem, disp_scale, ins);
+            } else {
+                ins.push_back(0xC0u | ((reg & 0x7u) << 3) | (rm & 0x7u));
+            }
+            return ins;
+        }
+
+        // push r64
+        InstGenX86::inst_t InstGenX86::base_push(gpr_t reg) {
+            inst_t ins;
+            if (reg >= r8) {
+                ins.push_back(0x41u);
+            }
+            ins.push_back(0x50u + (reg & 0x7u));
+            return ins;
+        }
+
+        // pop r64
+        InstGenX86::inst_t InstGenX86::base_pop(gpr_t reg) {
+            inst_t ins;
+            if (reg >= r8) {
+                ins.push_back(0x41u);
+            }
+            ins.push_back(0x58u + (reg & 0x7u));
+            return ins;
+        }
+
+        // ret
+        InstGenX86::inst_t InstGenX86::base_ret() {
+            return inst_t{0xC3u};
+        }
+
+        // mov r/m64, r64
+        InstGenX86::inst_t InstGenX86::base_mov_register(gpr_t dst,
+                                                         gpr_t src) {
+            return legacy_reg({0x89u}, src, dst);
+        }
+
+        // mov r/m64, imm32
+        InstGenX86::inst_t InstGenX86::base_mov_imm(gpr_t dst,
+                                                    int32_t imm32) {
+            inst_t ins = legacy_reg({0xC7u}, 0, dst);
+            for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                ins.push_back((static_cast<uint32_t>(imm32) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // mov r64, imm64
+        InstGenX86::inst_t InstGenX86::base_mov_imm64(gpr_t dst,
+                                                      int64_t imm64) {
+            inst_t ins{static_cast<uint8_t>(0x48u | ((dst >> 3) & 0x1u)), static_cast<uint8_t>(0xB8u + (dst & 0x7u))};
+            for (uint32_t l_by = 0; l_by < 8; l_by++) {
+                ins.push_back((static_cast<uint64_t>(imm64) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // call r/m64
+        InstGenX86::inst_t InstGenX86::base_call(gpr_t reg) {
+            inst_t ins;
+            if (reg >= r8) {
+                ins.push_back(0x41u);
+            }
+            ins.push_back(0xFFu);
+            ins.push_back(0xD0u | (reg & 0x7u));
+            return ins;
+        }
+
+        // mov r64, r/m64
+        InstGenX86::inst_t InstGenX86::base_mov_load(gpr_t dst,
+                                                     mem_t src) {
+            return legacy_mem({0x8Bu}, dst, src);
+        }
+
+        // mov r/m64, r64
+        InstGenX86::inst_t InstGenX86::base_mov_store(mem_t dst,
+                                                      gpr_t src) {
+            return legacy_mem({0x89u}, src, dst);
+        }
+
+        // mov r/m32, r32
+        InstGenX86::inst_t InstGenX86::base_mov_store32(mem_t dst,
+                                                        gpr_t src) {
+            return legacy_mem({0x89u}, src, dst, false);
+        }
+
+        // mov r/m32, imm32
+        InstGenX86::inst_t InstGenX86::base_mov_store_imm32(mem_t dst,
+                                                            int32_t imm32) {
+            inst_t ins = legacy_mem({0xC7u}, 0, dst, false);
+            for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                ins.push_back((static_cast<uint32_t>(imm32) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // lea r64, m
+        InstGenX86::inst_t InstGenX86::base_lea(gpr_t dst,
+                                                mem_t src) {
+            return legacy_mem({0x8Du}, dst, src);
+        }
+
+        // add r/m64, r64
+        InstGenX86::inst_t InstGenX86::base_add_register(gpr_t dst,
+                                                         gpr_t src) {
+            return legacy_reg({0x01u}, src, dst);
+        }
+
+        // add r64, r/m64
+        InstGenX86::inst_t InstGenX86::base_add_load(gpr_t dst,
+                                                     mem_t src) {
+            return legacy_mem({0x03u}, dst, src);
+        }
+
+        // add r/m64, imm8 / imm32
+        InstGenX86::inst_t InstGenX86::base_add_imm(gpr_t dst,
+                                                    int32_t imm32) {
+            if (imm32 >= -128 && imm32 <= 127) {
+                inst_t ins = legacy_reg({0x83u}, 0, dst);
+                ins.push_back(static_cast<uint8_t>(imm32));
+                return ins;
+            }
+            inst_t ins = legacy_reg({0x81u}, 0, dst);
+            for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                ins.push_back((static_cast<uint32_t>(imm32) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // sub r/m64, r64
+        InstGenX86::inst_t InstGenX86::base_sub_register(gpr_t dst,
+                                                         gpr_t src) {
+            return legacy_reg({0x29u}, src, dst);
+        }
+
+        // sub r/m64, imm8 / imm32
+        InstGenX86::inst_t InstGenX86::base_sub_imm(gpr_t dst,
+                                                    int32_t imm32) {
+            if (imm32 >= -128 && imm32 <= 127) {
+                inst_t ins = legacy_reg({0x83u}, 5, dst);
+                ins.push_back(static_cast<uint8_t>(imm32));
+                return ins;
+            }
+            inst_t ins = legacy_reg({0x81u}, 5, dst);
+            for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                ins.push_back((static_cast<uint32_t>(imm32) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // sub r/m64, imm8 / imm32
+        InstGenX86::inst_t InstGenX86::base_sub_store_imm(mem_t dst,
+                                                          int32_t imm32) {
+            if (imm32 >= -128 && imm32 <= 127) {
+                inst_t ins = legacy_mem({0x83u}, 5, dst);
+                ins.push_back(static_cast<uint8_t>(imm32));
+                return ins;
+            }
+            inst_t ins = legacy_mem({0x81u}, 5, dst);
+            for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                ins.push_back((static_cast<uint32_t>(imm32) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // imul r64, r/m64, imm32
+        InstGenX86::inst_t InstGenX86::base_imul_imm(gpr_t dst,
+                                                     gpr_t src,
+                                                     int32_t imm32) {
+            inst_t ins = legacy_reg({0x69u}, dst, src);
+            for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                ins.push_back((static_cast<uint32_t>(imm32) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // shl r/m64, imm8
+        InstGenX86::inst_t InstGenX86::base_shl_imm(gpr_t dst,
+                                                    uint8_t imm8) {
+            inst_t ins = legacy_reg({0xC1u}, 4, dst);
+            ins.push_back(imm8);
+            return ins;
+        }
+
+        // jnz rel32
+        InstGenX86::inst_t InstGenX86::base_jnz(int32_t rel32) {
+            inst_t ins{0x0Fu, 0x85u};
+            for (uint32_t l_by = 0; l_by < 4; l_by++) {
+                ins.push_back((static_cast<uint32_t>(rel32) >> (8 * l_by)) & 0xFFu);
+            }
+            return ins;
+        }
+
+        // prefetcht0 m8 / prefetcht1 m8
+        InstGenX86::inst_t InstGenX86::base_prefetch(mem_t src,
+                                                     bool l2) {
+            return legacy_mem({0x0Fu, 0x18u}, l2 ? 2 : 1, src, false);
+        }
+
+        // vzeroupper
+        InstGenX86::inst_t InstGenX86::avx_vzeroupper() {
+            return inst_t{0xC5u, 0xF8u, 0x77u};
+        }
+
+        // VEX.256.0F.WIG 10 /r
+        InstGenX86::inst_t InstGenX86::avx_vmovups_load(simd_t dst,
+                                                        mem_t src) {
+            return vex(1, 0, true, 0x10u, dst, 0, 0, &src);
+        }
+
+        // VEX.256.0F.WIG 11 /r
+        InstGenX86::inst_t InstGenX86::avx_vmovups_store(mem_t dst,
+                                                         simd_t src) {
+            return vex(1, 0, true, 0x11u, src, 0, 0, &dst);
+        }
+
+        // VEX.256.66.0F38.W0 2C /r
+        InstGenX86::inst_t InstGenX86::avx_vmaskmovps_load(simd_t dst,
+                                                           simd_t mask,
+                                                           mem_t src) {
+            return vex(2, 1, true, 0x2Cu, dst, mask, 0, &src);
+        }
+
+        // VEX.256.66.0F38.W0 2E /r
+        InstGenX86::inst_t InstGenX86::avx_vmaskmovps_store(mem_t dst,
+                                                            simd_t mask,
+                                                            simd_t src) {
+            return vex(2, 1, true, 0x2Eu, src, mask, 0, &dst);
+        }
+
+        // VEX.LIG.F3.0F.WIG 10 /r
+        InstGenX86::inst_t InstGenX86::avx_vmovss_load(simd_t dst,
+                                                       mem_t src) {
+            return vex(1, 2, false, 0x10u, dst, 0, 0, &src);
+        }
+
+        // VEX.LIG.F3.0F.WIG 11 /r
+        InstGenX86::inst_t InstGenX86::avx_vmovss_store(mem_t dst,
+                                                        simd_t src) {
+            return vex(1, 2, false, 0x11u, src, 0, 0, &dst);
+        }
+
+        // VEX.LIG.F2.0F.WIG 10 /r
+        InstGenX86::inst_t InstGenX86::avx_vmovsd_load(simd_t dst,
+                                                       mem_t src) {
+            return vex(1, 3, false, 0x10u, dst, 0, 0, &src);
+        }
+
+        // VEX.LIG.F2.0F.WIG 11 /r
+        InstGenX86::inst_t InstGenX86::avx_vmovsd_store(mem_t dst,
+                                                        simd_t src) {
+            return vex(1, 3, false, 0x11u, src, 0, 0, &dst);
+        }
+
+        // VEX.256.66.0F38.W0 18 /r
+        InstGenX86::inst_t InstGenX86::avx_vbroadcastss(simd_t dst,
+                                                        mem_t src) {
+            return vex(2, 1, true, 0x18u, dst, 0, 0, &src);
+        }
+
+        // VEX.256.66.0F38.W0 19 /r
+        InstGenX86::inst_t InstGenX86::avx_vbroadcastsd(simd_t dst,
+                                                        mem_t src) {
+            return vex(2, 1, true, 0x19u, dst, 0, 0, &src);
+        }
+
+        // VEX.256.66.0F38.W0 B8 /r
+        InstGenX86::inst_t InstGenX86::avx_vfmadd231ps(simd_t dst,
+                                                       simd_t src1,
+                                                       simd_t src2) {
+            return vex(2, 1, true, 0xB8u, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.66.0F38.W1 B8 /r
+        InstGenX86::inst_t InstGenX86::avx_vfmadd231pd(simd_t dst,
+                                                       simd_t src1,
+                                                       simd_t src2) {
+            return vex(2, 1, true, 0xB8u, dst, src1, src2, nullptr, true);
+        }
+
+        // VEX.256.0F.WIG 57 /r
+        InstGenX86::inst_t InstGenX86::avx_vxorps(simd_t dst,
+                                                  simd_t src1,
+                                                  simd_t src2) {
+            return vex(1, 0, true, 0x57u, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.0F.WIG 5F /r
+        InstGenX86::inst_t InstGenX86::avx_vmaxps(simd_t dst,
+                                                  simd_t src1,
+                                                  simd_t src2) {
+            return vex(1, 0, true, 0x5Fu, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.66.0F.WIG 5F /r
+        InstGenX86::inst_t InstGenX86::avx_vmaxpd(simd_t dst,
+                                                  simd_t src1,
+                                                  simd_t src2) {
+            return vex(1, 1, true, 0x5Fu, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.0F.WIG 5D /r
+        InstGenX86::inst_t InstGenX86::avx_vminps(simd_t dst,
+                                                  simd_t src1,
+                                                  simd_t src2) {
+            return vex(1, 0, true, 0x5Du, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.0F.WIG 58 /r
+        InstGenX86::inst_t InstGenX86::avx_vaddps(simd_t dst,
+                                                  simd_t src1,
+                                                  simd_t src2) {
+            return vex(1, 0, true, 0x58u, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.0F.WIG 59 /r
+        InstGenX86::inst_t InstGenX86::avx_vmulps(simd_t dst,
+                                                  simd_t src1,
+                                                  simd_t src2) {
+            return vex(1, 0, true, 0x59u, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.0F.WIG 5E /r
+        InstGenX86::inst_t InstGenX86::avx_vdivps(simd_t dst,
+                                                  simd_t src1,
+                                                  simd_t src2) {
+            return vex(1, 0, true, 0x5Eu, dst, src1, src2, nullptr);
+        }
+
+        // VEX.256.66.0F38.W0 92 /r
+        InstGenX86::inst_t InstGenX86::avx_vgatherdps(simd_t dst,
+                                                      mem_t src,
+                                                      simd_t mask) {
+            return vex(2, 1, true, 0x92u, dst, mask, 0, &src);
+        }
+
+        // VEX.L0.0F.W0 92 /r
+        InstGenX86::inst_t InstGenX86::avx512_kmovw(mask_t dst,
+                                                    gpr_t src) {
+            return vex(1, 0, false, 0x92u, dst, 0, src, nullptr);
+        }
+
+        // VEX.L0.0F.W0 90 /r
+        InstGenX86::inst_t InstGenX86::avx512_kmovw_mask(mask_t dst,
+                                                         mask_t src) {
+            return vex(1, 0, false, 0x90u, dst, 0, src, nullptr);
+        }
+
+        // EVEX.512.66.0F38.W0 92 /vsib
+        InstGenX86::inst_t InstGenX86::avx512_vgatherdps(simd_t dst,
+                                                         mem_t src,
+                                                         mask_t mask) {
+            return evex(2, 1, 0x92u, dst, 0, 0, &src, 4, mask, false);
+        }
+
+        // EVEX.512.0F.W0 10 /r
+        InstGenX86::inst_t InstGenX86::avx512_vmovups_load(simd_t dst,
+                                                           mem_t src,
+                                                           mask_t mask) {
+            return evex(1, 0, 0x10u, dst, 0, 0, &src, 64, mask, mask != k0);
+        }
+
+        // EVEX.512.0F.W0 11 /r
+        InstGenX86::inst_t InstGenX86::avx512_vmovups_store(mem_t dst,
+                                                            simd_t src,
+                                                            mask_t mask) {
+            return evex(1, 0, 0x11u, src, 0, 0, &dst, 64, mask, false);
+        }
+
+        // EVEX.512.66.0F38.W0 18 /r
+        InstGenX86::inst_t InstGenX86::avx512_vbroadcastss(simd_t dst,
+                                                           mem_t src) {
+            return evex(2, 1, 0x18u, dst, 0, 0, &src, 4, k0, false);
+        }
+
+        // EVEX.512.66.0F38.W1 19 /r
+        InstGenX86::inst_t InstGenX86::avx512_vbroadcastsd(simd_t dst,
+                                                           mem_t src) {
+            return evex(2, 1, 0x19u, dst, 0, 0, &src, 8, k0, false, true);
+        }
+
+        // EVEX.512.66.0F38.W0 B8 /r
+        InstGenX86::inst_t InstGenX86::avx512_vfmadd231ps(simd_t dst,
+                                                          simd_t src1,
+                                                          simd_t src2) {
+            return evex(2, 1, 0xB8u, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F38.W1 B8 /r
+        InstGenX86::inst_t InstGenX86::avx512_vfmadd231pd(simd_t dst,
+                                                          simd_t src1,
+                                                          simd_t src2) {
+            return evex(2, 1, 0xB8u, dst, src1, src2, nullptr, 1, k0, false, true);
+        }
+
+        // EVEX.512.66.0F.W0 EF /r
+        InstGenX86::inst_t InstGenX86::avx512_vpxord(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 1, 0xEFu, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.0F.W0 5F /r
+        InstGenX86::inst_t InstGenX86::avx512_vmaxps(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 0, 0x5Fu, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F.W1 5F /r
+        InstGenX86::inst_t InstGenX86::avx512_vmaxpd(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 1, 0x5Fu, dst, src1, src2, nullptr, 1, k0, false, true);
+        }
+
+        // EVEX.512.0F.W0 5D /r
+        InstGenX86::inst_t InstGenX86::avx512_vminps(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 0, 0x5Du, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.0F.W0 58 /r
+        InstGenX86::inst_t InstGenX86::avx512_vaddps(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 0, 0x58u, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.0F.W0 59 /r
+        InstGenX86::inst_t InstGenX86::avx512_vmulps(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 0, 0x59u, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.0F.W0 5E /r
+        InstGenX86::inst_t InstGenX86::avx512_vdivps(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 0, 0x5Eu, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.F3.0F38.W0 52 /r
+        InstGenX86::inst_t InstGenX86::avx512_vdpbf16ps(simd_t dst,
+                                                        simd_t src1,
+                                                        simd_t src2) {
+            return evex(2, 2, 0x52u, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.F3.0F38.W0 72 /r
+        InstGenX86::inst_t InstGenX86::avx512_vcvtneps2bf16(simd_t dst,
+                                                            simd_t src) {
+            return evex(2, 2, 0x72u, dst, 0, src, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F38.WIG 33 /r
+        InstGenX86::inst_t InstGenX86::avx512_vpmovzxwd_load(simd_t dst,
+                                                             mem_t src,
+                                                             mask_t mask) {
+            return evex(2, 1, 0x33u, dst, 0, 0, &src, 32, mask, mask != k0);
+        }
+
+        // EVEX.512.66.0F38.WIG 33 /r
+        InstGenX86::inst_t InstGenX86::avx512_vpmovzxwd(simd_t dst,
+                                                        simd_t src) {
+            return evex(2, 1, 0x33u, dst, 0, src, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.F3.0F38.W0 33 /r
+        InstGenX86::inst_t InstGenX86::avx512_vpmovdw_store(mem_t dst,
+                                                            simd_t src,
+                                                            mask_t mask) {
+            return evex(2, 2, 0x33u, src, 0, 0, &dst, 32, mask, false);
+        }
+
+        // EVEX.512.66.0F38.W0 79 /r
+        InstGenX86::inst_t InstGenX86::avx512_vpbroadcastw(simd_t dst,
+                                                           mem_t src) {
+            return evex(2, 1, 0x79u, dst, 0, 0, &src, 2, k0, false);
+        }
+
+        // EVEX.512.66.0F.W0 72 /6 ib
+        InstGenX86::inst_t InstGenX86::avx512_vpslld_imm(simd_t dst,
+                                                         simd_t src,
+                                                         uint8_t imm8) {
+            inst_t ins = evex(1, 1, 0x72u, 6, dst, src, nullptr, 1, k0, false);
+            ins.push_back(imm8);
+            return ins;
+        }
+
+        // EVEX.512.66.0F.W0 EB /r
+        InstGenX86::inst_t InstGenX86::avx512_vpord(simd_t dst,
+                                                    simd_t src1,
+                                                    simd_t src2) {
+            return evex(1, 1, 0xEBu, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F38.W0 50 /r
+        InstGenX86::inst_t InstGenX86::avx512_vpdpbusd(simd_t dst,
+                                                       simd_t src1,
+                                                       simd_t src2) {
+            return evex(2, 1, 0x50u, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F38.WIG 31 /r
+        InstGenX86::inst_t InstGenX86::avx512_vpmovzxbd_load(simd_t dst,
+                                                             mem_t src,
+                                                             mask_t mask) {
+            return evex(2, 1, 0x31u, dst, 0, 0, &src, 16, mask, mask != k0);
+        }
+
+        // EVEX.512.F2.0F.W0 6F /r
+        InstGenX86::inst_t InstGenX86::avx512_vmovdqu8_load(simd_t dst,
+                                                            mem_t src,
+                                                            mask_t mask) {
+            return evex(1, 3, 0x6Fu, dst, 0, 0, &src, 64, mask, mask != k0);
+        }
+
+        // EVEX.512.66.0F38.W0 58 /r
+        InstGenX86::inst_t InstGenX86::avx512_vpbroadcastd(simd_t dst,
+                                                           simd_t src) {
+            return evex(2, 1, 0x58u, dst, 0, src, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.0F.W0 5B /r
+        InstGenX86::inst_t InstGenX86::avx512_vcvtdq2ps(simd_t dst,
+                                                        simd_t src) {
+            return evex(1, 0, 0x5Bu, dst, 0, src, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F.W0 FA /r
+        InstGenX86::inst_t InstGenX86::avx512_vpsubd(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(1, 1, 0xFAu, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // VEX.L0.F2.0F.W0 92 /r
+        InstGenX86::inst_t InstGenX86::avx512_kmovd(mask_t dst,
+                                                    gpr_t src) {
+            return vex(1, 3, false, 0x92u, dst, 0, src, nullptr);
+        }
+
+        // EVEX.512.F2.0F.W1 6F /r
+        InstGenX86::inst_t InstGenX86::avx512_vmovdqu16_load(simd_t dst,
+                                                             mem_t src,
+                                                             mask_t mask) {
+            return evex(1, 3, 0x6Fu, dst, 0, 0, &src, 64, mask, mask != k0, true);
+        }
+
+        // EVEX.512.F2.0F.W1 7F /r
+        InstGenX86::inst_t InstGenX86::avx512_vmovdqu16_store(mem_t dst,
+                                                              simd_t src,
+                                                              mask_t mask) {
+            return evex(1, 3, 0x7Fu, src, 0, 0, &dst, 64, mask, false, true);
+        }
+
+        // EVEX.512.66.MAP6.W0 B8 /r
+        InstGenX86::inst_t InstGenX86::avx512_vfmadd231ph(simd_t dst,
+                                                          simd_t src1,
+                                                          simd_t src2) {
+            return evex(6, 1, 0xB8u, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.MAP5.W0 5F /r
+        InstGenX86::inst_t InstGenX86::avx512_vmaxph(simd_t dst,
+                                                     simd_t src1,
+                                                     simd_t src2) {
+            return evex(5, 0, 0x5Fu, dst, src1, src2, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F38.W0 13 /r
+        InstGenX86::inst_t InstGenX86::avx512_vcvtph2ps_load(simd_t dst,
+                                                             mem_t src,
+                                                             mask_t mask) {
+            return evex(2, 1, 0x13u, dst, 0, 0, &src, 32, mask, mask != k0);
+        }
+
+        // EVEX.512.66.0F38.W0 13 /r
+        InstGenX86::inst_t InstGenX86::avx512_vcvtph2ps(simd_t dst,
+                                                        simd_t src) {
+            return evex(2, 1, 0x13u, dst, 0, src, nullptr, 1, k0, false);
+        }
+
+        // EVEX.512.66.0F3A.W0 1D /r ib, imm8 = 0 rounds to nearest even
+        InstGenX86::inst_t InstGenX86::avx512_vcvtps2ph_store(mem_t dst,
+                                                              simd_t src,
+                                                              mask_t mask) {
+            inst_t ins = evex(3, 1, 0x1Du, src, 0, 0, &dst, 32, mask, false);
+            ins.push_back(0x00u);
+            return ins;
+        }
+    }  // namespace instructions
+}  // namespace mini_jit
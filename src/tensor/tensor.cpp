@@ -1,5 +1,7 @@
 #include "tensor.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
@@ -72,6 +74,49 @@ bool Tensor::compare(Tensor& tensor, float delta) {
     }
 }
 
+// quantize to int8 with symmetric scales
+void Tensor::quantize(bool per_channel) {
+    if (data_int8 == nullptr) {
+        data_int8 = new int8_t[size];
+    }
+
+    // values sharing a scale are contiguous, the first dimension has the largest stride
+    size_t channels = (per_channel && !id.empty()) ? static_cast<size_t>(id[0].dim_sizes) : 1;
+    size_t group = size / channels;
+    scales.assign(channels, 1.0f);
+
+    for (size_t c = 0; c < channels; c++) {
+        // local pointers, the int8 stores may alias the members otherwise
+        float const* in = data + c * group;
+        int8_t* out = data_int8 + c * group;
+
+        // eight partial maxima, a single running maximum is a serial dependency chain
+        float max_part[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        size_t i = 0;
+        for (; i + 8 <= group; i += 8) {
+            for (size_t j = 0; j < 8; j++) {
+                max_part[j] = std::max(max_part[j], std::abs(in[i + j]));
+            }
+        }
+        for (; i < group; i++) {
+            max_part[0] = std::max(max_part[0], std::abs(in[i]));
+        }
+        float max_abs = *std::max_element(max_part, max_part + 8);
+        if (max_abs > 0.0f) {
+            scales[c] = max_abs / 127.0f;
+        }
+
+        // adding and subtracting 1.5 * 2^23 rounds to the nearest integer (ties to even) for |x| < 2^22,
+        // unlike std::nearbyint the loop is vectorized without SSE4.1
+        float const inv_scale = 1.0f / scales[c];
+        float const round = 12582912.0f;
+        for (i = 0; i < group; i++) {
+            int32_t q = static_cast<int32_t>((in[i] * inv_scale + round) - round);
+            out[i] = static_cast<int8_t>(std::min(127, std::max(-127, q)));
+        }
+    }
+}
+
 // print 1D Tensors
 void Tensor::print() {
     for (int i = 0; i < size; i++) {
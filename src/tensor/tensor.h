@@ -3,6 +3,7 @@
 #ifndef TENSOR_H
 #define TENSOR_H
 
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -21,6 +22,12 @@ class Tensor {
     size_t size;
     float* data = nullptr;
 
+    // quantized copy of data, allocated by quantize()
+    int8_t* data_int8 = nullptr;
+    // scales of data_int8, data[i] ~ scales[c] * data_int8[i] with one scale
+    // per index c of the first dimension or a single one for the whole tensor
+    std::vector<float> scales;
+
     std::vector<DimInfo> id;
 
     // constructor taking n dimension sizes
@@ -97,6 +104,18 @@ class Tensor {
      */
     bool compare(Tensor& tensor, float delta);
 
+    /**
+     * @brief Quantizes the data symmetrically to signed 8-bit integers in data_int8.
+     *
+     * The scale of a group of values is max(|x|) / 127, the values are rounded
+     * to the nearest integer in [-127, 127]. Calling it again requantizes the
+     * current data, e.g., the activations of the next batch.
+     *
+     * @param per_channel One scale per index of the first dimension (e.g. per output
+     *                    feature of a weight matrix) if true, one scale for all values otherwise.
+     */
+    void quantize(bool per_channel);
+
     /**
      * @brief Print the raw data of the Tensor
      */
@@ -100,3 +100,33 @@ TEST_CASE("Model::BasicNet::Output", "[Model][BasicNet][Output]") {
 
     REQUIRE(output.compare(output_ref, 0.0001));
 }
+
+TEST_CASE("Model::BasicNet::Quantize", "[Model][BasicNet][Quantize]") {
+    Tensor W = Tensor(3, 4);
+    for (size_t i = 0; i < W.size; i++) {
+        W.data[i] = (i < 4) ? 0.0f : 0.37f * (float)i - 2.0f * (float)(i / 4);
+    }
+
+    // one scale per row, the zero row keeps the scale 1
+    W.quantize(true);
+    REQUIRE(W.scales.size() == 3);
+    REQUIRE(W.scales[0] == 1.0f);
+    for (size_t i = 0; i < W.size; i++) {
+        float scale = W.scales[i / 4];
+        REQUIRE(std::abs(W.data_int8[i]) <= 127);
+        REQUIRE(std::abs(scale * W.data_int8[i] - W.data[i]) <= 0.5f * scale);
+    }
+
+    // one scale for the whole tensor
+    W.quantize(false);
+    REQUIRE(W.scales.size() == 1);
+    float max_abs = 0.0f;
+    for (size_t i = 0; i < W.size; i++) {
+        max_abs = std::max(max_abs, std::abs(W.data[i]));
+        REQUIRE(std::abs(W.scales[0] * W.data_int8[i] - W.data[i]) <= 0.5f * W.scales[0]);
+    }
+    REQUIRE(W.scales[0] == max_abs / 127.0f);
+
+    delete[] W.data;
+    delete[] W.data_int8;
+}
@@ -1,11 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <string>
 
 #include "../../src/einsum/backend/TensorOperation.h"
+#include "../../src/mini_jit/backend/Cpu.h"
+#include "../test_utils/test_utils.h"
 
 using namespace einsum::backend;
 
@@ -106,9 +109,9 @@ TEST_CASE("Einsum::Backend::TensorOperation 1. pbtc example", "First pbtc exampl
     double error = 0.0;
     for (size_t i = 0; i < size_out; i++) {
         error += std::abs(tensor_out[i] - tensor_out_ref[i]);
+        REQUIRE(std::abs(tensor_out[i] - tensor_out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(tensor_out_ref[i])));
     }
     std::cout << "  Total error first example: " << error << std::endl;
-    REQUIRE(error < 1e-5);
 
     // cleanup
     delete[] tensor_in0;
@@ -190,9 +193,9 @@ TEST_CASE("Einsum::Backend::TensorOperation 2. pbtc example", "Second pbtc examp
     double error = 0.0;
     for (size_t i = 0; i < size_out; i++) {
         error += std::abs(tensor_out[i] - tensor_out_ref[i]);
+        REQUIRE(std::abs(tensor_out[i] - tensor_out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(tensor_out_ref[i])));
     }
     std::cout << "  Total error second example: " << error << std::endl;
-    REQUIRE(error < 1e-5);
 
     // cleanup
     delete[] tensor_in0;
@@ -278,16 +281,477 @@ TEST_CASE("Einsum::Backend::TensorOperation 3 pbtc example", "Third pbtc example
     double error = 0.0;
     for (size_t i = 0; i < size_out; i++) {
         error += std::abs(tensor_out[i] - tensor_out_ref[i]);
-        if (std::abs(tensor_out[i] - tensor_out_ref[i]) > 1e-5) {
-            std::cout << "Error at index " << i << ": " << tensor_out[i] << " vs " << tensor_out_ref[i] << std::endl;
-            break;
-        }
+        REQUIRE(std::abs(tensor_out[i] - tensor_out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(tensor_out_ref[i])));
     }
     std::cout << "  Total error third example: " << error << std::endl;
-    REQUIRE(error < 1e-5);
     // cleanup
     delete[] tensor_in0;
     delete[] tensor_in1;
     delete[] tensor_out;
     delete[] tensor_out_ref;
-}
\ No newline at end of file
+}
+TEST_CASE("Einsum::Backend::TensorOperation generated loop nest", "Generated loop nest") {
+    // seq M, K, N loops around a 16x8x8 primitive, K is revisited and its first and last iterations are peeled
+    std::vector<TensorOperation::dim_t> l_dim_types = {TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::k,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k};
+    std::vector<int64_t> l_dim_sizes = {3, 3, 2, 16, 8, 8};
+    std::vector<int64_t> l_strides_in0 = {384, 128, 0, 1, 0, 16};
+    std::vector<int64_t> l_strides_in1 = {0, 64, 192, 0, 8, 1};
+    std::vector<int64_t> l_strides_out = {256, 0, 128, 1, 16, 0};
+    std::vector<int64_t> l_strides_bias = {0, 0, 8, 0, 1, 0};
+
+    int64_t l_size_in0 = 3 * 384;
+    int64_t l_size_in1 = 2 * 192;
+    int64_t l_size_out = 3 * 256;
+
+    std::vector<float> l_in0(l_size_in0);
+    std::vector<float> l_in1(l_size_in1);
+    std::vector<float> l_bias(16);
+    srand48(17);
+    for (float& l_val : l_in0) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    for (float& l_val : l_in1) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    for (float& l_val : l_bias) {
+        l_val = (float)drand48() - 0.5f;
+    }
+
+    TensorOperation::exec_t l_outer_types[2] = {TensorOperation::exec_t::seq, TensorOperation::exec_t::shared};
+    TensorOperation::prim_t l_last_touches[3] = {TensorOperation::prim_t::none, TensorOperation::prim_t::relu, TensorOperation::prim_t::gelu};
+
+    for (TensorOperation::exec_t l_outer_type : l_outer_types) {
+        for (TensorOperation::prim_t l_last_touch : l_last_touches) {
+            for (bool l_use_bias : {false, true}) {
+                std::vector<TensorOperation::exec_t> l_exec_types = {l_outer_type,
+                                                                     TensorOperation::exec_t::seq,
+                                                                     TensorOperation::exec_t::seq,
+                                                                     TensorOperation::exec_t::prim,
+                                                                     TensorOperation::exec_t::prim,
+                                                                     TensorOperation::exec_t::prim};
+
+                std::vector<float> l_out[2];
+                for (uint32_t l_jit = 0; l_jit < 2; l_jit++) {
+                    TensorOperation l_tensor_op;
+                    l_tensor_op._jit_loops = (l_jit == 1);
+                    l_tensor_op.setup(TensorOperation::dtype_t::fp32,
+                                      TensorOperation::prim_t::zero,
+                                      TensorOperation::prim_t::gemm,
+                                      l_last_touch,
+                                      l_dim_types,
+                                      l_exec_types,
+                                      l_dim_sizes,
+                                      l_strides_in0,
+                                      l_strides_in1,
+                                      l_strides_out,
+                                      l_strides_bias);
+                    REQUIRE(l_tensor_op.compile() == TensorOperation::error_t::success);
+
+                    l_out[l_jit].assign(l_size_out, 42.0f);
+                    l_tensor_op.execute(l_in0.data(), l_in1.data(), l_out[l_jit].data(), l_use_bias ? l_bias.data() : nullptr);
+                }
+
+                // same kernels in the same order
+                for (int64_t l_id = 0; l_id < l_size_out; l_id++) {
+                    REQUIRE(l_out[1][l_id] == l_out[0][l_id]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Einsum::Backend::TensorOperation collapsed loops and split K", "Parallel loops") {
+    // loops M=3, N=2, K=6 around a 16x8x8 primitive
+    std::vector<TensorOperation::dim_t> l_dim_types = {TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k,
+                                                       TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k};
+    std::vector<int64_t> l_dim_sizes = {3, 2, 6, 16, 8, 8};
+    std::vector<int64_t> l_strides_in0 = {768, 0, 128, 1, 0, 16};
+    std::vector<int64_t> l_strides_in1 = {0, 384, 64, 0, 8, 1};
+    std::vector<int64_t> l_strides_out = {16, 384, 0, 1, 48, 0};
+    std::vector<int64_t> l_strides_bias = {0, 8, 0, 0, 1, 0};
+
+    std::vector<float> l_in0(3 * 768);
+    std::vector<float> l_in1(2 * 384);
+    std::vector<float> l_bias(16);
+    srand48(23);
+    for (float& l_val : l_in0) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    for (float& l_val : l_in1) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    for (float& l_val : l_bias) {
+        l_val = (float)drand48() - 0.5f;
+    }
+
+    // the shared loops are executed by 4 threads
+    std::shared_ptr<ThreadPool> l_thread_pool = std::make_shared<ThreadPool>(4);
+
+    // loops in the given order, K first for split K
+    auto l_run = [&](std::vector<std::size_t> const& i_order,
+                     std::vector<TensorOperation::exec_t> const& i_exec_types,
+                     TensorOperation::prim_t i_last_touch,
+                     bool i_use_bias,
+                     bool i_split_k) {
+        std::vector<TensorOperation::dim_t> l_types;
+        std::vector<TensorOperation::exec_t> l_execs;
+        std::vector<int64_t> l_sizes, l_in0_strides, l_in1_strides, l_out_strides, l_bias_strides;
+        for (std::size_t l_id = 0; l_id < 6; l_id++) {
+            std::size_t l_dim = (l_id < 3) ? i_order[l_id] : l_id;
+            l_types.push_back(l_dim_types[l_dim]);
+            l_execs.push_back((l_id < 3) ? i_exec_types[l_id] : TensorOperation::exec_t::prim);
+            l_sizes.push_back(l_dim_sizes[l_dim]);
+            l_in0_strides.push_back(l_strides_in0[l_dim]);
+            l_in1_strides.push_back(l_strides_in1[l_dim]);
+            l_out_strides.push_back(l_strides_out[l_dim]);
+            l_bias_strides.push_back(l_strides_bias[l_dim]);
+        }
+
+        TensorOperation l_tensor_op;
+        l_tensor_op._thread_pool = l_thread_pool;
+        l_tensor_op.setup(TensorOperation::dtype_t::fp32,
+                          TensorOperation::prim_t::zero,
+                          TensorOperation::prim_t::gemm,
+                          i_last_touch,
+                          l_types,
+                          l_execs,
+                          l_sizes,
+                          l_in0_strides,
+                          l_in1_strides,
+                          l_out_strides,
+                          l_bias_strides);
+        REQUIRE(l_tensor_op.compile() == TensorOperation::error_t::success);
+        REQUIRE(l_tensor_op._split_k == i_split_k);
+
+        std::vector<float> l_out(768, 42.0f);
+        l_tensor_op.execute(l_in0.data(), l_in1.data(), l_out.data(), i_use_bias ? l_bias.data() : nullptr);
+        return l_out;
+    };
+
+    using exec_t = TensorOperation::exec_t;
+    TensorOperation::prim_t l_last_touches[3] = {TensorOperation::prim_t::none, TensorOperation::prim_t::relu, TensorOperation::prim_t::gelu};
+    for (TensorOperation::prim_t l_last_touch : l_last_touches) {
+        for (bool l_use_bias : {false, true}) {
+            std::vector<float> l_out_ref = l_run({0, 1, 2}, {exec_t::seq, exec_t::seq, exec_t::seq}, l_last_touch, l_use_bias, false);
+
+            // collapsed M and N loops execute the same kernels on the same blocks
+            std::vector<float> l_out_collapsed = l_run({0, 1, 2}, {exec_t::shared, exec_t::shared, exec_t::seq}, l_last_touch, l_use_bias, false);
+            for (std::size_t l_id = 0; l_id < l_out_ref.size(); l_id++) {
+                REQUIRE(l_out_collapsed[l_id] == l_out_ref[l_id]);
+            }
+
+            // split K sums the partial outputs in another order
+            std::vector<float> l_out_split_k = l_run({2, 0, 1}, {exec_t::shared, exec_t::seq, exec_t::seq}, l_last_touch, l_use_bias, true);
+            for (std::size_t l_id = 0; l_id < l_out_ref.size(); l_id++) {
+                REQUIRE(std::abs(l_out_split_k[l_id] - l_out_ref[l_id]) < 1e-4);
+            }
+        }
+    }
+
+    // a contraction without M and N loops is split in K by the optimization
+    std::vector<TensorOperation::dim_t> l_gemv_types = {TensorOperation::dim_t::m,
+                                                        TensorOperation::dim_t::n,
+                                                        TensorOperation::dim_t::k};
+    std::vector<TensorOperation::exec_t> l_gemv_execs(3, TensorOperation::exec_t::seq);
+    std::vector<int64_t> l_gemv_sizes = {32, 4, 2048};
+    std::vector<int64_t> l_gemv_strides_in0 = {1, 0, 32};
+    std::vector<int64_t> l_gemv_strides_in1 = {0, 2048, 1};
+    std::vector<int64_t> l_gemv_strides_out = {1, 32, 0};
+
+    TensorOperation l_tensor_op;
+    l_tensor_op._thread_pool = l_thread_pool;
+    l_tensor_op.setup(TensorOperation::dtype_t::fp32,
+                      TensorOperation::prim_t::zero,
+                      TensorOperation::prim_t::gemm,
+                      TensorOperation::prim_t::none,
+                      l_gemv_types,
+                      l_gemv_execs,
+                      l_gemv_sizes,
+                      l_gemv_strides_in0,
+                      l_gemv_strides_in1,
+                      l_gemv_strides_out);
+    l_tensor_op.optimize();
+    REQUIRE(l_tensor_op.compile() == TensorOperation::error_t::success);
+    REQUIRE(l_tensor_op._split_k);
+
+    std::vector<float> l_a(32 * 2048);
+    std::vector<float> l_b(2048 * 4);
+    for (float& l_val : l_a) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    for (float& l_val : l_b) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    std::vector<float> l_c(32 * 4, 42.0f);
+    l_tensor_op.execute(l_a.data(), l_b.data(), l_c.data());
+
+    for (int64_t l_n = 0; l_n < 4; l_n++) {
+        for (int64_t l_m = 0; l_m < 32; l_m++) {
+            double l_ref = 0;
+            for (int64_t l_k = 0; l_k < 2048; l_k++) {
+                l_ref += l_a[l_k * 32 + l_m] * l_b[l_n * 2048 + l_k];
+            }
+            REQUIRE(std::abs(l_c[l_n * 32 + l_m] - l_ref) < 1e-3);
+        }
+    }
+}
+
+TEST_CASE("Einsum::Backend::TensorOperation zero first touch with a bias", "Bias layouts") {
+    // loops M=3, N=2, K=6 around a 16x8x8 primitive, the bias layouts have no fused kernel
+    std::vector<TensorOperation::dim_t> l_dim_types = {TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k,
+                                                       TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k};
+    std::vector<TensorOperation::exec_t> l_exec_types = {TensorOperation::exec_t::seq,
+                                                         TensorOperation::exec_t::seq,
+                                                         TensorOperation::exec_t::seq,
+                                                         TensorOperation::exec_t::prim,
+                                                         TensorOperation::exec_t::prim,
+                                                         TensorOperation::exec_t::prim};
+    std::vector<int64_t> l_dim_sizes = {3, 2, 6, 16, 8, 8};
+    std::vector<int64_t> l_strides_in0 = {768, 0, 128, 1, 0, 16};
+    std::vector<int64_t> l_strides_in1 = {0, 384, 64, 0, 8, 1};
+    std::vector<int64_t> l_strides_out = {16, 384, 0, 1, 48, 0};
+
+    std::vector<float> l_in0(3 * 768);
+    std::vector<float> l_in1(2 * 384);
+    std::vector<float> l_bias(768);
+    srand48(31);
+    for (float& l_val : l_in0) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    for (float& l_val : l_in1) {
+        l_val = (float)drand48() - 0.5f;
+    }
+    for (float& l_val : l_bias) {
+        l_val = (float)drand48() - 0.5f;
+    }
+
+    // a bias per output element and a single value broadcast over the output
+    std::vector<int64_t> l_strides_bias[2] = {l_strides_out, {}};
+    for (std::size_t l_la = 0; l_la < 2; l_la++) {
+        std::vector<double> l_out_ref(768);
+        for (int64_t l_n = 0; l_n < 16; l_n++) {
+            for (int64_t l_m = 0; l_m < 48; l_m++) {
+                double l_sum = l_bias[(l_la == 0) ? l_n * 48 + l_m : 0];
+                for (int64_t l_k = 0; l_k < 48; l_k++) {
+                    l_sum += l_in0[(l_m / 16) * 768 + (l_k / 8) * 128 + (l_k % 8) * 16 + l_m % 16] *
+                             l_in1[(l_n / 8) * 384 + (l_k / 8) * 64 + (l_n % 8) * 8 + l_k % 8];
+                }
+                l_out_ref[l_n * 48 + l_m] = l_sum;
+            }
+        }
+
+        TensorOperation l_tensor_op;
+        l_tensor_op.setup(TensorOperation::dtype_t::fp32,
+                          TensorOperation::prim_t::zero,
+                          TensorOperation::prim_t::gemm,
+                          TensorOperation::prim_t::none,
+                          l_dim_types,
+                          l_exec_types,
+                          l_dim_sizes,
+                          l_strides_in0,
+                          l_strides_in1,
+                          l_strides_out,
+                          l_strides_bias[l_la]);
+        REQUIRE(l_tensor_op.compile() == TensorOperation::error_t::success);
+
+        std::vector<float> l_out(768, 42.0f);
+        l_tensor_op.execute(l_in0.data(), l_in1.data(), l_out.data(), l_bias.data());
+        for (std::size_t l_id = 0; l_id < l_out_ref.size(); l_id++) {
+            REQUIRE(std::abs(l_out[l_id] - l_out_ref[l_id]) <= 1e-5 * std::max(1.0, std::abs(l_out_ref[l_id])));
+        }
+    }
+}
+
+TEST_CASE("Einsum::Backend::TensorOperation fp64", "Double precision") {
+    // loops M=3, N=2, K=6 around a 16x8x8 primitive, i.e., a 48x16x48 GEMM with a bias per column
+    std::vector<TensorOperation::dim_t> l_dim_types = {TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k,
+                                                       TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k};
+    std::vector<int64_t> l_dim_sizes = {3, 2, 6, 16, 8, 8};
+    std::vector<int64_t> l_strides_in0 = {768, 0, 128, 1, 0, 16};
+    std::vector<int64_t> l_strides_in1 = {0, 384, 64, 0, 8, 1};
+    std::vector<int64_t> l_strides_out = {16, 384, 0, 1, 48, 0};
+    std::vector<int64_t> l_strides_bias = {0, 8, 0, 0, 1, 0};
+
+    std::vector<double> l_in0(3 * 768);
+    std::vector<double> l_in1(2 * 384);
+    std::vector<double> l_bias(16);
+    srand48(29);
+    for (double& l_val : l_in0) {
+        l_val = drand48() - 0.5;
+    }
+    for (double& l_val : l_in1) {
+        l_val = drand48() - 0.5;
+    }
+    for (double& l_val : l_bias) {
+        l_val = drand48() - 0.5;
+    }
+
+    // in0 is M x K with the K blocks in between, in1 is K x N
+    std::vector<double> l_out_ref(768);
+    for (int64_t l_n = 0; l_n < 16; l_n++) {
+        for (int64_t l_m = 0; l_m < 48; l_m++) {
+            double l_sum = l_bias[l_n];
+            for (int64_t l_k = 0; l_k < 48; l_k++) {
+                l_sum += l_in0[(l_m / 16) * 768 + (l_k / 8) * 128 + (l_k % 8) * 16 + l_m % 16] *
+                         l_in1[(l_n / 8) * 384 + (l_k / 8) * 64 + (l_n % 8) * 8 + l_k % 8];
+            }
+            l_out_ref[l_n * 48 + l_m] = std::max(l_sum, 0.0);
+        }
+    }
+
+    std::shared_ptr<ThreadPool> l_thread_pool = std::make_shared<ThreadPool>(4);
+
+    using exec_t = TensorOperation::exec_t;
+    std::vector<std::size_t> l_orders[3] = {{0, 1, 2}, {0, 1, 2}, {2, 0, 1}};
+    std::vector<exec_t> l_exec_types[3] = {{exec_t::seq, exec_t::seq, exec_t::seq},
+                                           {exec_t::shared, exec_t::shared, exec_t::seq},
+                                           {exec_t::shared, exec_t::seq, exec_t::seq}};
+    // sequential, collapsed M and N loops and split K
+    for (std::size_t l_ru = 0; l_ru < 3; l_ru++) {
+        std::vector<TensorOperation::dim_t> l_types;
+        std::vector<TensorOperation::exec_t> l_execs;
+        std::vector<int64_t> l_sizes, l_in0_strides, l_in1_strides, l_out_strides, l_bias_strides;
+        for (std::size_t l_id = 0; l_id < 6; l_id++) {
+            std::size_t l_dim = (l_id < 3) ? l_orders[l_ru][l_id] : l_id;
+            l_types.push_back(l_dim_types[l_dim]);
+            l_execs.push_back((l_id < 3) ? l_exec_types[l_ru][l_id] : exec_t::prim);
+            l_sizes.push_back(l_dim_sizes[l_dim]);
+            l_in0_strides.push_back(l_strides_in0[l_dim]);
+            l_in1_strides.push_back(l_strides_in1[l_dim]);
+            l_out_strides.push_back(l_strides_out[l_dim]);
+            l_bias_strides.push_back(l_strides_bias[l_dim]);
+        }
+
+        TensorOperation l_tensor_op;
+        l_tensor_op._thread_pool = l_thread_pool;
+        l_tensor_op.setup(TensorOperation::dtype_t::fp64,
+                          TensorOperation::prim_t::zero,
+                          TensorOperation::prim_t::gemm,
+                          TensorOperation::prim_t::relu,
+                          l_types,
+                          l_execs,
+                          l_sizes,
+                          l_in0_strides,
+                          l_in1_strides,
+                          l_out_strides,
+                          l_bias_strides);
+        REQUIRE(l_tensor_op.compile() == TensorOperation::error_t::success);
+        REQUIRE(l_tensor_op._split_k == (l_ru == 2));
+
+        std::vector<double> l_out(768, 42.0);
+        l_tensor_op.execute(l_in0.data(), l_in1.data(), l_out.data(), l_bias.data());
+        for (std::size_t l_id = 0; l_id < l_out_ref.size(); l_id++) {
+            REQUIRE(std::abs(l_out[l_id] - l_out_ref[l_id]) < 1e-12);
+        }
+    }
+}
+
+TEST_CASE("Einsum::Backend::TensorOperation bf16", "Mixed precision") {
+    if (!mini_jit::backend::Cpu::has_bf16()) {
+        return;
+    }
+    // layout of the fp64 test: loops M=3, N=2, K=6 around a 16x8x8 primitive with a bias per column
+    std::vector<TensorOperation::dim_t> l_dim_types = {TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k,
+                                                       TensorOperation::dim_t::m,
+                                                       TensorOperation::dim_t::n,
+                                                       TensorOperation::dim_t::k};
+    std::vector<int64_t> l_dim_sizes = {3, 2, 6, 16, 8, 8};
+    std::vector<int64_t> l_strides_in0 = {768, 0, 128, 1, 0, 16};
+    std::vector<int64_t> l_strides_in1 = {0, 384, 64, 0, 8, 1};
+    std::vector<int64_t> l_strides_out = {16, 384, 0, 1, 48, 0};
+    std::vector<int64_t> l_strides_bias = {0, 8, 0, 0, 1, 0};
+
+    // bfloat16 inputs, single precision bias and output
+    std::vector<uint16_t> l_in0(3 * 768);
+    std::vector<uint16_t> l_in1(2 * 384);
+    std::vector<float> l_bias(16);
+    srand48(31);
+    for (uint16_t& l_val : l_in0) {
+        l_val = test::bf16::from_fp32(drand48() - 0.5);
+    }
+    for (uint16_t& l_val : l_in1) {
+        l_val = test::bf16::from_fp32(drand48() - 0.5);
+    }
+    for (float& l_val : l_bias) {
+        l_val = drand48() - 0.5;
+    }
+
+    std::vector<float> l_out_ref(768);
+    for (int64_t l_n = 0; l_n < 16; l_n++) {
+        for (int64_t l_m = 0; l_m < 48; l_m++) {
+            double l_sum = l_bias[l_n];
+            for (int64_t l_k = 0; l_k < 48; l_k++) {
+                l_sum += (double)test::bf16::to_fp32(l_in0[(l_m / 16) * 768 + (l_k / 8) * 128 + (l_k % 8) * 16 + l_m % 16]) *
+                         test::bf16::to_fp32(l_in1[(l_n / 8) * 384 + (l_k / 8) * 64 + (l_n % 8) * 8 + l_k % 8]);
+            }
+            l_out_ref[l_n * 48 + l_m] = std::max(l_sum, 0.0);
+        }
+    }
+
+    std::shared_ptr<ThreadPool> l_thread_pool = std::make_shared<ThreadPool>(4);
+
+    using exec_t = TensorOperation::exec_t;
+    std::vector<std::size_t> l_orders[3] = {{0, 1, 2}, {0, 1, 2}, {2, 0, 1}};
+    std::vector<exec_t> l_exec_types[3] = {{exec_t::seq, exec_t::seq, exec_t::seq},
+                                           {exec_t::shared, exec_t::shared, exec_t::seq},
+                                           {exec_t::shared, exec_t::seq, exec_t::seq}};
+    // sequential, collapsed M and N loops and split K, the sequential loops also as generated loop nest
+    for (std::size_t l_ru = 0; l_ru < 4; l_ru++) {
+        std::size_t l_or = (l_ru == 3) ? 0 : l_ru;
+        std::vector<TensorOperation::dim_t> l_types;
+        std::vector<TensorOperation::exec_t> l_execs;
+        std::vector<int64_t> l_sizes, l_in0_strides, l_in1_strides, l_out_strides, l_bias_strides;
+        for (std::size_t l_id = 0; l_id < 6; l_id++) {
+            std::size_t l_dim = (l_id < 3) ? l_orders[l_or][l_id] : l_id;
+            l_types.push_back(l_dim_types[l_dim]);
+            l_execs.push_back((l_id < 3) ? l_exec_types[l_or][l_id] : exec_t::prim);
+            l_sizes.push_back(l_dim_sizes[l_dim]);
+            l_in0_strides.push_back(l_strides_in0[l_dim]);
+            l_in1_strides.push_back(l_strides_in1[l_dim]);
+            l_out_strides.push_back(l_strides_out[l_dim]);
+            l_bias_strides.push_back(l_strides_bias[l_dim]);
+        }
+
+        TensorOperation l_tensor_op;
+        l_tensor_op._thread_pool = l_thread_pool;
+        l_tensor_op._jit_loops = (l_ru == 3);
+        l_tensor_op.setup(TensorOperation::dtype_t::bf16,
+                          TensorOperation::prim_t::zero,
+                          TensorOperation::prim_t::gemm,
+                          TensorOperation::prim_t::relu,
+                          l_types,
+                          l_execs,
+                          l_sizes,
+                          l_in0_strides,
+                          l_in1_strides,
+                          l_out_strides,
+                          l_bias_strides);
+        REQUIRE(l_tensor_op.compile() == TensorOperation::error_t::success);
+        REQUIRE(l_tensor_op._split_k == (l_ru == 2));
+
+        std::vector<float> l_out(768, 42.0f);
+        l_tensor_op.execute(l_in0.data(), l_in1.data(), l_out.data(), l_bias.data());
+        for (std::size_t l_id = 0; l_id < l_out_ref.size(); l_id++) {
+            REQUIRE(std::abs(l_out[l_id] - l_out_ref[l_id]) < 1e-5);
+        }
+    }
+}
@@ -1,11 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <string>
 
 #include "../../src/einsum/trees/einsum_trees.h"
+#include "../../src/mini_jit/backend/Cpu.h"
 #include "../../src/mini_jit/include/gemm_ref.h"
 #include "../test_utils/test_utils.h"
 
@@ -40,9 +42,9 @@ TEST_CASE("Einsum::Trees::EinsumTrees::simple binary operation", "[Einsum][Trees
     double error = 0;
     for (size_t i = 0; i < 7 * 88; i++) {
         error += std::abs(out[i] - out_ref[i]);
+        REQUIRE(std::abs(out[i] - out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(out_ref[i])));
     }
     std::cout << "Error: " << error << std::endl;
-    REQUIRE(error < 1e-5);
 
     tree.delete_tree();
 }
@@ -84,9 +86,9 @@ TEST_CASE("Einsum::Trees::EinsumTrees::simple bias op", "[Einsum][Trees][EinsumT
     double error = 0;
     for (size_t i = 0; i < 5 * 6; i++) {
         error += std::abs(out[i] - out_ref[i]);
+        REQUIRE(std::abs(out[i] - out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(out_ref[i])));
     }
     std::cout << "Error: " << error << std::endl;
-    REQUIRE(error < 1e-5);
 
     tree.delete_tree();
 }
@@ -185,11 +187,466 @@ TEST_CASE("Einsum::Trees::EinsumTrees::large bias tree", "[Einsum][Trees][Einsum
     double error = 0;
     for (size_t i = 0; i < 5 * 6; i++) {
         error += std::abs(out[i] - out_ref[i]);
+        REQUIRE(std::abs(out[i] - out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(out_ref[i])));
     }
     std::cout << "Error: " << error << std::endl;
+
+    tree.delete_tree();
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::workspace reuse", "[Einsum][Trees][EinsumTrees]") {
+    std::string str_repr = "[[[1,0],[2,1]->[2,0]],[3,2]->[3,0]],[4,3]->[4,0]";
+    EinsumTree tree = EinsumTree(str_repr, {5, 4, 6, 7, 8});
+    tree.optimize();
+    tree.lower();
+
+    // the first and the last intermediate are never alive at the same time
+    REQUIRE(tree.workspace_size() > 0);
+    REQUIRE(tree.workspace_size() < static_cast<int64_t>((5 * 6 + 5 * 7 + 5 * 8) * sizeof(float)));
+
+    std::vector<float> in0(5 * 4);
+    std::vector<float> in1(4 * 6);
+    std::vector<float> in2(6 * 7);
+    std::vector<float> in3(7 * 8);
+    for (float& value : in0) value = (float)drand48();
+    for (float& value : in1) value = (float)drand48();
+    for (float& value : in2) value = (float)drand48();
+    for (float& value : in3) value = (float)drand48();
+
+    std::vector<float> out_int0(5 * 6, 0.0f);
+    std::vector<float> out_int1(5 * 7, 0.0f);
+    std::vector<float> out_ref(5 * 8, 0.0f);
+    gemm_ref(in0.data(), in1.data(), out_int0.data(), 5, 6, 4, 5, 4, 5);
+    gemm_ref(out_int0.data(), in2.data(), out_int1.data(), 5, 7, 6, 5, 6, 5);
+    gemm_ref(out_int1.data(), in3.data(), out_ref.data(), 5, 8, 7, 5, 7, 5);
+
+    std::vector<void*> inputs = {in0.data(), in1.data(), in2.data(), in3.data()};
+
+    // repeated executions start from a clean output in the reused buffers
+    for (int run = 0; run < 2; run++) {
+        std::vector<float> out(5 * 8, 0.0f);
+        tree.execute(inputs, {}, out.data());
+
+        for (size_t i = 0; i < 5 * 8; i++) {
+            REQUIRE(std::abs(out[i] - out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(out_ref[i])));
+        }
+    }
+
+    tree.delete_tree();
+    REQUIRE(tree.workspace_size() == 0);
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::concurrent subtrees", "[Einsum][Trees][EinsumTrees]") {
+    std::string str_repr = "[[1,0],[2,1]->[2,0]],[[3,2],[4,3]->[4,2]]->[4,0]";
+
+    // both subtrees of the root are contractions and run concurrently
+    EinsumTree tree = EinsumTree(str_repr, {32, 24, 40, 16, 48});
+    tree.set_threads(4);
+    tree.lower();
+
+    // the outputs of both subtrees are alive at the same time
+    REQUIRE(tree.workspace_size() >= static_cast<int64_t>((32 * 40 + 40 * 48 + 32 * 48) * sizeof(float)));
+
+    std::vector<float> in0(32 * 24);
+    std::vector<float> in1(24 * 40);
+    std::vector<float> in2(40 * 16);
+    std::vector<float> in3(16 * 48);
+    for (float& value : in0) value = (float)drand48();
+    for (float& value : in1) value = (float)drand48();
+    for (float& value : in2) value = (float)drand48();
+    for (float& value : in3) value = (float)drand48();
+
+    std::vector<float> out_left(32 * 40, 0.0f);
+    std::vector<float> out_right(40 * 48, 0.0f);
+    std::vector<float> out_ref(32 * 48, 0.0f);
+    gemm_ref(in0.data(), in1.data(), out_left.data(), 32, 40, 24, 32, 24, 32);
+    gemm_ref(in2.data(), in3.data(), out_right.data(), 40, 48, 16, 40, 16, 40);
+    gemm_ref(out_left.data(), out_right.data(), out_ref.data(), 32, 48, 40, 32, 40, 32);
+
+    std::vector<float> out(32 * 48, 0.0f);
+    tree.execute({in0.data(), in1.data(), in2.data(), in3.data()}, {}, out.data());
+
+    double error = 0;
+    for (size_t i = 0; i < 32 * 48; i++) {
+        error += std::abs(out[i] - out_ref[i]) / (1 + std::abs(out_ref[i]));
+    }
+    std::cout << "Error: " << error << std::endl;
+    REQUIRE(error < 1e-3);
+
+    tree.delete_tree();
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::contraction path", "[Einsum][Trees][EinsumTrees]") {
+    // A(B C) with a thin A, (A B) C needs far fewer FLOPs and a smaller intermediate
+    std::string str_repr = "[1,0],[[2,1],[3,2]->[3,1]]->[3,0]";
+    std::vector<uint32_t> id_dims = {2, 64, 64, 64};
+
+    std::vector<float> in0(2 * 64);
+    std::vector<float> in1(64 * 64);
+    std::vector<float> in2(64 * 64);
+    for (float& value : in0) value = (float)drand48();
+    for (float& value : in1) value = (float)drand48();
+    for (float& value : in2) value = (float)drand48();
+
+    std::vector<float> out_int(2 * 64, 0.0f);
+    std::vector<float> out_ref(2 * 64, 0.0f);
+    gemm_ref(in0.data(), in1.data(), out_int.data(), 2, 64, 64, 2, 64, 2);
+    gemm_ref(out_int.data(), in2.data(), out_ref.data(), 2, 64, 64, 2, 64, 2);
+
+    EinsumTree tree_given = EinsumTree(str_repr, id_dims);
+    tree_given.lower();
+
+    for (EinsumTree::path_t path : {EinsumTree::path_t::greedy, EinsumTree::path_t::dp}) {
+        EinsumTree tree = EinsumTree(str_repr, id_dims);
+        tree.optimize_path(path);
+        tree.optimize();
+        tree.lower();
+        tree.print();
+
+        // intermediate of 2x64 instead of 64x64 elements
+        REQUIRE(tree.workspace_size() < tree_given.workspace_size());
+
+        std::vector<float> out(2 * 64, 0.0f);
+        tree.execute({in0.data(), in1.data(), in2.data()}, {}, out.data());
+
+        double error = 0;
+        for (size_t i = 0; i < 2 * 64; i++) {
+            error += std::abs(out[i] - out_ref[i]) / (1 + std::abs(out_ref[i]));
+        }
+        std::cout << "Error: " << error << std::endl;
+        REQUIRE(error < 1e-3);
+
+        tree.delete_tree();
+    }
+
+    tree_given.delete_tree();
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::folded layouts", "[Einsum][Trees][EinsumTrees]") {
+    // the intermediate is written as [2,0] for its consumer instead of being permuted
+    std::string str_repr = "[[1,0],[2,1]->[0,2]],[3,2]->[3,0]";
+    std::vector<uint32_t> id_dims = {5, 4, 6, 7};
+
+    EinsumTree tree_direct = EinsumTree("[[1,0],[2,1]->[2,0]],[3,2]->[3,0]", id_dims);
+    tree_direct.optimize();
+    tree_direct.lower();
+
+    EinsumTree tree = EinsumTree(str_repr, id_dims);
+    tree.optimize();
+    tree.lower();
+    tree.print();
+
+    // no permuted copy of the intermediate
+    REQUIRE(tree.workspace_size() == tree_direct.workspace_size());
+
+    std::vector<float> in0(5 * 4);
+    std::vector<float> in1(4 * 6);
+    std::vector<float> in2(6 * 7);
+    for (float& value : in0) value = (float)drand48();
+    for (float& value : in1) value = (float)drand48();
+    for (float& value : in2) value = (float)drand48();
+
+    std::vector<float> out_int(5 * 6, 0.0f);
+    std::vector<float> out_ref(5 * 7, 0.0f);
+    gemm_ref(in0.data(), in1.data(), out_int.data(), 5, 6, 4, 5, 4, 5);
+    gemm_ref(out_int.data(), in2.data(), out_ref.data(), 5, 7, 6, 5, 6, 5);
+
+    std::vector<float> out(5 * 7, 0.0f);
+    tree.execute({in0.data(), in1.data(), in2.data()}, {}, out.data());
+
+    double error = 0;
+    for (size_t i = 0; i < 5 * 7; i++) {
+        error += std::abs(out[i] - out_ref[i]);
+    }
     REQUIRE(error < 1e-5);
 
     tree.delete_tree();
+    tree_direct.delete_tree();
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::transposed inputs", "[Einsum][Trees][EinsumTrees]") {
+    // inputs with M outside of K or K outside of N are read by transposed BRGEMMs instead of being permuted
+    std::vector<uint32_t> id_dims = {37, 23, 19};
+    int64_t size_m = id_dims[0];
+    int64_t size_k = id_dims[1];
+    int64_t size_n = id_dims[2];
+
+    EinsumTree tree_direct = EinsumTree("[1,0],[2,1]->[2,0]", id_dims);
+    tree_direct.optimize();
+    tree_direct.lower();
+
+    for (std::string str_repr : {"[0,1],[2,1]->[2,0]", "[1,0],[1,2]->[2,0]", "[0,1],[1,2]->[2,0]"}) {
+        bool trans_a = (str_repr[1] == '0');
+        bool trans_b = (str_repr[7] == '1');
+
+        EinsumTree tree = EinsumTree(str_repr, id_dims);
+        tree.optimize();
+        tree.lower();
+        tree.print();
+
+        // no permuted copies of the inputs
+        REQUIRE(tree.workspace_size() == tree_direct.workspace_size());
+
+        std::vector<float> in0(size_m * size_k);
+        std::vector<float> in1(size_k * size_n);
+        for (float& value : in0) value = (float)drand48();
+        for (float& value : in1) value = (float)drand48();
+
+        std::vector<float> out_ref(size_m * size_n, 0.0f);
+        for (int64_t n = 0; n < size_n; n++) {
+            for (int64_t m = 0; m < size_m; m++) {
+                for (int64_t k = 0; k < size_k; k++) {
+                    float a = trans_a ? in0[m * size_k + k] : in0[k * size_m + m];
+                    float b = trans_b ? in1[k * size_n + n] : in1[n * size_k + k];
+                    out_ref[n * size_m + m] += a * b;
+                }
+            }
+        }
+
+        std::vector<float> out(size_m * size_n, 0.0f);
+        tree.execute({in0.data(), in1.data()}, {}, out.data());
+
+        double error = 0;
+        for (size_t i = 0; i < out.size(); i++) {
+            error += std::abs(out[i] - out_ref[i]);
+        }
+        REQUIRE(error < 1e-3);
+
+        tree.delete_tree();
+    }
+
+    tree_direct.delete_tree();
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::compiled tree", "[Einsum][Trees][EinsumTrees]") {
+    // model of the iris benchmark: three layers with bias, the first two with relu
+    std::string str_repr = "[[[1,0],[2,1]->[2,0]r],[3,2]->[3,0]r],[4,3]->[4,0]";
+    for (uint32_t batch_size : {1u, 5u}) {
+        std::vector<uint32_t> id_dims = {batch_size, 4, 64, 16, 3};
+
+        EinsumTree tree = EinsumTree(str_repr, id_dims, true);
+        tree.optimize();
+        tree.lower();
+
+        std::vector<float> input(4 * batch_size);
+        std::vector<float> w1(4 * 64);
+        std::vector<float> w2(64 * 16);
+        std::vector<float> w3(16 * 3);
+        std::vector<float> b1(64);
+        std::vector<float> b2(16);
+        std::vector<float> b3(3);
+        for (float& value : input) value = (float)drand48() * 2 - 1;
+        for (float& value : w1) value = (float)drand48() * 2 - 1;
+        for (float& value : w2) value = (float)drand48() * 2 - 1;
+        for (float& value : w3) value = (float)drand48() * 2 - 1;
+        for (float& value : b1) value = (float)drand48() * 2 - 1;
+        for (float& value : b2) value = (float)drand48() * 2 - 1;
+        for (float& value : b3) value = (float)drand48() * 2 - 1;
+
+        std::vector<void*> inputs = {input.data(), w1.data(), w2.data(), w3.data()};
+        std::vector<void*> biases = {b3.data(), b2.data(), b1.data()};
+
+        std::vector<float> out_ref(3 * batch_size, 0.0f);
+        tree.execute(inputs, biases, out_ref.data());
+
+        // the generated function calls the same kernels on the same blocks
+        REQUIRE(tree.compile());
+        for (int run = 0; run < 2; run++) {
+            std::vector<float> out(3 * batch_size, 0.0f);
+            tree.execute(inputs, biases, out.data());
+            for (size_t i = 0; i < out.size(); i++) {
+                REQUIRE(out[i] == out_ref[i]);
+            }
+        }
+
+        tree.delete_tree();
+    }
+
+    // a tree without bias zeroes the accumulators of every layer
+    EinsumTree tree_nb = EinsumTree("[[[1,0],[2,1]->[2,0]],[3,2]->[3,0]],[4,3]->[4,0]", {5, 4, 6, 7, 8});
+    tree_nb.optimize();
+    tree_nb.lower();
+    REQUIRE(tree_nb.compile());
+
+    std::vector<float> in0(5 * 4);
+    std::vector<float> in1(4 * 6);
+    std::vector<float> in2(6 * 7);
+    std::vector<float> in3(7 * 8);
+    for (float& value : in0) value = (float)drand48();
+    for (float& value : in1) value = (float)drand48();
+    for (float& value : in2) value = (float)drand48();
+    for (float& value : in3) value = (float)drand48();
+
+    std::vector<float> out_int0(5 * 6, 0.0f);
+    std::vector<float> out_int1(5 * 7, 0.0f);
+    std::vector<float> out_nb_ref(5 * 8, 0.0f);
+    gemm_ref(in0.data(), in1.data(), out_int0.data(), 5, 6, 4, 5, 4, 5);
+    gemm_ref(out_int0.data(), in2.data(), out_int1.data(), 5, 7, 6, 5, 6, 5);
+    gemm_ref(out_int1.data(), in3.data(), out_nb_ref.data(), 5, 8, 7, 5, 7, 5);
+
+    std::vector<float> out_nb(5 * 8, 1.0f);
+    tree_nb.execute({in0.data(), in1.data(), in2.data(), in3.data()}, {}, out_nb.data());
+
+    for (size_t i = 0; i < 5 * 8; i++) {
+        REQUIRE(std::abs(out_nb[i] - out_nb_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(out_nb_ref[i])));
+    }
+
+    tree_nb.delete_tree();
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::fp64", "[Einsum][Trees][EinsumTrees]") {
+    // iris model in double precision: three layers with bias, the first two with relu
+    std::string str_repr = "[[[1,0],[2,1]->[2,0]r],[3,2]->[3,0]r],[4,3]->[4,0]";
+    uint32_t batch_size = 5;
+    std::vector<uint32_t> id_dims = {batch_size, 4, 64, 16, 3};
+
+    EinsumTree tree = EinsumTree(str_repr, id_dims, true, TensorOperation::dtype_t::fp64);
+    tree.optimize();
+    tree.lower();
+    REQUIRE(tree.workspace_size() % sizeof(double) == 0);
+
+    std::vector<double> input(4 * batch_size);
+    std::vector<double> w1(4 * 64);
+    std::vector<double> w2(64 * 16);
+    std::vector<double> w3(16 * 3);
+    std::vector<double> b1(64);
+    std::vector<double> b2(16);
+    std::vector<double> b3(3);
+    for (double& value : input) value = drand48() * 2 - 1;
+    for (double& value : w1) value = drand48() * 2 - 1;
+    for (double& value : w2) value = drand48() * 2 - 1;
+    for (double& value : w3) value = drand48() * 2 - 1;
+    for (double& value : b1) value = drand48() * 2 - 1;
+    for (double& value : b2) value = drand48() * 2 - 1;
+    for (double& value : b3) value = drand48() * 2 - 1;
+
+    // layer out(b, j) = act(bias(j) + sum_i in(b, i) w(i, j)), the batch dimension is the fastest
+    auto layer = [&](std::vector<double> const& in, std::vector<double> const& w, std::vector<double> const& b, bool relu) {
+        int64_t size_in = in.size() / batch_size;
+        std::vector<double> out(b.size() * batch_size);
+        for (size_t j = 0; j < b.size(); j++) {
+            for (uint32_t l_b = 0; l_b < batch_size; l_b++) {
+                double sum = b[j];
+                for (int64_t i = 0; i < size_in; i++) {
+                    sum += in[i * batch_size + l_b] * w[j * size_in + i];
+                }
+                out[j * batch_size + l_b] = relu ? std::max(sum, 0.0) : sum;
+            }
+        }
+        return out;
+    };
+    std::vector<double> out_ref = layer(layer(layer(input, w1, b1, true), w2, b2, true), w3, b3, false);
+
+    std::vector<void*> inputs = {input.data(), w1.data(), w2.data(), w3.data()};
+    std::vector<void*> biases = {b3.data(), b2.data(), b1.data()};
+
+    // executed node by node and as one generated function
+    for (int run = 0; run < 2; run++) {
+        if (run == 1) {
+            REQUIRE(tree.compile());
+        }
+        std::vector<double> out(3 * batch_size, 0.0);
+        tree.execute(inputs, biases, out.data());
+        for (size_t i = 0; i < out.size(); i++) {
+            REQUIRE(std::abs(out[i] - out_ref[i]) < 1e-12);
+        }
+    }
+    tree.delete_tree();
+
+    // permutations copy eight byte elements
+    EinsumTree tree_perm = EinsumTree("[0,1,2]->[2,0,1]", {4, 3, 2}, false, TensorOperation::dtype_t::fp64);
+    tree_perm.lower();
+
+    std::vector<double> in(24);
+    std::vector<double> out(24, 0.0);
+    for (size_t i = 0; i < 24; i++) {
+        in[i] = i + 1 + 1.0 / 3;
+    }
+    tree_perm.execute({in.data()}, {}, out.data());
+    for (size_t i = 0; i < 24; i++) {
+        REQUIRE(out[i] == in[(i % 12) * 2 + i / 12]);
+    }
+    tree_perm.delete_tree();
+}
+
+TEST_CASE("Einsum::Trees::EinsumTrees::bf16", "[Einsum][Trees][EinsumTrees]") {
+    if (!mini_jit::backend::Cpu::has_bf16()) {
+        return;
+    }
+    // iris model with bfloat16 inputs, the layers accumulate in fp32 and pass bfloat16 to the next layer
+    std::string str_repr = "[[[1,0],[2,1]->[2,0]r],[3,2]->[3,0]r],[4,3]->[4,0]";
+    uint32_t batch_size = 5;
+    std::vector<uint32_t> id_dims = {batch_size, 4, 64, 16, 3};
+
+    EinsumTree tree = EinsumTree(str_repr, id_dims, true, TensorOperation::dtype_t::bf16);
+    tree.optimize();
+    tree.lower();
+    // the intermediate contractions are converted in C++
+    REQUIRE(!tree.compile());
+
+    auto random_bf16 = [](std::vector<uint16_t>& values) {
+        for (uint16_t& value : values) value = test::bf16::from_fp32(drand48() * 2 - 1);
+    };
+    std::vector<uint16_t> input(4 * batch_size);
+    std::vector<uint16_t> w1(4 * 64);
+    std::vector<uint16_t> w2(64 * 16);
+    std::vector<uint16_t> w3(16 * 3);
+    random_bf16(input);
+    random_bf16(w1);
+    random_bf16(w2);
+    random_bf16(w3);
+    std::vector<float> b1(64);
+    std::vector<float> b2(16);
+    std::vector<float> b3(3);
+    for (float& value : b1) value = drand48() * 2 - 1;
+    for (float& value : b2) value = drand48() * 2 - 1;
+    for (float& value : b3) value = drand48() * 2 - 1;
+
+    // layer out(b, j) = act(bias(j) + sum_i in(b, i) w(i, j)), the batch dimension is the fastest
+    auto layer = [&](std::vector<float> const& in, std::vector<uint16_t> const& w, std::vector<float> const& b, bool relu) {
+        int64_t size_in = in.size() / batch_size;
+        std::vector<float> out(b.size() * batch_size);
+        for (size_t j = 0; j < b.size(); j++) {
+            for (uint32_t l_b = 0; l_b < batch_size; l_b++) {
+                double sum = b[j];
+                for (int64_t i = 0; i < size_in; i++) {
+                    sum += in[i * batch_size + l_b] * test::bf16::to_fp32(w[j * size_in + i]);
+                }
+                out[j * batch_size + l_b] = relu ? std::max(sum, 0.0) : sum;
+            }
+        }
+        return out;
+    };
+    auto round = [](std::vector<float> values) {
+        for (float& value : values) value = test::bf16::to_fp32(test::bf16::from_fp32(value));
+        return values;
+    };
+    std::vector<float> input_fp32(input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+        input_fp32[i] = test::bf16::to_fp32(input[i]);
+    }
+    std::vector<float> out_ref = layer(round(layer(round(layer(input_fp32, w1, b1, true)), w2, b2, true)), w3, b3, false);
+
+    std::vector<float> out(3 * batch_size, 0.0f);
+    tree.execute({input.data(), w1.data(), w2.data(), w3.data()}, {b3.data(), b2.data(), b1.data()}, out.data());
+    // a different rounding of an intermediate value changes the result by about one bfloat16 ulp
+    for (size_t i = 0; i < out.size(); i++) {
+        REQUIRE(std::abs(out[i] - out_ref[i]) < 1e-2 * std::max(1.0f, std::abs(out_ref[i])));
+    }
+    tree.delete_tree();
+
+    // a single contraction is generated as one function
+    EinsumTree tree_single = EinsumTree("[1,0],[2,1]->[2,0]", {batch_size, 4, 64}, false, TensorOperation::dtype_t::bf16);
+    tree_single.optimize();
+    tree_single.lower();
+    REQUIRE(tree_single.compile());
+    std::vector<float> out_single(64 * batch_size, 0.0f);
+    tree_single.execute({input.data(), w1.data()}, {}, out_single.data());
+    std::vector<float> out_single_ref = layer(input_fp32, w1, std::vector<float>(64, 0.0f), false);
+    for (size_t i = 0; i < out_single.size(); i++) {
+        REQUIRE(std::abs(out_single[i] - out_single_ref[i]) < 1e-5);
+    }
+    tree_single.delete_tree();
 }
 
 TEST_CASE("Einsum::Trees::EinsumTrees::Large Tree Example 1 Lower", "[Einsum][Trees][EinsumTrees]") {
@@ -236,7 +693,7 @@ TEST_CASE("Einsum::Trees::EinsumTrees::Large Tree Example 1 Lower", "[Einsum][Tr
 
     // Reference calculations
     // first contraction in0, in1 -> out_int0
-    float* out_int0 = new float[32 * 128 * 4];
+    float* out_int0 = new float[32 * 128 * 4]();
 
     for (size_t n_0 = 0; n_0 < 32; n_0++) {
         for (size_t m = 0; m < 3; m++) {
@@ -253,7 +710,7 @@ TEST_CASE("Einsum::Trees::EinsumTrees::Large Tree Example 1 Lower", "[Einsum][Tr
     }
 
     // second contraction in2, in3 -> out_int1
-    float* out_int1 = new float[72 * 128 * 71 * 32];
+    float* out_int1 = new float[72 * 128 * 71 * 32]();
 
     for (size_t m_0 = 0; m_0 < 128; m_0++) {
         for (size_t n_0 = 0; n_0 < 72; n_0++) {
@@ -272,7 +729,7 @@ TEST_CASE("Einsum::Trees::EinsumTrees::Large Tree Example 1 Lower", "[Einsum][Tr
     }
 
     // third contraction out_int1, in4 -> out
-    float* out_int2 = new float[100 * 72 * 128 * 32];
+    float* out_int2 = new float[100 * 72 * 128 * 32]();
 
     for (size_t m_0 = 0; m_0 < 72; m_0++) {
         for (size_t m_1 = 0; m_1 < 128; m_1++) {
@@ -313,9 +770,9 @@ TEST_CASE("Einsum::Trees::EinsumTrees::Large Tree Example 1 Lower", "[Einsum][Tr
     double error = 0;
     for (size_t i = 0; i < 100 * 72 * 128 * 128 * 3; i++) {
         error += std::abs(out[i] - out_ref[i]);
+        REQUIRE(std::abs(out[i] - out_ref[i]) <= 1e-4 * std::max(1.0f, std::abs(out_ref[i])));
     }
     std::cout << "Error: " << error << std::endl;
-    REQUIRE(error < 1e-5);
 
     delete[] in0;
     delete[] in1;
@@ -134,4 +134,111 @@ TEST_CASE("Einsum::Backend::TensorOperationUnary Reorder", "TEST 2") {
             REQUIRE(tensor_out[i] == tensor_out_ref[i]);
         }
     }
-}
\ No newline at end of file
+}
+/**
+ * abcd->dbac
+ * dim_types = C
+ * exec_types = ( Seq, Seq, Seq, Seq)
+ * dim_sizes = (2, 70, 3, 130)
+ * strides_in0 = (27300, 390, 130, 1)
+ * strides_out =  (3, 6, 1, 420)
+ * prim_type = trans
+ */
+TEST_CASE("Einsum::Backend::TensorOperationUnary Reorder tiled", "TEST 3") {
+    TensorOperationUnary tensor_op;
+
+    std::vector<TensorOperationUnary::exec_t> i_exec_types(4, TensorOperationUnary::exec_t::seq);
+    std::vector<int64_t> i_dim_sizes = {2, 70, 3, 130};
+    std::vector<int64_t> i_strides_in0 = {70 * 3 * 130, 3 * 130, 130, 1};
+    std::vector<int64_t> i_strides_out = {3, 2 * 3, 1, 70 * 2 * 3};
+
+    tensor_op.setup(TensorOperationUnary::dtype_t::fp32,
+                    TensorOperationUnary::prim_t::trans,
+                    i_exec_types,
+                    i_dim_sizes,
+                    i_strides_in0,
+                    i_strides_out);
+    REQUIRE(tensor_op.compile() == TensorOperationUnary::error_t::success);
+
+    int64_t size = 2 * 70 * 3 * 130;
+    std::vector<float> tensor_in0(size);
+    std::vector<float> tensor_out(size, 0.0f);
+    std::vector<float> tensor_out_ref(size, 0.0f);
+
+    for (int64_t i = 0; i < size; i++) {
+        tensor_in0[i] = (float)drand48() * 10 - 5;
+    }
+
+    // execute reference
+    for (int64_t a = 0; a < i_dim_sizes[0]; a++) {
+        for (int64_t b = 0; b < i_dim_sizes[1]; b++) {
+            for (int64_t c = 0; c < i_dim_sizes[2]; c++) {
+                for (int64_t d = 0; d < i_dim_sizes[3]; d++) {
+                    tensor_out_ref[a * i_strides_out[0] + b * i_strides_out[1] + c * i_strides_out[2] + d * i_strides_out[3]] =
+                        tensor_in0[a * i_strides_in0[0] + b * i_strides_in0[1] + c * i_strides_in0[2] + d * i_strides_in0[3]];
+                }
+            }
+        }
+    }
+
+    // execute TenOp
+    tensor_op.execute(tensor_in0.data(), tensor_out.data());
+
+    for (int64_t i = 0; i < size; i++) {
+        REQUIRE(tensor_out[i] == tensor_out_ref[i]);
+    }
+}
+
+/**
+ * Permutations above the parallelization threshold:
+ * abc->cba with an outer loop, ab->ba on tiles only
+ */
+TEST_CASE("Einsum::Backend::TensorOperationUnary Reorder parallel", "TEST 4") {
+    std::vector<std::vector<int64_t>> l_shapes = {{8, 100, 130},
+                                                  {1, 300, 517}};
+
+    for (std::vector<int64_t> const& i_dim_sizes : l_shapes) {
+        int64_t size_a = i_dim_sizes[0];
+        int64_t size_b = i_dim_sizes[1];
+        int64_t size_c = i_dim_sizes[2];
+
+        std::vector<TensorOperationUnary::exec_t> i_exec_types(3, TensorOperationUnary::exec_t::seq);
+        std::vector<int64_t> i_strides_in0 = {size_b * size_c, size_c, 1};
+        std::vector<int64_t> i_strides_out = {1, size_a, size_a * size_b};
+
+        TensorOperationUnary tensor_op;
+        tensor_op.setup(TensorOperationUnary::dtype_t::fp32,
+                        TensorOperationUnary::prim_t::trans,
+                        i_exec_types,
+                        i_dim_sizes,
+                        i_strides_in0,
+                        i_strides_out);
+        REQUIRE(tensor_op.compile() == TensorOperationUnary::error_t::success);
+
+        int64_t size = size_a * size_b * size_c;
+        std::vector<float> tensor_in0(size);
+        std::vector<float> tensor_out(size, 0.0f);
+        std::vector<float> tensor_out_ref(size, 0.0f);
+
+        for (int64_t i = 0; i < size; i++) {
+            tensor_in0[i] = (float)drand48() * 10 - 5;
+        }
+
+        // execute reference
+        for (int64_t a = 0; a < size_a; a++) {
+            for (int64_t b = 0; b < size_b; b++) {
+                for (int64_t c = 0; c < size_c; c++) {
+                    tensor_out_ref[a * i_strides_out[0] + b * i_strides_out[1] + c * i_strides_out[2]] =
+                        tensor_in0[a * i_strides_in0[0] + b * i_strides_in0[1] + c * i_strides_in0[2]];
+                }
+            }
+        }
+
+        // execute TenOp
+        tensor_op.execute(tensor_in0.data(), tensor_out.data());
+
+        for (int64_t i = 0; i < size; i++) {
+            REQUIRE(tensor_out[i] == tensor_out_ref[i]);
+        }
+    }
+}
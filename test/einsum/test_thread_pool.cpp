@@ -0,0 +1,51 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "../../src/einsum/backend/ThreadPool.h"
+
+using namespace einsum::backend;
+
+TEST_CASE("Einsum::Backend::ThreadPool::parallel_for", "[Einsum][Backend][ThreadPool]") {
+    ThreadPool l_thread_pool(4);
+    REQUIRE(l_thread_pool.num_threads() == 4);
+
+    // every iteration is executed exactly once, also for fewer iterations than threads
+    for (int64_t l_size : {0, 1, 3, 4, 17, 1000}) {
+        std::vector<std::atomic<int64_t>> l_count(l_size);
+        l_thread_pool.parallel_for(l_size, [&](int64_t l_it) {
+            l_count[l_it]++;
+        });
+        for (int64_t l_it = 0; l_it < l_size; l_it++) {
+            REQUIRE(l_count[l_it] == 1);
+        }
+    }
+
+    // iterations of different length are balanced by stealing
+    std::atomic<int64_t> l_sum = 0;
+    l_thread_pool.parallel_for(64, [&](int64_t l_it) {
+        int64_t l_local = 0;
+        for (int64_t l_id = 0; l_id < (l_it < 8 ? 100000 : 10); l_id++) {
+            l_local += l_id % 3;
+        }
+        l_sum += l_local;
+    });
+    REQUIRE(l_sum == 8 * 99999 + 56 * 9);
+}
+
+TEST_CASE("Einsum::Backend::ThreadPool::nested parallel_for", "[Einsum][Backend][ThreadPool]") {
+    // workers pinned to the first CPU, nested loops share the workers of the outer loop
+    ThreadPool l_thread_pool(3, {0});
+    REQUIRE(l_thread_pool.cpus().size() == 1);
+
+    std::vector<std::atomic<int64_t>> l_count(16 * 32);
+    l_thread_pool.parallel_for(16, [&](int64_t l_outer) {
+        l_thread_pool.parallel_for(32, [&](int64_t l_inner) {
+            l_count[l_outer * 32 + l_inner]++;
+        });
+    });
+    for (std::atomic<int64_t>& l_value : l_count) {
+        REQUIRE(l_value == 1);
+    }
+}
@@ -1,9 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <vector>
 
+#include "../../src/mini_jit/backend/Cpu.h"
 #include "../../src/mini_jit/generator/Brgemm.h"
 #include "../../src/mini_jit/generator/Unary.h"
 #include "../../src/mini_jit/generator/Util.h"
@@ -45,17 +49,640 @@ TEST_CASE("MiniJit::Brgemm::FP32 Tests BRGEMMs", "[MiniJit][GEMM][FP32]") {
                    m, k, m,
                    m * k, n * k);
         mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
-        l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k);
+        l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k, nullptr);
+
+        // the summation order differs between the ISAs, compare relative to the magnitude of C
+        for (size_t i = 0; i < m * n; i++) {
+            REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 1e-4 * std::max(1.0f, std::abs(l_c_ref[i])));
+        }
+        free(l_a);
+        free(l_b);
+        free(l_c_jit);
+        free(l_c_ref);
+    }
+}
+TEST_CASE("MiniJit::Brgemm::FP32 Tests BRGEMMs with bias and zero initialization", "[MiniJit][GEMM][FP32]") {
+    srand48(time(NULL));
+
+    for (size_t l_i = 0; l_i < 400; l_i++) {
+        int64_t m = (int64_t)(drand48() * 64.0) + 1;
+        int64_t n = (int64_t)(drand48() * 64.0) + 1;
+        int64_t k = (int64_t)(drand48() * 64.0) + 1;
+        int16_t br = (int64_t)(drand48() * 4.0) + 1;
+        bool is_relu = (l_i % 4) == 3;
+        Brgemm::bias_t l_bias_type = (l_i % 3 == 0) ? Brgemm::bias_t::m : ((l_i % 3 == 1) ? Brgemm::bias_t::n : Brgemm::bias_t::zero);
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::fp32, is_relu, l_bias_type) == Brgemm::error_t::success);
+
+        float *l_a = (float *)malloc(m * k * br * sizeof(float));
+        float *l_b = (float *)malloc(k * n * br * sizeof(float));
+        float *l_bias = (float *)malloc((m + n) * sizeof(float));
+        float *l_c_jit = (float *)malloc(m * n * sizeof(float));
+        float *l_c_ref = (float *)malloc(m * n * sizeof(float));
+
+        for (int i = 0; i < br * m * k; i++) {
+            l_a[i] = (float)drand48() * 10 - 5;
+        }
+        for (int i = 0; i < br * k * n; i++) {
+            l_b[i] = (float)drand48() * 10 - 5;
+        }
+        for (int i = 0; i < m + n; i++) {
+            l_bias[i] = (float)drand48() * 10 - 5;
+        }
+
+        // the previous values of C are replaced by the bias, or by zero
+        for (int l_n = 0; l_n < n; l_n++) {
+            for (int l_m = 0; l_m < m; l_m++) {
+                l_c_jit[l_n * m + l_m] = (float)drand48() * 10 - 5;
+                if (l_bias_type == Brgemm::bias_t::m) {
+                    l_c_ref[l_n * m + l_m] = l_bias[l_m];
+                } else if (l_bias_type == Brgemm::bias_t::n) {
+                    l_c_ref[l_n * m + l_m] = l_bias[l_n];
+                } else {
+                    l_c_ref[l_n * m + l_m] = 0.0f;
+                }
+            }
+        }
+
+        brgemm_ref(l_a, l_b, l_c_ref,
+                   m, n, k, br,
+                   m, k, m,
+                   m * k, n * k);
+        if (is_relu) {
+            for (int i = 0; i < m * n; i++) {
+                l_c_ref[i] = std::max(l_c_ref[i], 0.0f);
+            }
+        }
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k, l_bias);
+
+        for (size_t i = 0; i < m * n; i++) {
+            REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 1e-4 * std::max(1.0f, std::abs(l_c_ref[i])));
+        }
+        free(l_a);
+        free(l_b);
+        free(l_bias);
+        free(l_c_jit);
+        free(l_c_ref);
+    }
+}
+
+TEST_CASE("MiniJit::Brgemm::FP32 Tests BRGEMMs with transposed operands", "[MiniJit][GEMM][FP32]") {
+    srand48(time(NULL));
+
+    for (size_t l_i = 0; l_i < 800; l_i++) {
+        int64_t m = (int64_t)(drand48() * 40.0) + 1;
+        int64_t n = (int64_t)(drand48() * 40.0) + 1;
+        int64_t k = (int64_t)(drand48() * 40.0) + 1;
+        int64_t br = (int64_t)(drand48() * 4.0) + 1;
+        uint32_t l_trans_a = l_i % 2;
+        uint32_t l_trans_b = (l_i / 2) % 2;
+        uint32_t l_trans_c = (l_i / 4) % 2;
+        Brgemm::act_t l_acts[4] = {Brgemm::act_t::none, Brgemm::act_t::relu, Brgemm::act_t::tanh, Brgemm::act_t::gelu};
+        Brgemm::act_t l_act = l_acts[(l_i / 8) % 4];
+        Brgemm::bias_t l_bias_type = static_cast<Brgemm::bias_t>((l_i / 8) % 3);
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, l_trans_a, l_trans_b, l_trans_c, mini_jit::generator::Brgemm::dtype_t::fp32, false, l_bias_type, l_act) == Brgemm::error_t::success);
+
+        // padded leading dimensions: distance of the columns, or of the rows of a row-major matrix
+        int64_t l_lda = (l_trans_a ? k : m) + l_i % 3;
+        int64_t l_ldb = (l_trans_b ? n : k) + l_i % 5;
+        int64_t l_ldc = (l_trans_c ? n : m) + l_i % 2;
+        int64_t l_stride_a = l_lda * (l_trans_a ? m : k);
+        int64_t l_stride_b = l_ldb * (l_trans_b ? k : n);
+        auto l_id_a = [&](int64_t i_br, int64_t i_m, int64_t i_k) {
+            return i_br * l_stride_a + (l_trans_a ? i_m * l_lda + i_k : i_k * l_lda + i_m);
+        };
+        auto l_id_b = [&](int64_t i_br, int64_t i_k, int64_t i_n) {
+            return i_br * l_stride_b + (l_trans_b ? i_k * l_ldb + i_n : i_n * l_ldb + i_k);
+        };
+        auto l_id_c = [&](int64_t i_m, int64_t i_n) {
+            return l_trans_c ? i_m * l_ldc + i_n : i_n * l_ldc + i_m;
+        };
+
+        std::vector<float> l_a(br * l_stride_a);
+        std::vector<float> l_b(br * l_stride_b);
+        std::vector<float> l_bias(m + n);
+        std::vector<float> l_c_jit(l_ldc * (l_trans_c ? m : n));
+        for (float &l_val : l_a) {
+            l_val = (float)drand48() * 10 - 5;
+        }
+        for (float &l_val : l_b) {
+            l_val = (float)drand48() * 10 - 5;
+        }
+        for (float &l_val : l_bias) {
+            l_val = (float)drand48() * 10 - 5;
+        }
+        for (float &l_val : l_c_jit) {
+            l_val = (float)drand48() * 10 - 5;
+        }
+        std::vector<float> l_c_ref = l_c_jit;
+
+        for (int64_t l_n = 0; l_n < n; l_n++) {
+            for (int64_t l_m = 0; l_m < m; l_m++) {
+                double l_sum = (l_bias_type == Brgemm::bias_t::none) ? l_c_ref[l_id_c(l_m, l_n)] : (l_bias_type == Brgemm::bias_t::m) ? l_bias[l_m]
+                                                                                                                                       : l_bias[l_n];
+                for (int64_t l_br = 0; l_br < br; l_br++) {
+                    for (int64_t l_k = 0; l_k < k; l_k++) {
+                        l_sum += (double)l_a[l_id_a(l_br, l_m, l_k)] * l_b[l_id_b(l_br, l_k, l_n)];
+                    }
+                }
+                l_c_ref[l_id_c(l_m, l_n)] = (l_act == Brgemm::act_t::none) ? l_sum : Activation::reference(l_act, l_sum);
+            }
+        }
+
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        l_kernel(l_a.data(), l_b.data(), l_c_jit.data(), l_lda, l_ldb, l_ldc, l_stride_a, l_stride_b, l_bias.data());
+
+        // the padding of C is not written
+        for (size_t i = 0; i < l_c_jit.size(); i++) {
+            REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.001);
+        }
+    }
+}
+
+TEST_CASE("MiniJit::Brgemm::FP32 Tests BRGEMMs with a row-major C", "[MiniJit][GEMM][FP32]") {
+    int64_t l_shapes[4][4] = {{1, 1, 1, 1}, {16, 4, 8, 2}, {13, 29, 7, 3}, {40, 3, 33, 1}};
+
+    for (int64_t const(&l_shape)[4] : l_shapes) {
+        int64_t m = l_shape[0];
+        int64_t n = l_shape[1];
+        int64_t k = l_shape[2];
+        int64_t br = l_shape[3];
+        int64_t l_ldc = n + 3;
+
+        // column-major A and B, C is stored row by row as by direct callers passing trans_c = 1
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, 0, 0, 1, mini_jit::generator::Brgemm::dtype_t::fp32, false) == Brgemm::error_t::success);
+
+        std::vector<float> l_a(br * m * k);
+        std::vector<float> l_b(br * k * n);
+        std::vector<float> l_c_jit(m * l_ldc);
+        for (size_t i = 0; i < l_a.size(); i++) {
+            l_a[i] = (float)(i % 7) - 3.0f;
+        }
+        for (size_t i = 0; i < l_b.size(); i++) {
+            l_b[i] = (float)(i % 5) * 0.5f - 1.0f;
+        }
+        for (size_t i = 0; i < l_c_jit.size(); i++) {
+            l_c_jit[i] = (float)(i % 3);
+        }
+        std::vector<float> l_c_ref = l_c_jit;
+
+        for (int64_t l_m = 0; l_m < m; l_m++) {
+            for (int64_t l_n = 0; l_n < n; l_n++) {
+                for (int64_t l_br = 0; l_br < br; l_br++) {
+                    for (int64_t l_k = 0; l_k < k; l_k++) {
+                        l_c_ref[l_m * l_ldc + l_n] += l_a[l_br * m * k + l_k * m + l_m] * l_b[l_br * k * n + l_n * k + l_k];
+                    }
+                }
+            }
+        }
+
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        l_kernel(l_a.data(), l_b.data(), l_c_jit.data(), m, k, l_ldc, m * k, k * n, nullptr);
+
+        // the products are exact, the padding of C is not written
+        for (size_t i = 0; i < l_c_jit.size(); i++) {
+            REQUIRE(l_c_jit[i] == l_c_ref[i]);
+        }
+    }
+}
+
+TEST_CASE("MiniJit::Brgemm::FP32 Tests BRGEMMs with activations", "[MiniJit][GEMM][FP32]") {
+    Brgemm::act_t l_acts[4] = {Brgemm::act_t::gelu, Brgemm::act_t::sigmoid, Brgemm::act_t::tanh, Brgemm::act_t::silu};
+
+    // accuracy of the approximations: C = A * 1 covers [-12, 12]
+    for (Brgemm::act_t l_act : l_acts) {
+        int64_t m = 2401;
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, 1, 1, 1, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::fp32, false, Brgemm::bias_t::zero, l_act) == Brgemm::error_t::success);
+
+        float *l_a = (float *)malloc(m * sizeof(float));
+        float *l_c = (float *)malloc(m * sizeof(float));
+        float l_b = 1.0f;
+        for (int i = 0; i < m; i++) {
+            l_a[i] = -12.0f + 0.01f * i;
+        }
+
+        l_brgemm.get_kernel()(l_a, &l_b, l_c, m, 1, m, m, 1, nullptr);
+
+        for (int i = 0; i < m; i++) {
+            float l_ref = Activation::reference(l_act, l_a[i]);
+            REQUIRE(std::abs(l_c[i] - l_ref) < 2e-6 * std::max(1.0f, std::abs(l_a[i])));
+        }
+        free(l_a);
+        free(l_c);
+    }
+
+    srand48(time(NULL));
+
+    for (size_t l_i = 0; l_i < 200; l_i++) {
+        int64_t m = (int64_t)(drand48() * 64.0) + 1;
+        int64_t n = (int64_t)(drand48() * 64.0) + 1;
+        int64_t k = (int64_t)(drand48() * 16.0) + 1;
+        int16_t br = (int64_t)(drand48() * 4.0) + 1;
+        Brgemm::act_t l_act = l_acts[l_i % 4];
+        Brgemm::bias_t l_bias_type = (l_i % 3 == 0) ? Brgemm::bias_t::n : Brgemm::bias_t::none;
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::fp32, false, l_bias_type, l_act) == Brgemm::error_t::success);
+
+        float *l_a = (float *)malloc(m * k * br * sizeof(float));
+        float *l_b = (float *)malloc(k * n * br * sizeof(float));
+        float *l_bias = (float *)malloc(n * sizeof(float));
+        float *l_c_jit = (float *)malloc(m * n * sizeof(float));
+        float *l_c_ref = (float *)malloc(m * n * sizeof(float));
+
+        for (int i = 0; i < br * m * k; i++) {
+            l_a[i] = (float)drand48() * 2 - 1;
+        }
+        for (int i = 0; i < br * k * n; i++) {
+            l_b[i] = (float)drand48() * 2 - 1;
+        }
+        for (int i = 0; i < n; i++) {
+            l_bias[i] = (float)drand48() * 2 - 1;
+        }
+        for (int l_n = 0; l_n < n; l_n++) {
+            for (int l_m = 0; l_m < m; l_m++) {
+                l_c_jit[l_n * m + l_m] = (float)drand48() * 2 - 1;
+                l_c_ref[l_n * m + l_m] = (l_bias_type == Brgemm::bias_t::n) ? l_bias[l_n] : l_c_jit[l_n * m + l_m];
+            }
+        }
+
+        brgemm_ref(l_a, l_b, l_c_ref,
+                   m, n, k, br,
+                   m, k, m,
+                   m * k, n * k);
+        for (int i = 0; i < m * n; i++) {
+            l_c_ref[i] = Activation::reference(l_act, l_c_ref[i]);
+        }
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k, l_bias);
 
-        double l_error = 0.0;
         for (size_t i = 0; i < m * n; i++) {
-            l_error += std::abs(l_c_jit[i] - l_c_ref[i]);
             REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
         }
-        REQUIRE(l_error < 1e-4);
         free(l_a);
         free(l_b);
+        free(l_bias);
+        free(l_c_jit);
+        free(l_c_ref);
+    }
+}
+
+TEST_CASE("MiniJit::Brgemm::FP64 Tests BRGEMMs", "[MiniJit][GEMM][FP64]") {
+    srand48(time(NULL));
+
+    for (size_t l_i = 0; l_i < 400; l_i++) {
+        int64_t m = (int64_t)(drand48() * 64.0) + 1;
+        int64_t n = (int64_t)(drand48() * 32.0) + 1;
+        int64_t k = (int64_t)(drand48() * 32.0) + 1;
+        int64_t br = (int64_t)(drand48() * 4.0) + 1;
+        int64_t lda = m + (l_i % 3);
+        int64_t ldb = k + (l_i % 2);
+        int64_t ldc = m + (l_i % 5);
+        bool is_relu = (l_i % 5) == 4;
+        Brgemm::bias_t l_bias_type = static_cast<Brgemm::bias_t>(l_i % 4);
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::fp64, is_relu, l_bias_type) == Brgemm::error_t::success);
+
+        double *l_a = (double *)malloc(lda * k * br * sizeof(double));
+        double *l_b = (double *)malloc(ldb * n * br * sizeof(double));
+        double *l_bias = (double *)malloc((m + n) * sizeof(double));
+        double *l_c_jit = (double *)malloc(ldc * n * sizeof(double));
+        double *l_c_ref = (double *)malloc(ldc * n * sizeof(double));
+
+        for (int i = 0; i < br * lda * k; i++) {
+            l_a[i] = drand48() * 10 - 5;
+        }
+        for (int i = 0; i < br * ldb * n; i++) {
+            l_b[i] = drand48() * 10 - 5;
+        }
+        for (int i = 0; i < m + n; i++) {
+            l_bias[i] = drand48() * 10 - 5;
+        }
+        for (int i = 0; i < ldc * n; i++) {
+            l_c_jit[i] = drand48() * 10 - 5;
+            l_c_ref[i] = l_c_jit[i];
+        }
+
+        // rows of the padding keep their values
+        for (int l_n = 0; l_n < n; l_n++) {
+            for (int l_m = 0; l_m < m; l_m++) {
+                double l_sum = l_c_ref[l_n * ldc + l_m];
+                if (l_bias_type == Brgemm::bias_t::m) {
+                    l_sum = l_bias[l_m];
+                } else if (l_bias_type == Brgemm::bias_t::n) {
+                    l_sum = l_bias[l_n];
+                } else if (l_bias_type == Brgemm::bias_t::zero) {
+                    l_sum = 0.0;
+                }
+                for (int l_br = 0; l_br < br; l_br++) {
+                    for (int l_k = 0; l_k < k; l_k++) {
+                        l_sum += l_a[l_br * lda * k + l_k * lda + l_m] * l_b[l_br * ldb * n + l_n * ldb + l_k];
+                    }
+                }
+                l_c_ref[l_n * ldc + l_m] = is_relu ? std::max(l_sum, 0.0) : l_sum;
+            }
+        }
+
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        l_kernel(l_a, l_b, l_c_jit, lda, ldb, ldc, lda * k, ldb * n, l_bias);
+
+        // double precision accumulation
+        for (int i = 0; i < ldc * n; i++) {
+            REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 1e-10);
+        }
+        free(l_a);
+        free(l_b);
+        free(l_bias);
         free(l_c_jit);
         free(l_c_ref);
     }
-}
\ No newline at end of file
+
+    // the rational activations are single precision only
+    mini_jit::generator::Brgemm l_brgemm;
+    REQUIRE(l_brgemm.generate(8, 8, 8, 1, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::fp64, false, Brgemm::bias_t::none, Brgemm::act_t::gelu) == Brgemm::error_t::bad_param);
+}
+
+TEST_CASE("MiniJit::Brgemm::BF16 Tests BRGEMMs", "[MiniJit][GEMM][BF16]") {
+    if (!mini_jit::backend::Cpu::has_bf16()) {
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(8, 8, 8, 1, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::bf16, false, Brgemm::bias_t::none) == Brgemm::error_t::bad_param);
+        return;
+    }
+    srand48(time(NULL));
+
+    for (size_t l_i = 0; l_i < 400; l_i++) {
+        int64_t m = (int64_t)(drand48() * 64.0) + 1;
+        int64_t n = (int64_t)(drand48() * 32.0) + 1;
+        int64_t k = (int64_t)(drand48() * 32.0) + 1;
+        int64_t br = (int64_t)(drand48() * 4.0) + 1;
+        int64_t lda = m + (l_i % 3);
+        int64_t ldb = k + (l_i % 2);
+        int64_t ldc = m + (l_i % 5);
+        Brgemm::bias_t l_bias_type = static_cast<Brgemm::bias_t>(l_i % 4);
+        Brgemm::act_t l_act = (l_i % 5 == 4) ? Brgemm::act_t::relu : (l_i % 7 == 6) ? Brgemm::act_t::gelu
+                                                                                       : Brgemm::act_t::none;
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::bf16, false, l_bias_type, l_act) == Brgemm::error_t::success);
+
+        uint16_t *l_a = (uint16_t *)malloc(lda * k * br * sizeof(uint16_t));
+        uint16_t *l_b = (uint16_t *)malloc(ldb * n * br * sizeof(uint16_t));
+        float *l_bias = (float *)malloc((m + n) * sizeof(float));
+        float *l_c_jit = (float *)malloc(ldc * n * sizeof(float));
+        float *l_c_ref = (float *)malloc(ldc * n * sizeof(float));
+
+        for (int i = 0; i < br * lda * k; i++) {
+            l_a[i] = test::bf16::from_fp32((float)drand48() * 2 - 1);
+        }
+        for (int i = 0; i < br * ldb * n; i++) {
+            l_b[i] = test::bf16::from_fp32((float)drand48() * 2 - 1);
+        }
+        for (int i = 0; i < m + n; i++) {
+            l_bias[i] = (float)drand48() * 2 - 1;
+        }
+        for (int i = 0; i < ldc * n; i++) {
+            l_c_jit[i] = (float)drand48() * 2 - 1;
+            l_c_ref[i] = l_c_jit[i];
+        }
+
+        // products of bfloat16 values are exact in single precision
+        for (int l_n = 0; l_n < n; l_n++) {
+            for (int l_m = 0; l_m < m; l_m++) {
+                double l_sum = l_c_ref[l_n * ldc + l_m];
+                if (l_bias_type == Brgemm::bias_t::m) {
+                    l_sum = l_bias[l_m];
+                } else if (l_bias_type == Brgemm::bias_t::n) {
+                    l_sum = l_bias[l_n];
+                } else if (l_bias_type == Brgemm::bias_t::zero) {
+                    l_sum = 0.0;
+                }
+                for (int l_br = 0; l_br < br; l_br++) {
+                    for (int l_k = 0; l_k < k; l_k++) {
+                        l_sum += (double)test::bf16::to_fp32(l_a[l_br * lda * k + l_k * lda + l_m]) * test::bf16::to_fp32(l_b[l_br * ldb * n + l_n * ldb + l_k]);
+                    }
+                }
+                l_c_ref[l_n * ldc + l_m] = Activation::reference(l_act, (float)l_sum);
+            }
+        }
+
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        l_kernel(l_a, l_b, l_c_jit, lda, ldb, ldc, lda * k, ldb * n, l_bias);
+
+        for (int i = 0; i < ldc * n; i++) {
+            REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
+        }
+        free(l_a);
+        free(l_b);
+        free(l_bias);
+        free(l_c_jit);
+        free(l_c_ref);
+    }
+}
+
+TEST_CASE("MiniJit::Brgemm::INT8 Tests BRGEMMs", "[MiniJit][GEMM][INT8]") {
+    if (!mini_jit::backend::Cpu::has_int8()) {
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(8, 8, 8, 1, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::int8, false, Brgemm::bias_t::none) == Brgemm::error_t::bad_param);
+        return;
+    }
+    srand48(time(NULL));
+
+    // the scales are per column of C
+    mini_jit::generator::Brgemm l_brgemm_m;
+    REQUIRE(l_brgemm_m.generate(8, 8, 8, 1, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::int8, false, Brgemm::bias_t::m) == Brgemm::error_t::bad_param);
+
+    Brgemm::bias_t const l_bias_types[3] = {Brgemm::bias_t::none, Brgemm::bias_t::n, Brgemm::bias_t::zero};
+    for (size_t l_i = 0; l_i < 300; l_i++) {
+        int64_t m = (int64_t)(drand48() * 64.0) + 1;
+        int64_t n = (int64_t)(drand48() * 32.0) + 1;
+        int64_t k = (int64_t)(drand48() * 40.0) + 1;
+        int64_t br = (int64_t)(drand48() * 4.0) + 1;
+        int64_t lda = m + (l_i % 3);
+        int64_t ldb = k + (l_i % 2);
+        int64_t ldc = m + (l_i % 5);
+        Brgemm::bias_t l_bias_type = l_bias_types[l_i % 3];
+        Brgemm::act_t l_act = (l_i % 5 == 4) ? Brgemm::act_t::relu : (l_i % 7 == 6) ? Brgemm::act_t::gelu
+                                                                                       : Brgemm::act_t::none;
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::int8, false, l_bias_type, l_act) == Brgemm::error_t::success);
+
+        int8_t *l_a = (int8_t *)malloc(lda * k * br * sizeof(int8_t));
+        int8_t *l_b = (int8_t *)malloc(ldb * n * br * sizeof(int8_t));
+        float *l_scale_bias = (float *)malloc(2 * n * sizeof(float));
+        float *l_c_jit = (float *)malloc(ldc * n * sizeof(float));
+        float *l_c_ref = (float *)malloc(ldc * n * sizeof(float));
+
+        for (int i = 0; i < br * lda * k; i++) {
+            l_a[i] = (int8_t)(drand48() * 256.0 - 128.0);
+        }
+        for (int i = 0; i < br * ldb * n; i++) {
+            l_b[i] = (int8_t)(drand48() * 256.0 - 128.0);
+        }
+        for (int i = 0; i < n; i++) {
+            l_scale_bias[i] = (float)drand48() * 1e-4f;
+            l_scale_bias[n + i] = (float)drand48() * 2 - 1;
+        }
+        for (int i = 0; i < ldc * n; i++) {
+            l_c_jit[i] = (float)drand48() * 2 - 1;
+            l_c_ref[i] = l_c_jit[i];
+        }
+
+        // the integer sums are exact, the kernel rounds them once to single precision before the scaling
+        for (int l_n = 0; l_n < n; l_n++) {
+            for (int l_m = 0; l_m < m; l_m++) {
+                int64_t l_sum = 0;
+                for (int l_br = 0; l_br < br; l_br++) {
+                    for (int l_k = 0; l_k < k; l_k++) {
+                        l_sum += (int64_t)l_a[l_br * lda * k + l_k * lda + l_m] * l_b[l_br * ldb * n + l_n * ldb + l_k];
+                    }
+                }
+                double l_value = (double)l_scale_bias[l_n] * (double)l_sum;
+                if (l_bias_type == Brgemm::bias_t::none) {
+                    l_value += l_c_ref[l_n * ldc + l_m];
+                } else if (l_bias_type == Brgemm::bias_t::n) {
+                    l_value += l_scale_bias[n + l_n];
+                }
+                l_c_ref[l_n * ldc + l_m] = Activation::reference(l_act, (float)l_value);
+            }
+        }
+
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        l_kernel(l_a, l_b, l_c_jit, lda, ldb, ldc, lda * k, ldb * n, l_scale_bias);
+
+        for (int i = 0; i < ldc * n; i++) {
+            REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
+        }
+        free(l_a);
+        free(l_b);
+        free(l_scale_bias);
+        free(l_c_jit);
+        free(l_c_ref);
+    }
+}
+
+TEST_CASE("MiniJit::Brgemm::FP16 Tests BRGEMMs", "[MiniJit][GEMM][FP16]") {
+    // the rational activations are evaluated in single precision only
+    mini_jit::generator::Brgemm l_brgemm_gelu;
+    REQUIRE(l_brgemm_gelu.generate(8, 8, 8, 1, 0, 0, 0, mini_jit::generator::Brgemm::dtype_t::fp16, false, Brgemm::bias_t::none, Brgemm::act_t::gelu) == Brgemm::error_t::bad_param);
+
+    srand48(time(NULL));
+
+    for (size_t l_i = 0; l_i < 400; l_i++) {
+        // half precision accumulation (fp16) or single precision accumulation (fp16_fp32)
+        bool l_fp16_fp32 = (l_i % 2 == 1);
+        Brgemm::dtype_t l_dtype = l_fp16_fp32 ? Brgemm::dtype_t::fp16_fp32 : Brgemm::dtype_t::fp16;
+        if (!(l_fp16_fp32 ? mini_jit::backend::Cpu::has_fp16_fp32() : mini_jit::backend::Cpu::has_fp16())) {
+            mini_jit::generator::Brgemm l_brgemm;
+            REQUIRE(l_brgemm.generate(8, 8, 8, 1, 0, 0, 0, l_dtype, false, Brgemm::bias_t::none) == Brgemm::error_t::bad_param);
+            continue;
+        }
+
+        int64_t m = (int64_t)(drand48() * 64.0) + 1;
+        int64_t n = (int64_t)(drand48() * 32.0) + 1;
+        int64_t k = (int64_t)(drand48() * 24.0) + 1;
+        int64_t br = (int64_t)(drand48() * 3.0) + 1;
+        int64_t lda = m + (l_i % 3);
+        int64_t ldb = k + (l_i % 2);
+        int64_t ldc = m + (l_i % 5);
+        Brgemm::bias_t l_bias_type = static_cast<Brgemm::bias_t>((l_i / 2) % 4);
+        Brgemm::act_t l_act = (l_i % 5 == 4) ? Brgemm::act_t::relu : (l_fp16_fp32 && l_i % 7 == 6) ? Brgemm::act_t::gelu
+                                                                                                     : Brgemm::act_t::none;
+
+        mini_jit::generator::Brgemm l_brgemm;
+        REQUIRE(l_brgemm.generate(m, n, k, br, 0, 0, 0, l_dtype, false, l_bias_type, l_act) == Brgemm::error_t::success);
+
+        uint16_t *l_a = (uint16_t *)malloc(lda * k * br * sizeof(uint16_t));
+        uint16_t *l_b = (uint16_t *)malloc(ldb * n * br * sizeof(uint16_t));
+        float *l_bias = (float *)malloc((m + n) * sizeof(float));
+        float *l_c_in = (float *)malloc(ldc * n * sizeof(float));
+        float *l_c_ref = (float *)malloc(ldc * n * sizeof(float));
+        float *l_abs = (float *)malloc(ldc * n * sizeof(float));
+        // C and the bias are half precision for fp16
+        uint16_t *l_bias_fp16 = (uint16_t *)malloc((m + n) * sizeof(uint16_t));
+        uint16_t *l_c_fp16 = (uint16_t *)malloc(ldc * n * sizeof(uint16_t));
+        float *l_c_fp32 = (float *)malloc(ldc * n * sizeof(float));
+
+        for (int i = 0; i < br * lda * k; i++) {
+            l_a[i] = test::fp16::from_fp32((float)drand48() * 2 - 1);
+        }
+        for (int i = 0; i < br * ldb * n; i++) {
+            l_b[i] = test::fp16::from_fp32((float)drand48() * 2 - 1);
+        }
+        for (int i = 0; i < m + n; i++) {
+            l_bias_fp16[i] = test::fp16::from_fp32((float)drand48() * 2 - 1);
+            l_bias[i] = l_fp16_fp32 ? (float)drand48() * 2 - 1 : test::fp16::to_fp32(l_bias_fp16[i]);
+        }
+        for (int i = 0; i < ldc * n; i++) {
+            l_c_fp16[i] = test::fp16::from_fp32((float)drand48() * 2 - 1);
+            l_c_fp32[i] = l_fp16_fp32 ? (float)drand48() * 2 - 1 : test::fp16::to_fp32(l_c_fp16[i]);
+            l_c_in[i] = l_c_fp32[i];
+            l_c_ref[i] = l_c_fp32[i];
+            l_abs[i] = 0.0f;
+        }
+
+        // products of half precision values are exact in single precision
+        for (int l_n = 0; l_n < n; l_n++) {
+            for (int l_m = 0; l_m < m; l_m++) {
+                double l_sum = l_c_ref[l_n * ldc + l_m];
+                if (l_bias_type == Brgemm::bias_t::m) {
+                    l_sum = l_bias[l_m];
+                } else if (l_bias_type == Brgemm::bias_t::n) {
+                    l_sum = l_bias[l_n];
+                } else if (l_bias_type == Brgemm::bias_t::zero) {
+                    l_sum = 0.0;
+                }
+                double l_sum_abs = std::abs(l_sum);
+                for (int l_br = 0; l_br < br; l_br++) {
+                    for (int l_k = 0; l_k < k; l_k++) {
+                        double l_prod = (double)test::fp16::to_fp32(l_a[l_br * lda * k + l_k * lda + l_m]) * test::fp16::to_fp32(l_b[l_br * ldb * n + l_n * ldb + l_k]);
+                        l_sum += l_prod;
+                        l_sum_abs += std::abs(l_prod);
+                    }
+                }
+                l_c_ref[l_n * ldc + l_m] = Activation::reference(l_act, (float)l_sum);
+                l_abs[l_n * ldc + l_m] = (float)l_sum_abs;
+            }
+        }
+
+        mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
+        if (l_fp16_fp32) {
+            l_kernel(l_a, l_b, l_c_fp32, lda, ldb, ldc, lda * k, ldb * n, l_bias);
+        } else {
+            l_kernel(l_a, l_b, l_c_fp16, lda, ldb, ldc, lda * k, ldb * n, l_bias_fp16);
+        }
+
+        for (int l_n = 0; l_n < n; l_n++) {
+            for (int l_m = 0; l_m < ldc; l_m++) {
+                int i = l_n * ldc + l_m;
+                if (l_fp16_fp32) {
+                    REQUIRE(std::abs(l_c_fp32[i] - l_c_ref[i]) < 0.0001);
+                } else if (l_m < m) {
+                    // every FMA rounds to half precision, the error bound grows with the number of terms
+                    float l_jit = test::fp16::to_fp32(l_c_fp16[i]);
+                    REQUIRE(std::abs(l_jit - l_c_ref[i]) <= 0.0005f * (k * br + 1) * (1.0f + l_abs[i]));
+                } else {
+                    // padding rows are left untouched
+                    REQUIRE(test::fp16::to_fp32(l_c_fp16[i]) == l_c_in[i]);
+                }
+            }
+        }
+        free(l_a);
+        free(l_b);
+        free(l_bias);
+        free(l_c_in);
+        free(l_c_ref);
+        free(l_abs);
+        free(l_bias_fp16);
+        free(l_c_fp16);
+        free(l_c_fp32);
+    }
+}
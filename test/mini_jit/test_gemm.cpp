@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
@@ -42,14 +43,12 @@ TEST_CASE("MiniJit::Brgemm::FP32 Test all GEMMs", "[MiniJit][GEMM][FP32]") {
                          m, n, k,
                          m, k, m);
                 mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
-                l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0);
+                l_kernel(l_a, l_b, l_c_jit, m, k, m, 0, 0, nullptr);
 
-                double l_error = 0.0;
+                // the summation order differs between the ISAs, compare relative to the magnitude of C
                 for (size_t i = 0; i < m * n; i++) {
-                    l_error += std::abs(l_c_jit[i] - l_c_ref[i]);
-                    REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
+                    REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 1e-4 * std::max(1.0f, std::abs(l_c_ref[i])));
                 }
-                REQUIRE(l_error < 1e-3);
                 free(l_a);
                 free(l_b);
                 free(l_c_jit);
@@ -93,14 +92,12 @@ TEST_CASE("MiniJit::Brgemm::FP32 Test bigger LD", "[MiniJit][GEMM][FP32]") {
                          m, n, k,
                          l_lda, l_ldb, l_ldc);
                 mini_jit::generator::Brgemm::kernel_t l_kernel = l_brgemm.get_kernel();
-                l_kernel(l_a, l_b, l_c_jit, l_lda, l_ldb, l_ldc, 0, 0);
+                l_kernel(l_a, l_b, l_c_jit, l_lda, l_ldb, l_ldc, 0, 0, nullptr);
 
-                double l_error = 0.0;
+                // the summation order differs between the ISAs, compare relative to the magnitude of C
                 for (size_t i = 0; i < m * n; i++) {
-                    l_error += std::abs(l_c_jit[i] - l_c_ref[i]);
-                    REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
+                    REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 1e-4 * std::max(1.0f, std::abs(l_c_ref[i])));
                 }
-                REQUIRE(l_error < 1e-4);
                 free(l_a);
                 free(l_b);
                 free(l_c_jit);
@@ -11,6 +11,15 @@
 
 using namespace mini_jit::instructions;
 
+#if defined(__x86_64__)
+// cross binutils, e.g., of the package binutils-aarch64-linux-gnu
+#define AS_AARCH64 "aarch64-linux-gnu-as"
+#define OBJCOPY_AARCH64 "aarch64-linux-gnu-objcopy"
+#else
+#define AS_AARCH64 "as"
+#define OBJCOPY_AARCH64 "objcopy"
+#endif
+
 uint32_t as(const std::string& instruction) {
     // write the instruction to a temporary assembly file
     std::ofstream asmFile("temp.s");
@@ -18,12 +27,12 @@ uint32_t as(const std::string& instruction) {
     asmFile.close();
 
     // assemble it to an object file
-    if (system("as temp.s -o temp.o") != 0) {
+    if (system(AS_AARCH64 " temp.s -o temp.o") != 0) {
         throw std::runtime_error("Assembly failed");
     }
 
     // extract raw binary
-    if (system("objcopy -O binary temp.o temp.bin") != 0) {
+    if (system(OBJCOPY_AARCH64 " -O binary temp.o temp.bin") != 0) {
         throw std::runtime_error("Objcopy failed");
     }
 
@@ -120,6 +129,11 @@ TEST_CASE("MiniJit::Instructions::Encoding::base_lsl_imm", "[MiniJit][Instructio
     std::string call = "lsl w1, w2, #0";
     uint32_t mc2 = as(call);
     REQUIRE(mc1 == mc2);
+
+    mc1 = InstGen::base_lsl_imm(InstGen::gpr_t::x3, InstGen::gpr_t::x4, 2);
+    call = "lsl x3, x4, #2";
+    mc2 = as(call);
+    REQUIRE(mc1 == mc2);
 }
 
 TEST_CASE("MiniJit::Instructions::Encoding::base_lsl_register", "[MiniJit][Instructions][Encoding]") {
@@ -135,3 +149,101 @@ TEST_CASE("MiniJit::Instructions::Encoding::base_br_cbnz", "[MiniJit][Instructio
     uint32_t mc2 = as(call);
     REQUIRE(mc1 == mc2);
 }
+
+TEST_CASE("MiniJit::Instructions::Encoding::base_b_cond", "[MiniJit][Instructions][Encoding]") {
+    uint32_t mc1 = InstGen::base_b_cond(InstGen::cond_t::mi, 2);
+    std::string call = "b.mi 0x00000008";
+    uint32_t mc2 = as(call);
+    REQUIRE(mc1 == mc2);
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::base_prfm", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::base_prfm_imm(InstGen::prfop_t::pldl2keep, InstGen::x15, 64) == as("prfm pldl2keep, [x15, #64]"));
+    REQUIRE(InstGen::base_prfm_register(InstGen::prfop_t::pldl1keep, InstGen::x7, InstGen::x6) == as("prfm pldl1keep, [x7, x6]"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::base_ldr_str", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::base_ldr_imm(InstGen::x28, InstGen::sp, 144) == as("ldr x28, [sp, #144]"));
+    REQUIRE(InstGen::base_str_imm(InstGen::x15, InstGen::sp, 144) == as("str x15, [sp, #144]"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::base_b_adr", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::base_b(65) == as("b #260"));
+    REQUIRE(InstGen::base_adr(InstGen::x14, 8) == as("adr x14, #8"));
+    REQUIRE(InstGen::base_blr(InstGen::x16) == as("blr x16"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::neon_ld1r", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::neon_ld1r(InstGen::v5, InstGen::x28) == as("ld1r {v5.4s}, [x28]"));
+    REQUIRE(InstGen::neon_ldr_q_imm(InstGen::v29, InstGen::x14, 48) == as("ldr q29, [x14, #48]"));
+    REQUIRE(InstGen::neon_ld1r(InstGen::v7, InstGen::x15, true) == as("ld1r {v7.2d}, [x15]"));
+    REQUIRE(InstGen::neon_ldr_imm(InstGen::v3, InstGen::x10, 48, InstGen::q) == as("ldr q3, [x10, #48]"));
+    REQUIRE(InstGen::neon_ldr_imm(InstGen::v30, InstGen::x10, 40, InstGen::d) == as("ldr d30, [x10, #40]"));
+    REQUIRE(InstGen::neon_str_imm(InstGen::v17, InstGen::x15, 32, InstGen::q) == as("str q17, [x15, #32]"));
+    REQUIRE(InstGen::neon_str_imm(InstGen::v2, InstGen::x15, 8, InstGen::d) == as("str d2, [x15, #8]"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::neon_arithmetic", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::neon_fmin_vector(InstGen::v1, InstGen::v2, InstGen::v3, false) == as("fmin v1.4s, v2.4s, v3.4s"));
+    REQUIRE(InstGen::neon_fadd_vector(InstGen::v28, InstGen::v28, InstGen::v31, false) == as("fadd v28.4s, v28.4s, v31.4s"));
+    REQUIRE(InstGen::neon_fmul_vector(InstGen::v0, InstGen::v29, InstGen::v30, false) == as("fmul v0.4s, v29.4s, v30.4s"));
+    REQUIRE(InstGen::neon_fdiv_vector(InstGen::v7, InstGen::v29, InstGen::v30, false) == as("fdiv v7.4s, v29.4s, v30.4s"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::sve", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::sve_ptrue(InstGen::p2) == as(".arch_extension sve\n    ptrue p2.s"));
+    REQUIRE(InstGen::sve_whilelt(InstGen::p1, InstGen::x15, InstGen::x9) == as(".arch_extension sve\n    whilelt p1.s, x15, x9"));
+    REQUIRE(InstGen::sve_incw(InstGen::x8, 2) == as(".arch_extension sve\n    incw x8, all, mul #2"));
+    REQUIRE(InstGen::sve_ld1w(InstGen::v3, InstGen::p1, InstGen::x10, 1) == as(".arch_extension sve\n    ld1w {z3.s}, p1/z, [x10, #1, mul vl]"));
+    REQUIRE(InstGen::sve_st1w(InstGen::v3, InstGen::p1, InstGen::x15, -1) == as(".arch_extension sve\n    st1w {z3.s}, p1, [x15, #-1, mul vl]"));
+    REQUIRE(InstGen::sve_ld1rw(InstGen::v30, InstGen::p2, InstGen::x19, 12) == as(".arch_extension sve\n    ld1rw {z30.s}, p2/z, [x19, #12]"));
+    REQUIRE(InstGen::sve_fmla(InstGen::v5, InstGen::p1, InstGen::v28, InstGen::v30) == as(".arch_extension sve\n    fmla z5.s, p1/m, z28.s, z30.s"));
+    REQUIRE(InstGen::sve_fmax_zero(InstGen::v5, InstGen::p2) == as(".arch_extension sve\n    fmax z5.s, p2/m, z5.s, #0.0"));
+    REQUIRE(InstGen::sve_dup_zero(InstGen::v5) == as(".arch_extension sve\n    dup z5.s, #0"));
+    REQUIRE(InstGen::sve_fadd(InstGen::v24, InstGen::v25, InstGen::v27) == as(".arch_extension sve\n    fadd z24.s, z25.s, z27.s"));
+    REQUIRE(InstGen::sve_fmul(InstGen::v24, InstGen::v3, InstGen::v27) == as(".arch_extension sve\n    fmul z24.s, z3.s, z27.s"));
+    REQUIRE(InstGen::sve_fmin(InstGen::v24, InstGen::p2, InstGen::v27) == as(".arch_extension sve\n    fmin z24.s, p2/m, z24.s, z27.s"));
+    REQUIRE(InstGen::sve_fmax(InstGen::v24, InstGen::p2, InstGen::v27) == as(".arch_extension sve\n    fmax z24.s, p2/m, z24.s, z27.s"));
+    REQUIRE(InstGen::sve_fdiv(InstGen::v25, InstGen::p2, InstGen::v26) == as(".arch_extension sve\n    fdiv z25.s, p2/m, z25.s, z26.s"));
+    REQUIRE(InstGen::sve_mov(InstGen::v7, InstGen::v25) == as(".arch_extension sve\n    mov z7.d, z25.d"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::neon_bf16", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::neon_bfmmla(InstGen::v3, InstGen::v24, InstGen::v20) == as(".arch_extension bf16\n    bfmmla v3.4s, v24.8h, v20.8h"));
+    REQUIRE(InstGen::neon_bfcvtn(InstGen::v2, InstGen::v0, false) == as(".arch_extension bf16\n    bfcvtn v2.4h, v0.4s"));
+    REQUIRE(InstGen::neon_bfcvtn(InstGen::v2, InstGen::v1, true) == as(".arch_extension bf16\n    bfcvtn2 v2.8h, v1.4s"));
+    REQUIRE(InstGen::neon_shll(InstGen::v1, InstGen::v0, false) == as("shll v1.4s, v0.4h, #16"));
+    REQUIRE(InstGen::neon_shll(InstGen::v2, InstGen::v0, true) == as("shll2 v2.4s, v0.8h, #16"));
+    REQUIRE(InstGen::neon_zip(InstGen::v28, InstGen::v24, InstGen::v25, 1, InstGen::h) == as("zip1 v28.8h, v24.8h, v25.8h"));
+    REQUIRE(InstGen::neon_zip(InstGen::v29, InstGen::v28, InstGen::v30, 2, InstGen::s) == as("zip2 v29.4s, v28.4s, v30.4s"));
+    REQUIRE(InstGen::neon_zip(InstGen::v2, InstGen::v0, InstGen::v1, 1) == as("zip1 v2.2d, v0.2d, v1.2d"));
+    REQUIRE(InstGen::neon_uzp(InstGen::v28, InstGen::v4, InstGen::v5, 1, InstGen::s) == as("uzp1 v28.4s, v4.4s, v5.4s"));
+    REQUIRE(InstGen::neon_uzp(InstGen::v29, InstGen::v4, InstGen::v5, 2, InstGen::s) == as("uzp2 v29.4s, v4.4s, v5.4s"));
+    REQUIRE(InstGen::neon_ld1_h_index(InstGen::v24, InstGen::x15, 5) == as("ld1 {v24.h}[5], [x15]"));
+    REQUIRE(InstGen::neon_st1_h_index(InstGen::v28, InstGen::x15, 2) == as("st1 {v28.h}[2], [x15]"));
+    REQUIRE(InstGen::neon_ldr_imm(InstGen::v24, InstGen::x10, 6, InstGen::h) == as("ldr h24, [x10, #6]"));
+    REQUIRE(InstGen::neon_str_imm(InstGen::v24, InstGen::x10, 12, InstGen::s) == as("str s24, [x10, #12]"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::neon_int8", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::neon_smmla(InstGen::v3, InstGen::v20, InstGen::v28) == as(".arch_extension i8mm\n    smmla v3.4s, v20.16b, v28.16b"));
+    REQUIRE(InstGen::neon_scvtf(InstGen::v5, InstGen::v5) == as("scvtf v5.4s, v5.4s"));
+    REQUIRE(InstGen::neon_ld1_b_index(InstGen::v16, InstGen::x17, 13) == as("ld1 {v16.b}[13], [x17]"));
+    REQUIRE(InstGen::neon_ld1_b_index(InstGen::v16, InstGen::x17, 6) == as("ld1 {v16.b}[6], [x17]"));
+    REQUIRE(InstGen::neon_zip(InstGen::v24, InstGen::v16, InstGen::v17, 1, InstGen::b) == as("zip1 v24.16b, v16.16b, v17.16b"));
+    REQUIRE(InstGen::neon_ldr_imm(InstGen::v28, InstGen::x19, 3, InstGen::b) == as("ldr b28, [x19, #3]"));
+}
+
+TEST_CASE("MiniJit::Instructions::Encoding::neon_fp16", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGen::neon_fmla_element_h(InstGen::v2, InstGen::v24, InstGen::v0, 0) == as(".arch_extension fp16\n    fmla v2.8h, v24.8h, v0.h[0]"));
+    REQUIRE(InstGen::neon_fmla_element_h(InstGen::v2, InstGen::v24, InstGen::v1, 5) == as(".arch_extension fp16\n    fmla v2.8h, v24.8h, v1.h[5]"));
+    REQUIRE(InstGen::neon_fmla_element_h(InstGen::v23, InstGen::v27, InstGen::v15, 7) == as(".arch_extension fp16\n    fmla v23.8h, v27.8h, v15.h[7]"));
+    REQUIRE(InstGen::neon_fmlal_element(InstGen::v3, InstGen::v25, InstGen::v1, 3, false) == as(".arch_extension fp16fml\n    fmlal v3.4s, v25.4h, v1.h[3]"));
+    REQUIRE(InstGen::neon_fmlal_element(InstGen::v2, InstGen::v24, InstGen::v15, 7, true) == as(".arch_extension fp16fml\n    fmlal2 v2.4s, v24.4h, v15.h[7]"));
+    REQUIRE(InstGen::neon_fmax_vector_h(InstGen::v2, InstGen::v3, InstGen::v4) == as(".arch_extension fp16\n    fmax v2.8h, v3.8h, v4.8h"));
+    REQUIRE(InstGen::neon_ld1r_h(InstGen::v2, InstGen::x5) == as("ld1r {v2.8h}, [x5]"));
+    REQUIRE(InstGen::neon_fcvtl(InstGen::v1, InstGen::v0, false) == as("fcvtl v1.4s, v0.4h"));
+    REQUIRE(InstGen::neon_fcvtl(InstGen::v1, InstGen::v0, true) == as("fcvtl2 v1.4s, v0.8h"));
+    REQUIRE(InstGen::neon_fcvtn(InstGen::v2, InstGen::v0, false) == as("fcvtn v2.4h, v0.4s"));
+    REQUIRE(InstGen::neon_fcvtn(InstGen::v2, InstGen::v1, true) == as("fcvtn2 v2.8h, v1.4s"));
+}
@@ -0,0 +1,129 @@
+#if defined(__x86_64__)
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../../src/mini_jit/instructions/instructions_x86.h"
+
+using namespace mini_jit::instructions;
+
+static std::vector<uint8_t> as_x86(const std::string& instruction) {
+    // write the instruction to a temporary assembly file
+    std::ofstream asmFile("temp_x86.s");
+    asmFile << ".intel_syntax noprefix\n.text\n.global _start\n_start:\n    " << instruction << "\n";
+    asmFile.close();
+
+    // assemble it to an object file
+    if (system("as temp_x86.s -o temp_x86.o") != 0) {
+        throw std::runtime_error("Assembly failed");
+    }
+
+    // extract raw binary
+    if (system("objcopy -O binary temp_x86.o temp_x86.bin") != 0) {
+        throw std::runtime_error("Objcopy failed");
+    }
+
+    std::ifstream binFile("temp_x86.bin", std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(binFile),
+                                std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("MiniJit::Instructions::EncodingX86::base", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGenX86::base_push(InstGenX86::r12) == as_x86("push r12"));
+    REQUIRE(InstGenX86::base_pop(InstGenX86::rbx) == as_x86("pop rbx"));
+    REQUIRE(InstGenX86::base_mov_register(InstGenX86::r11, InstGenX86::rdi) == as_x86("mov r11, rdi"));
+    REQUIRE(InstGenX86::base_mov_imm64(InstGenX86::r14, 0x123456789abcdef0) == as_x86("movabs r14, 0x123456789abcdef0"));
+    REQUIRE(InstGenX86::base_call(InstGenX86::rax) == as_x86("call rax"));
+    REQUIRE(InstGenX86::base_call(InstGenX86::r11) == as_x86("call r11"));
+    REQUIRE(InstGenX86::base_mov_load(InstGenX86::rax, InstGenX86::mem(InstGenX86::rsp, 152)) == as_x86("mov rax, [rsp + 152]"));
+    REQUIRE(InstGenX86::base_mov_store(InstGenX86::mem(InstGenX86::rsp, 8), InstGenX86::r13) == as_x86("mov [rsp + 8], r13"));
+    REQUIRE(InstGenX86::base_mov_store32(InstGenX86::mem(InstGenX86::rsp, 228), InstGenX86::r11) == as_x86("mov dword ptr [rsp + 228], r11d"));
+    REQUIRE(InstGenX86::base_lea(InstGenX86::r10, InstGenX86::mem(InstGenX86::r8, InstGenX86::r8, 2)) == as_x86("lea r10, [r8 + r8 * 2]"));
+    REQUIRE(InstGenX86::base_add_register(InstGenX86::rsi, InstGenX86::r8) == as_x86("add rsi, r8"));
+    REQUIRE(InstGenX86::base_sub_imm(InstGenX86::rsp, 96) == as_x86("sub rsp, 96"));
+    REQUIRE(InstGenX86::base_shl_imm(InstGenX86::rcx, 2) == as_x86("shl rcx, 2"));
+    REQUIRE(InstGenX86::base_prefetch(InstGenX86::mem(InstGenX86::r11, InstGenX86::rcx, 8)) == as_x86("prefetcht0 [r11 + rcx * 8]"));
+    REQUIRE(InstGenX86::base_prefetch(InstGenX86::mem(InstGenX86::rax, 64), true) == as_x86("prefetcht1 [rax + 64]"));
+}
+
+TEST_CASE("MiniJit::Instructions::EncodingX86::avx", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGenX86::avx_vmovups_load(InstGenX86::v3, InstGenX86::mem(InstGenX86::r11, 32)) == as_x86("vmovups ymm3, [r11 + 32]"));
+    REQUIRE(InstGenX86::avx_vmovups_store(InstGenX86::mem(InstGenX86::r9), InstGenX86::v12) == as_x86("vmovups [r9], ymm12"));
+    REQUIRE(InstGenX86::avx_vbroadcastss(InstGenX86::v14, InstGenX86::mem(InstGenX86::r12, InstGenX86::r8, 2)) == as_x86("vbroadcastss ymm14, dword ptr [r12 + r8 * 2]"));
+    REQUIRE(InstGenX86::avx_vfmadd231ps(InstGenX86::v0, InstGenX86::v13, InstGenX86::v14) == as_x86("vfmadd231ps ymm0, ymm13, ymm14"));
+    REQUIRE(InstGenX86::avx_vmaskmovps_load(InstGenX86::v1, InstGenX86::v15, InstGenX86::mem(InstGenX86::rax)) == as_x86("vmaskmovps ymm1, ymm15, [rax]"));
+    REQUIRE(InstGenX86::avx_vminps(InstGenX86::v12, InstGenX86::v0, InstGenX86::v15) == as_x86("vminps ymm12, ymm0, ymm15"));
+    REQUIRE(InstGenX86::avx_vaddps(InstGenX86::v12, InstGenX86::v12, InstGenX86::v13) == as_x86("vaddps ymm12, ymm12, ymm13"));
+    REQUIRE(InstGenX86::avx_vmulps(InstGenX86::v9, InstGenX86::v9, InstGenX86::v12) == as_x86("vmulps ymm9, ymm9, ymm12"));
+    REQUIRE(InstGenX86::avx_vdivps(InstGenX86::v0, InstGenX86::v13, InstGenX86::v14) == as_x86("vdivps ymm0, ymm13, ymm14"));
+    REQUIRE(InstGenX86::avx_vmovsd_load(InstGenX86::v2, InstGenX86::mem(InstGenX86::r10, 8)) == as_x86("vmovsd xmm2, qword ptr [r10 + 8]"));
+    REQUIRE(InstGenX86::avx_vmovsd_store(InstGenX86::mem(InstGenX86::rsi, InstGenX86::rcx, 1), InstGenX86::v9) == as_x86("vmovsd qword ptr [rsi + rcx], xmm9"));
+    REQUIRE(InstGenX86::avx_vbroadcastsd(InstGenX86::v14, InstGenX86::mem(InstGenX86::r12, InstGenX86::r8, 2)) == as_x86("vbroadcastsd ymm14, qword ptr [r12 + r8 * 2]"));
+    REQUIRE(InstGenX86::avx_vfmadd231pd(InstGenX86::v0, InstGenX86::v13, InstGenX86::v14) == as_x86("vfmadd231pd ymm0, ymm13, ymm14"));
+    REQUIRE(InstGenX86::avx_vfmadd231pd(InstGenX86::v11, InstGenX86::v1, InstGenX86::v2) == as_x86("vfmadd231pd ymm11, ymm1, ymm2"));
+    REQUIRE(InstGenX86::avx_vmaxpd(InstGenX86::v3, InstGenX86::v3, InstGenX86::v15) == as_x86("vmaxpd ymm3, ymm3, ymm15"));
+    REQUIRE(InstGenX86::avx_vgatherdps(InstGenX86::v4, InstGenX86::vsib(InstGenX86::r11, InstGenX86::v5, 1), InstGenX86::v7) == as_x86("vgatherdps ymm4, [r11 + ymm5], ymm7"));
+    REQUIRE(InstGenX86::avx_vgatherdps(InstGenX86::v9, InstGenX86::vsib(InstGenX86::rax, InstGenX86::v12, 4, 8), InstGenX86::v10) == as_x86("vgatherdps ymm9, [rax + ymm12 * 4 + 8], ymm10"));
+}
+
+TEST_CASE("MiniJit::Instructions::EncodingX86::avx512", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGenX86::avx512_kmovw(InstGenX86::k1, InstGenX86::rax) == as_x86("kmovw k1, eax"));
+    REQUIRE(InstGenX86::avx512_kmovw_mask(InstGenX86::k3, InstGenX86::k4) == as_x86("kmovw k3, k4"));
+    REQUIRE(InstGenX86::avx512_vgatherdps(InstGenX86::v28, InstGenX86::vsib(InstGenX86::r11, InstGenX86::v30, 1), InstGenX86::k3) == as_x86("vgatherdps zmm28{k3}, [r11 + zmm30]"));
+    REQUIRE(InstGenX86::avx512_vgatherdps(InstGenX86::v2, InstGenX86::vsib(InstGenX86::r11, InstGenX86::v9, 1, 8), InstGenX86::k3) == as_x86("vgatherdps zmm2{k3}, [r11 + zmm9 + 8]"));
+    REQUIRE(InstGenX86::avx512_vmovups_load(InstGenX86::v20, InstGenX86::mem(InstGenX86::r11, 128), InstGenX86::k1) == as_x86("vmovups zmm20{k1}{z}, [r11 + 128]"));
+    REQUIRE(InstGenX86::avx512_vmovups_store(InstGenX86::mem(InstGenX86::rdx, 64), InstGenX86::v31, InstGenX86::k1) == as_x86("vmovups [rdx + 64]{k1}, zmm31"));
+    REQUIRE(InstGenX86::avx512_vbroadcastss(InstGenX86::v30, InstGenX86::mem(InstGenX86::r13, 4)) == as_x86("vbroadcastss zmm30, dword ptr [r13 + 4]"));
+    REQUIRE(InstGenX86::avx512_vfmadd231ps(InstGenX86::v17, InstGenX86::v28, InstGenX86::v30) == as_x86("vfmadd231ps zmm17, zmm28, zmm30"));
+    REQUIRE(InstGenX86::avx512_vmaxps(InstGenX86::v5, InstGenX86::v5, InstGenX86::v31) == as_x86("vmaxps zmm5, zmm5, zmm31"));
+    REQUIRE(InstGenX86::avx512_vminps(InstGenX86::v28, InstGenX86::v5, InstGenX86::v31) == as_x86("vminps zmm28, zmm5, zmm31"));
+    REQUIRE(InstGenX86::avx512_vaddps(InstGenX86::v28, InstGenX86::v28, InstGenX86::v30) == as_x86("vaddps zmm28, zmm28, zmm30"));
+    REQUIRE(InstGenX86::avx512_vmulps(InstGenX86::v3, InstGenX86::v3, InstGenX86::v28) == as_x86("vmulps zmm3, zmm3, zmm28"));
+    REQUIRE(InstGenX86::avx512_vdivps(InstGenX86::v17, InstGenX86::v29, InstGenX86::v30) == as_x86("vdivps zmm17, zmm29, zmm30"));
+    REQUIRE(InstGenX86::avx512_vbroadcastsd(InstGenX86::v30, InstGenX86::mem(InstGenX86::r13, 8)) == as_x86("vbroadcastsd zmm30, qword ptr [r13 + 8]"));
+    REQUIRE(InstGenX86::avx512_vfmadd231pd(InstGenX86::v17, InstGenX86::v28, InstGenX86::v30) == as_x86("vfmadd231pd zmm17, zmm28, zmm30"));
+    REQUIRE(InstGenX86::avx512_vmaxpd(InstGenX86::v5, InstGenX86::v5, InstGenX86::v31) == as_x86("vmaxpd zmm5, zmm5, zmm31"));
+}
+
+TEST_CASE("MiniJit::Instructions::EncodingX86::avx512_bf16", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGenX86::avx512_vdpbf16ps(InstGenX86::v17, InstGenX86::v28, InstGenX86::v30) == as_x86("vdpbf16ps zmm17, zmm28, zmm30"));
+    REQUIRE(InstGenX86::avx512_vcvtneps2bf16(InstGenX86::v1, InstGenX86::v20) == as_x86("vcvtneps2bf16 ymm1, zmm20"));
+    REQUIRE(InstGenX86::avx512_vpmovzxwd_load(InstGenX86::v28, InstGenX86::mem(InstGenX86::r10, 64), InstGenX86::k1) == as_x86("vpmovzxwd zmm28{k1}{z}, ymmword ptr [r10 + 64]"));
+    REQUIRE(InstGenX86::avx512_vpmovzxwd_load(InstGenX86::v29, InstGenX86::mem(InstGenX86::r10, InstGenX86::rcx, 1, 32)) == as_x86("vpmovzxwd zmm29, ymmword ptr [r10 + rcx + 32]"));
+    REQUIRE(InstGenX86::avx512_vpmovzxwd(InstGenX86::v2, InstGenX86::v1) == as_x86("vpmovzxwd zmm2, ymm1"));
+    REQUIRE(InstGenX86::avx512_vpmovdw_store(InstGenX86::mem(InstGenX86::rsi, 96), InstGenX86::v2, InstGenX86::k1) == as_x86("vpmovdw ymmword ptr [rsi + 96]{k1}, zmm2"));
+    REQUIRE(InstGenX86::avx512_vpbroadcastw(InstGenX86::v30, InstGenX86::mem(InstGenX86::r13, 2)) == as_x86("vpbroadcastw zmm30, word ptr [r13 + 2]"));
+    REQUIRE(InstGenX86::avx512_vpslld_imm(InstGenX86::v29, InstGenX86::v29, 16) == as_x86("vpslld zmm29, zmm29, 16"));
+    REQUIRE(InstGenX86::avx512_vpord(InstGenX86::v28, InstGenX86::v28, InstGenX86::v29) == as_x86("vpord zmm28, zmm28, zmm29"));
+}
+
+TEST_CASE("MiniJit::Instructions::EncodingX86::avx512_int8", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGenX86::avx512_vpdpbusd(InstGenX86::v3, InstGenX86::v24, InstGenX86::v30) == as_x86("vpdpbusd zmm3, zmm24, zmm30"));
+    REQUIRE(InstGenX86::avx512_vpmovzxbd_load(InstGenX86::v24, InstGenX86::mem(InstGenX86::r11, 16), InstGenX86::k1) == as_x86("vpmovzxbd zmm24{k1}{z}, xmmword ptr [r11 + 16]"));
+    REQUIRE(InstGenX86::avx512_vpmovzxbd_load(InstGenX86::v25, InstGenX86::mem(InstGenX86::r11, InstGenX86::rcx, 2, 32)) == as_x86("vpmovzxbd zmm25, xmmword ptr [r11 + 2*rcx + 32]"));
+    REQUIRE(InstGenX86::avx512_vmovdqu8_load(InstGenX86::v29, InstGenX86::mem(InstGenX86::r13, InstGenX86::r8, 4), InstGenX86::k2) == as_x86("vmovdqu8 zmm29{k2}{z}, zmmword ptr [r13 + 4*r8]"));
+    REQUIRE(InstGenX86::avx512_vpbroadcastd(InstGenX86::v30, InstGenX86::v29) == as_x86("vpbroadcastd zmm30, xmm29"));
+    REQUIRE(InstGenX86::avx512_vcvtdq2ps(InstGenX86::v4, InstGenX86::v4) == as_x86("vcvtdq2ps zmm4, zmm4"));
+    REQUIRE(InstGenX86::avx512_vpsubd(InstGenX86::v17, InstGenX86::v17, InstGenX86::v31) == as_x86("vpsubd zmm17, zmm17, zmm31"));
+}
+
+TEST_CASE("MiniJit::Instructions::EncodingX86::avx512_fp16", "[MiniJit][Instructions][Encoding]") {
+    REQUIRE(InstGenX86::avx512_kmovd(InstGenX86::k1, InstGenX86::rax) == as_x86("kmovd k1, eax"));
+    REQUIRE(InstGenX86::avx512_kmovd(InstGenX86::k2, InstGenX86::r11) == as_x86("kmovd k2, r11d"));
+    REQUIRE(InstGenX86::avx512_vmovdqu16_load(InstGenX86::v3, InstGenX86::mem(InstGenX86::r11, 64), InstGenX86::k1) == as_x86("vmovdqu16 zmm3{k1}{z}, zmmword ptr [r11 + 64]"));
+    REQUIRE(InstGenX86::avx512_vmovdqu16_load(InstGenX86::v17, InstGenX86::mem(InstGenX86::rax)) == as_x86("vmovdqu16 zmm17, zmmword ptr [rax]"));
+    REQUIRE(InstGenX86::avx512_vmovdqu16_store(InstGenX86::mem(InstGenX86::r9, 128), InstGenX86::v3, InstGenX86::k1) == as_x86("vmovdqu16 zmmword ptr [r9 + 128]{k1}, zmm3"));
+    REQUIRE(InstGenX86::avx512_vfmadd231ph(InstGenX86::v0, InstGenX86::v1, InstGenX86::v2) == as_x86("vfmadd231ph zmm0, zmm1, zmm2"));
+    REQUIRE(InstGenX86::avx512_vfmadd231ph(InstGenX86::v9, InstGenX86::v17, InstGenX86::v30) == as_x86("vfmadd231ph zmm9, zmm17, zmm30"));
+    REQUIRE(InstGenX86::avx512_vmaxph(InstGenX86::v20, InstGenX86::v2, InstGenX86::v31) == as_x86("vmaxph zmm20, zmm2, zmm31"));
+    REQUIRE(InstGenX86::avx512_vcvtph2ps_load(InstGenX86::v5, InstGenX86::mem(InstGenX86::r11, 32), InstGenX86::k1) == as_x86("vcvtph2ps zmm5{k1}{z}, ymmword ptr [r11 + 32]"));
+    REQUIRE(InstGenX86::avx512_vcvtph2ps(InstGenX86::v7, InstGenX86::v7) == as_x86("vcvtph2ps zmm7, ymm7"));
+    REQUIRE(InstGenX86::avx512_vcvtps2ph_store(InstGenX86::mem(InstGenX86::rax, 32), InstGenX86::v3, InstGenX86::k1) == as_x86("vcvtps2ph ymmword ptr [rax + 32]{k1}, zmm3, 0"));
+}
+
+#endif
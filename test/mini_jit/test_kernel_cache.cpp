@@ -0,0 +1,392 @@
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "../../src/mini_jit/generator/KernelCache.h"
+#include "../../src/mini_jit/include/gemm_ref.h"
+
+using namespace mini_jit::generator;
+
+TEST_CASE("MiniJit::KernelCache::Reuses kernels with the same signature", "[MiniJit][KernelCache]") {
+    KernelCache::clear();
+
+    Brgemm::kernel_t l_kernel_0 = KernelCache::get_brgemm(16, 4, 8, 2, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+    Brgemm::kernel_t l_kernel_1 = KernelCache::get_brgemm(16, 4, 8, 2, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+    Brgemm::kernel_t l_kernel_relu = KernelCache::get_brgemm(16, 4, 8, 2, 0, 0, 0, Brgemm::dtype_t::fp32, true);
+
+    REQUIRE(l_kernel_0 != nullptr);
+    REQUIRE(l_kernel_0 == l_kernel_1);
+    REQUIRE(l_kernel_0 != l_kernel_relu);
+
+    Unary::kernel_t l_unary_0 = KernelCache::get_unary(16, 4, Unary::dtype_t::fp32, Unary::ptype_t::identity);
+    Unary::kernel_t l_unary_1 = KernelCache::get_unary(16, 4, Unary::dtype_t::fp32, Unary::ptype_t::identity);
+    Unary::kernel_t l_unary_zero = KernelCache::get_unary(16, 4, Unary::dtype_t::fp32, Unary::ptype_t::zero);
+
+    REQUIRE(l_unary_0 != nullptr);
+    REQUIRE(l_unary_0 == l_unary_1);
+    REQUIRE(l_unary_0 != l_unary_zero);
+
+    REQUIRE(KernelCache::size() == 4);
+
+    // unsupported parameters are not cached
+    REQUIRE(KernelCache::get_brgemm(16, 4, 8, 2, 1, 0, 0, Brgemm::dtype_t::fp64, false) == nullptr);
+    REQUIRE(KernelCache::size() == 4);
+
+    KernelCache::clear();
+    REQUIRE(KernelCache::size() == 0);
+}
+
+TEST_CASE("MiniJit::KernelCache::Packs a batch of kernels into the code arena", "[MiniJit][KernelCache]") {
+    KernelCache::clear();
+    REQUIRE(KernelCache::code_size() == 0);
+
+    Unary::kernel_t l_zero = nullptr;
+    Unary::kernel_t l_identity = nullptr;
+    {
+        KernelCache::Batch l_batch;
+        l_zero = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::zero);
+        l_identity = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::identity);
+    }
+    REQUIRE(l_zero != nullptr);
+    REQUIRE(l_identity != nullptr);
+
+    // both kernels share one page
+    uintptr_t l_page_size = sysconf(_SC_PAGESIZE);
+    std::size_t l_code_size = KernelCache::code_size();
+    REQUIRE(l_code_size > 0);
+    REQUIRE(l_code_size <= l_page_size);
+    REQUIRE(reinterpret_cast<uintptr_t>(l_zero) / l_page_size == reinterpret_cast<uintptr_t>(l_identity) / l_page_size);
+
+    float l_a[8 * 3];
+    float l_b[8 * 3];
+    for (int i = 0; i < 8 * 3; i++) {
+        l_a[i] = (float)i;
+        l_b[i] = -1.0f;
+    }
+
+    l_zero(nullptr, l_b, 8, 8);
+    for (int i = 0; i < 8 * 3; i++) {
+        REQUIRE(l_b[i] == 0.0f);
+    }
+    l_identity(l_a, l_b, 8, 8);
+    for (int i = 0; i < 8 * 3; i++) {
+        REQUIRE(l_b[i] == l_a[i]);
+    }
+
+    KernelCache::clear();
+    REQUIRE(KernelCache::code_size() == 0);
+}
+
+TEST_CASE("MiniJit::KernelCache::Packs kernels outside a batch into the code arena", "[MiniJit][KernelCache]") {
+    KernelCache::clear();
+
+    Unary::kernel_t l_zero = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::zero);
+    Unary::kernel_t l_identity = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::identity);
+    REQUIRE(l_zero != nullptr);
+    REQUIRE(l_identity != nullptr);
+
+    // the second kernel does not start on a new page
+    uintptr_t l_page_size = sysconf(_SC_PAGESIZE);
+    REQUIRE(KernelCache::code_size() <= l_page_size);
+    REQUIRE(reinterpret_cast<uintptr_t>(l_zero) / l_page_size == reinterpret_cast<uintptr_t>(l_identity) / l_page_size);
+
+    float l_a[8 * 3];
+    float l_b[8 * 3];
+    for (int i = 0; i < 8 * 3; i++) {
+        l_a[i] = (float)i;
+        l_b[i] = -1.0f;
+    }
+
+    // the first kernel stays executable while the second one is added
+    l_zero(nullptr, l_b, 8, 8);
+    for (int i = 0; i < 8 * 3; i++) {
+        REQUIRE(l_b[i] == 0.0f);
+    }
+    l_identity(l_a, l_b, 8, 8);
+    for (int i = 0; i < 8 * 3; i++) {
+        REQUIRE(l_b[i] == l_a[i]);
+    }
+
+    KernelCache::clear();
+}
+
+TEST_CASE("MiniJit::CodeArena::Batches of one arena do not defer other arenas", "[MiniJit][KernelCache]") {
+#if defined(__x86_64__)
+    // mov eax, 42; ret
+    uint8_t l_code[] = {0xb8, 0x2a, 0x00, 0x00, 0x00, 0xc3};
+#else
+    // mov w0, #42; ret
+    uint32_t l_code[] = {0x52800540, 0xd65f03c0};
+#endif
+
+    mini_jit::backend::CodeArena l_arena_0;
+    mini_jit::backend::CodeArena l_arena_1;
+
+    l_arena_0.begin_batch();
+    auto l_func = reinterpret_cast<int (*)()>(l_arena_1.add(l_code,
+                                                            sizeof(l_code)));
+    REQUIRE(l_func() == 42);
+    l_arena_0.end_batch();
+
+    REQUIRE(l_arena_1.get_size_used() == sizeof(l_code));
+}
+
+TEST_CASE("MiniJit::KernelCache::Hands out executable kernels of an open batch to other threads", "[MiniJit][KernelCache]") {
+    KernelCache::clear();
+
+    float l_a[8 * 3];
+    float l_b[8 * 3];
+    for (int i = 0; i < 8 * 3; i++) {
+        l_a[i] = (float)i;
+        l_b[i] = -1.0f;
+    }
+
+    {
+        KernelCache::Batch l_batch;
+        Unary::kernel_t l_pending = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::identity);
+        REQUIRE(l_pending != nullptr);
+
+        // the batch of this thread is still open
+        std::thread l_thread([&]() {
+            Unary::kernel_t l_kernel = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::identity);
+            l_kernel(l_a, l_b, 8, 8);
+        });
+        l_thread.join();
+    }
+
+    for (int i = 0; i < 8 * 3; i++) {
+        REQUIRE(l_b[i] == l_a[i]);
+    }
+
+    KernelCache::clear();
+}
+
+TEST_CASE("MiniJit::KernelCache::Cached BRGEMM is correct", "[MiniJit][KernelCache][FP32]") {
+    int64_t m = 21;
+    int64_t n = 7;
+    int64_t k = 13;
+    int64_t br = 3;
+
+    float *l_a = (float *)malloc(m * k * br * sizeof(float));
+    float *l_b = (float *)malloc(k * n * br * sizeof(float));
+    float *l_c_jit = (float *)malloc(m * n * sizeof(float));
+    float *l_c_ref = (float *)malloc(m * n * sizeof(float));
+
+    for (int i = 0; i < br * m * k; i++) {
+        l_a[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < br * k * n; i++) {
+        l_b[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < m * n; i++) {
+        l_c_jit[i] = (float)drand48() * 10 - 5;
+        l_c_ref[i] = l_c_jit[i];
+    }
+
+    // the second request hits the cache
+    KernelCache::get_brgemm(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+    Brgemm::kernel_t l_kernel = KernelCache::get_brgemm(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+    REQUIRE(l_kernel != nullptr);
+
+    brgemm_ref(l_a, l_b, l_c_ref,
+               m, n, k, br,
+               m, k, m,
+               m * k, n * k);
+    l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k, nullptr);
+
+    for (int i = 0; i < m * n; i++) {
+        REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
+    }
+
+    free(l_a);
+    free(l_b);
+    free(l_c_jit);
+    free(l_c_ref);
+}
+
+TEST_CASE("MiniJit::KernelCache::Prefetching BRGEMM is correct", "[MiniJit][KernelCache][FP32]") {
+    int64_t m = 35;
+    int64_t n = 9;
+    int64_t k = 17;
+    int64_t br = 4;
+
+    Brgemm::prefetch_t l_prefetch;
+    l_prefetch.k_distance = 8;
+    l_prefetch.next_br = true;
+
+    // prefetching kernels have a signature of their own
+    REQUIRE(KernelCache::brgemm_signature(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false) !=
+            KernelCache::brgemm_signature(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false, l_prefetch));
+
+    Brgemm::kernel_t l_kernel = KernelCache::get_brgemm(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false, l_prefetch);
+    REQUIRE(l_kernel != nullptr);
+    REQUIRE(l_kernel != KernelCache::get_brgemm(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false));
+
+    float *l_a = (float *)malloc(m * k * br * sizeof(float));
+    float *l_b = (float *)malloc(k * n * br * sizeof(float));
+    float *l_c_jit = (float *)malloc(m * n * sizeof(float));
+    float *l_c_ref = (float *)malloc(m * n * sizeof(float));
+
+    for (int i = 0; i < br * m * k; i++) {
+        l_a[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < br * k * n; i++) {
+        l_b[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < m * n; i++) {
+        l_c_jit[i] = (float)drand48() * 10 - 5;
+        l_c_ref[i] = l_c_jit[i];
+    }
+
+    brgemm_ref(l_a, l_b, l_c_ref,
+               m, n, k, br,
+               m, k, m,
+               m * k, n * k);
+    l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k, nullptr);
+
+    for (int i = 0; i < m * n; i++) {
+        REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
+    }
+
+    free(l_a);
+    free(l_b);
+    free(l_c_jit);
+    free(l_c_ref);
+}
+
+TEST_CASE("MiniJit::KernelCache::Warm start from the on-disk cache", "[MiniJit][KernelCache][FP32]") {
+    std::filesystem::path l_dir = std::filesystem::temp_directory_path() / "mini_jit_test_kernel_cache";
+    std::filesystem::remove_all(l_dir);
+    std::filesystem::create_directories(l_dir);
+
+    std::string l_cache_dir_old = KernelCache::get_cache_dir();
+    KernelCache::set_cache_dir(l_dir.string());
+    KernelCache::clear();
+
+    int64_t m = 19;
+    int64_t n = 5;
+    int64_t k = 9;
+    int64_t br = 2;
+
+    // cold start generates and stores the kernels
+    REQUIRE(KernelCache::get_brgemm(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false) != nullptr);
+    REQUIRE(KernelCache::get_unary(m, n, Unary::dtype_t::fp32, Unary::ptype_t::relu) != nullptr);
+
+    std::size_t l_num_files = 0;
+    for (auto const& l_entry : std::filesystem::directory_iterator(l_dir)) {
+        REQUIRE(l_entry.path().extension() == ".bin");
+        l_num_files++;
+    }
+    REQUIRE(l_num_files == 2);
+
+    // warm start loads the kernels
+    KernelCache::clear();
+    Brgemm::kernel_t l_kernel = KernelCache::get_brgemm(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+    Unary::kernel_t l_relu = KernelCache::get_unary(m, n, Unary::dtype_t::fp32, Unary::ptype_t::relu);
+    REQUIRE(l_kernel != nullptr);
+    REQUIRE(l_relu != nullptr);
+
+    float *l_a = (float *)malloc(m * k * br * sizeof(float));
+    float *l_b = (float *)malloc(k * n * br * sizeof(float));
+    float *l_c_jit = (float *)malloc(m * n * sizeof(float));
+    float *l_c_ref = (float *)malloc(m * n * sizeof(float));
+
+    for (int i = 0; i < br * m * k; i++) {
+        l_a[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < br * k * n; i++) {
+        l_b[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < m * n; i++) {
+        l_c_jit[i] = (float)drand48() * 10 - 5;
+        l_c_ref[i] = l_c_jit[i];
+    }
+
+    brgemm_ref(l_a, l_b, l_c_ref,
+               m, n, k, br,
+               m, k, m,
+               m * k, n * k);
+    l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k, nullptr);
+
+    for (int i = 0; i < m * n; i++) {
+        REQUIRE(std::abs(l_c_jit[i] - l_c_ref[i]) < 0.0001);
+    }
+
+    l_relu(l_c_jit, l_c_jit, m, m);
+    for (int i = 0; i < m * n; i++) {
+        REQUIRE(std::abs(l_c_jit[i] - std::max(l_c_ref[i], 0.0f)) < 0.0001);
+    }
+
+    free(l_a);
+    free(l_b);
+    free(l_c_jit);
+    free(l_c_ref);
+
+    KernelCache::clear();
+    KernelCache::set_cache_dir(l_cache_dir_old);
+    std::filesystem::remove_all(l_dir);
+}
+
+TEST_CASE("MiniJit::KernelCache::Rejects files of other kernels in the on-disk cache", "[MiniJit][KernelCache]") {
+    std::filesystem::path l_dir = std::filesystem::temp_directory_path() / "mini_jit_test_kernel_cache_rejects";
+    std::filesystem::remove_all(l_dir);
+    std::filesystem::create_directories(l_dir);
+
+    std::string l_cache_dir_old = KernelCache::get_cache_dir();
+    KernelCache::set_cache_dir(l_dir.string());
+    KernelCache::clear();
+
+    REQUIRE(KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::zero) != nullptr);
+    REQUIRE(KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::identity) != nullptr);
+
+    std::vector<std::filesystem::path> l_files;
+    for (auto const& l_entry : std::filesystem::directory_iterator(l_dir)) {
+        l_files.push_back(l_entry.path());
+    }
+    REQUIRE(l_files.size() == 2);
+
+    // swap the stored kernels, both files have valid headers of the other signature
+    std::filesystem::path l_tmp = l_dir / "swap.tmp";
+    std::filesystem::rename(l_files[0], l_tmp);
+    std::filesystem::rename(l_files[1], l_files[0]);
+    std::filesystem::rename(l_tmp, l_files[1]);
+
+    float l_a[8 * 3];
+    float l_b[8 * 3];
+    for (int i = 0; i < 8 * 3; i++) {
+        l_a[i] = (float)i;
+        l_b[i] = -1.0f;
+    }
+
+    KernelCache::clear();
+    Unary::kernel_t l_identity = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::identity);
+    REQUIRE(l_identity != nullptr);
+    l_identity(l_a, l_b, 8, 8);
+    for (int i = 0; i < 8 * 3; i++) {
+        REQUIRE(l_b[i] == l_a[i]);
+    }
+
+    // files without a header are not loaded either
+    for (std::filesystem::path const& l_file : l_files) {
+        std::ofstream l_out(l_file, std::ios::binary | std::ios::trunc);
+        l_out << "not a kernel";
+    }
+
+    KernelCache::clear();
+    Unary::kernel_t l_zero = KernelCache::get_unary(8, 3, Unary::dtype_t::fp32, Unary::ptype_t::zero);
+    REQUIRE(l_zero != nullptr);
+    l_zero(nullptr, l_b, 8, 8);
+    for (int i = 0; i < 8 * 3; i++) {
+        REQUIRE(l_b[i] == 0.0f);
+    }
+
+    KernelCache::clear();
+    KernelCache::set_cache_dir(l_cache_dir_old);
+    std::filesystem::remove_all(l_dir);
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+
+#include "../../src/mini_jit/generator/KernelCache.h"
+#include "../../src/mini_jit/generator/TuningTable.h"
+#include "../../src/mini_jit/include/gemm_ref.h"
+
+using namespace mini_jit::generator;
+
+static bool check_brgemm(Brgemm::kernel_t l_kernel,
+                         int64_t m,
+                         int64_t n,
+                         int64_t k,
+                         int64_t br) {
+    float *l_a = (float *)malloc((m * k * br + 16) * sizeof(float));
+    float *l_b = (float *)malloc((k * n * br + 16) * sizeof(float));
+    float *l_c_jit = (float *)malloc(m * n * sizeof(float));
+    float *l_c_ref = (float *)malloc(m * n * sizeof(float));
+
+    for (int i = 0; i < br * m * k; i++) {
+        l_a[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < br * k * n; i++) {
+        l_b[i] = (float)drand48() * 10 - 5;
+    }
+    for (int i = 0; i < m * n; i++) {
+        l_c_jit[i] = (float)drand48() * 10 - 5;
+        l_c_ref[i] = l_c_jit[i];
+    }
+
+    brgemm_ref(l_a, l_b, l_c_ref,
+               m, n, k, br,
+               m, k, m,
+               m * k, n * k);
+    l_kernel(l_a, l_b, l_c_jit, m, k, m, m * k, n * k, nullptr);
+
+    bool l_correct = true;
+    for (int i = 0; i < m * n; i++) {
+        if (std::abs(l_c_jit[i] - l_c_ref[i]) > 0.0001) {
+            l_correct = false;
+        }
+    }
+
+    free(l_a);
+    free(l_b);
+    free(l_c_jit);
+    free(l_c_ref);
+
+    return l_correct;
+}
+
+TEST_CASE("MiniJit::TuningTable::Explicit blockings are correct", "[MiniJit][TuningTable][FP32]") {
+    int64_t m = 37;
+    int64_t n = 11;
+    int64_t k = 5;
+    int64_t br = 2;
+
+    uint32_t l_num_generated = 0;
+    for (uint32_t l_mv = 1; l_mv <= TuningTable::MAX_M_VECTORS; l_mv++) {
+        for (uint32_t l_nb = 1; l_nb <= TuningTable::MAX_N_BLOCK; l_nb++) {
+            Brgemm::blocking_t l_blocking;
+            l_blocking.m_vectors = l_mv;
+            l_blocking.n = l_nb;
+
+            Brgemm l_brgemm;
+            l_brgemm.set_blocking(l_blocking);
+            if (l_brgemm.generate(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false) != Brgemm::error_t::success) {
+                continue;
+            }
+            l_num_generated++;
+
+            REQUIRE(check_brgemm(l_brgemm.get_kernel(), m, n, k, br));
+        }
+    }
+
+    // a single vector and column always fits
+    REQUIRE(l_num_generated > 0);
+}
+
+TEST_CASE("MiniJit::TuningTable::Tuned BRGEMM is correct", "[MiniJit][TuningTable][FP32]") {
+    // shape of the hidden layers of the iris model
+    int64_t m = 64;
+    int64_t n = 3;
+    int64_t k = 16;
+    int64_t br = 1;
+
+    TuningTable::clear();
+    Brgemm::blocking_t l_blocking;
+    REQUIRE(!TuningTable::lookup(m, n, k, br, l_blocking));
+
+    Brgemm::blocking_t l_tuned = TuningTable::tune(m, n, k, br);
+    REQUIRE(TuningTable::lookup(m, n, k, br, l_blocking));
+    REQUIRE(l_blocking.m_vectors == l_tuned.m_vectors);
+    REQUIRE(l_blocking.n == l_tuned.n);
+    REQUIRE(l_blocking.n <= n);
+
+    // the kernel cache picks up the tuned blocking
+    Brgemm::kernel_t l_kernel = KernelCache::get_brgemm(m, n, k, br, 0, 0, 0, Brgemm::dtype_t::fp32, false);
+    REQUIRE(l_kernel != nullptr);
+    REQUIRE(check_brgemm(l_kernel, m, n, k, br));
+
+    TuningTable::clear();
+}
+
+TEST_CASE("MiniJit::TuningTable::Store and load", "[MiniJit][TuningTable]") {
+    std::filesystem::path l_path = std::filesystem::temp_directory_path() / "mini_jit_test_tuning_table.txt";
+
+    TuningTable::clear();
+    TuningTable::record(64, 3, 16, 1, Brgemm::blocking_t{2, 3});
+    TuningTable::record(17, 9, 4, 8, Brgemm::blocking_t{0, 0});
+    REQUIRE(TuningTable::store(l_path.string().c_str()) == Brgemm::error_t::success);
+
+    TuningTable::clear();
+    REQUIRE(TuningTable::size() == 0);
+    REQUIRE(TuningTable::load(l_path.string().c_str()) == Brgemm::error_t::success);
+    REQUIRE(TuningTable::size() == 2);
+
+    Brgemm::blocking_t l_blocking;
+    REQUIRE(TuningTable::lookup(64, 3, 16, 1, l_blocking));
+    REQUIRE(l_blocking.m_vectors == 2);
+    REQUIRE(l_blocking.n == 3);
+    REQUIRE(TuningTable::lookup(17, 9, 4, 8, l_blocking));
+    REQUIRE(l_blocking.m_vectors == 0);
+    REQUIRE(l_blocking.n == 0);
+
+    REQUIRE(TuningTable::load("/nonexistent/mini_jit_tuning_table.txt") == Brgemm::error_t::io_error);
+
+    TuningTable::clear();
+    std::filesystem::remove(l_path);
+}
@@ -1,9 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 
+#include "../../src/mini_jit/backend/Cpu.h"
 #include "../../src/mini_jit/generator/Unary.h"
 #include "../../src/mini_jit/generator/Util.h"
 #include "../test_utils/test_utils.h"
@@ -120,4 +122,264 @@ TEST_CASE("MiniJit::Unary Tests Unary TRANSPOSE", "[MiniJit][UNARY]") {
     }
 }
 
-/* TODO add tests with using a new kernel */
\ No newline at end of file
+/* TODO add tests with using a new kernel */
+TEST_CASE("MiniJit::Unary Tests Unary activations", "[MiniJit][UNARY]") {
+    Unary::ptype_t ptypes[4] = {Unary::ptype_t::gelu, Unary::ptype_t::sigmoid, Unary::ptype_t::tanh, Unary::ptype_t::silu};
+    // full and partial vectors, more than one chunk of registers per column
+    int sizes[4][2] = {{1, 1}, {7, 3}, {33, 5}, {161, 2}};
+
+    for (Unary::ptype_t ptype : ptypes) {
+        for (auto& size : sizes) {
+            int l_m = size[0];
+            int l_n = size[1];
+            int l_ld_a = l_m + 3;
+            int l_ld_b = l_m + 1;
+
+            srand48(l_m * l_n);
+
+            float* l_in = new float[l_ld_a * l_n];
+            float* l_out = new float[l_ld_b * l_n];
+
+            for (int i = 0; i < l_ld_a * l_n; i++) {
+                l_in[i] = (float)drand48() * 20 - 10;
+            }
+            for (int i = 0; i < l_ld_b * l_n; i++) {
+                l_out[i] = 42.0f;
+            }
+
+            Unary l_unary;
+            REQUIRE(l_unary.generate(l_m, l_n, Unary::dtype_t::fp32, ptype) == Unary::error_t::success);
+            l_unary.get_kernel()(l_in, l_out, l_ld_a, l_ld_b);
+
+            for (int l_j = 0; l_j < l_n; l_j++) {
+                for (int l_i = 0; l_i < l_ld_b; l_i++) {
+                    float l_ref = 42.0f;
+                    if (l_i < l_m) {
+                        l_ref = Activation::reference(Unary::to_act(ptype), l_in[l_j * l_ld_a + l_i]);
+                    }
+                    REQUIRE(std::abs(l_out[l_j * l_ld_b + l_i] - l_ref) < 2e-5);
+                }
+            }
+
+            delete[] l_in;
+            delete[] l_out;
+        }
+    }
+}
+
+TEST_CASE("MiniJit::Unary Tests Unary FP64", "[MiniJit][UNARY][FP64]") {
+    Unary::ptype_t ptypes[4] = {Unary::ptype_t::zero, Unary::ptype_t::identity, Unary::ptype_t::relu, Unary::ptype_t::trans};
+    // odd and even sizes, more than one unrolled iteration per column
+    int sizes[5][2] = {{1, 1}, {7, 3}, {33, 5}, {2, 7}, {40, 4}};
+
+    for (Unary::ptype_t ptype : ptypes) {
+        for (auto& size : sizes) {
+            int l_m = size[0];
+            int l_n = size[1];
+            bool l_trans = ptype == Unary::ptype_t::trans;
+            // B is n x m for the transposition
+            int l_rows_b = l_trans ? l_n : l_m;
+            int l_cols_b = l_trans ? l_m : l_n;
+            int l_ld_a = l_m + 3;
+            int l_ld_b = l_rows_b + 1;
+
+            srand48(l_m * l_n);
+
+            double* l_in = new double[l_ld_a * l_n];
+            double* l_out = new double[l_ld_b * l_cols_b];
+
+            for (int i = 0; i < l_ld_a * l_n; i++) {
+                l_in[i] = drand48() * 20 - 10;
+            }
+            for (int i = 0; i < l_ld_b * l_cols_b; i++) {
+                l_out[i] = 42.0;
+            }
+
+            Unary l_unary;
+            REQUIRE(l_unary.generate(l_m, l_n, Unary::dtype_t::fp64, ptype) == Unary::error_t::success);
+            l_unary.get_kernel()(l_in, l_out, l_ld_a, l_ld_b);
+
+            for (int l_j = 0; l_j < l_cols_b; l_j++) {
+                for (int l_i = 0; l_i < l_ld_b; l_i++) {
+                    double l_ref = 42.0;
+                    if (l_i < l_rows_b) {
+                        if (l_trans) {
+                            l_ref = l_in[l_i * l_ld_a + l_j];
+                        } else if (ptype == Unary::ptype_t::zero) {
+                            l_ref = 0.0;
+                        } else {
+                            double l_a = l_in[l_j * l_ld_a + l_i];
+                            l_ref = (ptype == Unary::ptype_t::relu && l_a < 0.0) ? 0.0 : l_a;
+                        }
+                    }
+                    REQUIRE(l_out[l_j * l_ld_b + l_i] == l_ref);
+                }
+            }
+
+            delete[] l_in;
+            delete[] l_out;
+        }
+    }
+
+    // the activations are evaluated in fp32 only
+    Unary l_unary;
+    REQUIRE(l_unary.generate(8, 8, Unary::dtype_t::fp64, Unary::ptype_t::gelu) == Unary::error_t::bad_param);
+}
+
+TEST_CASE("MiniJit::Unary Tests Unary BF16", "[MiniJit][UNARY][BF16]") {
+    // bfloat16 is a storage type only
+    Unary l_relu;
+    REQUIRE(l_relu.generate(8, 8, Unary::dtype_t::bf16, Unary::ptype_t::relu) == Unary::error_t::bad_param);
+    Unary l_fp32;
+    REQUIRE(l_fp32.generate(8, 8, Unary::dtype_t::fp32, Unary::ptype_t::to_bf16) == Unary::error_t::bad_param);
+
+    if (!mini_jit::backend::Cpu::has_bf16()) {
+        Unary l_unary;
+        REQUIRE(l_unary.generate(8, 8, Unary::dtype_t::bf16, Unary::ptype_t::to_bf16) == Unary::error_t::bad_param);
+        return;
+    }
+
+    int sizes[6][2] = {{1, 1}, {7, 3}, {33, 5}, {2, 7}, {40, 4}, {64, 2}};
+    for (auto& size : sizes) {
+        int l_m = size[0];
+        int l_n = size[1];
+        int l_ld_a = l_m + 3;
+        int l_ld_b = l_m + 1;
+
+        srand48(l_m * l_n);
+
+        float* l_fp32_in = new float[l_ld_a * l_n];
+        uint16_t* l_bf16 = new uint16_t[l_ld_b * l_n];
+        float* l_fp32_out = new float[l_ld_a * l_n];
+
+        for (int i = 0; i < l_ld_a * l_n; i++) {
+            l_fp32_in[i] = (float)drand48() * 20 - 10;
+            l_fp32_out[i] = 42.0f;
+        }
+        for (int i = 0; i < l_ld_b * l_n; i++) {
+            l_bf16[i] = 0x1234;
+        }
+
+        Unary l_to_bf16;
+        REQUIRE(l_to_bf16.generate(l_m, l_n, Unary::dtype_t::bf16, Unary::ptype_t::to_bf16) == Unary::error_t::success);
+        l_to_bf16.get_kernel()(l_fp32_in, l_bf16, l_ld_a, l_ld_b);
+
+        Unary l_from_bf16;
+        REQUIRE(l_from_bf16.generate(l_m, l_n, Unary::dtype_t::bf16, Unary::ptype_t::from_bf16) == Unary::error_t::success);
+        l_from_bf16.get_kernel()(l_bf16, l_fp32_out, l_ld_b, l_ld_a);
+
+        for (int l_j = 0; l_j < l_n; l_j++) {
+            for (int l_i = 0; l_i < l_ld_b; l_i++) {
+                uint16_t l_ref = 0x1234;
+                if (l_i < l_m) {
+                    l_ref = test::bf16::from_fp32(l_fp32_in[l_j * l_ld_a + l_i]);
+                }
+                REQUIRE(l_bf16[l_j * l_ld_b + l_i] == l_ref);
+            }
+            for (int l_i = 0; l_i < l_ld_a; l_i++) {
+                float l_ref = 42.0f;
+                if (l_i < l_m) {
+                    l_ref = test::bf16::to_fp32(l_bf16[l_j * l_ld_b + l_i]);
+                }
+                REQUIRE(l_fp32_out[l_j * l_ld_a + l_i] == l_ref);
+            }
+        }
+
+        delete[] l_fp32_in;
+        delete[] l_bf16;
+        delete[] l_fp32_out;
+    }
+}
+
+TEST_CASE("MiniJit::Unary Tests Unary FP16", "[MiniJit][UNARY][FP16]") {
+    // the conversions are tied to the half precision data type, which has no rational activations
+    Unary l_fp32;
+    REQUIRE(l_fp32.generate(8, 8, Unary::dtype_t::fp32, Unary::ptype_t::to_fp16) == Unary::error_t::bad_param);
+    Unary l_gelu;
+    REQUIRE(l_gelu.generate(8, 8, Unary::dtype_t::fp16, Unary::ptype_t::gelu) == Unary::error_t::bad_param);
+
+    if (!mini_jit::backend::Cpu::has_fp16_fp32()) {
+        Unary l_unary;
+        REQUIRE(l_unary.generate(8, 8, Unary::dtype_t::fp16, Unary::ptype_t::to_fp16) == Unary::error_t::bad_param);
+        return;
+    }
+
+    int sizes[6][2] = {{1, 1}, {7, 3}, {33, 5}, {2, 7}, {40, 4}, {64, 2}};
+    for (auto& size : sizes) {
+        int l_m = size[0];
+        int l_n = size[1];
+        int l_ld_a = l_m + 3;
+        int l_ld_b = l_m + 1;
+
+        srand48(l_m * l_n);
+
+        float* l_fp32_in = new float[l_ld_a * l_n];
+        uint16_t* l_fp16 = new uint16_t[l_ld_b * l_n];
+        uint16_t* l_fp16_out = new uint16_t[l_ld_b * l_n];
+        float* l_fp32_out = new float[l_ld_a * l_n];
+
+        for (int i = 0; i < l_ld_a * l_n; i++) {
+            l_fp32_in[i] = (float)drand48() * 20 - 10;
+            l_fp32_out[i] = 42.0f;
+        }
+        for (int i = 0; i < l_ld_b * l_n; i++) {
+            l_fp16[i] = 0x1234;
+            l_fp16_out[i] = 0x1234;
+        }
+
+        Unary l_to_fp16;
+        REQUIRE(l_to_fp16.generate(l_m, l_n, Unary::dtype_t::fp16, Unary::ptype_t::to_fp16) == Unary::error_t::success);
+        l_to_fp16.get_kernel()(l_fp32_in, l_fp16, l_ld_a, l_ld_b);
+
+        Unary l_from_fp16;
+        REQUIRE(l_from_fp16.generate(l_m, l_n, Unary::dtype_t::fp16, Unary::ptype_t::from_fp16) == Unary::error_t::success);
+        l_from_fp16.get_kernel()(l_fp16, l_fp32_out, l_ld_b, l_ld_a);
+
+        for (int l_j = 0; l_j < l_n; l_j++) {
+            for (int l_i = 0; l_i < l_ld_b; l_i++) {
+                uint16_t l_ref = 0x1234;
+                if (l_i < l_m) {
+                    l_ref = test::fp16::from_fp32(l_fp32_in[l_j * l_ld_a + l_i]);
+                }
+                REQUIRE(l_fp16[l_j * l_ld_b + l_i] == l_ref);
+            }
+            for (int l_i = 0; l_i < l_ld_a; l_i++) {
+                float l_ref = 42.0f;
+                if (l_i < l_m) {
+                    l_ref = test::fp16::to_fp32(l_fp16[l_j * l_ld_b + l_i]);
+                }
+                REQUIRE(l_fp32_out[l_j * l_ld_a + l_i] == l_ref);
+            }
+        }
+
+        // identity, ReLU and zero on half precision data
+        Unary::ptype_t l_ptypes[3] = {Unary::ptype_t::identity, Unary::ptype_t::relu, Unary::ptype_t::zero};
+        for (Unary::ptype_t l_ptype : l_ptypes) {
+            Unary l_unary;
+            if (l_ptype == Unary::ptype_t::relu && !mini_jit::backend::Cpu::has_fp16()) {
+                REQUIRE(l_unary.generate(l_m, l_n, Unary::dtype_t::fp16, l_ptype) == Unary::error_t::bad_param);
+                continue;
+            }
+            REQUIRE(l_unary.generate(l_m, l_n, Unary::dtype_t::fp16, l_ptype) == Unary::error_t::success);
+            l_unary.get_kernel()(l_fp16, l_fp16_out, l_ld_b, l_ld_b);
+
+            for (int l_j = 0; l_j < l_n; l_j++) {
+                for (int l_i = 0; l_i < l_ld_b; l_i++) {
+                    uint16_t l_in = l_fp16[l_j * l_ld_b + l_i];
+                    uint16_t l_ref = 0x1234;
+                    if (l_i < l_m) {
+                        l_ref = (l_ptype == Unary::ptype_t::zero)                      ? 0
+                                : (l_ptype == Unary::ptype_t::relu && (l_in & 0x8000)) ? 0
+                                                                                       : l_in;
+                    }
+                    REQUIRE(l_fp16_out[l_j * l_ld_b + l_i] == l_ref);
+                }
+            }
+        }
+
+        delete[] l_fp32_in;
+        delete[] l_fp16;
+        delete[] l_fp16_out;
+        delete[] l_fp32_out;
+    }
+}
@@ -1,4 +1,7 @@
 #include "test_utils.h"
+
+#include <cmath>
+#include <cstring>
 void test::matmul::generate_matrix(uint32_t height, uint32_t width, float* M, bool set_zero, bool visualization) {
     float MAX = 100;
     float MIN = -100;
@@ -44,4 +47,55 @@ void test::matmul::print_matrix(uint32_t height, uint32_t width, float* M, std::
         }
         std::cout << std::endl;
     }
-}
\ No newline at end of file
+}
+
+uint16_t test::bf16::from_fp32(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return static_cast<uint16_t>((bits + 0x7fff + ((bits >> 16) & 1)) >> 16);
+}
+
+float test::bf16::to_fp32(uint16_t value) {
+    uint32_t bits = static_cast<uint32_t>(value) << 16;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+uint16_t test::fp16::from_fp32(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    bits &= 0x7fffffff;
+
+    // NaN, infinity and values rounding to infinity
+    if (bits > 0x7f800000) {
+        return sign | 0x7e00;
+    }
+    if (bits >= 0x477ff000) {
+        return sign | 0x7c00;
+    }
+    // subnormal half-precision values are multiples of 2^-24
+    if (bits < 0x38800000) {
+        float magnitude;
+        std::memcpy(&magnitude, &bits, sizeof(magnitude));
+        return sign | static_cast<uint16_t>(std::nearbyint(magnitude * 16777216.0f));
+    }
+    // round to nearest even on the 13 dropped bits and rebias the exponent from 127 to 15
+    bits += 0xfff + ((bits >> 13) & 1);
+    return sign | static_cast<uint16_t>((bits - 0x38000000) >> 13);
+}
+
+float test::fp16::to_fp32(uint16_t value) {
+    float sign = (value & 0x8000) ? -1.0f : 1.0f;
+    int exponent = (value >> 10) & 0x1f;
+    int mantissa = value & 0x3ff;
+
+    if (exponent == 0) {
+        return sign * std::ldexp(static_cast<float>(mantissa), -24);
+    }
+    if (exponent == 31) {
+        return mantissa == 0 ? sign * INFINITY : NAN;
+    }
+    return sign * std::ldexp(static_cast<float>(mantissa + 1024), exponent - 25);
+}
@@ -15,6 +15,16 @@ namespace test {
         bool compare_matrix(uint32_t height, uint32_t width, float* M, float* C);
         void print_matrix(uint32_t height, uint32_t width, float* M, std::string name);
     }  // namespace matmul
+    namespace bf16 {
+        // rounds to nearest even
+        uint16_t from_fp32(float value);
+        float to_fp32(uint16_t value);
+    }  // namespace bf16
+    namespace fp16 {
+        // IEEE half precision, rounds to nearest even
+        uint16_t from_fp32(float value);
+        float to_fp32(uint16_t value);
+    }  // namespace fp16
 }  // namespace test
 
 #endif
\ No newline at end of file